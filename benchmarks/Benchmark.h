@@ -0,0 +1,52 @@
+//
+// Benchmark.h
+//
+// Minimal self-registering benchmark harness for the lambda_bench target.
+//
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+class BenchmarkState {
+public:
+	std::size_t iterations;
+	// Work units (steps, nodes, ...) reported by the case for throughput.
+	std::size_t items = 0;
+
+	explicit BenchmarkState(std::size_t iterations):
+		iterations(iterations)
+	{};
+};
+
+struct BenchmarkCase {
+	std::string name;
+	std::function<void(BenchmarkState&)> body;
+};
+
+std::vector<BenchmarkCase>& benchmark_registry();
+
+struct BenchmarkRegistrar {
+	BenchmarkRegistrar(std::string name, std::function<void(BenchmarkState&)> body) {
+		benchmark_registry().push_back({std::move(name), std::move(body)});
+	}
+};
+
+template<typename T>
+void do_not_optimize(T const& value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_INNER(a, b)
+#define BENCHMARK_CASE(name) \
+	static void BENCHMARK_CONCAT(bench_, name)(BenchmarkState&); \
+	static const BenchmarkRegistrar BENCHMARK_CONCAT(bench_registrar_, name)(#name, BENCHMARK_CONCAT(bench_, name)); \
+	static void BENCHMARK_CONCAT(bench_, name)(BenchmarkState& state)
+
+#endif //BENCHMARK_H
@@ -0,0 +1,64 @@
+//
+// Workloads.cpp
+//
+
+#include "Workloads.h"
+
+using std::unique_ptr, std::make_unique;
+
+unique_ptr<Term> church_numeral(std::size_t n) {
+	unique_ptr<Term> body = make_unique<Variable>("x");
+	for (std::size_t i = 0; i < n; ++i) {
+		body = make_unique<Application>(make_unique<Variable>("f"), std::move(body));
+	}
+	return make_unique<Abstraction>(
+		make_unique<Variable>("f"),
+		make_unique<Abstraction>(make_unique<Variable>("x"), std::move(body))
+	);
+}
+
+unique_ptr<Term> church_mult() {
+	return make_unique<Abstraction>(make_unique<Variable>("m"),
+		make_unique<Abstraction>(make_unique<Variable>("n"),
+			make_unique<Abstraction>(make_unique<Variable>("f"),
+				make_unique<Application>(
+					make_unique<Variable>("m"),
+					make_unique<Application>(make_unique<Variable>("n"), make_unique<Variable>("f"))
+				))));
+}
+
+unique_ptr<Term> church_add() {
+	return make_unique<Abstraction>(make_unique<Variable>("m"),
+		make_unique<Abstraction>(make_unique<Variable>("n"),
+			make_unique<Abstraction>(make_unique<Variable>("f"),
+				make_unique<Abstraction>(make_unique<Variable>("x"),
+					make_unique<Application>(
+						make_unique<Application>(make_unique<Variable>("m"), make_unique<Variable>("f")),
+						make_unique<Application>(
+							make_unique<Application>(make_unique<Variable>("n"), make_unique<Variable>("f")),
+							make_unique<Variable>("x")
+						))))));
+}
+
+unique_ptr<Term> church_product(std::size_t a, std::size_t b) {
+	return make_unique<Application>(
+		make_unique<Application>(church_mult(), church_numeral(a)),
+		church_numeral(b)
+	);
+}
+
+unique_ptr<Term> eager_normalize(unique_ptr<Term> term, std::size_t& steps) {
+	while (!term->is_normal()) {
+		term = term->beta_reduce();
+		++steps;
+	}
+	return term;
+}
+
+unique_ptr<Term> in_place_normalize(unique_ptr<Term> term, std::size_t& steps) {
+	while (!term->is_normal()) {
+		term = beta_reduce(std::move(term));
+		++steps;
+	}
+	return term;
+}
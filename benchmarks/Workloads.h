@@ -0,0 +1,29 @@
+//
+// Workloads.h
+//
+// Standard terms shared by the benchmark cases.
+//
+
+#ifndef WORKLOADS_H
+#define WORKLOADS_H
+
+#include "../models/lambda.h"
+
+#include <cstddef>
+#include <memory>
+
+// λf. λx. f (f (... x))
+std::unique_ptr<Term> church_numeral(std::size_t n);
+// λm. λn. λf. m (n f)
+std::unique_ptr<Term> church_mult();
+// λm. λn. λf. λx. m f (n f x)
+std::unique_ptr<Term> church_add();
+// (mult a) b
+std::unique_ptr<Term> church_product(std::size_t a, std::size_t b);
+
+// Normal-order normalization through Term::beta_reduce, the eager baseline.
+std::unique_ptr<Term> eager_normalize(std::unique_ptr<Term> term, std::size_t& steps);
+// Same reduction order through the consuming ::beta_reduce overload.
+std::unique_ptr<Term> in_place_normalize(std::unique_ptr<Term> term, std::size_t& steps);
+
+#endif //WORKLOADS_H
@@ -0,0 +1,74 @@
+//
+// bench_block_lexer.cpp
+//
+
+#include "Benchmark.h"
+#include "../models/lambda.h"
+#include "../models/TermGenerator.h"
+#include "../parser/Lexer.h"
+#include "../parser/BlockLexer.h"
+
+#include <string>
+
+namespace {
+	// About 8 MB of to_string output.
+	const std::string& corpus() {
+		static const std::string text = [] {
+			std::string joined;
+			for (std::uint64_t seed = 0; joined.size() < (8u << 20); ++seed) {
+				joined += TermGenerator(GeneratorOptions{.seed = seed, .size = 50'000}).generate()->to_string();
+				joined += '\n';
+			}
+			return joined;
+		}();
+		return text;
+	}
+
+	void run_blocks(BenchmarkState& state, ScanBackend backend) {
+		if (!scan_backend_supported(backend)) return;
+		const auto& text = corpus();
+		for (std::size_t i = 0; i < state.iterations; ++i) {
+			auto tokens = tokenize_blocks(text, backend);
+			state.items += text.size();
+			do_not_optimize(tokens);
+		}
+	}
+}
+
+BENCHMARK_CASE(lex_8mb_tokenize) {
+	const auto& text = corpus();
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		auto tokens = tokenize(text);
+		state.items += text.size();
+		do_not_optimize(tokens);
+	}
+}
+
+BENCHMARK_CASE(lex_8mb_blocks_scalar) {
+	run_blocks(state, ScanBackend::Scalar);
+}
+
+BENCHMARK_CASE(lex_8mb_blocks_sse2) {
+	run_blocks(state, ScanBackend::SSE2);
+}
+
+BENCHMARK_CASE(lex_8mb_blocks_avx2) {
+	run_blocks(state, ScanBackend::AVX2);
+}
+
+// One short line, as the batch driver lexes them.
+BENCHMARK_CASE(lex_short_line_tokenize) {
+	const std::string line = "(λf. λx. (f) ((f) (x))) (λy. ((add) (y)) (1))";
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(tokenize(line));
+		++state.items;
+	}
+}
+
+BENCHMARK_CASE(lex_short_line_blocks) {
+	const std::string line = "(λf. λx. (f) ((f) (x))) (λy. ((add) (y)) (1))";
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(tokenize_blocks(line));
+		++state.items;
+	}
+}
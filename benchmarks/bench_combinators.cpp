@@ -0,0 +1,72 @@
+//
+// bench_combinators.cpp
+//
+// Items are whole normalizations here: β steps and combinator rewrites are
+// not comparable units.
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../engines/Combinators.h"
+
+namespace {
+	// ((mult a) b) g z, whose normal form g (g (... z)) reads back the same
+	// from either engine.
+	std::unique_ptr<Term> applied_product(std::size_t a, std::size_t b) {
+		return std::make_unique<Application>(
+			std::make_unique<Application>(church_product(a, b), std::make_unique<Variable>("g")),
+			std::make_unique<Variable>("z"));
+	}
+}
+
+BENCHMARK_CASE(applied_product_12x12_beta_reduce) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		do_not_optimize(eager_normalize(applied_product(12, 12), steps));
+	}
+	state.items = state.iterations;
+}
+
+BENCHMARK_CASE(applied_product_12x12_consuming_beta_reduce) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		do_not_optimize(in_place_normalize(applied_product(12, 12), steps));
+	}
+	state.items = state.iterations;
+}
+
+BENCHMARK_CASE(applied_product_12x12_combinators_compile_and_reduce) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		CombinatorGraph graph(*applied_product(12, 12));
+		graph.normalize();
+		do_not_optimize(graph.read_back());
+	}
+	state.items = state.iterations;
+}
+
+BENCHMARK_CASE(applied_product_12x12_combinators_reduce_only) {
+	const CombinatorGraph compiled(*applied_product(12, 12));
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		auto graph = compiled;
+		graph.normalize();
+		do_not_optimize(graph.read_back());
+	}
+	state.items = state.iterations;
+}
+
+BENCHMARK_CASE(applied_product_24x24_combinators_compile_and_reduce) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		CombinatorGraph graph(*applied_product(24, 24));
+		graph.normalize();
+		do_not_optimize(graph.read_back());
+	}
+	state.items = state.iterations;
+}
+
+BENCHMARK_CASE(applied_product_24x24_consuming_beta_reduce) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		do_not_optimize(in_place_normalize(applied_product(24, 24), steps));
+	}
+	state.items = state.iterations;
+}
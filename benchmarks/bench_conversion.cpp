@@ -0,0 +1,60 @@
+//
+// bench_conversion.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../engines/Conversion.h"
+#include "../engines/ExplicitSubstitution.h"
+
+namespace {
+	// The old way: normalize both sides completely and compare the text.
+	bool normalize_and_compare(const Term& lhs, const Term& rhs, std::size_t& steps) {
+		ExplicitSubstitutionEngine lhs_engine(lhs);
+		ExplicitSubstitutionEngine rhs_engine(rhs);
+		const bool equal = lhs_engine.normalize()->to_string() == rhs_engine.normalize()->to_string();
+		steps += lhs_engine.stats().beta_steps + rhs_engine.stats().beta_steps;
+		return equal;
+	}
+
+	// f (m * n) against g (m * n): unequal at the head.
+	std::unique_ptr<Term> applied_product(const char* head, std::size_t m, std::size_t n) {
+		return std::make_unique<Application>(std::make_unique<Variable>(head), church_product(m, n));
+	}
+}
+
+BENCHMARK_CASE(convert_product_30x30_normalize) {
+	const auto lhs = church_product(30, 30);
+	const auto rhs = church_numeral(900);
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(normalize_and_compare(*lhs, *rhs, state.items));
+	}
+}
+
+BENCHMARK_CASE(convert_product_30x30_lazy) {
+	const auto lhs = church_product(30, 30);
+	const auto rhs = church_numeral(900);
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		ConversionStats stats;
+		do_not_optimize(convertible(*lhs, *rhs, stats));
+		state.items += stats.reduction.beta_steps;
+	}
+}
+
+BENCHMARK_CASE(convert_head_mismatch_normalize) {
+	const auto lhs = applied_product("f", 30, 30);
+	const auto rhs = applied_product("g", 30, 30);
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(normalize_and_compare(*lhs, *rhs, state.items));
+	}
+}
+
+BENCHMARK_CASE(convert_head_mismatch_lazy) {
+	const auto lhs = applied_product("f", 30, 30);
+	const auto rhs = applied_product("g", 30, 30);
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		ConversionStats stats;
+		do_not_optimize(convertible(*lhs, *rhs, stats));
+		state.items += stats.reduction.beta_steps;
+	}
+}
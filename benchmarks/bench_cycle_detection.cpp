@@ -0,0 +1,34 @@
+//
+// bench_cycle_detection.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../engines/BoundedEvaluation.h"
+
+namespace {
+	void run_bounded(BenchmarkState& state, const ResourcePolicy& policy) {
+		for (std::size_t i = 0; i < state.iterations; ++i) {
+			auto result = evaluate(church_product(6, 6), policy);
+			state.items += result.steps;
+			do_not_optimize(result.term);
+		}
+	}
+}
+
+BENCHMARK_CASE(church_product_6x6_unguarded) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		auto result = in_place_normalize(church_product(6, 6), steps);
+		state.items += steps;
+		do_not_optimize(result);
+	}
+}
+
+BENCHMARK_CASE(church_product_6x6_bounded_no_cycle_check) {
+	run_bounded(state, ResourcePolicy{.max_steps = 1'000'000});
+}
+
+BENCHMARK_CASE(church_product_6x6_bounded_cycle_check) {
+	run_bounded(state, ResourcePolicy{.max_steps = 1'000'000, .detect_cycles = true});
+}
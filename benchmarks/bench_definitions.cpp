@@ -0,0 +1,46 @@
+//
+// bench_definitions.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+
+namespace {
+	// ((mult a) b) with mult and both numerals shared through definitions.
+	std::unique_ptr<Term> shared_product(const Definitions& definitions) {
+		return std::make_unique<Application>(
+			std::make_unique<Application>(definitions.reference("mult"), definitions.reference("a")),
+			definitions.reference("b"));
+	}
+}
+
+BENCHMARK_CASE(church_product_12x12_inlined_term_build) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		for (int copy = 0; copy < 1000; ++copy) do_not_optimize(church_product(12, 12));
+	}
+	state.items = state.iterations * 1000;
+}
+
+BENCHMARK_CASE(church_product_12x12_shared_term_build) {
+	Definitions definitions;
+	definitions.define("mult", church_mult());
+	definitions.define("a", church_numeral(12));
+	definitions.define("b", church_numeral(12));
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		for (int copy = 0; copy < 1000; ++copy) do_not_optimize(shared_product(definitions));
+	}
+	state.items = state.iterations * 1000;
+}
+
+BENCHMARK_CASE(church_product_12x12_shared_normalize) {
+	Definitions definitions;
+	definitions.define("mult", church_mult());
+	definitions.define("a", church_numeral(12));
+	definitions.define("b", church_numeral(12));
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		auto result = in_place_normalize(shared_product(definitions), steps);
+		state.items += steps;
+		do_not_optimize(result);
+	}
+}
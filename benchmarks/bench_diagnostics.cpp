@@ -0,0 +1,77 @@
+//
+// bench_diagnostics.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../engines/Diagnostics.h"
+#include "../models/lambda.h"
+#include "../parser/Parser.h"
+
+#include <vector>
+
+namespace {
+	// Ill-typed a tenth of the way in, so the rejection is cheap and the
+	// error path dominates.
+	std::vector<std::unique_ptr<Term>> ill_typed_terms() {
+		std::vector<std::unique_ptr<Term>> terms;
+		for (int i = 0; i < 64; ++i) terms.push_back(parse_term("λf: Nat -> Nat. add (f true) (mul " + std::to_string(i) + " 2)"));
+		return terms;
+	}
+}
+
+BENCHMARK_CASE(reject_ill_typed_exceptions) {
+	const auto terms = ill_typed_terms();
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		for (const auto& term : terms) {
+			try {
+				do_not_optimize(term->type_check(TypingContext()));
+			} catch (const std::exception& error) {
+				do_not_optimize(error);
+			}
+			++state.items;
+		}
+	}
+}
+
+BENCHMARK_CASE(reject_ill_typed_expected) {
+	const auto terms = ill_typed_terms();
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		for (const auto& term : terms) {
+			auto checked = try_type_check(*term);
+			do_not_optimize(checked);
+			++state.items;
+		}
+	}
+}
+
+// Reduction loops that find the normal form by running into it.
+BENCHMARK_CASE(church_product_4x4_until_exception) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		auto term = church_product(4, 4);
+		try {
+			for (;;) {
+				term = ::beta_reduce(std::move(term));
+				++state.items;
+			}
+		} catch (const ReductionOnNormalForm& error) {
+			do_not_optimize(error);
+		}
+	}
+}
+
+BENCHMARK_CASE(church_product_4x4_until_unexpected) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		auto term = church_product(4, 4);
+		for (;;) {
+			auto next = try_beta_reduce(std::move(term));
+			if (!next) {
+				term = std::move(next.error().term);
+				break;
+			}
+			term = std::move(*next);
+			++state.items;
+		}
+		do_not_optimize(term);
+	}
+}
@@ -0,0 +1,48 @@
+//
+// bench_explicit_substitution.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../engines/ExplicitSubstitution.h"
+
+BENCHMARK_CASE(church_product_12x12_eager) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		auto result = eager_normalize(church_product(12, 12), steps);
+		state.items += steps;
+		do_not_optimize(result);
+	}
+}
+
+BENCHMARK_CASE(church_product_12x12_explicit_substitution) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		ExplicitSubstitutionEngine engine(*church_product(12, 12));
+		auto result = engine.normalize();
+		state.items += engine.stats().beta_steps;
+		do_not_optimize(result);
+	}
+}
+
+// Only the head is demanded: λx. ... with the body left delayed.
+BENCHMARK_CASE(church_product_40x40_head_explicit_substitution) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		ExplicitSubstitutionEngine engine(*church_product(40, 40));
+		auto result = engine.weak_head_normalize();
+		state.items += engine.stats().beta_steps;
+		do_not_optimize(result);
+	}
+}
+
+BENCHMARK_CASE(church_product_40x40_head_eager) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		auto term = church_product(40, 40);
+		std::size_t steps = 0;
+		while (dynamic_cast<Abstraction*>(term.get()) == nullptr) {
+			term = term->beta_reduce();
+			++steps;
+		}
+		state.items += steps;
+		do_not_optimize(term);
+	}
+}
@@ -0,0 +1,24 @@
+//
+// bench_in_place.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+
+BENCHMARK_CASE(church_product_12x12_const_beta_reduce) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		auto result = eager_normalize(church_product(12, 12), steps);
+		state.items += steps;
+		do_not_optimize(result);
+	}
+}
+
+BENCHMARK_CASE(church_product_12x12_consuming_beta_reduce) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		auto result = in_place_normalize(church_product(12, 12), steps);
+		state.items += steps;
+		do_not_optimize(result);
+	}
+}
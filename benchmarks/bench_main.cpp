@@ -0,0 +1,36 @@
+//
+// bench_main.cpp
+//
+// Usage: lambda_bench [filter] [iterations]
+//
+
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+std::vector<BenchmarkCase>& benchmark_registry() {
+	static std::vector<BenchmarkCase> registry;
+	return registry;
+}
+
+int main(int argc, char** argv) {
+	const std::string filter = argc > 1 ? argv[1] : "";
+	const std::size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+
+	std::printf("%-48s %10s %14s %14s\n", "benchmark", "iters", "ns/iter", "items/s");
+	for (const auto& [name, body] : benchmark_registry()) {
+		if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+
+		BenchmarkState state(iterations);
+		const auto start = std::chrono::steady_clock::now();
+		body(state);
+		const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		const double per_iter = elapsed / static_cast<double>(state.iterations);
+		const double throughput = state.items == 0 ? 0.0 : static_cast<double>(state.items) / (elapsed / 1e9);
+		std::printf("%-48s %10zu %14.0f %14.0f\n", name.c_str(), state.iterations, per_iter, throughput);
+	}
+	return 0;
+}
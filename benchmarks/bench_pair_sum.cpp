@@ -0,0 +1,54 @@
+//
+// bench_pair_sum.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../parser/Parser.h"
+
+#include <string>
+
+namespace {
+	// `wrap` applied `depth` times around `seed`.
+	std::string nest(const std::string& wrap, const std::string& seed, std::size_t depth) {
+		std::string source = seed;
+		for (std::size_t i = 0; i < depth; ++i) source = wrap + " (" + source + ")";
+		return source;
+	}
+
+	constexpr std::size_t depth = 64;
+
+	void run(BenchmarkState& state, const std::string& source) {
+		for (std::size_t i = 0; i < state.iterations; ++i) {
+			std::size_t steps = 0;
+			auto result = in_place_normalize(parse_term(source), steps);
+			state.items += steps;
+			do_not_optimize(result);
+		}
+	}
+}
+
+BENCHMARK_CASE(swap_pair_64_church) {
+	run(state, "let mkpair = λa. λb. λs. s a b in "
+		"let first = λp. p (λx. λy. x) in "
+		"let second = λp. p (λx. λy. y) in "
+		"let swap = λp. mkpair (second p) (first p) in "
+		"first (" + nest("swap", "mkpair 1 2", depth) + ")");
+}
+
+BENCHMARK_CASE(swap_pair_64_native) {
+	run(state, "let swap = λp: Nat * Nat. (snd p, fst p) in "
+		"fst (" + nest("swap", "(1, 2)", depth) + ")");
+}
+
+BENCHMARK_CASE(flip_sum_64_church) {
+	run(state, "let left = λv. λl. λr. l v in "
+		"let right = λv. λl. λr. r v in "
+		"let flip = λs. s (λn. right n) (λn. left n) in "
+		"(" + nest("flip", "left 1", depth) + ") (λn. n) (λn. n)");
+}
+
+BENCHMARK_CASE(flip_sum_64_native) {
+	run(state, "let flip = λs: Nat + Nat. case s (λn: Nat. inr[Nat + Nat] n) (λn: Nat. inl[Nat + Nat] n) in "
+		"case (" + nest("flip", "inl[Nat + Nat] 1", depth) + ") (λn: Nat. n) (λn: Nat. n)");
+}
@@ -0,0 +1,31 @@
+//
+// bench_parallel_type_check.cpp
+//
+
+#include "Benchmark.h"
+#include "../engines/ParallelTypeCheck.h"
+#include "../models/TermGenerator.h"
+#include "../models/lambda.h"
+
+namespace {
+	std::unique_ptr<Term> large_term() {
+		return TermGenerator(GeneratorOptions{.seed = 7, .size = 200000, .max_depth = 64}).generate();
+	}
+}
+
+BENCHMARK_CASE(type_check_200k_sequential) {
+	const auto term = large_term();
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(try_type_check(*term));
+		++state.items;
+	}
+}
+
+BENCHMARK_CASE(type_check_200k_parallel) {
+	const auto term = large_term();
+	WorkStealingPool pool;
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(parallel_type_check(*term, pool));
+		++state.items;
+	}
+}
@@ -0,0 +1,27 @@
+//
+// bench_primitive.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+
+BENCHMARK_CASE(product_30x30_church) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		auto result = in_place_normalize(church_product(30, 30), steps);
+		state.items += steps;
+		do_not_optimize(result);
+	}
+}
+
+BENCHMARK_CASE(product_1000x1000_native) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::unique_ptr<Term> term = std::make_unique<Application>(
+			std::make_unique<Application>(std::make_unique<Primitive>(PrimitiveOp::Mul), Literal::nat(1000)),
+			Literal::nat(1000));
+		std::size_t steps = 0;
+		auto result = in_place_normalize(std::move(term), steps);
+		state.items += steps;
+		do_not_optimize(result);
+	}
+}
@@ -0,0 +1,44 @@
+//
+// bench_reduction_trace.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../engines/BoundedEvaluation.h"
+#include "../engines/ReductionTrace.h"
+
+#include <string>
+
+BENCHMARK_CASE(church_product_6x6_untraced) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		auto result = evaluate(church_product(6, 6), ResourcePolicy{});
+		state.items += result.steps;
+		do_not_optimize(result.term);
+	}
+}
+
+BENCHMARK_CASE(church_product_6x6_delta_trace) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		TraceRecorder recorder;
+		auto result = evaluate(church_product(6, 6), ResourcePolicy{.trace = &recorder});
+		state.items += result.steps;
+		do_not_optimize(result.term);
+		do_not_optimize(recorder.bytes());
+	}
+}
+
+// The approach the delta trace replaces: print every intermediate term.
+BENCHMARK_CASE(church_product_6x6_to_string_trace) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::string log;
+		auto term = church_product(6, 6);
+		log += term->to_string();
+		while (!term->is_normal()) {
+			term = ::beta_reduce(std::move(term));
+			log += term->to_string();
+			++state.items;
+		}
+		do_not_optimize(term);
+		do_not_optimize(log);
+	}
+}
@@ -0,0 +1,87 @@
+//
+// bench_shared_term.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../models/SharedTerm.h"
+
+#include <memory>
+
+namespace {
+
+// (λx. x x ... x) (church 500): one step copies the argument `copies` times.
+std::unique_ptr<Term> duplicating_redex(std::size_t copies) {
+	std::unique_ptr<Term> body = std::make_unique<Variable>("x");
+	for (std::size_t i = 1; i < copies; ++i) body = std::make_unique<Application>(std::move(body), std::make_unique<Variable>("x"));
+	return std::make_unique<Application>(
+		std::make_unique<Abstraction>(std::make_unique<Variable>("x"), std::move(body)),
+		church_numeral(500));
+}
+
+// m n for Church numerals, i.e. n^m.
+std::unique_ptr<Term> church_power(std::size_t base, std::size_t exponent) {
+	return std::make_unique<Application>(church_numeral(exponent), church_numeral(base));
+}
+
+}
+
+BENCHMARK_CASE(clone_church_2000_term) {
+	const auto term = church_numeral(2000);
+	for (std::size_t i = 0; i < state.iterations; ++i) do_not_optimize(term->clone());
+	state.items = state.iterations;
+}
+
+BENCHMARK_CASE(clone_church_2000_shared) {
+	const auto term = to_shared(*church_numeral(2000));
+	for (std::size_t i = 0; i < state.iterations; ++i) do_not_optimize(SharedTermPtr(term));
+	state.items = state.iterations;
+}
+
+BENCHMARK_CASE(duplicate_argument_16x_term) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		auto term = duplicating_redex(16);
+		do_not_optimize(::beta_reduce(std::move(term)));
+	}
+	state.items = state.iterations;
+}
+
+BENCHMARK_CASE(duplicate_argument_16x_shared) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		const auto term = to_shared(*duplicating_redex(16));
+		do_not_optimize(beta_reduce(term));
+	}
+	state.items = state.iterations;
+}
+
+BENCHMARK_CASE(church_product_8x8_normalize_term) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		do_not_optimize(in_place_normalize(church_product(8, 8), steps));
+		state.items += steps;
+	}
+}
+
+BENCHMARK_CASE(church_product_8x8_normalize_shared) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		do_not_optimize(normalize(to_shared(*church_product(8, 8)), steps));
+		state.items += steps;
+	}
+}
+
+BENCHMARK_CASE(church_power_3_5_normalize_term) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		do_not_optimize(in_place_normalize(church_power(3, 5), steps));
+		state.items += steps;
+	}
+}
+
+BENCHMARK_CASE(church_power_3_5_normalize_shared) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		do_not_optimize(normalize(to_shared(*church_power(3, 5)), steps));
+		state.items += steps;
+	}
+}
@@ -0,0 +1,47 @@
+//
+// bench_tagged_term.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../models/TaggedTerm.h"
+
+BENCHMARK_CASE(church_numeral_2000_analyses_virtual) {
+	const auto term = church_numeral(2000);
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(term->is_normal());
+		do_not_optimize(term->has_free("y"));
+		do_not_optimize(term->to_string().size());
+	}
+	state.items = state.iterations * 3;
+}
+
+BENCHMARK_CASE(church_numeral_2000_analyses_tagged) {
+	const auto term = to_tagged(*church_numeral(2000));
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(is_normal(*term));
+		do_not_optimize(has_free(*term, "y"));
+		do_not_optimize(to_string(*term).size());
+	}
+	state.items = state.iterations * 3;
+}
+
+BENCHMARK_CASE(church_product_8x8_reduce_virtual) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		std::size_t steps = 0;
+		auto result = eager_normalize(church_product(8, 8), steps);
+		state.items += steps;
+		do_not_optimize(result);
+	}
+}
+
+BENCHMARK_CASE(church_product_8x8_reduce_tagged) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		auto term = to_tagged(*church_product(8, 8));
+		while (!is_normal(*term)) {
+			term = beta_reduce(*term);
+			++state.items;
+		}
+		do_not_optimize(term);
+	}
+}
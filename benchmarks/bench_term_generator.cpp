@@ -0,0 +1,36 @@
+//
+// bench_term_generator.cpp
+//
+
+#include "Benchmark.h"
+#include "../models/lambda.h"
+#include "../models/TermGenerator.h"
+#include "../models/TermTape.h"
+
+BENCHMARK_CASE(generate_1m_nodes) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		TermGenerator generator(GeneratorOptions{.seed = i, .size = 1'000'000});
+		auto term = generator.generate();
+		state.items += term->measure().nodes;
+		do_not_optimize(term);
+	}
+}
+
+BENCHMARK_CASE(type_check_generated_100k) {
+	TermGenerator generator(GeneratorOptions{.seed = 1, .size = 100'000});
+	const auto term = generator.generate();
+	const auto nodes = term->measure().nodes;
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(term->type_check(TypingContext()));
+	}
+	state.items = state.iterations * nodes;
+}
+
+BENCHMARK_CASE(type_check_generated_100k_tape) {
+	TermGenerator generator(GeneratorOptions{.seed = 1, .size = 100'000});
+	const TermTape tape(*generator.generate());
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(tape.type_check(TypingContext()));
+	}
+	state.items = state.iterations * tape.size();
+}
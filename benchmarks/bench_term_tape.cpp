@@ -0,0 +1,27 @@
+//
+// bench_term_tape.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../models/TermTape.h"
+
+BENCHMARK_CASE(church_numeral_20000_analyses_pointer_tree) {
+	const auto term = church_numeral(20000);
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(term->is_normal());
+		do_not_optimize(term->has_free("y"));
+		do_not_optimize(term->to_string().size());
+	}
+	state.items = state.iterations * 3;
+}
+
+BENCHMARK_CASE(church_numeral_20000_analyses_tape) {
+	const TermTape tape(*church_numeral(20000));
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		do_not_optimize(tape.is_normal());
+		do_not_optimize(tape.has_free("y"));
+		do_not_optimize(tape.to_string().size());
+	}
+	state.items = state.iterations * 3;
+}
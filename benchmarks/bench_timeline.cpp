@@ -0,0 +1,48 @@
+//
+// bench_timeline.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../models/Timeline.h"
+#include "../engines/BoundedEvaluation.h"
+
+namespace {
+	// 12 * 12 in Church numerals, one evaluate() step span per beta step.
+	void run(BenchmarkState& state, bool recording) {
+		if (recording) Timeline::start();
+		const auto term = church_product(12, 12);
+		for (std::size_t i = 0; i < state.iterations; ++i) {
+			auto result = evaluate(term->clone(), ResourcePolicy{});
+			state.items += result.steps;
+			do_not_optimize(result);
+		}
+		Timeline::stop();
+	}
+}
+
+BENCHMARK_CASE(timeline_span_idle) {
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		TimelineSpan span("idle");
+		do_not_optimize(span);
+		++state.items;
+	}
+}
+
+BENCHMARK_CASE(timeline_span_recording) {
+	Timeline::start();
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		TimelineSpan span("recording");
+		do_not_optimize(span);
+		++state.items;
+	}
+	Timeline::stop();
+}
+
+BENCHMARK_CASE(timeline_evaluate_idle) {
+	run(state, false);
+}
+
+BENCHMARK_CASE(timeline_evaluate_recording) {
+	run(state, true);
+}
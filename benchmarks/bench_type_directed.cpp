@@ -0,0 +1,48 @@
+//
+// bench_type_directed.cpp
+//
+
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "../engines/BoundedEvaluation.h"
+#include "../parser/Parser.h"
+
+#include <string>
+
+namespace {
+	// ((mult a) b) on Church numerals annotated at Nat, so it type-checks.
+	std::string typed_product_source(std::size_t a, std::size_t b) {
+		const auto numeral = [](std::size_t n) {
+			std::string body = "x";
+			for (std::size_t i = 0; i < n; ++i) body = "f (" + body + ")";
+			return "(λf:Nat -> Nat. λx:Nat. " + body + ")";
+		};
+		return "(λm:(Nat -> Nat) -> Nat -> Nat. λn:(Nat -> Nat) -> Nat -> Nat. λf:Nat -> Nat. m (n f)) "
+			+ numeral(a) + " " + numeral(b);
+	}
+
+	const ResourcePolicy all_guards{
+		.max_steps = 1'000'000,
+		.max_nodes = 1'000'000,
+		.deadline = std::chrono::steady_clock::time_point::max(),
+		.detect_cycles = true,
+	};
+}
+
+BENCHMARK_CASE(typed_product_20x20_all_guards) {
+	const auto prototype = parse_term(typed_product_source(20, 20));
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		auto result = evaluate(prototype->clone(), all_guards);
+		state.items += result.steps;
+		do_not_optimize(result.term);
+	}
+}
+
+BENCHMARK_CASE(typed_product_20x20_type_directed) {
+	const auto prototype = parse_term(typed_product_source(20, 20));
+	for (std::size_t i = 0; i < state.iterations; ++i) {
+		auto result = evaluate_type_directed(prototype->clone(), all_guards);
+		state.items += result.steps;
+		do_not_optimize(result.term);
+	}
+}
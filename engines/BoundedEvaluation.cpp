@@ -0,0 +1,104 @@
+//
+// BoundedEvaluation.cpp
+//
+
+#include "BoundedEvaluation.h"
+#include "CycleDetector.h"
+#include "Diagnostics.h"
+#include "ReductionTrace.h"
+#include "../models/SharedTerm.h"
+#include "../models/Timeline.h"
+#include "../exceptions/Exceptions.h"
+
+#include <string>
+
+using std::unique_ptr;
+
+EvaluationResult evaluate(unique_ptr<Term> term, const ResourcePolicy& policy) {
+	TIMELINE_SPAN("evaluate");
+	EvaluationResult result{EvaluationStatus::Normal, nullptr};
+	const bool limits_size = policy.limits_size();
+	CycleDetector cycles;
+	if (policy.trace != nullptr) policy.trace->begin(*term);
+
+	// Every limit is checked before each step, so the returned term is
+	// always one that respected them; an oversized term is reported as soon
+	// as it appears.
+	for (;;) {
+		if (limits_size) {
+			const auto size = term->measure();
+			if (size.nodes > result.peak.nodes) result.peak.nodes = size.nodes;
+			if (size.bytes > result.peak.bytes) result.peak.bytes = size.bytes;
+			if (policy.max_nodes != 0 && size.nodes > policy.max_nodes) {
+				result.status = EvaluationStatus::Nodes;
+				break;
+			}
+			if (policy.max_bytes != 0 && size.bytes > policy.max_bytes) {
+				result.status = EvaluationStatus::Bytes;
+				break;
+			}
+		}
+		if (term->is_normal()) break;
+		if (policy.detect_cycles && cycles.observe(alpha_hash(*term))) {
+			result.status = EvaluationStatus::Cycle;
+			result.period = cycles.period();
+			break;
+		}
+		if (policy.max_steps != 0 && result.steps == policy.max_steps) {
+			result.status = EvaluationStatus::Steps;
+			break;
+		}
+		if (policy.cancellation != nullptr && policy.cancellation->cancelled()) {
+			result.status = EvaluationStatus::Cancelled;
+			break;
+		}
+		if (policy.deadline && std::chrono::steady_clock::now() >= *policy.deadline) {
+			result.status = EvaluationStatus::Deadline;
+			break;
+		}
+
+		{
+			TIMELINE_SPAN("step");
+			term = policy.trace != nullptr ? policy.trace->step(std::move(term)) : ::beta_reduce(std::move(term));
+		}
+		++result.steps;
+	}
+
+	result.term = std::move(term);
+	return result;
+}
+
+unique_ptr<Term> normalize_unguarded(unique_ptr<Term> term, std::size_t& steps) {
+	TIMELINE_SPAN("normalize");
+	if (term->is_normal()) return term;
+	return from_shared(*normalize(to_shared(*term), steps));
+}
+
+EvaluationResult evaluate_type_directed(unique_ptr<Term> term, const ResourcePolicy& policy, const TypingContext& context) {
+	if (!try_type_check(*term, context)) return evaluate(std::move(term), policy);
+
+	EvaluationResult result{EvaluationStatus::Normal, nullptr};
+	result.unguarded = true;
+	result.term = normalize_unguarded(std::move(term), result.steps);
+	return result;
+}
+
+std::string describe_exhaustion(const EvaluationResult& result, const ResourcePolicy& policy) {
+	switch (result.status) {
+		case EvaluationStatus::Normal:
+			return "normal form reached";
+		case EvaluationStatus::Steps:
+			return "step limit of " + std::to_string(policy.max_steps) + " exceeded";
+		case EvaluationStatus::Nodes:
+			return "node limit of " + std::to_string(policy.max_nodes) + " exceeded after " + std::to_string(result.steps) + " steps";
+		case EvaluationStatus::Bytes:
+			return "byte limit of " + std::to_string(policy.max_bytes) + " exceeded after " + std::to_string(result.steps) + " steps";
+		case EvaluationStatus::Deadline:
+			return "deadline passed after " + std::to_string(result.steps) + " steps";
+		case EvaluationStatus::Cancelled:
+			return "cancelled after " + std::to_string(result.steps) + " steps";
+		case EvaluationStatus::Cycle:
+			return "reduction cycles with period " + std::to_string(result.period) + " after " + std::to_string(result.steps) + " steps";
+	}
+	return "unknown evaluation status";
+}
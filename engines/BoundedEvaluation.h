@@ -0,0 +1,93 @@
+//
+// BoundedEvaluation.h
+//
+// Normal-order evaluation under a resource policy. Instead of running until a
+// normal form, which never comes for Ω, the evaluator stops at the first
+// exhausted limit and hands back the term reached so far.
+//
+
+#ifndef BOUNDEDEVALUATION_H
+#define BOUNDEDEVALUATION_H
+
+#include "../models/Terms.h"
+#include "../models/TypingContext.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+class TraceRecorder;
+
+// Cooperative cancellation flag, safe to set from any thread.
+class CancellationToken {
+public:
+	void cancel() { this->flag.store(true, std::memory_order_relaxed); }
+	[[nodiscard]] bool cancelled() const { return this->flag.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<bool> flag = false;
+};
+
+// Zero means unlimited for the numeric limits.
+struct ResourcePolicy {
+	std::size_t max_steps = 0;
+	std::size_t max_nodes = 0;
+	std::size_t max_bytes = 0;
+	std::optional<std::chrono::steady_clock::time_point> deadline;
+	const CancellationToken* cancellation = nullptr;
+	// Hash every state and stop when one repeats (see CycleDetector).
+	bool detect_cycles = false;
+	// Logs the initial term and every step taken (see ReductionTrace.h).
+	TraceRecorder* trace = nullptr;
+
+	[[nodiscard]] bool limits_size() const { return this->max_nodes != 0 || this->max_bytes != 0; }
+};
+
+enum class EvaluationStatus : std::uint8_t {
+	Normal,     // reached a normal form
+	Steps,      // max_steps reductions done, still not normal
+	Nodes,      // term grew past max_nodes
+	Bytes,      // term grew past max_bytes
+	Deadline,
+	Cancelled,
+	Cycle       // a state repeated, so the reduction never terminates
+};
+
+struct EvaluationResult {
+	EvaluationStatus status;
+	// The normal form, or the last term reached when a limit was hit.
+	std::unique_ptr<Term> term;
+	std::size_t steps = 0;
+	// Largest term seen; only tracked when the policy limits size.
+	TermSize peak;
+	// Length of the detected cycle when status is Cycle.
+	std::size_t period = 0;
+	// Set when the term type-checked and ran on the unguarded fast path.
+	bool unguarded = false;
+
+	[[nodiscard]] bool exhausted() const { return this->status != EvaluationStatus::Normal; }
+};
+
+[[nodiscard]] EvaluationResult evaluate(std::unique_ptr<Term> term, const ResourcePolicy& policy);
+
+// Normal-order reduction with no limits or bookkeeping at all. Only safe for
+// terms known to terminate, i.e. well-typed ones: simply-typed terms are
+// strongly normalizing, and δ-rules and definition unfolding preserve that.
+// Termination is all that is guaranteed. A typed term may still take
+// exponentially many steps, or grow exponentially large. Reduction runs on
+// SharedTerm nodes, so duplicated arguments are shared rather than copied
+// until the result is converted back.
+[[nodiscard]] std::unique_ptr<Term> normalize_unguarded(std::unique_ptr<Term> term, std::size_t& steps);
+
+// Type-checks `term` in `context` first. A well-typed term goes to
+// normalize_unguarded and anything else to evaluate() under `policy`, so the
+// guards are only paid for on untyped input.
+[[nodiscard]] EvaluationResult evaluate_type_directed(std::unique_ptr<Term> term, const ResourcePolicy& policy, const TypingContext& context = TypingContext());
+
+// "step limit of 100 exceeded" and the like, for reporting an exhausted result.
+[[nodiscard]] std::string describe_exhaustion(const EvaluationResult& result, const ResourcePolicy& policy);
+
+#endif //BOUNDEDEVALUATION_H
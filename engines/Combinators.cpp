@@ -0,0 +1,384 @@
+//
+// Combinators.cpp
+//
+
+#include "Combinators.h"
+
+#include "../models/terms/Variable.h"
+#include "../models/terms/Abstraction.h"
+#include "../models/terms/Application.h"
+#include "../models/terms/Let.h"
+#include "../models/terms/Reference.h"
+
+#include <stdexcept>
+
+using std::unique_ptr, std::make_unique;
+using Kind = CombinatorNode::Kind;
+
+std::size_t combinator_arity(Combinator combinator) {
+	switch (combinator) {
+		case Combinator::I: return 1;
+		case Combinator::K: return 2;
+		case Combinator::S:
+		case Combinator::B:
+		case Combinator::C: return 3;
+		case Combinator::SPrime:
+		case Combinator::BStar:
+		case Combinator::CPrime: return 4;
+	}
+	return 0;
+}
+
+const char* combinator_name(Combinator combinator) {
+	switch (combinator) {
+		case Combinator::S: return "S";
+		case Combinator::K: return "K";
+		case Combinator::I: return "I";
+		case Combinator::B: return "B";
+		case Combinator::C: return "C";
+		case Combinator::SPrime: return "S'";
+		case Combinator::BStar: return "B*";
+		case Combinator::CPrime: return "C'";
+	}
+	return "?";
+}
+
+CombinatorGraph::CombinatorGraph(const Term& term) {
+	this->root = this->compile(term);
+}
+
+std::uint32_t CombinatorGraph::add(CombinatorNode node) {
+	this->nodes.push_back(node);
+	return static_cast<std::uint32_t>(this->nodes.size() - 1);
+}
+
+std::uint32_t CombinatorGraph::combinator(Combinator combinator) {
+	return this->add({.kind = Kind::Combinator, .combinator = combinator});
+}
+
+std::uint32_t CombinatorGraph::intern(const std::string& name) {
+	auto it = this->name_ids.find(name);
+	if (it == this->name_ids.end()) {
+		it = this->name_ids.emplace(name, static_cast<std::uint32_t>(this->names.size())).first;
+		this->names.push_back(name);
+	}
+	return it->second;
+}
+
+std::uint32_t CombinatorGraph::variable(const std::string& name) {
+	return this->add({.kind = Kind::Variable, .name = this->intern(name)});
+}
+
+std::uint32_t CombinatorGraph::apply(std::uint32_t function, std::uint32_t value) {
+	return this->add({.kind = Kind::Application, .left = function, .right = value});
+}
+
+std::uint32_t CombinatorGraph::apply(Combinator combinator, std::uint32_t a, std::uint32_t b) {
+	return this->apply(this->apply(this->combinator(combinator), a), b);
+}
+
+std::uint32_t CombinatorGraph::compile(const Term& term) {
+	if (const auto* var = dynamic_cast<const Variable*>(&term)) {
+		return this->variable(var->name);
+	}
+	if (const auto* abs = dynamic_cast<const Abstraction*>(&term)) {
+		const auto body = this->compile(*abs->body);
+		return this->abstract(this->intern(abs->var_name), body);
+	}
+	if (const auto* app = dynamic_cast<const Application*>(&term)) {
+		const auto function = this->compile(*app->function);
+		return this->apply(function, this->compile(*app->value));
+	}
+	if (const auto* literal = dynamic_cast<const Literal*>(&term)) {
+		return this->add({.kind = Kind::Literal, .literal = {literal->kind, literal->value}});
+	}
+	if (const auto* prim = dynamic_cast<const Primitive*>(&term)) {
+		return this->add({.kind = Kind::Primitive, .op = prim->op});
+	}
+	if (const auto* let = dynamic_cast<const Let*>(&term)) {
+		const auto bound = this->compile(*let->bound);
+		const auto body = this->compile(*let->body);
+		return this->apply(this->abstract(this->intern(let->var_name), body), bound);
+	}
+	if (const auto* ref = dynamic_cast<const Reference*>(&term)) {
+		const auto* definition = ref->definition.get();
+		if (const auto it = this->compiled_definitions.find(definition); it != this->compiled_definitions.end()) return it->second;
+		// Closed, so every enclosing abstraction wraps it in K and the one
+		// compiled graph is shared by all references.
+		const auto compiled = this->compile(*definition->body);
+		this->compiled_definitions.emplace(definition, compiled);
+		return compiled;
+	}
+	throw std::invalid_argument("Combinator compilation: unsupported term '" + term.to_string() + "'");
+}
+
+bool CombinatorGraph::contains(std::uint32_t node, std::uint32_t name) const {
+	const auto& current = this->nodes[node];
+	switch (current.kind) {
+		case Kind::Variable:
+			return current.name == name;
+		case Kind::Application:
+			return this->contains(current.left, name) || this->contains(current.right, name);
+		default:
+			return false;
+	}
+}
+
+bool CombinatorGraph::is_applied(std::uint32_t node, Combinator combinator, std::uint32_t& argument) const {
+	const auto& current = this->nodes[node];
+	if (current.kind != Kind::Application) return false;
+	const auto& function = this->nodes[current.left];
+	if (function.kind != Kind::Combinator || function.combinator != combinator) return false;
+	argument = current.right;
+	return true;
+}
+
+// [x] body, eliminating every occurrence of variable `name`.
+std::uint32_t CombinatorGraph::abstract(std::uint32_t name, std::uint32_t body) {
+	if (!this->contains(body, name)) return this->apply(this->combinator(Combinator::K), body);
+	const auto current = this->nodes[body];
+	if (current.kind == Kind::Variable) return this->combinator(Combinator::I);
+
+	// current is an application mentioning `name`.
+	const auto value = this->nodes[current.right];
+	if (value.kind == Kind::Variable && value.name == name && !this->contains(current.left, name)) {
+		return current.left;    // [x] f x = f
+	}
+	const auto f = this->abstract(name, current.left);
+	const auto g = this->abstract(name, current.right);
+	return this->optimize_s(f, g);
+}
+
+// S f g, simplified with Turner's rules.
+std::uint32_t CombinatorGraph::optimize_s(std::uint32_t f, std::uint32_t g) {
+	std::uint32_t p, q, r;
+	if (this->is_applied(f, Combinator::K, p)) {
+		if (this->is_applied(g, Combinator::K, q)) {
+			return this->apply(this->combinator(Combinator::K), this->apply(p, q));    // S (K p) (K q) = K (p q)
+		}
+		const auto& g_node = this->nodes[g];
+		if (g_node.kind == Kind::Combinator && g_node.combinator == Combinator::I) return p;    // S (K p) I = p
+		if (g_node.kind == Kind::Application && this->is_applied(g_node.left, Combinator::B, q)) {
+			r = g_node.right;    // S (K p) (B q r) = B* p q r
+			return this->apply(this->apply(Combinator::BStar, p, q), r);
+		}
+		return this->apply(Combinator::B, p, g);    // S (K p) g = B p g
+	}
+
+	const auto& f_node = this->nodes[f];
+	const bool f_is_b = f_node.kind == Kind::Application && this->is_applied(f_node.left, Combinator::B, p);
+	if (f_is_b) q = f_node.right;
+
+	if (this->is_applied(g, Combinator::K, r)) {
+		if (f_is_b) return this->apply(this->apply(Combinator::CPrime, p, q), r);    // S (B p q) (K r) = C' p q r
+		return this->apply(Combinator::C, f, r);    // S f (K r) = C f r
+	}
+	if (f_is_b) return this->apply(this->apply(Combinator::SPrime, p, q), g);    // S (B p q) g = S' p q g
+	return this->apply(Combinator::S, f, g);
+}
+
+std::uint32_t CombinatorGraph::follow(std::uint32_t node) const {
+	while (this->nodes[node].kind == Kind::Indirection) node = this->nodes[node].left;
+	return node;
+}
+
+// Contracts the redex at the top of `spine` whose head is `head`; spine
+// holds the application nodes from the root down, the last one applying
+// the head to its first argument. Returns false if the head is stuck.
+bool CombinatorGraph::rewrite(std::uint32_t head, const std::vector<std::uint32_t>& spine) {
+	const auto& head_node = this->nodes[head];
+	const auto arg = [&](std::size_t i) { return this->nodes[spine[spine.size() - i]].right; };
+
+	if (head_node.kind == Kind::Combinator) {
+		const auto combinator = head_node.combinator;
+		const auto arity = combinator_arity(combinator);
+		if (spine.size() < arity) return false;
+		const auto redex = spine[spine.size() - arity];
+		CombinatorNode result{.kind = Kind::Application};
+		switch (combinator) {
+			case Combinator::I:
+			case Combinator::K:
+				result = {.kind = Kind::Indirection, .left = arg(1)};
+				break;
+			case Combinator::S: {
+				const auto f = arg(1), g = arg(2), x = arg(3);
+				const auto fx = this->apply(f, x);
+				result.left = fx;
+				result.right = this->apply(g, x);
+				break;
+			}
+			case Combinator::B: {
+				const auto f = arg(1), g = arg(2), x = arg(3);
+				result.left = f;
+				result.right = this->apply(g, x);
+				break;
+			}
+			case Combinator::C: {
+				const auto f = arg(1), g = arg(2), x = arg(3);
+				result.left = this->apply(f, x);
+				result.right = g;
+				break;
+			}
+			case Combinator::SPrime: {
+				const auto c = arg(1), f = arg(2), g = arg(3), x = arg(4);
+				const auto fx = this->apply(f, x);
+				result.left = this->apply(c, fx);
+				result.right = this->apply(g, x);
+				break;
+			}
+			case Combinator::BStar: {
+				const auto c = arg(1), f = arg(2), g = arg(3), x = arg(4);
+				const auto gx = this->apply(g, x);
+				result.left = c;
+				result.right = this->apply(f, gx);
+				break;
+			}
+			case Combinator::CPrime: {
+				const auto c = arg(1), f = arg(2), g = arg(3), x = arg(4);
+				const auto fx = this->apply(f, x);
+				result.left = this->apply(c, fx);
+				result.right = g;
+				break;
+			}
+		}
+		this->nodes[redex] = result;
+		++this->counters.rewrites;
+		return true;
+	}
+
+	if (head_node.kind == Kind::Primitive) {
+		const auto op = head_node.op;
+		const auto arity = primitive_arity(op);
+		if (spine.size() < arity) return false;
+		const auto redex = spine[spine.size() - arity];
+		std::vector<std::uint32_t> args;
+		for (std::size_t i = 1; i <= arity; ++i) args.push_back(arg(i));
+		for (std::size_t i = 0; i < arity; ++i) {
+			LiteralKind expected;
+			if (!primitive_strict_in(op, i, expected)) continue;
+			args[i] = this->whnf(args[i]);
+			const auto& value = this->nodes[args[i]];
+			if (value.kind != Kind::Literal || value.literal.kind != expected) return false;
+		}
+		if (op == PrimitiveOp::If) {
+			this->nodes[redex] = {.kind = Kind::Indirection, .left = this->nodes[args[0]].literal.value ? args[1] : args[2]};
+		} else {
+			const auto lhs = this->nodes[args[0]].literal.value;
+			const auto rhs = this->nodes[args[1]].literal.value;
+			this->nodes[redex] = {.kind = Kind::Literal, .literal = evaluate_primitive(op, lhs, rhs)};
+		}
+		++this->counters.delta_steps;
+		return true;
+	}
+	return false;
+}
+
+std::uint32_t CombinatorGraph::whnf(std::uint32_t node) {
+	std::vector<std::uint32_t> spine;
+	node = this->follow(node);
+	for (;;) {
+		// Unwind from `node`; the spine above it is still valid.
+		auto head = node;
+		while (this->nodes[head].kind == Kind::Application) {
+			spine.push_back(head);
+			head = this->follow(this->nodes[head].left);
+		}
+		const auto depth = spine.size();
+		if (!this->rewrite(head, spine)) return spine.empty() ? head : spine.front();
+
+		// Continue from the rewritten redex, or from the root if it was the
+		// root that changed.
+		const auto arity = this->nodes[head].kind == Kind::Combinator
+			? combinator_arity(this->nodes[head].combinator)
+			: primitive_arity(this->nodes[head].op);
+		const auto redex = spine[depth - arity];
+		spine.resize(depth - arity);
+		node = this->follow(redex);
+		if (!spine.empty()) {
+			// Keep the parent pointing past any indirection.
+			this->nodes[spine.back()].left = node;
+		}
+	}
+}
+
+void CombinatorGraph::normalize(std::uint32_t node) {
+	node = this->whnf(node);
+	while (this->nodes[node].kind == Kind::Application) {
+		this->normalize(this->nodes[node].right);
+		this->nodes[node].right = this->follow(this->nodes[node].right);
+		node = this->follow(this->nodes[node].left);
+	}
+}
+
+void CombinatorGraph::normalize() {
+	this->normalize(this->root);
+	this->root = this->follow(this->root);
+}
+
+void CombinatorGraph::weak_head_normalize() {
+	this->root = this->whnf(this->root);
+}
+
+unique_ptr<Term> CombinatorGraph::read_back(std::uint32_t node) const {
+	const auto& current = this->nodes[this->follow(node)];
+	switch (current.kind) {
+		case Kind::Combinator:
+			return make_unique<Variable>(combinator_name(current.combinator));
+		case Kind::Variable:
+			return make_unique<Variable>(this->names[current.name]);
+		case Kind::Literal:
+			return make_unique<Literal>(current.literal.kind, current.literal.value);
+		case Kind::Primitive:
+			return make_unique<Primitive>(current.op);
+		case Kind::Application:
+			return make_unique<Application>(this->read_back(current.left), this->read_back(current.right));
+		case Kind::Indirection:
+			break;
+	}
+	throw std::logic_error("Combinator read-back: unresolved indirection");
+}
+
+unique_ptr<Term> CombinatorGraph::read_back() const {
+	return this->read_back(this->root);
+}
+
+void CombinatorGraph::print(std::uint32_t node, bool argument, std::string& out) const {
+	const auto& current = this->nodes[this->follow(node)];
+	switch (current.kind) {
+		case Kind::Combinator:
+			out += combinator_name(current.combinator);
+			return;
+		case Kind::Variable:
+			out += this->names[current.name];
+			return;
+		case Kind::Literal:
+			out += Literal(current.literal.kind, current.literal.value).to_string();
+			return;
+		case Kind::Primitive:
+			out += primitive_name(current.op);
+			return;
+		case Kind::Application:
+			if (argument) out += '(';
+			this->print(current.left, false, out);
+			out += ' ';
+			this->print(current.right, true, out);
+			if (argument) out += ')';
+			return;
+		case Kind::Indirection:
+			return;
+	}
+}
+
+std::string CombinatorGraph::to_string() const {
+	std::string out;
+	this->print(this->root, false, out);
+	return out;
+}
+
+const CombinatorGraph::Stats& CombinatorGraph::stats() const {
+	return this->counters;
+}
+
+std::size_t CombinatorGraph::allocated_nodes() const {
+	return this->nodes.size();
+}
@@ -0,0 +1,107 @@
+//
+// Combinators.h
+//
+// Compiles terms to combinators with Turner's optimized bracket abstraction
+// and normalizes them by graph reduction. Once compiled there are no bound
+// variables left, so a reduction step is a local rewrite of one application
+// node: no substitution and no capture checks. Arguments are shared rather
+// than copied, so each one is reduced at most once.
+//
+
+#ifndef COMBINATORS_H
+#define COMBINATORS_H
+
+#include "../models/Terms.h"
+#include "../models/terms/Literal.h"
+#include "../models/terms/Primitive.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Definition;
+
+//   S f g x = f x (g x)       S' c f g x = c (f x) (g x)
+//   K x y   = x               B* c f g x = c (f (g x))
+//   I x     = x               C' c f g x = c (f x) g
+//   B f g x = f (g x)
+//   C f g x = f x g
+enum class Combinator : std::uint8_t { S, K, I, B, C, SPrime, BStar, CPrime };
+
+[[nodiscard]] std::size_t combinator_arity(Combinator combinator);
+[[nodiscard]] const char* combinator_name(Combinator combinator);
+
+struct CombinatorNode {
+	enum class Kind : std::uint8_t { Combinator, Variable, Literal, Primitive, Application, Indirection };
+
+	Kind kind;
+	Combinator combinator{};
+	PrimitiveOp op{};
+	LiteralValue literal{};
+	// Variable: index into the graph's name table.
+	std::uint32_t name = 0;
+	// Application function, or the target of an Indirection.
+	std::uint32_t left = 0;
+	// Application argument.
+	std::uint32_t right = 0;
+};
+
+class CombinatorGraph {
+public:
+	struct Stats {
+		std::size_t rewrites = 0;
+		std::size_t delta_steps = 0;
+	};
+
+	// Free variables stay as opaque constants, definitions are compiled once
+	// and shared, and let is compiled as (λx. body) bound. Type annotations
+	// are dropped.
+	explicit CombinatorGraph(const Term& term);
+
+	// Rewrites the graph in place to normal form. Diverges on terms without
+	// one.
+	void normalize();
+	// Rewrites only until the root is no longer a redex.
+	void weak_head_normalize();
+
+	// Combinators read back as variables named after them, e.g. (S) (K).
+	[[nodiscard]] std::unique_ptr<Term> read_back() const;
+	// Combinator notation with minimal parentheses: S (K f) I.
+	[[nodiscard]] std::string to_string() const;
+
+	[[nodiscard]] const Stats& stats() const;
+	[[nodiscard]] std::size_t allocated_nodes() const;
+
+private:
+	std::vector<CombinatorNode> nodes;
+	std::vector<std::string> names;
+	std::map<std::string, std::uint32_t, std::less<>> name_ids;
+	std::map<const Definition*, std::uint32_t> compiled_definitions;
+	std::uint32_t root;
+	Stats counters;
+
+	std::uint32_t add(CombinatorNode node);
+	std::uint32_t combinator(Combinator combinator);
+	std::uint32_t intern(const std::string& name);
+	std::uint32_t variable(const std::string& name);
+	std::uint32_t apply(std::uint32_t function, std::uint32_t value);
+	std::uint32_t apply(Combinator combinator, std::uint32_t a, std::uint32_t b);
+
+	std::uint32_t compile(const Term& term);
+	[[nodiscard]] bool contains(std::uint32_t node, std::uint32_t name) const;
+	[[nodiscard]] bool is_applied(std::uint32_t node, Combinator combinator, std::uint32_t& argument) const;
+	std::uint32_t abstract(std::uint32_t name, std::uint32_t body);
+	std::uint32_t optimize_s(std::uint32_t f, std::uint32_t g);
+
+	[[nodiscard]] std::uint32_t follow(std::uint32_t node) const;
+	std::uint32_t whnf(std::uint32_t node);
+	bool rewrite(std::uint32_t head, const std::vector<std::uint32_t>& spine);
+	void normalize(std::uint32_t node);
+	[[nodiscard]] std::unique_ptr<Term> read_back(std::uint32_t node) const;
+	void print(std::uint32_t node, bool argument, std::string& out) const;
+};
+
+#endif //COMBINATORS_H
@@ -0,0 +1,164 @@
+//
+// Conversion.cpp
+//
+
+#include "Conversion.h"
+#include "../models/Timeline.h"
+
+#include <vector>
+
+using std::make_shared;
+
+namespace {
+
+// Structural equality of two freshly lowered terms. De Bruijn indices make
+// this α-equivalence; lowering leaves no closures behind.
+bool same_term(const ESNode& lhs, const ESNode& rhs) {
+	if (&lhs == &rhs) return true;
+	if (lhs.kind != rhs.kind) return false;
+	switch (lhs.kind) {
+		case ESNode::Kind::Index:
+			return lhs.index == rhs.index;
+		case ESNode::Kind::Free:
+			return lhs.name == rhs.name;
+		case ESNode::Kind::Literal:
+			return lhs.literal.kind == rhs.literal.kind && lhs.literal.value == rhs.literal.value;
+		case ESNode::Kind::Primitive:
+			return lhs.op == rhs.op;
+		case ESNode::Kind::Abstraction:
+			return same_term(*lhs.left, *rhs.left);
+		case ESNode::Kind::Application:
+		case ESNode::Kind::Pair:
+			return same_term(*lhs.left, *rhs.left) && same_term(*lhs.right, *rhs.right);
+		case ESNode::Kind::Projection:
+		case ESNode::Kind::Injection:
+			return lhs.index == rhs.index && same_term(*lhs.left, *rhs.left);
+		case ESNode::Kind::Case:
+			return same_term(*lhs.left, *rhs.left) && same_term(*lhs.right, *rhs.right) && same_term(*lhs.third, *rhs.third);
+		case ESNode::Kind::Closure:
+			break;
+	}
+	return false;
+}
+
+class Converter {
+public:
+	Converter(ExplicitSubstitutionEngine& engine, ConversionStats& stats):
+		engine(engine),
+		stats(stats)
+	{}
+
+	bool equal(ESRef lhs, ESRef rhs) {
+		++this->stats.comparisons;
+		// Closures over the same node are caught before anything is reduced.
+		lhs = this->engine.expose(std::move(lhs));
+		rhs = this->engine.expose(std::move(rhs));
+		if (lhs == rhs) {
+			++this->stats.shared;
+			return true;
+		}
+		lhs = this->engine.whnf(std::move(lhs));
+		rhs = this->engine.whnf(std::move(rhs));
+		if (lhs == rhs) {
+			++this->stats.shared;
+			return true;
+		}
+		const bool lhs_abstraction = lhs->kind == ESNode::Kind::Abstraction;
+		const bool rhs_abstraction = rhs->kind == ESNode::Kind::Abstraction;
+		if (lhs_abstraction && rhs_abstraction) return this->equal(lhs->left, rhs->left);
+		if (lhs_abstraction) return this->equal(lhs->left, eta_body(*lhs, rhs));
+		if (rhs_abstraction) return this->equal(eta_body(*rhs, lhs), rhs->left);
+		return this->equal_heads(*lhs, *rhs);
+	}
+
+private:
+	ExplicitSubstitutionEngine& engine;
+	ConversionStats& stats;
+
+	// Body of the η-expansion of `term` under the binder of `like`:
+	// (term ↑1) 0.
+	ESRef eta_body(const ESNode& like, const ESRef& term) {
+		++this->stats.eta_expansions;
+		auto shifted = make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Closure,
+			.left = term,
+			.subst = make_shared<const ESSubst>(ESSubst{ .kind = ESSubst::Kind::Shift, .shift = 1 })
+		});
+		auto bound = make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Index, .index = 0, .name = like.name, .var_type = like.var_type
+		});
+		return make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Application, .left = std::move(shifted), .right = std::move(bound)
+		});
+	}
+
+	// Both sides are weak-head normal and neither is an abstraction.
+	bool equal_heads(const ESNode& lhs, const ESNode& rhs) {
+		if (lhs.kind != rhs.kind) return false;
+		switch (lhs.kind) {
+			case ESNode::Kind::Index:
+				return lhs.index == rhs.index;
+			case ESNode::Kind::Free:
+				return lhs.name == rhs.name;
+			case ESNode::Kind::Literal:
+				return lhs.literal.kind == rhs.literal.kind && lhs.literal.value == rhs.literal.value;
+			case ESNode::Kind::Primitive:
+				return lhs.op == rhs.op;
+			case ESNode::Kind::Application:
+				return this->equal_spines(lhs, rhs);
+			case ESNode::Kind::Pair:
+				return this->equal(lhs.left, rhs.left) && this->equal(lhs.right, rhs.right);
+			case ESNode::Kind::Projection:
+			case ESNode::Kind::Injection:
+				return lhs.index == rhs.index && this->equal(lhs.left, rhs.left);
+			case ESNode::Kind::Case:
+				return this->equal(lhs.left, rhs.left) && this->equal(lhs.right, rhs.right) && this->equal(lhs.third, rhs.third);
+			case ESNode::Kind::Abstraction:
+			case ESNode::Kind::Closure:
+				break;
+		}
+		return false;
+	}
+
+	// Stuck applications h a1 ... an. whnf already reduced every function
+	// along the spine, so the heads are compared as they are, and the
+	// arguments, still unreduced, only once the heads and arities agree.
+	bool equal_spines(const ESNode& lhs, const ESNode& rhs) {
+		std::vector<const ESNode*> lhs_spine, rhs_spine;
+		const ESNode* lhs_head = &lhs;
+		const ESNode* rhs_head = &rhs;
+		for (; lhs_head->kind == ESNode::Kind::Application; lhs_head = lhs_head->left.get()) lhs_spine.push_back(lhs_head);
+		for (; rhs_head->kind == ESNode::Kind::Application; rhs_head = rhs_head->left.get()) rhs_spine.push_back(rhs_head);
+		if (lhs_spine.size() != rhs_spine.size() || !this->equal_heads(*lhs_head, *rhs_head)) return false;
+		for (std::size_t i = lhs_spine.size(); i-- > 0;) {
+			if (!this->equal(lhs_spine[i]->right, rhs_spine[i]->right)) return false;
+		}
+		return true;
+	}
+};
+
+}
+
+bool convertible(const Term& lhs, const Term& rhs, ConversionStats& stats) {
+	TIMELINE_SPAN("convertible");
+	ExplicitSubstitutionEngine engine;
+	const auto lhs_node = engine.load(lhs);
+	const auto rhs_node = engine.load(rhs);
+	// Equal hashes are only a hint; the structural walk settles it.
+	if (alpha_hash(lhs) == alpha_hash(rhs) && same_term(*lhs_node, *rhs_node)) {
+		stats.syntactic = true;
+		return true;
+	}
+	Converter converter(engine, stats);
+	const bool result = converter.equal(lhs_node, rhs_node);
+	const auto& reduction = engine.stats();
+	stats.reduction.beta_steps += reduction.beta_steps;
+	stats.reduction.delta_steps += reduction.delta_steps;
+	stats.reduction.substitution_steps += reduction.substitution_steps;
+	return result;
+}
+
+bool convertible(const Term& lhs, const Term& rhs) {
+	ConversionStats stats;
+	return convertible(lhs, rhs, stats);
+}
@@ -0,0 +1,39 @@
+//
+// Conversion.h
+//
+// βη-conversion without normalizing either side. Both terms are lowered
+// into one explicit-substitution engine and compared from the top: each
+// pair of subterms is reduced only to weak-head form, heads are compared
+// before arguments, and the first mismatch ends the check. Identical nodes,
+// such as two uses of one definition, are never looked into.
+//
+// Like the engine's normalize(), a check may diverge when a subterm it has
+// to inspect has no weak-head form. Annotations are not compared: binder
+// and injection types only matter to the type checker.
+//
+
+#ifndef CONVERSION_H
+#define CONVERSION_H
+
+#include "ExplicitSubstitution.h"
+#include "../models/Terms.h"
+
+#include <cstddef>
+
+struct ConversionStats {
+	// Pairs of subterms compared, and those settled by node identity.
+	std::size_t comparisons = 0;
+	std::size_t shared = 0;
+	// Abstractions compared against a non-abstraction through λx. t x.
+	std::size_t eta_expansions = 0;
+	// Both sides were α-equivalent as written, so nothing was reduced.
+	bool syntactic = false;
+	ExplicitSubstitutionEngine::Stats reduction;
+};
+
+// True when `lhs` and `rhs` are βη-convertible, with δ, projection and case
+// contractions included.
+[[nodiscard]] bool convertible(const Term& lhs, const Term& rhs, ConversionStats& stats);
+[[nodiscard]] bool convertible(const Term& lhs, const Term& rhs);
+
+#endif //CONVERSION_H
@@ -0,0 +1,50 @@
+//
+// CycleDetector.h
+//
+// Brent's cycle detection over the alpha-invariant hashes of successive
+// reduction states. It keeps one saved hash, whatever the run length. The
+// saved state moves at power-of-two intervals, so a cycle of period λ
+// entered after μ steps is reported within about 2(μ + λ) steps; the λ = 1
+// cycle of Ω is reported on the first repeat.
+//
+// Only hashes are compared, so two distinct states that collide in 64 bits
+// would be reported as a cycle. The hash is well mixed, so this is
+// negligible next to the step limits the detector sits beside.
+//
+
+#ifndef CYCLEDETECTOR_H
+#define CYCLEDETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+class CycleDetector {
+public:
+	// Feeds the next state; returns true once a state has repeated.
+	bool observe(std::uint64_t state) {
+		if (!this->started) {
+			this->started = true;
+			this->saved = state;
+			return false;
+		}
+		++this->length;
+		if (state == this->saved) return true;
+		if (this->length == this->power) {
+			this->saved = state;
+			this->power *= 2;
+			this->length = 0;
+		}
+		return false;
+	}
+
+	// Period of the detected cycle; meaningful once observe returned true.
+	[[nodiscard]] std::size_t period() const { return this->length; }
+
+private:
+	std::uint64_t saved = 0;
+	std::size_t power = 1;
+	std::size_t length = 0;
+	bool started = false;
+};
+
+#endif //CYCLEDETECTOR_H
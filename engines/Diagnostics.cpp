@@ -0,0 +1,251 @@
+//
+// Diagnostics.cpp
+//
+
+#include "Diagnostics.h"
+#include "ReductionTrace.h"
+
+#include "../models/lambda.h"
+#include "../models/Timeline.h"
+
+#include <map>
+#include <optional>
+
+using std::unique_ptr; using std::make_unique;
+
+namespace {
+
+// Mirrors the type_check overrides. A null type marks a subterm that already
+// failed, so its parents stay quiet about it.
+class Checker {
+public:
+	Checker(const TypingContext& context, std::vector<TypeError>* errors):
+		context(context),
+		errors(errors)
+	{}
+
+	std::optional<TypeError> first;
+
+	unique_ptr<Type> check(const Term& term) {
+		if (this->stopped) return nullptr;
+		if (const auto* variable = dynamic_cast<const Variable*>(&term)) return this->check_variable(*variable);
+		if (const auto* abstraction = dynamic_cast<const Abstraction*>(&term)) {
+			this->scope.emplace_back(abstraction->var_name, abstraction->var_type.get());
+			auto body = this->check(*abstraction->body);
+			this->scope.pop_back();
+			if (!body) return nullptr;
+			return make_unique<FunctionType>(abstraction->var_type->clone(), std::move(body));
+		}
+		if (const auto* application = dynamic_cast<const Application*>(&term)) return this->check_application(*application);
+		if (const auto* let = dynamic_cast<const Let*>(&term)) {
+			const auto bound = this->check(*let->bound);
+			this->scope.emplace_back(let->var_name, bound.get());
+			auto body = this->check(*let->body);
+			this->scope.pop_back();
+			return body;
+		}
+		if (const auto* primitive = dynamic_cast<const Primitive*>(&term)) {
+			if (primitive->op == PrimitiveOp::If && primitive->branch_type == nullptr) {
+				this->fail(TypeError{ErrorCode::UntypedIf, &term});
+				return nullptr;
+			}
+			return primitive_type(primitive->op, primitive->branch_type.get());
+		}
+		if (const auto* reference = dynamic_cast<const Reference*>(&term)) return this->check_definition(*reference->definition);
+		if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+			auto first = this->check(*pair->first);
+			auto second = this->check(*pair->second);
+			if (!first || !second) return nullptr;
+			return make_unique<ProductType>(std::move(first), std::move(second));
+		}
+		if (const auto* projection = dynamic_cast<const Projection*>(&term)) return this->check_projection(*projection);
+		if (const auto* injection = dynamic_cast<const Injection*>(&term)) return this->check_injection(*injection);
+		if (const auto* match = dynamic_cast<const Case*>(&term)) return this->check_case(*match);
+		return term.type_check(this->context);
+	}
+
+private:
+	const TypingContext& context;
+	std::vector<TypeError>* errors;
+	bool stopped = false;
+	// Innermost binder last. A null type is a let whose bound term failed.
+	std::vector<std::pair<std::string_view, const Type*>> scope;
+	std::map<const Definition*, unique_ptr<Type>> definitions;
+
+	void fail(TypeError error) {
+		if (this->errors != nullptr) {
+			this->errors->push_back(std::move(error));
+		} else if (!this->stopped) {
+			// A mismatch still yields the codomain, so later errors may
+			// follow; only the first counts.
+			this->first = std::move(error);
+			this->stopped = true;
+		}
+	}
+
+	unique_ptr<Type> check_variable(const Variable& variable) {
+		for (auto it = this->scope.rbegin(); it != this->scope.rend(); ++it) {
+			if (it->first == variable.name) return it->second ? it->second->clone() : nullptr;
+		}
+		if (const auto* type = this->context.lookup(variable.name)) return type->clone();
+		this->fail(TypeError{ErrorCode::UndeclaredVariable, &variable, variable.name});
+		return nullptr;
+	}
+
+	unique_ptr<Type> check_application(const Application& application) {
+		auto function = this->check(*application.function);
+		const auto* function_type = dynamic_cast<const FunctionType*>(function.get());
+		if (function && !function_type) {
+			this->fail(TypeError{ErrorCode::NotAFunction, &application, {}, nullptr, std::move(function)});
+			(void)this->check(*application.value);
+			return nullptr;
+		}
+		const auto value = this->check(*application.value);
+		if (!function_type) return nullptr;
+		if (value && value->to_string() != function_type->domain->to_string()) {
+			this->fail(TypeError{ErrorCode::DomainMismatch, &application, {}, function_type->domain->clone(), value->clone()});
+		}
+		return function_type->codomain->clone();
+	}
+
+	unique_ptr<Type> check_projection(const Projection& projection) {
+		auto operand = this->check(*projection.operand);
+		if (!operand) return nullptr;
+		const auto* product = dynamic_cast<const ProductType*>(operand.get());
+		if (!product) {
+			this->fail(TypeError{ErrorCode::NotAProduct, &projection, {}, nullptr, std::move(operand)});
+			return nullptr;
+		}
+		return projection.component == Component::First ? product->first->clone() : product->second->clone();
+	}
+
+	unique_ptr<Type> check_injection(const Injection& injection) {
+		const auto* sum = dynamic_cast<const SumType*>(injection.sum_type.get());
+		if (!sum) {
+			this->fail(TypeError{ErrorCode::NotASum, &injection, {}, nullptr, injection.sum_type->clone()});
+			(void)this->check(*injection.value);
+			return nullptr;
+		}
+		const auto value = this->check(*injection.value);
+		const auto& expected = injection.side == Side::Left ? *sum->left : *sum->right;
+		if (value && value->to_string() != expected.to_string()) {
+			this->fail(TypeError{ErrorCode::DomainMismatch, &injection, {}, expected.clone(), value->clone()});
+		}
+		return sum->clone();
+	}
+
+	unique_ptr<Type> check_case(const Case& match) {
+		auto scrutinee = this->check(*match.scrutinee);
+		const auto* sum = dynamic_cast<const SumType*>(scrutinee.get());
+		if (scrutinee && !sum) this->fail(TypeError{ErrorCode::NotASum, &match, {}, nullptr, std::move(scrutinee)});
+		auto left = this->check_branch(*match.on_left, sum ? sum->left.get() : nullptr);
+		auto right = this->check_branch(*match.on_right, sum ? sum->right.get() : nullptr);
+		if (!sum || !left || !right) return nullptr;
+		if (left->to_string() != right->to_string()) {
+			this->fail(TypeError{ErrorCode::BranchMismatch, &match, {}, std::move(left), std::move(right)});
+			return nullptr;
+		}
+		return left;
+	}
+
+	// A case branch is a function taking `domain`, or anything when the
+	// scrutinee already failed; yields its codomain.
+	unique_ptr<Type> check_branch(const Term& branch, const Type* domain) {
+		auto type = this->check(branch);
+		if (!type) return nullptr;
+		const auto* function = dynamic_cast<const FunctionType*>(type.get());
+		if (!function) {
+			this->fail(TypeError{ErrorCode::NotAFunction, &branch, {}, nullptr, std::move(type)});
+			return nullptr;
+		}
+		if (domain && function->domain->to_string() != domain->to_string()) {
+			this->fail(TypeError{ErrorCode::DomainMismatch, &branch, {}, function->domain->clone(), domain->clone()});
+		}
+		return function->codomain->clone();
+	}
+
+	// Definitions are closed, so each one is checked once, in the empty
+	// context.
+	unique_ptr<Type> check_definition(const Definition& definition) {
+		auto it = this->definitions.find(&definition);
+		if (it == this->definitions.end()) {
+			const TypingContext empty;
+			Checker body_checker(empty, this->errors);
+			auto type = body_checker.check(*definition.body);
+			if (body_checker.first) this->fail(std::move(*body_checker.first));
+			it = this->definitions.emplace(&definition, std::move(type)).first;
+		}
+		return it->second ? it->second->clone() : nullptr;
+	}
+};
+
+}
+
+const char* error_code_name(ErrorCode code) {
+	switch (code) {
+		case ErrorCode::UndeclaredVariable: return "undeclared-variable";
+		case ErrorCode::NotAFunction: return "not-a-function";
+		case ErrorCode::DomainMismatch: return "domain-mismatch";
+		case ErrorCode::UntypedIf: return "untyped-if";
+		case ErrorCode::NotAProduct: return "not-a-product";
+		case ErrorCode::NotASum: return "not-a-sum";
+		case ErrorCode::BranchMismatch: return "branch-mismatch";
+		case ErrorCode::NormalForm: return "normal-form";
+	}
+	return "?";
+}
+
+std::string TypeError::message() const {
+	switch (this->code) {
+		case ErrorCode::UndeclaredVariable:
+			return "Undeclared variable: '" + std::string(this->name) + "'";
+		case ErrorCode::NotAFunction:
+			return "Type error: '" + this->actual->to_string() + "' is not a function.";
+		case ErrorCode::DomainMismatch:
+			return "Type mismatch: expecting domain '" + this->expected->to_string() + "', got '" + this->actual->to_string() + "'";
+		case ErrorCode::UntypedIf:
+			return "Type error: 'if' has no branch type";
+		case ErrorCode::NotAProduct:
+			return "Type error: '" + this->actual->to_string() + "' is not a product.";
+		case ErrorCode::NotASum:
+			return "Type error: '" + this->actual->to_string() + "' is not a sum.";
+		case ErrorCode::BranchMismatch:
+			return "Type mismatch: case branches return '" + this->expected->to_string() + "' and '" + this->actual->to_string() + "'";
+		case ErrorCode::NormalForm:
+			break;
+	}
+	return error_code_name(this->code);
+}
+
+std::string StepError::message() const {
+	return "Reduction on normal form: " + this->term->to_string();
+}
+
+std::expected<unique_ptr<Type>, TypeError> try_type_check(const Term& term, const TypingContext& context) {
+	TIMELINE_SPAN("type_check");
+	Checker checker(context, nullptr);
+	auto type = checker.check(term);
+	if (checker.first) return std::unexpected(std::move(*checker.first));
+	return type;
+}
+
+std::vector<TypeError> collect_type_errors(const Term& term, const TypingContext& context) {
+	std::vector<TypeError> errors;
+	Checker checker(context, &errors);
+	(void)checker.check(term);
+	return errors;
+}
+
+std::expected<unique_ptr<Term>, StepError> try_beta_reduce(unique_ptr<Term> term) {
+	std::vector<bool> path;
+	auto& slot = find_redex(term, path);
+	const Term* redex = slot.get();
+	const auto* projection = dynamic_cast<const Projection*>(redex);
+	const auto* match = dynamic_cast<const Case*>(redex);
+	if (dynamic_cast<const Application*>(redex) == nullptr && dynamic_cast<const Let*>(redex) == nullptr
+		&& dynamic_cast<const Reference*>(redex) == nullptr && !(projection && projection->is_redex()) && !(match && match->is_redex())) {
+		return std::unexpected(StepError{ErrorCode::NormalForm, std::move(term)});
+	}
+	slot = ::beta_reduce(std::move(slot));
+	return term;
+}
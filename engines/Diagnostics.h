@@ -0,0 +1,74 @@
+//
+// Diagnostics.h
+//
+// Exception-free entry points for type checking and reduction. Failures come
+// back as std::unexpected holding a small error code and its operands. The
+// message text is only built when message() is called, so rejecting an
+// ill-typed term costs neither unwinding nor string formatting.
+//
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include "../models/Terms.h"
+#include "../models/Type.h"
+#include "../models/TypingContext.h"
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class ErrorCode : std::uint8_t {
+	UndeclaredVariable,  // a free variable missing from the context
+	NotAFunction,        // applied a term whose type is not a function type
+	DomainMismatch,      // argument type differs from the function's domain
+	UntypedIf,           // an `if` without a branch type
+	NotAProduct,         // projected from a term whose type is not a product
+	NotASum,             // a case on, or an injection into, a non-sum type
+	BranchMismatch,      // case branches returning different types
+	NormalForm           // asked to reduce a term that is already normal
+};
+
+[[nodiscard]] const char* error_code_name(ErrorCode code);
+
+struct TypeError {
+	ErrorCode code;
+	// The offending variable, application, primitive, projection,
+	// injection, case or case branch, borrowed from the checked term.
+	const Term* term = nullptr;
+	// Variable name for UndeclaredVariable; points into `term`.
+	std::string_view name;
+	// The domain for DomainMismatch, the left branch type for BranchMismatch.
+	std::unique_ptr<Type> expected;
+	// The applied type for NotAFunction, the argument type for DomainMismatch,
+	// the offending type for NotAProduct and NotASum, the right branch type
+	// for BranchMismatch.
+	std::unique_ptr<Type> actual;
+
+	[[nodiscard]] std::string message() const;
+};
+
+struct StepError {
+	ErrorCode code;
+	// The input, handed back unchanged.
+	std::unique_ptr<Term> term;
+
+	[[nodiscard]] std::string message() const;
+};
+
+// Same result as Term::type_check, which throws instead.
+[[nodiscard]] std::expected<std::unique_ptr<Type>, TypeError> try_type_check(const Term& term, const TypingContext& context = TypingContext());
+
+// Every type error in the term, found in one pass and in source order.
+// Checking continues past an error; a subterm whose type could not be
+// determined does not produce follow-up errors.
+[[nodiscard]] std::vector<TypeError> collect_type_errors(const Term& term, const TypingContext& context = TypingContext());
+
+// One normal-order step, like ::beta_reduce, but a normal form is reported
+// with ErrorCode::NormalForm and returned rather than thrown.
+[[nodiscard]] std::expected<std::unique_ptr<Term>, StepError> try_beta_reduce(std::unique_ptr<Term> term);
+
+#endif //DIAGNOSTICS_H
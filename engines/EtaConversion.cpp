@@ -0,0 +1,134 @@
+//
+// EtaConversion.cpp
+//
+
+#include "EtaConversion.h"
+
+#include "../models/terms/Variable.h"
+#include "../models/terms/Abstraction.h"
+#include "../models/terms/Application.h"
+#include "../models/terms/Let.h"
+#include "../models/terms/Pair.h"
+#include "../models/terms/Projection.h"
+#include "../models/terms/Injection.h"
+#include "../models/terms/Case.h"
+#include "../models/Timeline.h"
+#include "../exceptions/Exceptions.h"
+
+#include <vector>
+
+using std::unique_ptr, std::make_unique;
+
+namespace {
+
+unique_ptr<Term> reduce_everywhere(unique_ptr<Term> term, EtaStats& stats) {
+	if (auto* abs = dynamic_cast<Abstraction*>(term.get())) {
+		abs->body = reduce_everywhere(std::move(abs->body), stats);
+		if (!is_eta_redex(*abs)) return term;
+		++stats.reductions;
+		return std::move(static_cast<Application&>(*abs->body).function);
+	}
+	if (auto* app = dynamic_cast<Application*>(term.get())) {
+		app->function = reduce_everywhere(std::move(app->function), stats);
+		app->value = reduce_everywhere(std::move(app->value), stats);
+		return term;
+	}
+	if (auto* let = dynamic_cast<Let*>(term.get())) {
+		let->bound = reduce_everywhere(std::move(let->bound), stats);
+		let->body = reduce_everywhere(std::move(let->body), stats);
+		return term;
+	}
+	if (auto* pair = dynamic_cast<Pair*>(term.get())) {
+		pair->first = reduce_everywhere(std::move(pair->first), stats);
+		pair->second = reduce_everywhere(std::move(pair->second), stats);
+		return term;
+	}
+	if (auto* projection = dynamic_cast<Projection*>(term.get())) {
+		projection->operand = reduce_everywhere(std::move(projection->operand), stats);
+		return term;
+	}
+	if (auto* injection = dynamic_cast<Injection*>(term.get())) {
+		injection->value = reduce_everywhere(std::move(injection->value), stats);
+		return term;
+	}
+	if (auto* match = dynamic_cast<Case*>(term.get())) {
+		match->scrutinee = reduce_everywhere(std::move(match->scrutinee), stats);
+		match->on_left = reduce_everywhere(std::move(match->on_left), stats);
+		match->on_right = reduce_everywhere(std::move(match->on_right), stats);
+		return term;
+	}
+	return term;
+}
+
+unique_ptr<Term> expand(unique_ptr<Term> term, const Type& type, const TypingContext& context, EtaStats& stats) {
+	const auto* function_type = dynamic_cast<const FunctionType*>(&type);
+
+	if (auto* abs = dynamic_cast<Abstraction*>(term.get())) {
+		if (function_type == nullptr) throw NotAFunctionError(type.to_string());
+		auto inner = context;
+		inner.add(abs->var_name, abs->var_type.get());
+		abs->body = expand(std::move(abs->body), *function_type->codomain, inner, stats);
+		return term;
+	}
+
+	// A neutral term h a1 ... an: expand each argument at its domain type.
+	std::vector<Application*> spine;
+	Term* head = term.get();
+	while (auto* app = dynamic_cast<Application*>(head)) {
+		spine.push_back(app);
+		head = app->function.get();
+	}
+	if (!spine.empty()) {
+		auto head_type = head->type_check(context);
+		for (auto it = spine.rbegin(); it != spine.rend(); ++it) {
+			const auto* head_function = dynamic_cast<const FunctionType*>(head_type.get());
+			if (head_function == nullptr) throw NotAFunctionError(head_type->to_string());
+			(*it)->value = expand(std::move((*it)->value), *head_function->domain, context, stats);
+			head_type = head_function->codomain->clone();
+		}
+	}
+	if (function_type == nullptr) return term;
+
+	// t : A -> B becomes λx:A. t x; expanding the new application as a
+	// neutral term also expands x at A.
+	std::string fresh_name = "x";
+	while (term->has_free(fresh_name) || context.lookup(fresh_name) != nullptr) fresh_name += "'";
+	auto inner = context;
+	inner.add(fresh_name, function_type->domain.get());
+	auto argument = make_unique<Variable>(fresh_name, function_type->domain->clone());
+	auto body = expand(make_unique<Application>(std::move(term), std::move(argument)), *function_type->codomain, inner, stats);
+	++stats.expansions;
+	return make_unique<Abstraction>(function_type->domain->clone(), fresh_name, std::move(body));
+}
+
+}
+
+bool is_eta_redex(const Term& term) {
+	const auto* abs = dynamic_cast<const Abstraction*>(&term);
+	if (abs == nullptr) return false;
+	const auto* app = dynamic_cast<const Application*>(abs->body.get());
+	if (app == nullptr) return false;
+	const auto* argument = dynamic_cast<const Variable*>(app->value.get());
+	return argument != nullptr && argument->name == abs->var_name && !app->function->has_free(abs->var_name);
+}
+
+unique_ptr<Term> eta_reduce(unique_ptr<Term> term, EtaStats& stats) {
+	TIMELINE_SPAN("eta_reduce");
+	stats.nodes_before += term->measure().nodes;
+	term = reduce_everywhere(std::move(term), stats);
+	stats.nodes_after += term->measure().nodes;
+	return term;
+}
+
+unique_ptr<Term> eta_expand(unique_ptr<Term> term, const Type& type, const TypingContext& context, EtaStats& stats) {
+	stats.nodes_before += term->measure().nodes;
+	term = expand(std::move(term), type, context, stats);
+	stats.nodes_after += term->measure().nodes;
+	return term;
+}
+
+EvaluationResult beta_eta_normalize(unique_ptr<Term> term, const ResourcePolicy& policy, EtaStats& stats) {
+	auto result = evaluate(std::move(term), policy);
+	if (!result.exhausted()) result.term = eta_reduce(std::move(result.term), stats);
+	return result;
+}
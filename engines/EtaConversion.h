@@ -0,0 +1,51 @@
+//
+// EtaConversion.h
+//
+// The η rule, λx. f x = f when x is not free in f, in both directions:
+// contraction everywhere in a term, type-directed expansion to η-long form,
+// and βη-normalization on top of the bounded evaluator.
+//
+
+#ifndef ETACONVERSION_H
+#define ETACONVERSION_H
+
+#include "BoundedEvaluation.h"
+#include "../models/Terms.h"
+#include "../models/Type.h"
+#include "../models/TypingContext.h"
+
+#include <cstddef>
+#include <memory>
+
+struct EtaStats {
+	std::size_t reductions = 0;
+	std::size_t expansions = 0;
+	// Term size before and after the η pass.
+	std::size_t nodes_before = 0;
+	std::size_t nodes_after = 0;
+
+	// Negative when expansion grew the term.
+	[[nodiscard]] std::ptrdiff_t nodes_saved() const {
+		return static_cast<std::ptrdiff_t>(this->nodes_before) - static_cast<std::ptrdiff_t>(this->nodes_after);
+	}
+};
+
+// True for λx. f x with x not free in f.
+[[nodiscard]] bool is_eta_redex(const Term& term);
+
+// Contracts every η-redex, innermost first, reusing the nodes of `term`.
+// Contracting an η-redex never creates a β-redex inside a β-normal term,
+// so a β-normal input gives a βη-normal result.
+[[nodiscard]] std::unique_ptr<Term> eta_reduce(std::unique_ptr<Term> term, EtaStats& stats);
+
+// η-long form of a β-normal term of type `type` in `context`: every
+// subterm of function type becomes an abstraction, and every variable
+// occurrence is applied to all its arguments. Throws the usual type
+// errors if the term does not have `type`.
+[[nodiscard]] std::unique_ptr<Term> eta_expand(std::unique_ptr<Term> term, const Type& type, const TypingContext& context, EtaStats& stats);
+
+// β-normalizes under `policy`, then η-reduces the normal form. An exhausted
+// result is returned as evaluate() left it, without the η pass.
+[[nodiscard]] EvaluationResult beta_eta_normalize(std::unique_ptr<Term> term, const ResourcePolicy& policy, EtaStats& stats);
+
+#endif //ETACONVERSION_H
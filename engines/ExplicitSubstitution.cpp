@@ -0,0 +1,518 @@
+//
+// ExplicitSubstitution.cpp
+//
+
+#include "ExplicitSubstitution.h"
+
+#include "../models/terms/Variable.h"
+#include "../models/terms/Abstraction.h"
+#include "../models/terms/Application.h"
+#include "../models/terms/Literal.h"
+#include "../models/terms/Primitive.h"
+#include "../models/terms/Let.h"
+#include "../models/terms/Reference.h"
+#include "../models/terms/Pair.h"
+#include "../models/terms/Projection.h"
+#include "../models/terms/Injection.h"
+#include "../models/terms/Case.h"
+#include "../models/Timeline.h"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+using std::unique_ptr, std::make_unique, std::make_shared;
+
+namespace {
+	ESRef make_index(std::size_t index, const ESNode& like) {
+		return make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Index, .index = index, .name = like.name, .var_type = like.var_type
+		});
+	}
+
+	ESRef make_abstraction(const ESNode& like, ESRef body) {
+		return make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Abstraction, .name = like.name, .var_type = like.var_type, .left = std::move(body)
+		});
+	}
+
+	ESRef make_application(ESRef function, ESRef value) {
+		return make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Application, .left = std::move(function), .right = std::move(value)
+		});
+	}
+
+	ESRef make_pair(ESRef first, ESRef second) {
+		return make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Pair, .left = std::move(first), .right = std::move(second)
+		});
+	}
+
+	ESRef make_projection(std::size_t component, ESRef operand) {
+		return make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Projection, .index = component, .left = std::move(operand)
+		});
+	}
+
+	ESRef make_injection(std::size_t side, std::shared_ptr<const Type> sum_type, ESRef value) {
+		return make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Injection, .index = side, .var_type = std::move(sum_type), .left = std::move(value)
+		});
+	}
+
+	ESRef make_case(ESRef scrutinee, ESRef on_left, ESRef on_right) {
+		return make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Case, .left = std::move(scrutinee), .right = std::move(on_left), .third = std::move(on_right)
+		});
+	}
+
+	bool is_identity(const ESSubstRef& subst) {
+		return subst->kind == ESSubst::Kind::Shift && subst->shift == 0;
+	}
+
+	bool is_closed_leaf(const ESNode& node) {
+		return node.kind == ESNode::Kind::Free || node.kind == ESNode::Kind::Literal || node.kind == ESNode::Kind::Primitive;
+	}
+
+	ESRef make_literal(LiteralValue literal) {
+		return make_shared<const ESNode>(ESNode{ .kind = ESNode::Kind::Literal, .literal = literal });
+	}
+
+	ESRef make_primitive(PrimitiveOp op, std::shared_ptr<const Type> branch_type) {
+		return make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Primitive, .var_type = std::move(branch_type), .op = op
+		});
+	}
+
+	ESRef make_closure(ESRef term, ESSubstRef subst) {
+		if (is_identity(subst) || is_closed_leaf(*term)) return term;
+		return make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Closure, .left = std::move(term), .subst = std::move(subst)
+		});
+	}
+
+	ESSubstRef make_shift(std::size_t by) {
+		return make_shared<const ESSubst>(ESSubst{ .kind = ESSubst::Kind::Shift, .shift = by });
+	}
+
+	ESSubstRef make_lift(ESSubstRef rest) {
+		return make_shared<const ESSubst>(ESSubst{ .kind = ESSubst::Kind::Lift, .rest = std::move(rest) });
+	}
+
+	ESSubstRef make_cons(ESRef term, ESSubstRef rest) {
+		return make_shared<const ESSubst>(ESSubst{
+			.kind = ESSubst::Kind::Cons, .term = std::move(term), .rest = std::move(rest)
+		});
+	}
+
+	struct Lowering {
+		std::vector<std::string> scope;
+		std::set<std::string>& free_names;
+		// Every reference to one definition shares a single lowered body.
+		std::map<const Definition*, ESRef>& definitions;
+	};
+
+	// let x = t in u lowers to the redex (λx. u) t.
+	ESRef make_let(const std::string& var_name, ESRef bound, ESRef body) {
+		auto abstraction = make_shared<const ESNode>(ESNode{
+			.kind = ESNode::Kind::Abstraction,
+			.name = var_name,
+			.var_type = make_shared<const BaseType>("τ"),
+			.left = std::move(body)
+		});
+		return make_application(std::move(abstraction), std::move(bound));
+	}
+
+	ESRef lower_into(const Term& term, Lowering& state);
+
+	ESRef lower_definition(const std::shared_ptr<const Definition>& definition, Lowering& state) {
+		if (const auto it = state.definitions.find(definition.get()); it != state.definitions.end()) return it->second;
+		// Definitions are closed: lower the body in an empty scope.
+		auto outer_scope = std::move(state.scope);
+		state.scope.clear();
+		auto lowered = lower_into(*definition->body, state);
+		state.scope = std::move(outer_scope);
+		state.definitions.emplace(definition.get(), lowered);
+		return lowered;
+	}
+
+	ESRef lower_into(const Term& term, Lowering& state) {
+		if (const auto* var = dynamic_cast<const Variable*>(&term)) {
+			const auto bound = std::find(state.scope.rbegin(), state.scope.rend(), var->name);
+			std::shared_ptr<const Type> type = var->get_type().clone();
+			if (bound == state.scope.rend()) {
+				state.free_names.insert(var->name);
+				return make_shared<const ESNode>(ESNode{
+					.kind = ESNode::Kind::Free, .name = var->name, .var_type = std::move(type)
+				});
+			}
+			return make_shared<const ESNode>(ESNode{
+				.kind = ESNode::Kind::Index,
+				.index = static_cast<std::size_t>(bound - state.scope.rbegin()),
+				.name = var->name,
+				.var_type = std::move(type)
+			});
+		}
+		if (const auto* abs = dynamic_cast<const Abstraction*>(&term)) {
+			state.scope.push_back(abs->var_name);
+			auto body = lower_into(*abs->body, state);
+			state.scope.pop_back();
+			return make_shared<const ESNode>(ESNode{
+				.kind = ESNode::Kind::Abstraction,
+				.name = abs->var_name,
+				.var_type = std::shared_ptr<const Type>(abs->var_type->clone()),
+				.left = std::move(body)
+			});
+		}
+		if (const auto* app = dynamic_cast<const Application*>(&term)) {
+			auto function = lower_into(*app->function, state);
+			auto value = lower_into(*app->value, state);
+			return make_application(std::move(function), std::move(value));
+		}
+		if (const auto* literal = dynamic_cast<const Literal*>(&term)) {
+			return make_literal({literal->kind, literal->value});
+		}
+		if (const auto* prim = dynamic_cast<const Primitive*>(&term)) {
+			return make_primitive(prim->op, prim->branch_type ? std::shared_ptr<const Type>(prim->branch_type->clone()) : nullptr);
+		}
+		if (const auto* let = dynamic_cast<const Let*>(&term)) {
+			auto bound = lower_into(*let->bound, state);
+			state.scope.push_back(let->var_name);
+			auto body = lower_into(*let->body, state);
+			state.scope.pop_back();
+			return make_let(let->var_name, std::move(bound), std::move(body));
+		}
+		if (const auto* ref = dynamic_cast<const Reference*>(&term)) {
+			return lower_definition(ref->definition, state);
+		}
+		if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+			auto first = lower_into(*pair->first, state);
+			return make_pair(std::move(first), lower_into(*pair->second, state));
+		}
+		if (const auto* projection = dynamic_cast<const Projection*>(&term)) {
+			return make_projection(static_cast<std::size_t>(projection->component), lower_into(*projection->operand, state));
+		}
+		if (const auto* injection = dynamic_cast<const Injection*>(&term)) {
+			return make_injection(static_cast<std::size_t>(injection->side), std::shared_ptr<const Type>(injection->sum_type->clone()),
+				lower_into(*injection->value, state));
+		}
+		if (const auto* match = dynamic_cast<const Case*>(&term)) {
+			auto scrutinee = lower_into(*match->scrutinee, state);
+			auto on_left = lower_into(*match->on_left, state);
+			return make_case(std::move(scrutinee), std::move(on_left), lower_into(*match->on_right, state));
+		}
+		throw std::invalid_argument("Explicit substitution: unsupported term '" + term.to_string() + "'");
+	}
+
+	ESRef lower_into(const TaggedTerm& term, Lowering& state) {
+		switch (term.kind()) {
+			case TermKind::Variable: {
+				const auto& var = term.as<VariableNode>();
+				const auto bound = std::find(state.scope.rbegin(), state.scope.rend(), var.name);
+				std::shared_ptr<const Type> type = from_tagged(*var.type);
+				if (bound == state.scope.rend()) {
+					state.free_names.insert(var.name);
+					return make_shared<const ESNode>(ESNode{
+						.kind = ESNode::Kind::Free, .name = var.name, .var_type = std::move(type)
+					});
+				}
+				return make_shared<const ESNode>(ESNode{
+					.kind = ESNode::Kind::Index,
+					.index = static_cast<std::size_t>(bound - state.scope.rbegin()),
+					.name = var.name,
+					.var_type = std::move(type)
+				});
+			}
+			case TermKind::Abstraction: {
+				const auto& abs = term.as<AbstractionNode>();
+				state.scope.push_back(abs.var_name);
+				auto body = lower_into(*abs.body, state);
+				state.scope.pop_back();
+				return make_shared<const ESNode>(ESNode{
+					.kind = ESNode::Kind::Abstraction,
+					.name = abs.var_name,
+					.var_type = std::shared_ptr<const Type>(from_tagged(*abs.var_type)),
+					.left = std::move(body)
+				});
+			}
+			case TermKind::Application: {
+				const auto& app = term.as<ApplicationNode>();
+				auto function = lower_into(*app.function, state);
+				auto value = lower_into(*app.value, state);
+				return make_application(std::move(function), std::move(value));
+			}
+			case TermKind::Literal: {
+				const auto& literal = term.as<LiteralNode>();
+				return make_literal({literal.kind, literal.value});
+			}
+			case TermKind::Primitive: {
+				const auto& prim = term.as<PrimitiveNode>();
+				return make_primitive(prim.op, prim.branch_type ? std::shared_ptr<const Type>(from_tagged(*prim.branch_type)) : nullptr);
+			}
+			case TermKind::Let: {
+				const auto& let = term.as<LetNode>();
+				auto bound = lower_into(*let.bound, state);
+				state.scope.push_back(let.var_name);
+				auto body = lower_into(*let.body, state);
+				state.scope.pop_back();
+				return make_let(let.var_name, std::move(bound), std::move(body));
+			}
+			case TermKind::Reference:
+				return lower_definition(term.as<ReferenceNode>().definition, state);
+			case TermKind::Pair: {
+				const auto& pair = term.as<PairNode>();
+				auto first = lower_into(*pair.first, state);
+				return make_pair(std::move(first), lower_into(*pair.second, state));
+			}
+			case TermKind::Projection: {
+				const auto& projection = term.as<ProjectionNode>();
+				return make_projection(static_cast<std::size_t>(projection.component), lower_into(*projection.operand, state));
+			}
+			case TermKind::Injection: {
+				const auto& injection = term.as<InjectionNode>();
+				return make_injection(static_cast<std::size_t>(injection.side), std::shared_ptr<const Type>(from_tagged(*injection.sum_type)),
+					lower_into(*injection.value, state));
+			}
+			case TermKind::Case: {
+				const auto& node = term.as<CaseNode>();
+				auto scrutinee = lower_into(*node.scrutinee, state);
+				auto on_left = lower_into(*node.on_left, state);
+				return make_case(std::move(scrutinee), std::move(on_left), lower_into(*node.on_right, state));
+			}
+		}
+		throw std::invalid_argument("Explicit substitution: unsupported term '" + to_string(term) + "'");
+	}
+}
+
+ExplicitSubstitutionEngine::ExplicitSubstitutionEngine(const Term& term) {
+	Lowering state{.free_names = this->free_names, .definitions = this->definitions};
+	this->root = lower_into(term, state);
+}
+
+ExplicitSubstitutionEngine::ExplicitSubstitutionEngine(const TaggedTerm& term) {
+	Lowering state{.free_names = this->free_names, .definitions = this->definitions};
+	this->root = lower_into(term, state);
+}
+
+ESRef ExplicitSubstitutionEngine::lower(const Term& term) {
+	std::set<std::string> free_names;
+	std::map<const Definition*, ESRef> definitions;
+	Lowering state{.free_names = free_names, .definitions = definitions};
+	return lower_into(term, state);
+}
+
+ESRef ExplicitSubstitutionEngine::load(const Term& term) {
+	Lowering state{.free_names = this->free_names, .definitions = this->definitions};
+	return lower_into(term, state);
+}
+
+const ExplicitSubstitutionEngine::Stats& ExplicitSubstitutionEngine::stats() const {
+	return this->counters;
+}
+
+ESRef ExplicitSubstitutionEngine::lookup(const ESRef& index, ESSubstRef subst) {
+	std::size_t n = index->index;
+	std::size_t pending_shift = 0;
+	for (;;) {
+		++this->counters.substitution_steps;
+		switch (subst->kind) {
+			case ESSubst::Kind::Shift:
+				return make_index(n + subst->shift + pending_shift, *index);
+			case ESSubst::Kind::Cons:
+				if (n == 0) return make_closure(subst->term, make_shift(pending_shift));
+				--n;
+				subst = subst->rest;
+				break;
+			case ESSubst::Kind::Lift:
+				if (n == 0) return make_index(pending_shift, *index);
+				--n;
+				++pending_shift;
+				subst = subst->rest;
+				break;
+		}
+	}
+}
+
+ESRef ExplicitSubstitutionEngine::expose(ESRef node) {
+	while (node->kind == ESNode::Kind::Closure) {
+		++this->counters.substitution_steps;
+		const ESRef& term = node->left;
+		const ESSubstRef& subst = node->subst;
+		switch (term->kind) {
+			case ESNode::Kind::Index:
+				node = this->lookup(term, subst);
+				break;
+			case ESNode::Kind::Free:
+			case ESNode::Kind::Literal:
+			case ESNode::Kind::Primitive:
+				node = term;
+				break;
+			case ESNode::Kind::Abstraction:
+				node = make_abstraction(*term, make_closure(term->left, make_lift(subst)));
+				break;
+			case ESNode::Kind::Application:
+				node = make_application(make_closure(term->left, subst), make_closure(term->right, subst));
+				break;
+			case ESNode::Kind::Pair:
+				node = make_pair(make_closure(term->left, subst), make_closure(term->right, subst));
+				break;
+			case ESNode::Kind::Projection:
+				node = make_projection(term->index, make_closure(term->left, subst));
+				break;
+			case ESNode::Kind::Injection:
+				node = make_injection(term->index, term->var_type, make_closure(term->left, subst));
+				break;
+			case ESNode::Kind::Case:
+				node = make_case(make_closure(term->left, subst), make_closure(term->right, subst), make_closure(term->third, subst));
+				break;
+			case ESNode::Kind::Closure:
+				node = make_closure(this->expose(term), subst);
+				break;
+		}
+	}
+	return node;
+}
+
+ESRef ExplicitSubstitutionEngine::whnf(ESRef node) {
+	for (;;) {
+		node = this->expose(std::move(node));
+		if (node->kind == ESNode::Kind::Projection) {
+			auto operand = this->whnf(node->left);
+			if (operand->kind != ESNode::Kind::Pair) {
+				return operand == node->left ? node : make_projection(node->index, std::move(operand));
+			}
+			++this->counters.delta_steps;
+			node = static_cast<Component>(node->index) == Component::First ? operand->left : operand->right;
+			continue;
+		}
+		if (node->kind == ESNode::Kind::Case) {
+			auto scrutinee = this->whnf(node->left);
+			if (scrutinee->kind != ESNode::Kind::Injection) {
+				return scrutinee == node->left ? node : make_case(std::move(scrutinee), node->right, node->third);
+			}
+			++this->counters.delta_steps;
+			node = make_application(static_cast<Side>(scrutinee->index) == Side::Left ? node->right : node->third, scrutinee->left);
+			continue;
+		}
+		if (node->kind != ESNode::Kind::Application) return node;
+
+		auto head = this->whnf(node->left);
+		if (head->kind != ESNode::Kind::Abstraction) {
+			auto stuck = head == node->left ? node : make_application(std::move(head), node->right);
+			auto contractum = this->try_delta(stuck->left, stuck);
+			if (contractum == nullptr) return stuck;
+			++this->counters.delta_steps;
+			node = std::move(contractum);
+			continue;
+		}
+		++this->counters.beta_steps;
+		node = make_closure(head->left, make_cons(node->right, make_shift(0)));
+	}
+}
+
+ESRef ExplicitSubstitutionEngine::try_delta(const ESRef& head, const ESRef& application) {
+	// `head` is already in weak-head form, so a primitive spine is a chain
+	// of Application nodes ending in a Primitive.
+	std::vector<ESRef> args{application->right};
+	const ESNode* node = head.get();
+	while (node->kind == ESNode::Kind::Application) {
+		if (args.size() == 3) return nullptr;
+		args.push_back(node->right);
+		node = node->left.get();
+	}
+	if (node->kind != ESNode::Kind::Primitive || primitive_arity(node->op) != args.size()) return nullptr;
+	std::reverse(args.begin(), args.end());
+
+	const auto op = node->op;
+	for (std::size_t i = 0; i < args.size(); ++i) {
+		LiteralKind expected;
+		if (!primitive_strict_in(op, i, expected)) continue;
+		args[i] = this->whnf(args[i]);
+		if (args[i]->kind != ESNode::Kind::Literal || args[i]->literal.kind != expected) return nullptr;
+	}
+	if (op == PrimitiveOp::If) return args[0]->literal.value ? args[1] : args[2];
+	return make_literal(evaluate_primitive(op, args[0]->literal.value, args[1]->literal.value));
+}
+
+ESRef ExplicitSubstitutionEngine::full_normal(const ESRef& node) {
+	auto head = this->whnf(node);
+	switch (head->kind) {
+		case ESNode::Kind::Abstraction:
+			return make_abstraction(*head, this->full_normal(head->left));
+		case ESNode::Kind::Application:
+			return make_application(this->full_normal(head->left), this->full_normal(head->right));
+		case ESNode::Kind::Pair:
+			return make_pair(this->full_normal(head->left), this->full_normal(head->right));
+		case ESNode::Kind::Projection:
+			return make_projection(head->index, this->full_normal(head->left));
+		case ESNode::Kind::Injection:
+			return make_injection(head->index, head->var_type, this->full_normal(head->left));
+		case ESNode::Kind::Case:
+			return make_case(this->full_normal(head->left), this->full_normal(head->right), this->full_normal(head->third));
+		default:
+			return head;
+	}
+}
+
+unique_ptr<Term> ExplicitSubstitutionEngine::normalize() {
+	TIMELINE_SPAN("normalize");
+	this->root = this->full_normal(this->root);
+	return this->read_back(this->root);
+}
+
+unique_ptr<Term> ExplicitSubstitutionEngine::weak_head_normalize() {
+	this->root = this->whnf(this->root);
+	return this->read_back(this->root);
+}
+
+unique_ptr<Term> ExplicitSubstitutionEngine::read_back(const ESRef& node) {
+	std::vector<std::string> scope;
+	return this->read_back(node, scope);
+}
+
+unique_ptr<Term> ExplicitSubstitutionEngine::read_back(const ESRef& node, std::vector<std::string>& scope) {
+	const auto exposed = this->expose(node);
+	switch (exposed->kind) {
+		case ESNode::Kind::Index:
+			return make_unique<Variable>(scope[scope.size() - 1 - exposed->index], exposed->var_type->clone());
+		case ESNode::Kind::Free:
+			return make_unique<Variable>(exposed->name, exposed->var_type->clone());
+		case ESNode::Kind::Abstraction: {
+			// Binder names are only hints; prime them until they can neither
+			// capture a free variable nor shadow an enclosing binder.
+			std::string name = exposed->name;
+			while (this->free_names.contains(name) || std::ranges::find(scope, name) != scope.end()) {
+				name += "'";
+			}
+			scope.push_back(name);
+			auto body = this->read_back(exposed->left, scope);
+			scope.pop_back();
+			return make_unique<Abstraction>(exposed->var_type->clone(), name, std::move(body));
+		}
+		case ESNode::Kind::Application: {
+			auto function = this->read_back(exposed->left, scope);
+			auto value = this->read_back(exposed->right, scope);
+			return make_unique<Application>(std::move(function), std::move(value));
+		}
+		case ESNode::Kind::Literal:
+			return make_unique<Literal>(exposed->literal.kind, exposed->literal.value);
+		case ESNode::Kind::Primitive:
+			return make_unique<Primitive>(exposed->op, exposed->var_type ? exposed->var_type->clone() : nullptr);
+		case ESNode::Kind::Pair: {
+			auto first = this->read_back(exposed->left, scope);
+			return make_unique<Pair>(std::move(first), this->read_back(exposed->right, scope));
+		}
+		case ESNode::Kind::Projection:
+			return make_unique<Projection>(static_cast<Component>(exposed->index), this->read_back(exposed->left, scope));
+		case ESNode::Kind::Injection:
+			return make_unique<Injection>(static_cast<Side>(exposed->index), exposed->var_type->clone(), this->read_back(exposed->left, scope));
+		case ESNode::Kind::Case: {
+			auto scrutinee = this->read_back(exposed->left, scope);
+			auto on_left = this->read_back(exposed->right, scope);
+			return make_unique<Case>(std::move(scrutinee), std::move(on_left), this->read_back(exposed->third, scope));
+		}
+		case ESNode::Kind::Closure:
+			break;
+	}
+	throw std::logic_error("Explicit substitution: closure survived expose()");
+}
@@ -0,0 +1,108 @@
+//
+// ExplicitSubstitution.h
+//
+// A λυ-style explicit substitution layer. Terms are lowered into de Bruijn
+// form where a β-contraction only allocates a closure `body[arg · id]`; the
+// substitution is pushed one constructor down whenever that node is actually
+// inspected, so parts of the result that are never looked at cost nothing.
+//
+
+#ifndef EXPLICITSUBSTITUTION_H
+#define EXPLICITSUBSTITUTION_H
+
+#include "../models/Terms.h"
+#include "../models/TaggedTerm.h"
+#include "../models/Type.h"
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+struct ESNode;
+struct ESSubst;
+using ESRef = std::shared_ptr<const ESNode>;
+using ESSubstRef = std::shared_ptr<const ESSubst>;
+
+// Substitutions of the λυ calculus: ↑k (shift), a·s (cons) and ⇑s (lift).
+struct ESSubst {
+	enum class Kind { Shift, Cons, Lift };
+
+	Kind kind;
+	std::size_t shift = 0;
+	ESRef term;
+	ESSubstRef rest;
+};
+
+struct ESNode {
+	enum class Kind { Index, Free, Abstraction, Application, Closure, Literal, Primitive, Pair, Projection, Injection, Case };
+
+	Kind kind;
+	// De Bruijn index, the Component of a Projection or the Side of an
+	// Injection.
+	std::size_t index = 0;
+	// Binder hint for Abstraction/Index, the variable name for Free.
+	std::string name;
+	// Variable/binder type, the branch type of an If primitive, or the sum
+	// type of an Injection.
+	std::shared_ptr<const Type> var_type;
+	LiteralValue literal{};
+	PrimitiveOp op{};
+	// Abstraction body / Application function / Closure term / first
+	// component / Projection operand / Injection payload / Case scrutinee.
+	ESRef left;
+	// Application value / second component / left branch of a Case.
+	ESRef right;
+	// Right branch of a Case.
+	ESRef third;
+	ESSubstRef subst;
+};
+
+class ExplicitSubstitutionEngine {
+public:
+	struct Stats {
+		std::size_t beta_steps = 0;
+		// Primitive δ-rules, projections of pairs and cases on injections.
+		std::size_t delta_steps = 0;
+		std::size_t substitution_steps = 0;
+	};
+
+	// An engine without a root term, for load() and whnf() only.
+	ExplicitSubstitutionEngine() = default;
+	explicit ExplicitSubstitutionEngine(const Term& term);
+	explicit ExplicitSubstitutionEngine(const TaggedTerm& term);
+
+	// Full normal-order normalization. Diverges on terms without a normal form.
+	[[nodiscard]] std::unique_ptr<Term> normalize();
+	// Reduces only the head to weak-head normal form; arguments and bodies
+	// are read back with their substitutions applied but never contracted.
+	[[nodiscard]] std::unique_ptr<Term> weak_head_normalize();
+
+	[[nodiscard]] const Stats& stats() const;
+
+	[[nodiscard]] static ESRef lower(const Term& term);
+	// Lowers another term alongside the root, sharing its lowered
+	// definitions, so references to one definition become the same node.
+	[[nodiscard]] ESRef load(const Term& term);
+	[[nodiscard]] std::unique_ptr<Term> read_back(const ESRef& node);
+	// Pushes substitutions down until `node` is not a closure; contracts
+	// no redex.
+	[[nodiscard]] ESRef expose(ESRef node);
+	// Weak-head form of `node`, with no closure left at its top.
+	[[nodiscard]] ESRef whnf(ESRef node);
+
+private:
+	ESRef root;
+	std::set<std::string> free_names;
+	std::map<const Definition*, ESRef> definitions;
+	Stats counters;
+
+	[[nodiscard]] ESRef lookup(const ESRef& index, ESSubstRef subst);
+	[[nodiscard]] ESRef try_delta(const ESRef& head, const ESRef& application);
+	[[nodiscard]] ESRef full_normal(const ESRef& node);
+	[[nodiscard]] std::unique_ptr<Term> read_back(const ESRef& node, std::vector<std::string>& scope);
+};
+
+#endif //EXPLICITSUBSTITUTION_H
@@ -0,0 +1,108 @@
+//
+// Generator.h
+//
+// Minimal synchronous coroutine generator in the style of C++23
+// std::generator, which the supported standard libraries do not all ship.
+// A coroutine returning Generator<T> uses `co_yield value;` with a T that
+// outlives the suspension (typically a local of the coroutine). Consumers
+// get a `const T&` to it without a copy.
+//
+// Unlike std::generator, begin() may be called again after the consumer
+// stopped early. It does not advance the coroutine, so the new loop starts
+// at the value the previous one stopped on.
+//
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+template <typename T>
+class Generator {
+public:
+	struct promise_type {
+		const T* current = nullptr;
+		std::exception_ptr exception;
+
+		Generator get_return_object() { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		std::suspend_always yield_value(const T& value) noexcept {
+			this->current = std::addressof(value);
+			return {};
+		}
+		void return_void() noexcept {}
+		void unhandled_exception() { this->exception = std::current_exception(); }
+
+		// Generators only yield.
+		template <typename U>
+		std::suspend_never await_transform(U&&) = delete;
+	};
+
+	using handle_type = std::coroutine_handle<promise_type>;
+
+	class iterator {
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = T;
+
+		iterator() = default;
+		explicit iterator(Generator* owner): owner(owner) {}
+
+		const T& operator*() const { return *this->owner->coroutine.promise().current; }
+		const T* operator->() const { return this->owner->coroutine.promise().current; }
+		iterator& operator++() {
+			this->owner->advance();
+			return *this;
+		}
+		void operator++(int) { ++*this; }
+		bool operator==(std::default_sentinel_t) const { return this->owner->done(); }
+
+	private:
+		Generator* owner = nullptr;
+	};
+
+	Generator(Generator&& other) noexcept: coroutine(std::exchange(other.coroutine, nullptr)), started(other.started) {}
+	Generator& operator=(Generator other) noexcept {
+		std::swap(this->coroutine, other.coroutine);
+		std::swap(this->started, other.started);
+		return *this;
+	}
+	~Generator() {
+		if (this->coroutine) this->coroutine.destroy();
+	}
+
+	iterator begin() {
+		if (!this->started) this->advance();
+		return iterator(this);
+	}
+	std::default_sentinel_t end() const { return {}; }
+
+	// Pull interface: the next value, or nullptr once the coroutine returned.
+	const T* next() {
+		this->advance();
+		return this->done() ? nullptr : this->coroutine.promise().current;
+	}
+
+	[[nodiscard]] bool done() const { return !this->coroutine || this->coroutine.done(); }
+
+private:
+	handle_type coroutine;
+	bool started = false;
+
+	explicit Generator(handle_type coroutine): coroutine(coroutine) {}
+
+	void advance() {
+		this->started = true;
+		if (this->done()) return;
+		this->coroutine.resume();
+		if (auto exception = std::exchange(this->coroutine.promise().exception, nullptr)) std::rethrow_exception(exception);
+	}
+};
+
+#endif //GENERATOR_H
@@ -0,0 +1,273 @@
+//
+// NormalFormCache.cpp
+//
+
+#include "NormalFormCache.h"
+
+#include "../models/lambda.h"
+#include "../models/TermCodec.h"
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::unique_ptr;
+
+namespace {
+
+constexpr std::string_view cache_magic("LNFC\x01\0\0\0", 8);
+// key, checksum, input node count, payload length
+constexpr std::size_t entry_header_bytes = 8 + 8 + 4 + 4;
+
+std::uint64_t checksum(std::uint64_t key, std::uint32_t nodes, std::string_view payload) {
+	return hash_mix(hash_mix(key, (static_cast<std::uint64_t>(nodes) << 32) | payload.size()), hash_name(payload));
+}
+
+std::uint64_t load_u64(const char* bytes) {
+	std::uint64_t value = 0;
+	for (int i = 0; i < 8; ++i) value |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+	return value;
+}
+
+std::uint32_t load_u32(const char* bytes) {
+	return static_cast<std::uint32_t>(load_u64(bytes) & 0xffffffff);
+}
+
+void put_u32(std::string& out, std::uint32_t value) {
+	for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+// Mixes every type annotation, in walk order, and every definition reached
+// into `key`. alpha_hash skips binder annotations, but they carry over
+// into the normal form and decide its type.
+void collect_key(const Term& term, std::set<const Definition*>& seen, std::uint64_t& key) {
+	if (const auto* variable = dynamic_cast<const Variable*>(&term)) {
+		key = hash_mix(key, type_hash(variable->get_type()));
+	} else if (const auto* abstraction = dynamic_cast<const Abstraction*>(&term)) {
+		key = hash_mix(key, type_hash(*abstraction->var_type));
+		collect_key(*abstraction->body, seen, key);
+	} else if (const auto* application = dynamic_cast<const Application*>(&term)) {
+		collect_key(*application->function, seen, key);
+		collect_key(*application->value, seen, key);
+	} else if (const auto* primitive = dynamic_cast<const Primitive*>(&term)) {
+		if (primitive->branch_type) key = hash_mix(key, type_hash(*primitive->branch_type));
+	} else if (const auto* let = dynamic_cast<const Let*>(&term)) {
+		collect_key(*let->bound, seen, key);
+		collect_key(*let->body, seen, key);
+	} else if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+		collect_key(*pair->first, seen, key);
+		collect_key(*pair->second, seen, key);
+	} else if (const auto* projection = dynamic_cast<const Projection*>(&term)) {
+		collect_key(*projection->operand, seen, key);
+	} else if (const auto* injection = dynamic_cast<const Injection*>(&term)) {
+		key = hash_mix(key, type_hash(*injection->sum_type));
+		collect_key(*injection->value, seen, key);
+	} else if (const auto* match = dynamic_cast<const Case*>(&term)) {
+		collect_key(*match->scrutinee, seen, key);
+		collect_key(*match->on_left, seen, key);
+		collect_key(*match->on_right, seen, key);
+	} else if (const auto* reference = dynamic_cast<const Reference*>(&term)) {
+		const auto& definition = *reference->definition;
+		if (!seen.insert(&definition).second) return;
+		key = hash_mix(hash_mix(key, hash_name(definition.name)), alpha_hash(*definition.body));
+		collect_key(*definition.body, seen, key);
+	}
+}
+
+std::runtime_error system_error(const std::string& what, const std::filesystem::path& path) {
+	return std::runtime_error(what + " " + path.string() + ": " + std::strerror(errno));
+}
+
+// flock(2) for the scope of one scan or append.
+class FileLock {
+public:
+	FileLock(int fd, int operation): fd(fd) { while (::flock(fd, operation) != 0 && errno == EINTR) {} }
+	~FileLock() { ::flock(this->fd, LOCK_UN); }
+	FileLock(const FileLock&) = delete;
+	FileLock& operator=(const FileLock&) = delete;
+
+private:
+	int fd;
+};
+
+std::size_t file_size(int fd) {
+	struct stat info {};
+	if (::fstat(fd, &info) != 0) return 0;
+	return static_cast<std::size_t>(info.st_size);
+}
+
+}
+
+std::uint64_t cache_key(const Term& term) {
+	std::uint64_t key = alpha_hash(term);
+	std::set<const Definition*> seen;
+	collect_key(term, seen, key);
+	return key;
+}
+
+NormalFormCache::NormalFormCache(const std::filesystem::path& path, std::size_t max_bytes):
+	max_bytes(max_bytes)
+{
+	this->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+	if (this->fd < 0) throw system_error("cannot open normal-form cache", path);
+
+	FileLock lock(this->fd, LOCK_EX);
+	const auto size = file_size(this->fd);
+	if (size == 0) {
+		if (::write(this->fd, cache_magic.data(), cache_magic.size()) != static_cast<ssize_t>(cache_magic.size())) {
+			::close(this->fd);
+			throw system_error("cannot initialize normal-form cache", path);
+		}
+	} else {
+		char header[cache_magic.size()] = {};
+		if (size < cache_magic.size() || ::pread(this->fd, header, sizeof header, 0) != static_cast<ssize_t>(sizeof header)
+			|| std::string_view(header, sizeof header) != cache_magic) {
+			::close(this->fd);
+			throw std::runtime_error("not a normal-form cache: " + path.string());
+		}
+	}
+	this->scanned_bytes = cache_magic.size();
+	(void)this->remap();
+}
+
+NormalFormCache::~NormalFormCache() {
+	this->unmap();
+	if (this->fd >= 0) ::close(this->fd);
+}
+
+void NormalFormCache::unmap() {
+	if (this->mapping != nullptr) ::munmap(const_cast<char*>(this->mapping), this->mapped_bytes);
+	this->mapping = nullptr;
+	this->mapped_bytes = 0;
+}
+
+// Maps the whole file and indexes the entries past the last scan. The
+// caller holds a file lock, so no append is in progress. Returns false if
+// the file could not be mapped; the old mapping and index then stay.
+bool NormalFormCache::remap() {
+	const auto size = file_size(this->fd);
+	if (size != this->mapped_bytes) {
+		// The index points into the old mapping, so it stays until a new
+		// one is in place.
+		void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, this->fd, 0);
+		if (mapped == MAP_FAILED) return false;
+		this->unmap();
+		this->mapping = static_cast<const char*>(mapped);
+		this->mapped_bytes = size;
+	}
+	// An unchanged size does not mean unchanged contents: another writer
+	// may have cut a torn tail and appended an entry of the same length.
+	if (this->scanned_bytes < size) {
+		this->scanned_bytes = this->scan(this->scanned_bytes, size);
+		std::erase_if(this->recent, [this](const auto& entry) { return this->index.contains(entry.first); });
+	}
+	return true;
+}
+
+// Indexes entries from `from` until the first one that is cut short or
+// fails its checksum, and returns where that one starts.
+std::size_t NormalFormCache::scan(std::size_t from, std::size_t size) {
+	while (size - from >= entry_header_bytes) {
+		const char* header = this->mapping + from;
+		const auto key = load_u64(header);
+		const auto sum = load_u64(header + 8);
+		const auto nodes = load_u32(header + 16);
+		const auto length = load_u32(header + 20);
+		if (size - from - entry_header_bytes < length) break;
+		const std::string_view payload(header + entry_header_bytes, length);
+		if (checksum(key, nodes, payload) != sum) break;
+		this->index.try_emplace(key, Location{from + entry_header_bytes, nodes, length});
+		from += entry_header_bytes + length;
+	}
+	return from;
+}
+
+unique_ptr<Term> NormalFormCache::lookup(const Term& term) {
+	const auto key = cache_key(term);
+	std::string_view payload;
+	std::uint32_t nodes = 0;
+	std::shared_lock lock(this->mutex);
+	if (const auto it = this->index.find(key); it != this->index.end()) {
+		payload = std::string_view(this->mapping + it->second.offset, it->second.length);
+		nodes = it->second.nodes;
+	} else if (const auto recent = this->recent.find(key); recent != this->recent.end()) {
+		payload = recent->second.second;
+		nodes = recent->second.first;
+	}
+	// The node count guards against a 64-bit key collision.
+	if (payload.empty() || nodes != term.measure().nodes) {
+		++this->misses;
+		return nullptr;
+	}
+	try {
+		auto normal_form = decode_term(payload);
+		++this->hits;
+		return normal_form;
+	} catch (const TermFormatError&) {
+		++this->misses;
+		return nullptr;
+	}
+}
+
+void NormalFormCache::store(const Term& term, const Term& normal_form) {
+	const auto key = cache_key(term);
+	{
+		std::shared_lock lock(this->mutex);
+		if (this->index.contains(key) || this->recent.contains(key)) return;
+	}
+	const auto nodes = static_cast<std::uint32_t>(term.measure().nodes);
+	const auto payload = encode_term(normal_form);
+	std::string entry;
+	entry.reserve(entry_header_bytes + payload.size());
+	put_u64(entry, key);
+	put_u64(entry, checksum(key, nodes, payload));
+	put_u32(entry, nodes);
+	put_u32(entry, static_cast<std::uint32_t>(payload.size()));
+	entry += payload;
+
+	std::unique_lock lock(this->mutex);
+	FileLock file_lock(this->fd, LOCK_EX);
+	// Without a current scan, valid entries could look like a torn tail.
+	if (!this->remap()) return;
+	if (this->index.contains(key)) return;
+	// Holding the exclusive lock, anything after the last valid entry was
+	// left by a writer that died mid-append.
+	if (this->scanned_bytes < file_size(this->fd)) {
+		if (::ftruncate(this->fd, static_cast<off_t>(this->scanned_bytes)) != 0) return;
+		(void)this->remap();
+	}
+	if (this->scanned_bytes + entry.size() > this->max_bytes) {
+		++this->rejected;
+		return;
+	}
+	if (::write(this->fd, entry.data(), entry.size()) != static_cast<ssize_t>(entry.size())) return;
+	this->recent.try_emplace(key, nodes, std::move(payload));
+	++this->stores;
+}
+
+void NormalFormCache::refresh() {
+	std::unique_lock lock(this->mutex);
+	FileLock file_lock(this->fd, LOCK_SH);
+	(void)this->remap();
+}
+
+CacheStats NormalFormCache::stats() const {
+	std::shared_lock lock(this->mutex);
+	return CacheStats{
+		.entries = this->index.size() + this->recent.size(),
+		.hits = this->hits,
+		.misses = this->misses,
+		.stores = this->stores,
+		.rejected = this->rejected,
+		.file_bytes = file_size(this->fd),
+	};
+}
@@ -0,0 +1,97 @@
+//
+// NormalFormCache.h
+//
+// Persistent normal-form cache shared by every process on a machine. Entries
+// are keyed by cache_key(), an alpha-invariant hash, and hold the normal
+// form in the TermCodec encoding. Valid entries are never rewritten; the
+// file grows by appends and is read through a read-only shared mapping:
+//
+//   - Appends happen under an exclusive flock(2), one write(2) per entry.
+//   - Scans take a shared lock, so a scan never races with an append.
+//   - Every entry carries a checksum. A tail left behind by a crashed
+//     writer fails it and is truncated by the next writer.
+//   - The file stops growing at max_bytes. Later stores are dropped, and
+//     nothing is ever evicted.
+//
+// Lookups only read the mapping, so any number of processes and threads can
+// read concurrently. Entries other processes append after this one opened
+// the file become visible after refresh().
+//
+
+#ifndef NORMALFORMCACHE_H
+#define NORMALFORMCACHE_H
+
+#include "../models/Terms.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// alpha_hash of the term, mixed with every type annotation in it and with
+// the name and body hash of every definition it refers to, directly or
+// through other definitions. Terms that differ only in an annotation, or a
+// redefinition in a later run, therefore miss instead of returning a stale
+// normal form.
+[[nodiscard]] std::uint64_t cache_key(const Term& term);
+
+struct CacheStats {
+	std::size_t entries = 0;    // usable entries, from the file and this process
+	std::size_t hits = 0;
+	std::size_t misses = 0;
+	std::size_t stores = 0;
+	std::size_t rejected = 0;   // stores dropped because the file is full
+	std::size_t file_bytes = 0;
+};
+
+class NormalFormCache {
+public:
+	static constexpr std::size_t default_max_bytes = std::size_t{256} << 20;
+
+	explicit NormalFormCache(const std::filesystem::path& path, std::size_t max_bytes = default_max_bytes);
+	~NormalFormCache();
+	NormalFormCache(const NormalFormCache&) = delete;
+	NormalFormCache& operator=(const NormalFormCache&) = delete;
+
+	// The cached normal form of `term`, or nullptr.
+	[[nodiscard]] std::unique_ptr<Term> lookup(const Term& term);
+	// Records `normal_form` as the normal form of `term`. Does nothing if
+	// the term is already cached or the file is full.
+	void store(const Term& term, const Term& normal_form);
+	// Maps entries appended by other processes since the last scan.
+	void refresh();
+
+	[[nodiscard]] CacheStats stats() const;
+
+private:
+	struct Location {
+		std::size_t offset;     // payload offset in the mapping
+		std::uint32_t nodes;    // node count of the cached input term
+		std::uint32_t length;
+	};
+
+	int fd = -1;
+	std::size_t max_bytes;
+	const char* mapping = nullptr;
+	std::size_t mapped_bytes = 0;
+	std::size_t scanned_bytes = 0;   // end of the last valid entry in the mapping
+	std::unordered_map<std::uint64_t, Location> index;
+	// Entries this process appended past the mapping, until refresh() maps them.
+	std::unordered_map<std::uint64_t, std::pair<std::uint32_t, std::string>> recent;
+	mutable std::shared_mutex mutex;
+
+	std::atomic<std::size_t> hits = 0;
+	std::atomic<std::size_t> misses = 0;
+	std::atomic<std::size_t> stores = 0;
+	std::atomic<std::size_t> rejected = 0;
+
+	bool remap();
+	void unmap();
+	std::size_t scan(std::size_t from, std::size_t size);
+};
+
+#endif //NORMALFORMCACHE_H
@@ -0,0 +1,214 @@
+//
+// ParallelTypeCheck.cpp
+//
+
+#include "ParallelTypeCheck.h"
+
+#include "../models/lambda.h"
+#include "../models/Timeline.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+
+using std::unique_ptr; using std::make_unique;
+
+namespace {
+
+using CheckResult = std::expected<unique_ptr<Type>, TypeError>;
+
+// One binder. Frames live on the stack of the check that introduced them
+// and are never modified, so tasks forked underneath may read them freely.
+struct ScopeFrame {
+	std::string_view name;
+	const Type* type;
+	const ScopeFrame* parent;
+};
+
+// Node count of `term`, recording every application worth forking at.
+std::size_t mark_forks(const Term& term, std::size_t threshold, std::unordered_set<const Term*>& forks) {
+	if (const auto* abstraction = dynamic_cast<const Abstraction*>(&term)) return 1 + mark_forks(*abstraction->body, threshold, forks);
+	if (const auto* application = dynamic_cast<const Application*>(&term)) {
+		const auto function = mark_forks(*application->function, threshold, forks);
+		const auto value = mark_forks(*application->value, threshold, forks);
+		if (function >= threshold && value >= threshold) forks.insert(&term);
+		return 1 + function + value;
+	}
+	if (const auto* let = dynamic_cast<const Let*>(&term)) {
+		return 1 + mark_forks(*let->bound, threshold, forks) + mark_forks(*let->body, threshold, forks);
+	}
+	if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+		return 1 + mark_forks(*pair->first, threshold, forks) + mark_forks(*pair->second, threshold, forks);
+	}
+	if (const auto* projection = dynamic_cast<const Projection*>(&term)) return 1 + mark_forks(*projection->operand, threshold, forks);
+	if (const auto* injection = dynamic_cast<const Injection*>(&term)) return 1 + mark_forks(*injection->value, threshold, forks);
+	if (const auto* match = dynamic_cast<const Case*>(&term)) {
+		return 1 + mark_forks(*match->scrutinee, threshold, forks) + mark_forks(*match->on_left, threshold, forks)
+			+ mark_forks(*match->on_right, threshold, forks);
+	}
+	return 1;
+}
+
+// Mirrors the Checker in Diagnostics.cpp, stopping at the first error.
+class ParallelChecker {
+public:
+	ParallelChecker(const TypingContext& context, WorkStealingPool& pool, std::unordered_set<const Term*> forks):
+		context(context),
+		pool(pool),
+		forks(std::move(forks))
+	{}
+
+	CheckResult check(const Term& term, const ScopeFrame* scope) {
+		if (const auto* variable = dynamic_cast<const Variable*>(&term)) return this->check_variable(*variable, scope);
+		if (const auto* abstraction = dynamic_cast<const Abstraction*>(&term)) {
+			const ScopeFrame frame{abstraction->var_name, abstraction->var_type.get(), scope};
+			auto body = this->check(*abstraction->body, &frame);
+			if (!body) return body;
+			return make_unique<FunctionType>(abstraction->var_type->clone(), std::move(*body));
+		}
+		if (const auto* application = dynamic_cast<const Application*>(&term)) return this->check_application(*application, scope);
+		if (const auto* let = dynamic_cast<const Let*>(&term)) {
+			auto bound = this->check(*let->bound, scope);
+			if (!bound) return bound;
+			const ScopeFrame frame{let->var_name, bound->get(), scope};
+			return this->check(*let->body, &frame);
+		}
+		if (const auto* primitive = dynamic_cast<const Primitive*>(&term)) {
+			if (primitive->op == PrimitiveOp::If && primitive->branch_type == nullptr) {
+				return std::unexpected(TypeError{ErrorCode::UntypedIf, &term});
+			}
+			return primitive_type(primitive->op, primitive->branch_type.get());
+		}
+		if (const auto* reference = dynamic_cast<const Reference*>(&term)) return this->check_definition(*reference->definition);
+		if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+			auto first = this->check(*pair->first, scope);
+			if (!first) return first;
+			auto second = this->check(*pair->second, scope);
+			if (!second) return second;
+			return make_unique<ProductType>(std::move(*first), std::move(*second));
+		}
+		if (const auto* projection = dynamic_cast<const Projection*>(&term)) return this->check_projection(*projection, scope);
+		if (const auto* injection = dynamic_cast<const Injection*>(&term)) return this->check_injection(*injection, scope);
+		if (const auto* match = dynamic_cast<const Case*>(&term)) return this->check_case(*match, scope);
+		return term.type_check(this->context);
+	}
+
+private:
+	const TypingContext& context;
+	WorkStealingPool& pool;
+	const std::unordered_set<const Term*> forks;
+	std::mutex definitions_mutex;
+	std::map<const Definition*, unique_ptr<Type>> definitions;
+
+	CheckResult check_variable(const Variable& variable, const ScopeFrame* scope) const {
+		for (const auto* frame = scope; frame != nullptr; frame = frame->parent) {
+			if (frame->name == variable.name) return frame->type->clone();
+		}
+		if (const auto* type = this->context.lookup(variable.name)) return type->clone();
+		return std::unexpected(TypeError{ErrorCode::UndeclaredVariable, &variable, variable.name});
+	}
+
+	CheckResult check_application(const Application& application, const ScopeFrame* scope) {
+		if (!this->forks.contains(&application)) {
+			auto function = this->check(*application.function, scope);
+			if (!function) return function;
+			if (dynamic_cast<const FunctionType*>(function->get()) == nullptr) return not_a_function(application, std::move(*function));
+			return combine(application, std::move(*function), this->check(*application.value, scope));
+		}
+
+		CheckResult value;
+		WorkStealingPool::Task task([&] { value = this->check(*application.value, scope); });
+		this->pool.fork(task);
+		auto function = this->check(*application.function, scope);
+		this->pool.join(task);
+		// Report errors in the order the sequential checker meets them.
+		if (!function) return function;
+		if (dynamic_cast<const FunctionType*>(function->get()) == nullptr) return not_a_function(application, std::move(*function));
+		return combine(application, std::move(*function), std::move(value));
+	}
+
+	static CheckResult not_a_function(const Application& application, unique_ptr<Type> function) {
+		return std::unexpected(TypeError{ErrorCode::NotAFunction, &application, {}, nullptr, std::move(function)});
+	}
+
+	static CheckResult combine(const Application& application, unique_ptr<Type> function, CheckResult value) {
+		if (!value) return value;
+		const auto& function_type = static_cast<const FunctionType&>(*function);
+		if ((*value)->to_string() != function_type.domain->to_string()) {
+			return std::unexpected(TypeError{ErrorCode::DomainMismatch, &application, {}, function_type.domain->clone(), std::move(*value)});
+		}
+		return function_type.codomain->clone();
+	}
+
+	CheckResult check_projection(const Projection& projection, const ScopeFrame* scope) {
+		auto operand = this->check(*projection.operand, scope);
+		if (!operand) return operand;
+		const auto* product = dynamic_cast<const ProductType*>(operand->get());
+		if (product == nullptr) return std::unexpected(TypeError{ErrorCode::NotAProduct, &projection, {}, nullptr, std::move(*operand)});
+		return projection.component == Component::First ? product->first->clone() : product->second->clone();
+	}
+
+	CheckResult check_injection(const Injection& injection, const ScopeFrame* scope) {
+		const auto* sum = dynamic_cast<const SumType*>(injection.sum_type.get());
+		if (sum == nullptr) return std::unexpected(TypeError{ErrorCode::NotASum, &injection, {}, nullptr, injection.sum_type->clone()});
+		auto value = this->check(*injection.value, scope);
+		if (!value) return value;
+		const auto& expected = injection.side == Side::Left ? *sum->left : *sum->right;
+		if ((*value)->to_string() != expected.to_string()) {
+			return std::unexpected(TypeError{ErrorCode::DomainMismatch, &injection, {}, expected.clone(), std::move(*value)});
+		}
+		return sum->clone();
+	}
+
+	CheckResult check_case(const Case& match, const ScopeFrame* scope) {
+		auto scrutinee = this->check(*match.scrutinee, scope);
+		if (!scrutinee) return scrutinee;
+		const auto* sum = dynamic_cast<const SumType*>(scrutinee->get());
+		if (sum == nullptr) return std::unexpected(TypeError{ErrorCode::NotASum, &match, {}, nullptr, std::move(*scrutinee)});
+		auto left = this->check_branch(*match.on_left, *sum->left, scope);
+		if (!left) return left;
+		auto right = this->check_branch(*match.on_right, *sum->right, scope);
+		if (!right) return right;
+		if ((*left)->to_string() != (*right)->to_string()) {
+			return std::unexpected(TypeError{ErrorCode::BranchMismatch, &match, {}, std::move(*left), std::move(*right)});
+		}
+		return left;
+	}
+
+	// A case branch is a function taking `domain`; yields its codomain.
+	CheckResult check_branch(const Term& branch, const Type& domain, const ScopeFrame* scope) {
+		auto type = this->check(branch, scope);
+		if (!type) return type;
+		const auto* function = dynamic_cast<const FunctionType*>(type->get());
+		if (function == nullptr) return std::unexpected(TypeError{ErrorCode::NotAFunction, &branch, {}, nullptr, std::move(*type)});
+		if (function->domain->to_string() != domain.to_string()) {
+			return std::unexpected(TypeError{ErrorCode::DomainMismatch, &branch, {}, function->domain->clone(), domain.clone()});
+		}
+		return function->codomain->clone();
+	}
+
+	// Definitions are closed and checked once, by whichever task gets there
+	// first; a failing one is not cached, as checking stops there anyway.
+	CheckResult check_definition(const Definition& definition) {
+		{
+			std::lock_guard lock(this->definitions_mutex);
+			if (const auto it = this->definitions.find(&definition); it != this->definitions.end()) return it->second->clone();
+		}
+		auto type = try_type_check(*definition.body);
+		if (!type) return type;
+		std::lock_guard lock(this->definitions_mutex);
+		this->definitions.try_emplace(&definition, (*type)->clone());
+		return type;
+	}
+};
+
+}
+
+std::expected<unique_ptr<Type>, TypeError> parallel_type_check(const Term& term, WorkStealingPool& pool, const TypingContext& context, std::size_t threshold) {
+	TIMELINE_SPAN("parallel_type_check");
+	std::unordered_set<const Term*> forks;
+	if (pool.size() > 1) (void)mark_forks(term, std::max<std::size_t>(threshold, 1), forks);
+	ParallelChecker checker(context, pool, std::move(forks));
+	return checker.check(term, nullptr);
+}
@@ -0,0 +1,34 @@
+//
+// ParallelTypeCheck.h
+//
+// Type checking spread over a WorkStealingPool. A sizing pass first picks
+// the applications whose function and argument are both at least
+// `threshold` nodes; at each of them the argument is checked as a forked
+// task while the function is checked in place. Smaller subterms are checked
+// sequentially, so the fork overhead is only paid where it can be won back.
+//
+// Checking only reads the term and the context. Binders are kept in an
+// immutable chain of scope frames on the stack, so a forked task shares its
+// parent's scope without copying or locking it.
+//
+
+#ifndef PARALLELTYPECHECK_H
+#define PARALLELTYPECHECK_H
+
+#include "Diagnostics.h"
+#include "WorkStealingPool.h"
+
+#include <cstddef>
+
+inline constexpr std::size_t default_fork_threshold = 1 << 12;
+
+// Same result as try_type_check, including which error is reported when the
+// term has several.
+[[nodiscard]] std::expected<std::unique_ptr<Type>, TypeError> parallel_type_check(
+	const Term& term,
+	WorkStealingPool& pool,
+	const TypingContext& context = TypingContext(),
+	std::size_t threshold = default_fork_threshold
+);
+
+#endif //PARALLELTYPECHECK_H
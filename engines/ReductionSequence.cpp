@@ -0,0 +1,14 @@
+//
+// ReductionSequence.cpp
+//
+
+#include "ReductionSequence.h"
+
+Generator<ReductionStep> reduction_sequence(std::unique_ptr<Term> term) {
+	for (std::size_t index = 0;; ++index) {
+		const bool normal = term->is_normal();
+		co_yield ReductionStep{index, *term, normal};
+		if (normal) co_return;
+		term = ::beta_reduce(std::move(term));
+	}
+}
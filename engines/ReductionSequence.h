@@ -0,0 +1,31 @@
+//
+// ReductionSequence.h
+//
+// Lazy view of a normal-order reduction: each step is computed only when the
+// consumer asks for it. The yielded references point at the coroutine's
+// current term and stay valid until the next step, so streaming a long
+// reduction costs no copies. Dropping the generator stops the reduction.
+//
+
+#ifndef REDUCTIONSEQUENCE_H
+#define REDUCTIONSEQUENCE_H
+
+#include "Generator.h"
+#include "../models/Terms.h"
+
+#include <cstddef>
+#include <memory>
+
+struct ReductionStep {
+	// 0 for the input term.
+	std::size_t index;
+	const Term& term;
+	// True on the last step, whose term is the normal form.
+	bool normal;
+};
+
+// Yields the input, then the result of every step up to the normal form.
+// Never finishes for terms without one.
+[[nodiscard]] Generator<ReductionStep> reduction_sequence(std::unique_ptr<Term> term);
+
+#endif //REDUCTIONSEQUENCE_H
@@ -0,0 +1,301 @@
+//
+// ReductionTrace.cpp
+//
+
+#include "ReductionTrace.h"
+
+#include "../models/lambda.h"
+
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+
+using std::unique_ptr; using std::make_unique;
+
+namespace {
+
+constexpr std::string_view trace_magic = "LTRC";
+constexpr char trace_version = 1;
+
+enum RecordTag : char { LabelRecord = 'L', DefinitionRecord = 'D', TermRecord = 'T', StepRecord = 'S' };
+
+unique_ptr<Term>& follow_path(unique_ptr<Term>& root, const std::vector<bool>& path) {
+	unique_ptr<Term>* current = &root;
+	std::size_t taken = 0;
+	for (;;) {
+		if (auto* abstraction = dynamic_cast<Abstraction*>(current->get())) {
+			current = &abstraction->body;
+		} else if (auto* injection = dynamic_cast<Injection*>(current->get())) {
+			current = &injection->value;
+		} else if (auto* projection = dynamic_cast<Projection*>(current->get()); projection && !(taken == path.size() && projection->is_redex())) {
+			current = &projection->operand;
+		} else if (auto* application = dynamic_cast<Application*>(current->get()); application && taken < path.size()) {
+			current = path[taken++] ? &application->value : &application->function;
+		} else if (auto* pair = dynamic_cast<Pair*>(current->get()); pair && taken < path.size()) {
+			current = path[taken++] ? &pair->second : &pair->first;
+		} else if (auto* match = dynamic_cast<Case*>(current->get()); match && taken < path.size()) {
+			if (!path[taken++]) {
+				current = &match->scrutinee;
+			} else if (taken < path.size()) {
+				current = path[taken++] ? &match->on_right : &match->on_left;
+			} else {
+				throw TraceFormatError("path " + path_to_string(path) + " ends inside a case");
+			}
+		} else if (taken == path.size()) {
+			return *current;
+		} else {
+			throw TraceFormatError("path " + path_to_string(path) + " leaves the term");
+		}
+	}
+}
+
+std::optional<TraceStep> describe_redex(const Term& redex) {
+	if (const auto* application = dynamic_cast<const Application*>(&redex)) {
+		if (const auto* function = dynamic_cast<const Abstraction*>(application->function.get())) {
+			return TraceStep{RedexRule::Beta, {}, function->var_name, alpha_hash(*application->value)};
+		}
+		if (is_delta_redex(*application)) return TraceStep{RedexRule::Delta, {}, {}, 0};
+	} else if (const auto* let = dynamic_cast<const Let*>(&redex)) {
+		return TraceStep{RedexRule::Let, {}, let->var_name, alpha_hash(*let->bound)};
+	} else if (const auto* reference = dynamic_cast<const Reference*>(&redex)) {
+		return TraceStep{RedexRule::Unfold, {}, reference->definition->name, 0};
+	} else if (const auto* projection = dynamic_cast<const Projection*>(&redex); projection && projection->is_redex()) {
+		return TraceStep{RedexRule::Projection, {}, {}, 0};
+	} else if (const auto* match = dynamic_cast<const Case*>(&redex); match && match->is_redex()) {
+		return TraceStep{RedexRule::Case, {}, {}, 0};
+	}
+	return std::nullopt;
+}
+
+bool has_binder(RedexRule rule) {
+	return rule == RedexRule::Beta || rule == RedexRule::Let || rule == RedexRule::Unfold;
+}
+
+bool has_argument(RedexRule rule) {
+	return rule == RedexRule::Beta || rule == RedexRule::Let;
+}
+
+}
+
+unique_ptr<Term>& find_redex(unique_ptr<Term>& root, std::vector<bool>& path) {
+	unique_ptr<Term>* current = &root;
+	for (;;) {
+		if (auto* abstraction = dynamic_cast<Abstraction*>(current->get())) {
+			current = &abstraction->body;
+		} else if (auto* application = dynamic_cast<Application*>(current->get())) {
+			if (dynamic_cast<const Abstraction*>(application->function.get()) || is_delta_redex(*application)) return *current;
+			const bool into_value = application->function->is_normal();
+			path.push_back(into_value);
+			current = into_value ? &application->value : &application->function;
+		} else if (auto* pair = dynamic_cast<Pair*>(current->get())) {
+			const bool into_second = pair->first->is_normal();
+			path.push_back(into_second);
+			current = into_second ? &pair->second : &pair->first;
+		} else if (auto* projection = dynamic_cast<Projection*>(current->get())) {
+			if (projection->is_redex()) return *current;
+			current = &projection->operand;
+		} else if (auto* injection = dynamic_cast<Injection*>(current->get())) {
+			current = &injection->value;
+		} else if (auto* match = dynamic_cast<Case*>(current->get())) {
+			if (match->is_redex()) return *current;
+			const bool into_branch = match->scrutinee->is_normal();
+			path.push_back(into_branch);
+			if (!into_branch) {
+				current = &match->scrutinee;
+				continue;
+			}
+			const bool into_right = match->on_left->is_normal();
+			path.push_back(into_right);
+			current = into_right ? &match->on_right : &match->on_left;
+		} else {
+			return *current;
+		}
+	}
+}
+
+const char* redex_rule_name(RedexRule rule) {
+	switch (rule) {
+		case RedexRule::Beta: return "beta";
+		case RedexRule::Delta: return "delta";
+		case RedexRule::Let: return "let";
+		case RedexRule::Unfold: return "unfold";
+		case RedexRule::Projection: return "projection";
+		case RedexRule::Case: return "case";
+	}
+	return "?";
+}
+
+std::string path_to_string(const std::vector<bool>& path) {
+	if (path.empty()) return "root";
+	std::string text;
+	text.reserve(path.size());
+	for (const bool into_value : path) text.push_back(into_value ? 'a' : 'f');
+	return text;
+}
+
+TraceRecorder::TraceRecorder(std::string label) {
+	if (label.empty()) return;
+	this->encoder.bytes().push_back(LabelRecord);
+	put_string(this->encoder.bytes(), label);
+}
+
+void TraceRecorder::begin(const Term& term) {
+	this->write_definitions(term);
+	this->encoder.bytes().push_back(TermRecord);
+	this->encoder.term(term);
+}
+
+unique_ptr<Term> TraceRecorder::step(unique_ptr<Term> term) {
+	std::vector<bool> path;
+	auto& slot = find_redex(term, path);
+	auto step = describe_redex(*slot);
+	// Not a redex, so the term is normal; beta_reduce throws with it.
+	if (!step) return ::beta_reduce(std::move(term));
+	slot = ::beta_reduce(std::move(slot));
+
+	auto& out = this->encoder.bytes();
+	out.push_back(StepRecord);
+	out.push_back(static_cast<char>(step->rule));
+	put_varint(out, path.size());
+	for (std::size_t i = 0; i < path.size(); i += 8) {
+		std::uint8_t packed = 0;
+		for (std::size_t bit = 0; bit < 8 && i + bit < path.size(); ++bit) packed |= path[i + bit] << bit;
+		out.push_back(static_cast<char>(packed));
+	}
+	if (has_binder(step->rule)) this->encoder.name(step->binder);
+	if (has_argument(step->rule)) put_u64(out, step->argument);
+	++this->step_count;
+	return term;
+}
+
+// Emits a record for every definition `term` refers to, dependencies first,
+// so the term and any later unfold can refer to them by id.
+void TraceRecorder::write_definitions(const Term& term) {
+	if (const auto* abstraction = dynamic_cast<const Abstraction*>(&term)) {
+		this->write_definitions(*abstraction->body);
+	} else if (const auto* application = dynamic_cast<const Application*>(&term)) {
+		this->write_definitions(*application->function);
+		this->write_definitions(*application->value);
+	} else if (const auto* let = dynamic_cast<const Let*>(&term)) {
+		this->write_definitions(*let->bound);
+		this->write_definitions(*let->body);
+	} else if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+		this->write_definitions(*pair->first);
+		this->write_definitions(*pair->second);
+	} else if (const auto* projection = dynamic_cast<const Projection*>(&term)) {
+		this->write_definitions(*projection->operand);
+	} else if (const auto* injection = dynamic_cast<const Injection*>(&term)) {
+		this->write_definitions(*injection->value);
+	} else if (const auto* match = dynamic_cast<const Case*>(&term)) {
+		this->write_definitions(*match->scrutinee);
+		this->write_definitions(*match->on_left);
+		this->write_definitions(*match->on_right);
+	} else if (const auto* reference = dynamic_cast<const Reference*>(&term)) {
+		const auto& definition = *reference->definition;
+		if (this->encoder.defined(definition)) return;
+		this->write_definitions(*definition.body);
+		(void)this->encoder.define(definition);
+		this->encoder.bytes().push_back(DefinitionRecord);
+		this->encoder.name(definition.name);
+		this->encoder.term(*definition.body);
+	}
+}
+
+TraceFile::TraceFile(const std::filesystem::path& path):
+	out(path, std::ios::binary | std::ios::app)
+{
+	if (!this->out) throw std::runtime_error("cannot open trace file " + path.string());
+	std::error_code error;
+	if (std::filesystem::file_size(path, error) == 0 && !error) {
+		write_trace_header(this->out);
+		this->out.flush();
+	}
+}
+
+void TraceFile::append(const TraceRecorder& recorder) {
+	this->append(recorder.bytes());
+}
+
+void TraceFile::append(std::string_view trace) {
+	std::string prefix;
+	put_varint(prefix, trace.size());
+	std::lock_guard lock(this->mutex);
+	this->out << prefix << trace;
+	this->out.flush();
+}
+
+void write_trace_header(std::ostream& out) {
+	out << trace_magic << trace_version;
+}
+
+void write_trace(std::ostream& out, const TraceRecorder& recorder) {
+	std::string prefix;
+	put_varint(prefix, recorder.bytes().size());
+	out << prefix << recorder.bytes();
+}
+
+std::vector<ReductionTrace> read_traces(std::istream& in) {
+	const std::string data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+	ByteReader file(data);
+	if (file.bytes(trace_magic.size()) != trace_magic) throw TraceFormatError("not a trace file");
+	if (file.byte() != trace_version) throw TraceFormatError("unsupported version");
+
+	std::vector<ReductionTrace> traces;
+	while (!file.at_end()) {
+		TermDecoder decoder(file.bytes(file.varint()));
+		auto& input = decoder.reader();
+		auto& trace = traces.emplace_back();
+		while (!input.at_end()) {
+			switch (input.byte()) {
+				case LabelRecord:
+					trace.label = input.bytes(input.varint());
+					break;
+				case DefinitionRecord: {
+					auto name = decoder.name();
+					decoder.define(std::make_shared<const Definition>(std::move(name), decoder.term()));
+					break;
+				}
+				case TermRecord:
+					trace.initial = decoder.term();
+					break;
+				case StepRecord: {
+					TraceStep step{static_cast<RedexRule>(input.byte())};
+					if (step.rule > RedexRule::Case) throw TraceFormatError("unknown redex rule");
+					step.path.resize(input.varint());
+					for (std::size_t i = 0; i < step.path.size(); i += 8) {
+						const auto packed = input.byte();
+						for (std::size_t bit = 0; bit < 8 && i + bit < step.path.size(); ++bit) step.path[i + bit] = (packed >> bit) & 1;
+					}
+					if (has_binder(step.rule)) step.binder = decoder.name();
+					if (has_argument(step.rule)) step.argument = input.u64();
+					trace.steps.push_back(std::move(step));
+					break;
+				}
+				default:
+					throw TraceFormatError("unknown record");
+			}
+		}
+		if (!trace.initial) throw TraceFormatError("trace without an initial term");
+	}
+	return traces;
+}
+
+unique_ptr<Term> ReductionTrace::apply(unique_ptr<Term> term, std::size_t index) const {
+	const auto& expected = this->steps.at(index);
+	auto& slot = follow_path(term, expected.path);
+	const auto found = describe_redex(*slot);
+	if (!found || found->rule != expected.rule || found->binder != expected.binder || found->argument != expected.argument) {
+		throw TraceFormatError("step " + std::to_string(index) + " does not match the term it is replayed on");
+	}
+	slot = ::beta_reduce(std::move(slot));
+	return term;
+}
+
+unique_ptr<Term> ReductionTrace::term_at(std::size_t count) const {
+	if (count > this->steps.size()) throw std::out_of_range("trace has only " + std::to_string(this->steps.size()) + " steps");
+	auto term = this->initial->clone();
+	for (std::size_t i = 0; i < count; ++i) term = this->apply(std::move(term), i);
+	return term;
+}
@@ -0,0 +1,121 @@
+//
+// ReductionTrace.h
+//
+// Compact binary log of a reduction. The initial term is stored once. After
+// that, each step is stored only as a delta: the path to the contracted
+// redex, the binder it eliminated and a hash of the substituted argument.
+// A step takes a few bytes instead of a full term, and any intermediate
+// term can be rebuilt offline by replaying the deltas (see tools/trace.cpp).
+//
+// File layout: the magic "LTRC", a version byte, then whole traces. Each
+// trace is a varint byte length followed by its records. Traces are
+// self-contained, so a file only ever grows by appending.
+//
+
+#ifndef REDUCTIONTRACE_H
+#define REDUCTIONTRACE_H
+
+#include "../models/Terms.h"
+#include "../models/Definitions.h"
+#include "../models/TermCodec.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class RedexRule : std::uint8_t { Beta, Delta, Let, Unfold, Projection, Case };
+
+[[nodiscard]] const char* redex_rule_name(RedexRule rule);
+
+struct TraceStep {
+	RedexRule rule;
+	// One entry per Application or Pair passed on the way down from the
+	// root: false for its function or first component, true for its argument
+	// or second. A Case takes false for its scrutinee, or true and then one
+	// more entry for its left or right branch. Abstraction, Projection and
+	// Injection are entered without an entry, since they have a single child.
+	std::vector<bool> path;
+	// Variable bound by a Beta or Let redex, or the definition unfolded;
+	// empty for the other rules.
+	std::string binder;
+	// alpha_hash of the substituted argument for Beta and Let, otherwise 0.
+	std::uint64_t argument = 0;
+};
+
+// Slot of the next normal-order redex in `root`, appending the way there to
+// `path`. Takes the same branch as the beta_reduce_in_place overrides, but
+// calls is_normal only on the functions it passes. On a normal form, it
+// stops at a leaf.
+[[nodiscard]] std::unique_ptr<Term>& find_redex(std::unique_ptr<Term>& root, std::vector<bool>& path);
+
+// Renders a path as 'f'/'a' per Application, or "root".
+[[nodiscard]] std::string path_to_string(const std::vector<bool>& path);
+
+// Records one reduction into memory. Pass it through ResourcePolicy::trace
+// and evaluate() records every step it takes.
+class TraceRecorder {
+public:
+	explicit TraceRecorder(std::string label = {});
+
+	void begin(const Term& term);
+	// Takes one normal-order step, identical to ::beta_reduce, and logs it.
+	// Like ::beta_reduce it consumes a normal form and throws, so callers
+	// check is_normal() first, as evaluate() does.
+	[[nodiscard]] std::unique_ptr<Term> step(std::unique_ptr<Term> term);
+
+	[[nodiscard]] std::size_t steps() const { return this->step_count; }
+	// The encoded trace, without its length prefix.
+	[[nodiscard]] const std::string& bytes() const { return this->encoder.bytes(); }
+
+private:
+	TermEncoder encoder;
+	std::size_t step_count = 0;
+
+	void write_definitions(const Term& term);
+};
+
+// Append-only trace file. Each whole trace is written under a lock and then
+// flushed, so concurrent evaluations never interleave and a crash can only
+// lose traces that were not finished yet.
+class TraceFile {
+public:
+	explicit TraceFile(const std::filesystem::path& path);
+
+	void append(const TraceRecorder& recorder);
+	// Appends a trace encoded elsewhere, such as in a worker process.
+	void append(std::string_view trace);
+
+private:
+	std::mutex mutex;
+	std::ofstream out;
+};
+
+class ReductionTrace {
+public:
+	std::string label;
+	std::unique_ptr<Term> initial;
+	std::vector<TraceStep> steps;
+
+	// Applies step `index` to `term`, the term reached after the steps
+	// before it. Throws TraceFormatError if the redex found at the recorded
+	// path does not match the step.
+	[[nodiscard]] std::unique_ptr<Term> apply(std::unique_ptr<Term> term, std::size_t index) const;
+	// The term after the first `count` steps.
+	[[nodiscard]] std::unique_ptr<Term> term_at(std::size_t count) const;
+};
+
+// Writes the file header that TraceFile writes to a new file.
+void write_trace_header(std::ostream& out);
+// Writes one length-prefixed trace.
+void write_trace(std::ostream& out, const TraceRecorder& recorder);
+// Reads every trace in a file written by TraceFile.
+[[nodiscard]] std::vector<ReductionTrace> read_traces(std::istream& in);
+
+#endif //REDUCTIONTRACE_H
@@ -0,0 +1,109 @@
+//
+// WorkStealingPool.cpp
+//
+
+#include "WorkStealingPool.h"
+#include "../models/Timeline.h"
+
+#include <algorithm>
+#include <string>
+
+namespace {
+
+// The pool and queue the current thread works from, if it is a worker.
+thread_local const WorkStealingPool* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+
+}
+
+WorkStealingPool::WorkStealingPool(std::size_t threads) {
+	const auto count = std::max<std::size_t>(threads, 1);
+	for (std::size_t i = 0; i < count; ++i) this->queues.push_back(std::make_unique<Queue>());
+	this->threads.reserve(count - 1);
+	for (std::size_t i = 1; i < count; ++i) this->threads.emplace_back([this, i] { this->work(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+	{
+		std::lock_guard lock(this->sleep_mutex);
+		this->stopping = true;
+	}
+	this->wake.notify_all();
+	this->threads.clear();
+}
+
+std::size_t WorkStealingPool::own_queue() const {
+	return current_pool == this ? current_queue : 0;
+}
+
+void WorkStealingPool::fork(Task& task) {
+	auto& queue = *this->queues[this->own_queue()];
+	{
+		std::lock_guard lock(queue.mutex);
+		queue.tasks.push_back(&task);
+	}
+	this->queued.fetch_add(1, std::memory_order_release);
+	if (!this->threads.empty()) {
+		// Taking the lock orders this against a worker about to sleep.
+		{ std::lock_guard lock(this->sleep_mutex); }
+		this->wake.notify_one();
+	}
+}
+
+void WorkStealingPool::join(Task& task) {
+	const auto queue = this->own_queue();
+	while (!task.done()) {
+		if (auto* next = this->take(queue)) {
+			execute(*next);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	if (task.error) std::rethrow_exception(task.error);
+}
+
+// Newest task of `queue` first, then the oldest task of any other queue.
+WorkStealingPool::Task* WorkStealingPool::take(std::size_t queue) {
+	if (this->queued.load(std::memory_order_acquire) == 0) return nullptr;
+	for (std::size_t i = 0; i < this->queues.size(); ++i) {
+		auto& victim = *this->queues[(queue + i) % this->queues.size()];
+		std::lock_guard lock(victim.mutex);
+		if (victim.tasks.empty()) continue;
+		Task* task;
+		if (i == 0) {
+			task = victim.tasks.back();
+			victim.tasks.pop_back();
+		} else {
+			task = victim.tasks.front();
+			victim.tasks.pop_front();
+		}
+		this->queued.fetch_sub(1, std::memory_order_relaxed);
+		return task;
+	}
+	return nullptr;
+}
+
+void WorkStealingPool::execute(Task& task) {
+	TIMELINE_SPAN("task");
+	try {
+		task.body();
+	} catch (...) {
+		task.error = std::current_exception();
+	}
+	task.finished.store(true, std::memory_order_release);
+}
+
+void WorkStealingPool::work(std::size_t queue) {
+	current_pool = this;
+	current_queue = queue;
+	TIMELINE_THREAD("worker " + std::to_string(queue));
+	while (true) {
+		if (auto* task = this->take(queue)) {
+			execute(*task);
+			continue;
+		}
+		std::unique_lock lock(this->sleep_mutex);
+		this->wake.wait(lock, [this] { return this->stopping || this->queued.load(std::memory_order_acquire) != 0; });
+		if (this->stopping) return;
+	}
+}
@@ -0,0 +1,78 @@
+//
+// WorkStealingPool.h
+//
+// Fork-join thread pool. Every worker owns a deque: it pushes and pops its
+// own tasks at the back, and idle workers steal from the front of the
+// others'. Threads outside the pool share one extra deque. A thread waiting
+// in join() keeps running queued tasks, so nested fork-join never leaves a
+// worker blocked while there is work.
+//
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+	class Task {
+	public:
+		explicit Task(std::function<void()> body): body(std::move(body)) {}
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		[[nodiscard]] bool done() const { return this->finished.load(std::memory_order_acquire); }
+
+	private:
+		friend class WorkStealingPool;
+		std::function<void()> body;
+		std::exception_ptr error;
+		std::atomic<bool> finished{false};
+	};
+
+	// `threads` includes the thread that forks and joins, so a pool of one
+	// runs every task inline.
+	explicit WorkStealingPool(std::size_t threads = std::thread::hardware_concurrency());
+	~WorkStealingPool();
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	[[nodiscard]] std::size_t size() const { return this->threads.size() + 1; }
+
+	// Offers `task` to other threads. It must stay alive until join(task)
+	// returns.
+	void fork(Task& task);
+	// Returns once `task` has run, running it or other tasks meanwhile.
+	// Rethrows whatever the task threw.
+	void join(Task& task);
+
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task*> tasks;
+	};
+
+	// queues[0] is shared by threads outside the pool.
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::jthread> threads;
+	std::atomic<std::size_t> queued{0};
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+	bool stopping = false;
+
+	[[nodiscard]] std::size_t own_queue() const;
+	[[nodiscard]] Task* take(std::size_t queue);
+	static void execute(Task& task);
+	void work(std::size_t queue);
+};
+
+#endif //WORKSTEALINGPOOL_H
@@ -6,7 +6,14 @@
 #include "Exceptions.h"
 
 const char* ReductionOnNormalForm::what() const noexcept {
-	return fullMessage.c_str();
+	try {
+		std::call_once(this->message->built, [this] {
+			this->message->text = "Reduction on normal form: " + this->message->term->to_string();
+		});
+	} catch (...) {
+		return "Reduction on normal form";
+	}
+	return this->message->text.c_str();
 }
 
 const char* UndeclaredVariableError::what() const noexcept {
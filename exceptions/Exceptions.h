@@ -7,23 +7,37 @@
 #ifndef EXCEPTIONS_H
 #define EXCEPTIONS_H
 #include "../models/Terms.h"
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <sstream>
 
+// The message includes the whole term, so it is only built if what() is
+// called; throwing keeps just the term. Pass a term the thrower owns by
+// rvalue, so it is moved in rather than copied.
 class ReductionOnNormalForm final : public std::runtime_error {
 private:
-    std::string fullMessage;
+    struct LazyMessage {
+        std::unique_ptr<Term> term;
+        std::once_flag built;
+        std::string text;
+    };
+    std::shared_ptr<LazyMessage> message;
 public:
     explicit ReductionOnNormalForm(const std::unique_ptr<Term> &term):
-        std::runtime_error("")
-    {
-        std::stringstream ss;
-        ss << "Reduction on normal form: " << term->to_string();
-        fullMessage = ss.str();
-    }
+        std::runtime_error(""),
+        message(std::make_shared<LazyMessage>(term->clone()))
+    {}
+    explicit ReductionOnNormalForm(std::unique_ptr<Term>&& term):
+        std::runtime_error(""),
+        message(std::make_shared<LazyMessage>(std::move(term)))
+    {}
 
     [[nodiscard]] const char* what() const noexcept override;
+    // The term that could not be reduced; after a consuming step, the only
+    // copy left.
+    [[nodiscard]] const Term& term() const { return *this->message->term; }
 };
 
 class UndeclaredVariableError final : public std::runtime_error {
@@ -41,6 +55,33 @@ public:
     [[nodiscard]] const char* what() const noexcept override;
 };
 
+class DuplicateDefinitionError final : public std::runtime_error {
+public:
+    explicit DuplicateDefinitionError(const std::string& name)
+        : std::runtime_error("Duplicate definition: '" + name + "'") {}
+};
+
+class ParseError final : public std::runtime_error {
+public:
+    std::size_t position;
+
+    explicit ParseError(const std::string& message, std::size_t position)
+        : std::runtime_error("Parse error at " + std::to_string(position) + ": " + message),
+          position(position) {}
+};
+
+class TermFormatError : public std::runtime_error {
+public:
+    explicit TermFormatError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+class TraceFormatError final : public TermFormatError {
+public:
+    explicit TraceFormatError(const std::string& message)
+        : TermFormatError("Malformed reduction trace: " + message) {}
+};
+
 class TypeMismatchError : public std::runtime_error {
 public:
     explicit TypeMismatchError(const std::string& message)
@@ -61,4 +102,22 @@ public:
         : TypeMismatchError("Type mismatch: expecting domain '" + expected + "', got '" + actual + "'") {}
 };
 
+class NotAProductError final : public TypeMismatchError {
+public:
+    explicit NotAProductError(const std::string& typeName)
+        : TypeMismatchError("Type error: '" + typeName + "' is not a product.") {}
+};
+
+class NotASumError final : public TypeMismatchError {
+public:
+    explicit NotASumError(const std::string& typeName)
+        : TypeMismatchError("Type error: '" + typeName + "' is not a sum.") {}
+};
+
+class BranchTypeMismatchError final : public TypeMismatchError {
+public:
+    explicit BranchTypeMismatchError(const std::string& left, const std::string& right)
+        : TypeMismatchError("Type mismatch: case branches return '" + left + "' and '" + right + "'") {}
+};
+
 #endif //EXCEPTIONS_H
\ No newline at end of file
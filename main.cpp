@@ -1,41 +1,173 @@
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <optional>
 #include <iostream>
-#include "models/lambda.h"
-
-int main() {
-    std::cout << "Hello, World!" << std::endl;
-    auto s_term = std::make_unique<Abstraction>(
-    std::make_unique<Variable>("x"),
-    std::make_unique<Abstraction>(
-        std::make_unique<Variable>("y"),
-        std::make_unique<Abstraction>(
-            std::make_unique<Variable>("z"),
-            std::make_unique<Application>(
-                std::make_unique<Application>(
-                    std::make_unique<Variable>("x"),
-                    std::make_unique<Variable>("z")),
-                std::make_unique<Application>(
-                    std::make_unique<Variable>("y"),
-                    std::make_unique<Variable>("z"))
-            ))));
-
-    // Identity combinator
-    auto i_combinator_a = std::make_unique<Abstraction>(std::make_unique<Variable>("a"), std::make_unique<Variable>("a"));
-    auto i_combinator_b = std::make_unique<Abstraction>(std::make_unique<Variable>("b"), std::make_unique<Variable>("b"));
-
-    // ((S I) I)
-    auto test_term = std::make_unique<Application>(
-        std::make_unique<Application>(std::move(s_term), std::move(i_combinator_a)),
-        std::move(i_combinator_b));
-
-    // The self-applying function
-    auto body = std::make_unique<Application>(std::make_unique<Variable>("x"), std::make_unique<Variable>("x"));
-    auto omega_body = std::make_unique<Abstraction>(std::make_unique<Variable>("x"), std::move(body));
-
-    // The full omega term
-    auto omega = std::make_unique<Application>(
-        std::move(omega_body->clone()),
-        std::move(omega_body));
-
-    std::cout << *test_term << std::endl << *omega << std::endl;
-    return 0;
-}
\ No newline at end of file
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "pipeline/BatchPipeline.h"
+#include "models/MemoryProfile.h"
+#include "models/Timeline.h"
+
+namespace {
+
+void usage() {
+    std::cerr << "usage: lambda [-j workers] [--queue capacity] [--max-steps n] [--max-nodes n] [--max-bytes n]\n"
+                 "              [--timeout-ms n] [--detect-cycles] [--trust-types] [--types] [--strict]\n"
+                 "              [--processes n] [--worker-memory bytes] [--eta] [--trace file] [--cache file]\n"
+                 "              [--cache-max-bytes n] [--memory-report] [--timeline file] [--quiet]\n"
+                 "              [file...]\n"
+                 "Normalizes one term per line of each file, or of stdin when no file is given.\n";
+}
+
+bool parse_count(const char* text, std::size_t& value) {
+    const std::string_view digits(text);
+    const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+    return error == std::errc() && end == digits.data() + digits.size();
+}
+
+BatchPipeline* running = nullptr;
+
+extern "C" void interrupt(int) {
+    if (running != nullptr) running->cancel();
+}
+
+}
+
+int main(int argc, char** argv) {
+    BatchOptions options;
+    options.workers = std::max(1u, std::thread::hardware_concurrency());
+    bool quiet = false;
+    bool memory_report = false;
+    std::string timeline_path;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        const bool has_value = i + 1 < argc;
+        if ((arg == "-j" || arg == "--workers") && has_value) {
+            if (!parse_count(argv[++i], options.workers)) return usage(), 2;
+        } else if (arg == "--processes" && has_value) {
+            if (!parse_count(argv[++i], options.processes)) return usage(), 2;
+        } else if (arg == "--worker-memory" && has_value) {
+            if (!parse_count(argv[++i], options.worker_memory)) return usage(), 2;
+        } else if (arg == "--queue" && has_value) {
+            if (!parse_count(argv[++i], options.queue_capacity)) return usage(), 2;
+        } else if (arg == "--max-steps" && has_value) {
+            if (!parse_count(argv[++i], options.max_steps)) return usage(), 2;
+        } else if (arg == "--max-nodes" && has_value) {
+            if (!parse_count(argv[++i], options.max_nodes)) return usage(), 2;
+        } else if (arg == "--max-bytes" && has_value) {
+            if (!parse_count(argv[++i], options.max_bytes)) return usage(), 2;
+        } else if (arg == "--timeout-ms" && has_value) {
+            std::size_t milliseconds = 0;
+            if (!parse_count(argv[++i], milliseconds)) return usage(), 2;
+            options.timeout = std::chrono::milliseconds(milliseconds);
+        } else if (arg == "--detect-cycles") {
+            options.detect_cycles = true;
+        } else if (arg == "--trust-types") {
+            options.trust_types = true;
+        } else if (arg == "--eta") {
+            options.eta = true;
+        } else if (arg == "--trace" && has_value) {
+            options.trace_path = argv[++i];
+        } else if (arg == "--cache" && has_value) {
+            options.cache_path = argv[++i];
+        } else if (arg == "--cache-max-bytes" && has_value) {
+            if (!parse_count(argv[++i], options.cache_max_bytes)) return usage(), 2;
+        } else if (arg == "--types") {
+            options.show_types = true;
+        } else if (arg == "--strict") {
+            options.strict = true;
+        } else if (arg == "--memory-report") {
+            memory_report = true;
+        } else if (arg == "--timeline" && has_value) {
+            timeline_path = argv[++i];
+        } else if (arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "-h" || arg == "--help") {
+            usage();
+            return 0;
+        } else if (arg.starts_with('-') && arg != "-") {
+            usage();
+            return 2;
+        } else {
+            files.emplace_back(arg);
+        }
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::optional<AllocationTracker> tracker;
+    if (memory_report) tracker.emplace();
+    if (!timeline_path.empty()) {
+        Timeline::name_thread("main");
+        Timeline::start();
+    }
+    // Opening the trace or cache file can fail.
+    std::optional<BatchPipeline> pipeline;
+    try {
+        pipeline.emplace(options);
+    } catch (const std::exception& error) {
+        std::cerr << "lambda: " << error.what() << '\n';
+        return 1;
+    }
+    running = &*pipeline;
+    std::signal(SIGINT, interrupt);
+    BatchStats total;
+    const auto accumulate = [&total](const BatchStats& stats) {
+        total.terms += stats.terms;
+        total.failures += stats.failures;
+        total.exhausted += stats.exhausted;
+        total.steps += stats.steps;
+        total.cache_hits += stats.cache_hits;
+        total.worker_restarts += stats.worker_restarts;
+        total.eta.reductions += stats.eta.reductions;
+        total.eta.nodes_before += stats.eta.nodes_before;
+        total.eta.nodes_after += stats.eta.nodes_after;
+        total.seconds += stats.seconds;
+    };
+
+    if (files.empty()) files.emplace_back("-");
+    for (const auto& file : files) {
+        if (file == "-") {
+            accumulate(pipeline->run(std::cin, std::cout));
+            continue;
+        }
+        std::ifstream input(file);
+        if (!input) {
+            std::cerr << "lambda: cannot open " << file << ": " << std::strerror(errno) << '\n';
+            return 1;
+        }
+        accumulate(pipeline->run(input, std::cout));
+    }
+
+    if (!quiet) {
+        std::fprintf(stderr, "%zu terms (%zu failed, %zu out of resources), %zu steps in %.3f s: %.0f terms/s, %.0f steps/s\n",
+            total.terms, total.failures, total.exhausted, total.steps, total.seconds,
+            total.terms_per_second(), total.steps_per_second());
+        if (total.worker_restarts != 0) std::fprintf(stderr, "workers: %zu restarted\n", total.worker_restarts);
+        if (!options.cache_path.empty()) std::fprintf(stderr, "cache: %zu of %zu terms answered\n", total.cache_hits, total.terms);
+        if (options.eta) {
+            std::fprintf(stderr, "eta: %zu contractions, %zu -> %zu nodes (%td saved)\n",
+                total.eta.reductions, total.eta.nodes_before, total.eta.nodes_after, total.eta.nodes_saved());
+        }
+    }
+    if (tracker) std::cerr << tracker->stats().to_json() << '\n';
+    if (!timeline_path.empty()) {
+        Timeline::stop();
+        std::ofstream timeline(timeline_path);
+        if (!timeline) {
+            std::cerr << "lambda: cannot open " << timeline_path << ": " << std::strerror(errno) << '\n';
+            return 1;
+        }
+        Timeline::write_json(timeline);
+    }
+    return total.failures == 0 ? 0 : 1;
+}
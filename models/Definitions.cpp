@@ -0,0 +1,50 @@
+//
+// Definitions.cpp
+//
+
+#include "Definitions.h"
+
+#include "TermTape.h"
+#include "terms/Reference.h"
+#include "../exceptions/Exceptions.h"
+
+const Type& Definition::type() const {
+    std::call_once(this->checked, [this] {
+        const TypingContext empty;
+        this->cached_type = this->body->type_check(empty);
+    });
+    return *this->cached_type;
+}
+
+Definitions::Definitions() = default;
+Definitions::~Definitions() = default;
+
+std::shared_ptr<const Definition> Definitions::define(std::string name, std::unique_ptr<Term> body) {
+    if (this->table.contains(name)) throw DuplicateDefinitionError(name);
+
+    const TermTape tape(*body);
+    for (const auto& node : tape.nodes()) {
+        if (node.kind == TermKind::Variable && node.left == TermTape::npos) {
+            throw UndeclaredVariableError(tape.names()[node.name]);
+        }
+    }
+
+    auto definition = std::make_shared<const Definition>(name, std::move(body));
+    this->table.emplace(std::move(name), definition);
+    return definition;
+}
+
+std::shared_ptr<const Definition> Definitions::lookup(const std::string& name) const {
+    if (const auto it = this->table.find(name); it != this->table.end()) return it->second;
+    return nullptr;
+}
+
+std::unique_ptr<Reference> Definitions::reference(const std::string& name) const {
+    auto definition = this->lookup(name);
+    if (definition == nullptr) throw UndeclaredVariableError(name);
+    return std::make_unique<Reference>(std::move(definition));
+}
+
+std::size_t Definitions::size() const {
+    return this->table.size();
+}
@@ -0,0 +1,56 @@
+//
+// Definitions.h
+//
+// Global table of named, closed top-level definitions. Terms refer to a
+// definition through a Reference node instead of inlining its body, and the
+// body is only copied in when a reducer reaches that reference.
+//
+
+#ifndef DEFINITIONS_H
+#define DEFINITIONS_H
+
+#include "Terms.h"
+#include "Type.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class Reference;
+
+class Definition {
+public:
+    const std::string name;
+    const std::unique_ptr<const Term> body;
+
+    explicit Definition(std::string name, std::unique_ptr<const Term> body):
+        name(std::move(name)),
+        body(std::move(body))
+    {};
+
+    // Type of the body in the empty context. Checked on first use only;
+    // later calls return the cached result.
+    [[nodiscard]] const Type& type() const;
+
+private:
+    mutable std::once_flag checked;
+    mutable std::unique_ptr<Type> cached_type;
+};
+
+class Definitions {
+private:
+    std::map<std::string, std::shared_ptr<const Definition>, std::less<>> table;
+public:
+    Definitions();
+    ~Definitions();
+
+    // Bodies must be closed; they may use references to earlier definitions,
+    // so the table can never contain a cycle.
+    std::shared_ptr<const Definition> define(std::string name, std::unique_ptr<Term> body);
+    [[nodiscard]] std::shared_ptr<const Definition> lookup(const std::string& name) const;
+    [[nodiscard]] std::unique_ptr<Reference> reference(const std::string& name) const;
+    [[nodiscard]] std::size_t size() const;
+};
+
+#endif //DEFINITIONS_H
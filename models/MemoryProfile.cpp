@@ -0,0 +1,288 @@
+//
+// MemoryProfile.cpp
+//
+
+#include "MemoryProfile.h"
+
+#include "terms/Variable.h"
+#include "terms/Abstraction.h"
+#include "terms/Application.h"
+#include "terms/Literal.h"
+#include "terms/Primitive.h"
+#include "terms/Let.h"
+#include "terms/Reference.h"
+#include "terms/Pair.h"
+#include "terms/Projection.h"
+#include "terms/Injection.h"
+#include "terms/Case.h"
+
+#include <atomic>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const char* const TERM_KIND_NAMES[] = {"Variable", "Abstraction", "Application", "Literal", "Primitive", "Let", "Reference", "Pair", "Projection", "Injection", "Case"};
+
+class Profiler {
+public:
+	MemoryProfile profile;
+
+	// First pass: usage, plus a structural hash and size for every subtree.
+	std::uint64_t walk(const Term& term, std::size_t& size) {
+		std::uint64_t hash;
+		size = 1;
+		if (const auto* var = dynamic_cast<const Variable*>(&term)) {
+			this->count(TermKind::Variable, sizeof(Variable));
+			this->name(var->name);
+			this->type(var->get_type());
+			hash = hash_mix(1, hash_name(var->name));
+		} else if (const auto* abs = dynamic_cast<const Abstraction*>(&term)) {
+			this->count(TermKind::Abstraction, sizeof(Abstraction));
+			this->name(abs->var_name);
+			this->type(*abs->var_type);
+			std::size_t body_size;
+			hash = hash_mix(hash_mix(2, hash_name(abs->var_name)), this->walk(*abs->body, body_size));
+			size += body_size;
+		} else if (const auto* app = dynamic_cast<const Application*>(&term)) {
+			this->count(TermKind::Application, sizeof(Application));
+			std::size_t function_size, value_size;
+			const auto function_hash = this->walk(*app->function, function_size);
+			hash = hash_mix(hash_mix(3, function_hash), this->walk(*app->value, value_size));
+			size += function_size + value_size;
+		} else if (const auto* literal = dynamic_cast<const Literal*>(&term)) {
+			this->count(TermKind::Literal, sizeof(Literal));
+			hash = hash_mix(hash_mix(4, static_cast<std::uint64_t>(literal->kind)), literal->value);
+		} else if (const auto* prim = dynamic_cast<const Primitive*>(&term)) {
+			this->count(TermKind::Primitive, sizeof(Primitive));
+			if (prim->branch_type) this->type(*prim->branch_type);
+			hash = hash_mix(5, static_cast<std::uint64_t>(prim->op));
+		} else if (const auto* let = dynamic_cast<const Let*>(&term)) {
+			this->count(TermKind::Let, sizeof(Let));
+			this->name(let->var_name);
+			std::size_t bound_size, body_size;
+			const auto bound_hash = this->walk(*let->bound, bound_size);
+			hash = hash_mix(hash_mix(hash_mix(6, hash_name(let->var_name)), bound_hash), this->walk(*let->body, body_size));
+			size += bound_size + body_size;
+		} else if (const auto* ref = dynamic_cast<const Reference*>(&term)) {
+			// The definition body is shared, so it is not part of this term.
+			this->count(TermKind::Reference, sizeof(Reference));
+			hash = hash_mix(7, hash_name(ref->definition->name));
+		} else if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+			this->count(TermKind::Pair, sizeof(Pair));
+			std::size_t first_size, second_size;
+			const auto first_hash = this->walk(*pair->first, first_size);
+			hash = hash_mix(hash_mix(8, first_hash), this->walk(*pair->second, second_size));
+			size += first_size + second_size;
+		} else if (const auto* projection = dynamic_cast<const Projection*>(&term)) {
+			this->count(TermKind::Projection, sizeof(Projection));
+			std::size_t operand_size;
+			hash = hash_mix(hash_mix(9, static_cast<std::uint64_t>(projection->component)), this->walk(*projection->operand, operand_size));
+			size += operand_size;
+		} else if (const auto* injection = dynamic_cast<const Injection*>(&term)) {
+			this->count(TermKind::Injection, sizeof(Injection));
+			this->type(*injection->sum_type);
+			std::size_t value_size;
+			hash = hash_mix(hash_mix(10, static_cast<std::uint64_t>(injection->side)), this->walk(*injection->value, value_size));
+			size += value_size;
+		} else if (const auto* match = dynamic_cast<const Case*>(&term)) {
+			this->count(TermKind::Case, sizeof(Case));
+			std::size_t scrutinee_size, left_size, right_size;
+			const auto scrutinee_hash = this->walk(*match->scrutinee, scrutinee_size);
+			const auto left_hash = this->walk(*match->on_left, left_size);
+			hash = hash_mix(hash_mix(hash_mix(11, scrutinee_hash), left_hash), this->walk(*match->on_right, right_size));
+			size += scrutinee_size + left_size + right_size;
+		} else {
+			hash = 0;
+		}
+		this->subtrees.push_back({&term, hash, size});
+		++this->occurrences[hash];
+		return hash;
+	}
+
+	// Second pass, top down: a subtree whose hash was already met is a
+	// duplicate and its own subtrees are not looked at again.
+	void find_duplicates() {
+		std::unordered_map<const Term*, const Subtree*> by_node;
+		for (const auto& subtree : this->subtrees) by_node.emplace(subtree.term, &subtree);
+		std::unordered_map<std::uint64_t, bool> seen;
+		std::vector<const Term*> stack{this->subtrees.back().term};
+		while (!stack.empty()) {
+			const auto* term = stack.back();
+			stack.pop_back();
+			const auto& subtree = *by_node.at(term);
+			if (subtree.size > 1 && this->occurrences[subtree.hash] > 1 && !seen.emplace(subtree.hash, true).second) {
+				++this->profile.duplicate_subtrees;
+				this->profile.duplicate_nodes += subtree.size;
+				continue;
+			}
+			if (const auto* abs = dynamic_cast<const Abstraction*>(term)) {
+				stack.push_back(abs->body.get());
+			} else if (const auto* app = dynamic_cast<const Application*>(term)) {
+				stack.push_back(app->value.get());
+				stack.push_back(app->function.get());
+			} else if (const auto* let = dynamic_cast<const Let*>(term)) {
+				stack.push_back(let->body.get());
+				stack.push_back(let->bound.get());
+			} else if (const auto* pair = dynamic_cast<const Pair*>(term)) {
+				stack.push_back(pair->second.get());
+				stack.push_back(pair->first.get());
+			} else if (const auto* projection = dynamic_cast<const Projection*>(term)) {
+				stack.push_back(projection->operand.get());
+			} else if (const auto* injection = dynamic_cast<const Injection*>(term)) {
+				stack.push_back(injection->value.get());
+			} else if (const auto* match = dynamic_cast<const Case*>(term)) {
+				stack.push_back(match->on_right.get());
+				stack.push_back(match->on_left.get());
+				stack.push_back(match->scrutinee.get());
+			}
+		}
+	}
+
+private:
+	struct Subtree {
+		const Term* term;
+		std::uint64_t hash;
+		std::size_t size;
+	};
+	std::vector<Subtree> subtrees;
+	std::unordered_map<std::uint64_t, std::size_t> occurrences;
+
+	void count(TermKind kind, std::size_t bytes) {
+		auto& usage = this->profile.terms[static_cast<std::size_t>(kind)];
+		++usage.count;
+		usage.bytes += bytes;
+	}
+
+	void name(const std::string& text) {
+		++this->profile.names;
+		this->profile.name_chars += text.size();
+		this->profile.name_heap_bytes += heap_bytes(text);
+	}
+
+	void type(const Type& type) {
+		if (const auto* base = dynamic_cast<const BaseType*>(&type)) {
+			++this->profile.base_types.count;
+			this->profile.base_types.bytes += sizeof(BaseType);
+			this->name(base->name);
+		} else if (const auto* function = dynamic_cast<const FunctionType*>(&type)) {
+			++this->profile.function_types.count;
+			this->profile.function_types.bytes += sizeof(FunctionType);
+			this->type(*function->domain);
+			this->type(*function->codomain);
+		} else if (const auto* product = dynamic_cast<const ProductType*>(&type)) {
+			++this->profile.product_types.count;
+			this->profile.product_types.bytes += sizeof(ProductType);
+			this->type(*product->first);
+			this->type(*product->second);
+		} else if (const auto* sum = dynamic_cast<const SumType*>(&type)) {
+			++this->profile.sum_types.count;
+			this->profile.sum_types.bytes += sizeof(SumType);
+			this->type(*sum->left);
+			this->type(*sum->right);
+		}
+	}
+};
+
+std::atomic<bool> tracking = false;
+std::atomic<std::size_t> allocations = 0;
+std::atomic<std::size_t> deallocations = 0;
+std::atomic<std::int64_t> live_nodes = 0;
+std::atomic<std::int64_t> live_bytes = 0;
+std::atomic<std::int64_t> peak_nodes = 0;
+std::atomic<std::int64_t> peak_bytes = 0;
+
+void raise(std::atomic<std::int64_t>& peak, std::int64_t value) {
+	auto current = peak.load(std::memory_order_relaxed);
+	while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+}
+
+std::size_t MemoryProfile::term_nodes() const {
+	std::size_t total = 0;
+	for (const auto& usage : this->terms) total += usage.count;
+	return total;
+}
+
+std::size_t MemoryProfile::total_bytes() const {
+	std::size_t total = this->base_types.bytes + this->function_types.bytes + this->product_types.bytes + this->sum_types.bytes
+		+ this->name_heap_bytes;
+	for (const auto& usage : this->terms) total += usage.bytes;
+	return total;
+}
+
+std::string MemoryProfile::to_json() const {
+	std::ostringstream out;
+	out << "{\"terms\":{";
+	for (std::size_t i = 0; i < this->terms.size(); ++i) {
+		if (i != 0) out << ',';
+		out << '"' << TERM_KIND_NAMES[i] << "\":{\"count\":" << this->terms[i].count << ",\"bytes\":" << this->terms[i].bytes << '}';
+	}
+	out << "},\"types\":{"
+		<< "\"Base\":{\"count\":" << this->base_types.count << ",\"bytes\":" << this->base_types.bytes << "},"
+		<< "\"Function\":{\"count\":" << this->function_types.count << ",\"bytes\":" << this->function_types.bytes << "},"
+		<< "\"Product\":{\"count\":" << this->product_types.count << ",\"bytes\":" << this->product_types.bytes << "},"
+		<< "\"Sum\":{\"count\":" << this->sum_types.count << ",\"bytes\":" << this->sum_types.bytes << "}},"
+		<< "\"names\":{\"count\":" << this->names << ",\"chars\":" << this->name_chars << ",\"heap_bytes\":" << this->name_heap_bytes << "},"
+		<< "\"duplicates\":{\"subtrees\":" << this->duplicate_subtrees << ",\"nodes\":" << this->duplicate_nodes << "},"
+		<< "\"term_nodes\":" << this->term_nodes() << ",\"total_bytes\":" << this->total_bytes() << '}';
+	return out.str();
+}
+
+MemoryProfile profile_memory(const Term& term) {
+	Profiler profiler;
+	std::size_t size;
+	(void)profiler.walk(term, size);
+	profiler.find_duplicates();
+	return profiler.profile;
+}
+
+std::string AllocationStats::to_json() const {
+	std::ostringstream out;
+	out << "{\"allocations\":" << this->allocations << ",\"deallocations\":" << this->deallocations
+		<< ",\"live_nodes\":" << this->live_nodes << ",\"live_bytes\":" << this->live_bytes
+		<< ",\"peak_nodes\":" << this->peak_nodes << ",\"peak_bytes\":" << this->peak_bytes << '}';
+	return out.str();
+}
+
+AllocationTracker::AllocationTracker() {
+	allocations = 0;
+	deallocations = 0;
+	live_nodes = 0;
+	live_bytes = 0;
+	peak_nodes = 0;
+	peak_bytes = 0;
+	tracking.store(true, std::memory_order_release);
+}
+
+AllocationTracker::~AllocationTracker() {
+	tracking.store(false, std::memory_order_release);
+}
+
+AllocationStats AllocationTracker::stats() const {
+	return {
+		.allocations = allocations.load(),
+		.deallocations = deallocations.load(),
+		.live_nodes = live_nodes.load(),
+		.live_bytes = live_bytes.load(),
+		.peak_nodes = peak_nodes.load(),
+		.peak_bytes = peak_bytes.load(),
+	};
+}
+
+void record_term_allocation(std::size_t bytes) {
+	if (!tracking.load(std::memory_order_relaxed)) return;
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	raise(peak_nodes, live_nodes.fetch_add(1, std::memory_order_relaxed) + 1);
+	const auto size = static_cast<std::int64_t>(bytes);
+	raise(peak_bytes, live_bytes.fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+void record_term_deallocation(std::size_t bytes) {
+	if (!tracking.load(std::memory_order_relaxed)) return;
+	deallocations.fetch_add(1, std::memory_order_relaxed);
+	live_nodes.fetch_sub(1, std::memory_order_relaxed);
+	live_bytes.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+}
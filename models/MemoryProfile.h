@@ -0,0 +1,82 @@
+//
+// MemoryProfile.h
+//
+// Memory accounting for terms. profile_memory() walks one term and breaks
+// its footprint down by node kind, type annotations and name strings. It
+// also finds duplicated subtrees. AllocationTracker counts every Term
+// allocation through Term's class-level operator new/delete, which gives
+// live-node high-water marks over a whole reduction.
+//
+
+#ifndef MEMORYPROFILE_H
+#define MEMORYPROFILE_H
+
+#include "Terms.h"
+#include "TaggedTerm.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct KindUsage {
+	std::size_t count = 0;
+	std::size_t bytes = 0;
+};
+
+struct MemoryProfile {
+	// Indexed by TermKind; bytes are sizeof the node class.
+	std::array<KindUsage, static_cast<std::size_t>(TermKind::Case) + 1> terms{};
+	// Annotation types owned by variables, binders, if and injections.
+	KindUsage base_types;
+	KindUsage function_types;
+	KindUsage product_types;
+	KindUsage sum_types;
+	// Variable, binder and base type names: count, characters, and bytes
+	// allocated outside the small-string buffer.
+	std::size_t names = 0;
+	std::size_t name_chars = 0;
+	std::size_t name_heap_bytes = 0;
+	// Subtrees that structurally repeat an earlier one, counted at the
+	// largest repeat only, and the nodes that sharing them would save.
+	std::size_t duplicate_subtrees = 0;
+	std::size_t duplicate_nodes = 0;
+
+	[[nodiscard]] std::size_t term_nodes() const;
+	[[nodiscard]] std::size_t total_bytes() const;
+	[[nodiscard]] std::string to_json() const;
+};
+
+[[nodiscard]] MemoryProfile profile_memory(const Term& term);
+
+struct AllocationStats {
+	std::size_t allocations = 0;
+	std::size_t deallocations = 0;
+	// Relative to when tracking started, so freeing older nodes can make
+	// them negative.
+	std::int64_t live_nodes = 0;
+	std::int64_t live_bytes = 0;
+	std::int64_t peak_nodes = 0;
+	std::int64_t peak_bytes = 0;
+
+	[[nodiscard]] std::string to_json() const;
+};
+
+// Counts Term allocations on all threads while it is alive. When no tracker
+// is alive the hooks cost one relaxed load per allocation. Trackers do not
+// nest.
+class AllocationTracker {
+public:
+	AllocationTracker();
+	~AllocationTracker();
+	AllocationTracker(const AllocationTracker&) = delete;
+	AllocationTracker& operator=(const AllocationTracker&) = delete;
+
+	[[nodiscard]] AllocationStats stats() const;
+};
+
+// Called by Term::operator new/delete.
+void record_term_allocation(std::size_t bytes);
+void record_term_deallocation(std::size_t bytes);
+
+#endif //MEMORYPROFILE_H
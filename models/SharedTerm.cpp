@@ -0,0 +1,475 @@
+//
+// SharedTerm.cpp
+//
+
+#include "SharedTerm.h"
+
+#include "terms/Variable.h"
+#include "terms/Abstraction.h"
+#include "terms/Application.h"
+#include "terms/Let.h"
+#include "terms/Reference.h"
+#include "terms/Pair.h"
+#include "terms/Case.h"
+#include "../exceptions/Exceptions.h"
+
+#include <array>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+using std::unique_ptr, std::make_unique;
+
+namespace {
+
+std::uint64_t name_bit(std::string_view name) {
+	return std::uint64_t(1) << (hash_name(name) & 63);
+}
+
+bool is_delta_redex(const SharedTerm& term) {
+	// Unwind at most three applications (the largest arity) to the head.
+	std::array<const SharedTerm*, 3> args{};
+	const SharedTerm* node = &term;
+	std::size_t count = 0;
+	while (node->kind() == TermKind::Application) {
+		if (count == args.size()) return false;
+		args[count++] = node->right().get();
+		node = node->left().get();
+	}
+	if (node->kind() != TermKind::Primitive || count == 0) return false;
+	const auto op = node->op();
+	if (primitive_arity(op) != count) return false;
+
+	for (std::size_t i = 0; i < count; ++i) {
+		LiteralKind expected;
+		if (!primitive_strict_in(op, i, expected)) continue;
+		// args were collected outermost first.
+		const SharedTerm* arg = args[count - 1 - i];
+		if (arg->kind() != TermKind::Literal || arg->literal().kind != expected) return false;
+	}
+	return true;
+}
+
+SharedTermPtr delta_reduce(const SharedTerm& term) {
+	const auto& inner = *term.left();
+	if (inner.left()->kind() == TermKind::Primitive) {
+		const auto [kind, value] = evaluate_primitive(inner.left()->op(), inner.right()->literal().value, term.right()->literal().value);
+		return SharedTerm::literal(kind, value);
+	}
+	// ((if c) t) e
+	const auto& condition = *inner.left()->right();
+	return condition.literal().value ? inner.right() : term.right();
+}
+
+std::shared_ptr<const Type> share_type(const Type& type) {
+	return std::shared_ptr<const Type>(type.clone());
+}
+
+// Renames `binder` in `body` to a name free in neither `body` nor `newValue`,
+// as Term::substitute does before it would capture.
+std::string fresh_name(const std::string& binder, const SharedTerm& body, const SharedTerm& newValue) {
+	auto fresh = binder + "'";
+	while (has_free(newValue, fresh) || has_free(body, fresh)) fresh += "'";
+	return fresh;
+}
+
+}
+
+void SharedTermPtr::release(SharedTerm* node) noexcept {
+	if (node->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+	// Children whose last reference a dying node held are queued here rather
+	// than released recursively.
+	std::vector<SharedTerm*> doomed;
+	while (true) {
+		for (auto* child : {node->first.detach(), node->second.detach(), node->third.detach()}) {
+			if (child != nullptr && child->references.fetch_sub(1, std::memory_order_acq_rel) == 1) doomed.push_back(child);
+		}
+		delete node;
+		if (doomed.empty()) return;
+		node = doomed.back();
+		doomed.pop_back();
+	}
+}
+
+SharedTermPtr SharedTerm::variable(std::string name, std::shared_ptr<const Type> type) {
+	SharedTermPtr term(new SharedTerm(TermKind::Variable));
+	auto& node = *term.node;
+	node.free_names = name_bit(name);
+	node.text = std::move(name);
+	node.annotation = std::move(type);
+	return term;
+}
+
+SharedTermPtr SharedTerm::abstraction(std::string var_name, std::shared_ptr<const Type> var_type, SharedTermPtr body) {
+	SharedTermPtr term(new SharedTerm(TermKind::Abstraction));
+	auto& node = *term.node;
+	node.normal = body->normal;
+	node.free_names = body->free_names;
+	node.binder_names = name_bit(var_name) | body->binder_names;
+	node.text = std::move(var_name);
+	node.annotation = std::move(var_type);
+	node.first = std::move(body);
+	return term;
+}
+
+SharedTermPtr SharedTerm::application(SharedTermPtr function, SharedTermPtr value) {
+	SharedTermPtr term(new SharedTerm(TermKind::Application));
+	auto& node = *term.node;
+	node.free_names = function->free_names | value->free_names;
+	node.binder_names = function->binder_names | value->binder_names;
+	const bool children_normal = function->normal && value->normal && function->kind() != TermKind::Abstraction;
+	node.first = std::move(function);
+	node.second = std::move(value);
+	node.normal = children_normal && !is_delta_redex(node);
+	return term;
+}
+
+SharedTermPtr SharedTerm::literal(LiteralKind kind, std::uint64_t value) {
+	SharedTermPtr term(new SharedTerm(TermKind::Literal));
+	term.node->literal_kind = kind;
+	term.node->value = value;
+	return term;
+}
+
+SharedTermPtr SharedTerm::primitive(PrimitiveOp op, std::shared_ptr<const Type> branch_type) {
+	SharedTermPtr term(new SharedTerm(TermKind::Primitive));
+	term.node->primitive_op = op;
+	term.node->annotation = std::move(branch_type);
+	return term;
+}
+
+SharedTermPtr SharedTerm::let(std::string var_name, SharedTermPtr bound, SharedTermPtr body) {
+	SharedTermPtr term(new SharedTerm(TermKind::Let));
+	auto& node = *term.node;
+	node.normal = false;
+	node.free_names = bound->free_names | body->free_names;
+	node.binder_names = name_bit(var_name) | bound->binder_names | body->binder_names;
+	node.text = std::move(var_name);
+	node.first = std::move(bound);
+	node.second = std::move(body);
+	return term;
+}
+
+SharedTermPtr SharedTerm::reference(std::shared_ptr<const Definition> definition) {
+	SharedTermPtr term(new SharedTerm(TermKind::Reference));
+	term.node->normal = false;
+	term.node->target = std::move(definition);
+	return term;
+}
+
+SharedTermPtr SharedTerm::pair(SharedTermPtr first, SharedTermPtr second) {
+	SharedTermPtr term(new SharedTerm(TermKind::Pair));
+	auto& node = *term.node;
+	node.normal = first->normal && second->normal;
+	node.free_names = first->free_names | second->free_names;
+	node.binder_names = first->binder_names | second->binder_names;
+	node.first = std::move(first);
+	node.second = std::move(second);
+	return term;
+}
+
+SharedTermPtr SharedTerm::projection(Component component, SharedTermPtr operand) {
+	SharedTermPtr term(new SharedTerm(TermKind::Projection));
+	auto& node = *term.node;
+	node.normal = operand->normal && operand->kind() != TermKind::Pair;
+	node.value = static_cast<std::uint64_t>(component);
+	node.free_names = operand->free_names;
+	node.binder_names = operand->binder_names;
+	node.first = std::move(operand);
+	return term;
+}
+
+SharedTermPtr SharedTerm::injection(Side side, std::shared_ptr<const Type> sum_type, SharedTermPtr value) {
+	SharedTermPtr term(new SharedTerm(TermKind::Injection));
+	auto& node = *term.node;
+	node.normal = value->normal;
+	node.value = static_cast<std::uint64_t>(side);
+	node.free_names = value->free_names;
+	node.binder_names = value->binder_names;
+	node.annotation = std::move(sum_type);
+	node.first = std::move(value);
+	return term;
+}
+
+SharedTermPtr SharedTerm::case_of(SharedTermPtr scrutinee, SharedTermPtr on_left, SharedTermPtr on_right) {
+	SharedTermPtr term(new SharedTerm(TermKind::Case));
+	auto& node = *term.node;
+	node.normal = scrutinee->normal && on_left->normal && on_right->normal && scrutinee->kind() != TermKind::Injection;
+	node.free_names = scrutinee->free_names | on_left->free_names | on_right->free_names;
+	node.binder_names = scrutinee->binder_names | on_left->binder_names | on_right->binder_names;
+	node.first = std::move(scrutinee);
+	node.second = std::move(on_left);
+	node.third = std::move(on_right);
+	return term;
+}
+
+std::string to_string(const SharedTerm& term) {
+	switch (term.kind()) {
+		case TermKind::Variable:
+			return term.name();
+		case TermKind::Abstraction:
+			return "λ" + term.name() + ". " + to_string(*term.left());
+		case TermKind::Application:
+			return "(" + to_string(*term.left()) + ") (" + to_string(*term.right()) + ")";
+		case TermKind::Literal: {
+			const auto literal = term.literal();
+			if (literal.kind == LiteralKind::Bool) return literal.value ? "true" : "false";
+			return std::to_string(literal.value);
+		}
+		case TermKind::Primitive:
+			return primitive_name(term.op());
+		case TermKind::Let:
+			return "let " + term.name() + " = " + to_string(*term.left()) + " in " + to_string(*term.right());
+		case TermKind::Reference:
+			return term.definition()->name;
+		case TermKind::Pair:
+			return "(" + to_string(*term.left()) + ", " + to_string(*term.right()) + ")";
+		case TermKind::Projection:
+			return std::string(component_name(term.component())) + " (" + to_string(*term.left()) + ")";
+		case TermKind::Injection:
+			return std::string(side_name(term.side())) + "[" + term.type()->to_string() + "] (" + to_string(*term.left()) + ")";
+		case TermKind::Case:
+			return "case (" + to_string(*term.left()) + ") (" + to_string(*term.right()) + ") (" + to_string(*term.last()) + ")";
+	}
+	return "";
+}
+
+bool has_free(const SharedTerm& term, std::string_view target) {
+	if ((term.free_mask() & name_bit(target)) == 0) return false;
+	switch (term.kind()) {
+		case TermKind::Variable:
+			return term.name() == target;
+		case TermKind::Abstraction:
+			return term.name() != target && has_free(*term.left(), target);
+		case TermKind::Application:
+			return has_free(*term.left(), target) || has_free(*term.right(), target);
+		case TermKind::Let:
+			return has_free(*term.left(), target) || (term.name() != target && has_free(*term.right(), target));
+		case TermKind::Pair:
+			return has_free(*term.left(), target) || has_free(*term.right(), target);
+		case TermKind::Projection:
+		case TermKind::Injection:
+			return has_free(*term.left(), target);
+		case TermKind::Case:
+			return has_free(*term.left(), target) || has_free(*term.right(), target) || has_free(*term.last(), target);
+		case TermKind::Literal:
+		case TermKind::Primitive:
+		case TermKind::Reference:
+			return false;
+	}
+	return false;
+}
+
+SharedTermPtr substitute(const SharedTermPtr& term, const std::string& target, const SharedTermPtr& newValue) {
+	// Nothing to replace and nothing to rename: Term::substitute would return
+	// a structural copy.
+	if ((term->free_mask() & name_bit(target)) == 0 && (term->binder_mask() & newValue->free_mask()) == 0) return term;
+
+	switch (term->kind()) {
+		case TermKind::Variable:
+			return term->name() == target ? newValue : term;
+		case TermKind::Abstraction: {
+			if (term->name() == target) return term;
+			const auto& body = term->left();
+			if (has_free(*newValue, term->name())) {
+				auto fresh = fresh_name(term->name(), *body, *newValue);
+				const auto fresh_var = SharedTerm::variable(fresh, term->type());
+				// Like Term::alpha_convert followed by substitute on the result.
+				const auto renamed = SharedTerm::abstraction(std::move(fresh), term->type(), substitute(body, term->name(), fresh_var));
+				return substitute(renamed, target, newValue);
+			}
+			auto new_body = substitute(body, target, newValue);
+			if (new_body == body) return term;
+			return SharedTerm::abstraction(term->name(), term->type(), std::move(new_body));
+		}
+		case TermKind::Application: {
+			auto function = substitute(term->left(), target, newValue);
+			auto value = substitute(term->right(), target, newValue);
+			if (function == term->left() && value == term->right()) return term;
+			return SharedTerm::application(std::move(function), std::move(value));
+		}
+		case TermKind::Let: {
+			auto bound = substitute(term->left(), target, newValue);
+			const auto& body = term->right();
+			if (term->name() == target) {
+				if (bound == term->left()) return term;
+				return SharedTerm::let(term->name(), std::move(bound), body);
+			}
+			if (has_free(*newValue, term->name())) {
+				auto fresh = fresh_name(term->name(), *body, *newValue);
+				const auto fresh_var = SharedTerm::variable(fresh, std::make_shared<const BaseType>("τ"));
+				auto renamed_body = substitute(body, term->name(), fresh_var);
+				return SharedTerm::let(std::move(fresh), std::move(bound), substitute(renamed_body, target, newValue));
+			}
+			auto new_body = substitute(body, target, newValue);
+			if (bound == term->left() && new_body == body) return term;
+			return SharedTerm::let(term->name(), std::move(bound), std::move(new_body));
+		}
+		case TermKind::Pair: {
+			auto first = substitute(term->left(), target, newValue);
+			auto second = substitute(term->right(), target, newValue);
+			if (first == term->left() && second == term->right()) return term;
+			return SharedTerm::pair(std::move(first), std::move(second));
+		}
+		case TermKind::Projection: {
+			auto operand = substitute(term->left(), target, newValue);
+			if (operand == term->left()) return term;
+			return SharedTerm::projection(term->component(), std::move(operand));
+		}
+		case TermKind::Injection: {
+			auto value = substitute(term->left(), target, newValue);
+			if (value == term->left()) return term;
+			return SharedTerm::injection(term->side(), term->type(), std::move(value));
+		}
+		case TermKind::Case: {
+			auto scrutinee = substitute(term->left(), target, newValue);
+			auto on_left = substitute(term->right(), target, newValue);
+			auto on_right = substitute(term->last(), target, newValue);
+			if (scrutinee == term->left() && on_left == term->right() && on_right == term->last()) return term;
+			return SharedTerm::case_of(std::move(scrutinee), std::move(on_left), std::move(on_right));
+		}
+		case TermKind::Literal:
+		case TermKind::Primitive:
+		case TermKind::Reference:
+			return term;
+	}
+	return term;
+}
+
+SharedTermPtr beta_reduce(const SharedTermPtr& term) {
+	switch (term->kind()) {
+		case TermKind::Variable:
+		case TermKind::Literal:
+		case TermKind::Primitive:
+			break;
+		case TermKind::Abstraction:
+			if (term->is_normal()) break;
+			return SharedTerm::abstraction(term->name(), term->type(), beta_reduce(term->left()));
+		case TermKind::Application: {
+			const auto& function = term->left();
+			const auto& value = term->right();
+			if (function->kind() == TermKind::Abstraction) return substitute(function->left(), function->name(), value);
+			if (is_delta_redex(*term)) return delta_reduce(*term);
+			if (!function->is_normal()) return SharedTerm::application(beta_reduce(function), value);
+			if (!value->is_normal()) return SharedTerm::application(function, beta_reduce(value));
+			break;
+		}
+		case TermKind::Let:
+			return substitute(term->right(), term->name(), term->left());
+		case TermKind::Reference:
+			return to_shared(*term->definition()->body);
+		case TermKind::Pair:
+			if (!term->left()->is_normal()) return SharedTerm::pair(beta_reduce(term->left()), term->right());
+			if (!term->right()->is_normal()) return SharedTerm::pair(term->left(), beta_reduce(term->right()));
+			break;
+		case TermKind::Projection: {
+			const auto& operand = term->left();
+			if (operand->kind() == TermKind::Pair) return term->component() == Component::First ? operand->left() : operand->right();
+			if (!operand->is_normal()) return SharedTerm::projection(term->component(), beta_reduce(operand));
+			break;
+		}
+		case TermKind::Injection:
+			if (term->is_normal()) break;
+			return SharedTerm::injection(term->side(), term->type(), beta_reduce(term->left()));
+		case TermKind::Case: {
+			const auto& scrutinee = term->left();
+			if (scrutinee->kind() == TermKind::Injection) {
+				return SharedTerm::application(scrutinee->side() == Side::Left ? term->right() : term->last(), scrutinee->left());
+			}
+			if (!scrutinee->is_normal()) return SharedTerm::case_of(beta_reduce(scrutinee), term->right(), term->last());
+			if (!term->right()->is_normal()) return SharedTerm::case_of(scrutinee, beta_reduce(term->right()), term->last());
+			if (!term->last()->is_normal()) return SharedTerm::case_of(scrutinee, term->right(), beta_reduce(term->last()));
+			break;
+		}
+	}
+	throw ReductionOnNormalForm(from_shared(*term));
+}
+
+SharedTermPtr normalize(SharedTermPtr term, std::size_t& steps) {
+	while (!term->is_normal()) {
+		term = beta_reduce(term);
+		++steps;
+	}
+	return term;
+}
+
+std::size_t distinct_nodes(const SharedTerm& term) {
+	std::unordered_set<const SharedTerm*> seen;
+	std::vector<const SharedTerm*> pending{&term};
+	while (!pending.empty()) {
+		const auto* node = pending.back();
+		pending.pop_back();
+		if (!seen.insert(node).second) continue;
+		if (node->left()) pending.push_back(node->left().get());
+		if (node->right()) pending.push_back(node->right().get());
+		if (node->last()) pending.push_back(node->last().get());
+	}
+	return seen.size();
+}
+
+SharedTermPtr to_shared(const Term& term) {
+	if (const auto* var = dynamic_cast<const Variable*>(&term)) {
+		return SharedTerm::variable(var->name, share_type(var->get_type()));
+	}
+	if (const auto* abs = dynamic_cast<const Abstraction*>(&term)) {
+		return SharedTerm::abstraction(abs->var_name, share_type(*abs->var_type), to_shared(*abs->body));
+	}
+	if (const auto* app = dynamic_cast<const Application*>(&term)) {
+		return SharedTerm::application(to_shared(*app->function), to_shared(*app->value));
+	}
+	if (const auto* literal = dynamic_cast<const Literal*>(&term)) {
+		return SharedTerm::literal(literal->kind, literal->value);
+	}
+	if (const auto* prim = dynamic_cast<const Primitive*>(&term)) {
+		return SharedTerm::primitive(prim->op, prim->branch_type ? share_type(*prim->branch_type) : nullptr);
+	}
+	if (const auto* let = dynamic_cast<const Let*>(&term)) {
+		return SharedTerm::let(let->var_name, to_shared(*let->bound), to_shared(*let->body));
+	}
+	if (const auto* ref = dynamic_cast<const Reference*>(&term)) {
+		return SharedTerm::reference(ref->definition);
+	}
+	if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+		return SharedTerm::pair(to_shared(*pair->first), to_shared(*pair->second));
+	}
+	if (const auto* projection = dynamic_cast<const Projection*>(&term)) {
+		return SharedTerm::projection(projection->component, to_shared(*projection->operand));
+	}
+	if (const auto* injection = dynamic_cast<const Injection*>(&term)) {
+		return SharedTerm::injection(injection->side, share_type(*injection->sum_type), to_shared(*injection->value));
+	}
+	if (const auto* match = dynamic_cast<const Case*>(&term)) {
+		return SharedTerm::case_of(to_shared(*match->scrutinee), to_shared(*match->on_left), to_shared(*match->on_right));
+	}
+	throw std::invalid_argument("Unsupported term '" + term.to_string() + "'");
+}
+
+unique_ptr<Term> from_shared(const SharedTerm& term) {
+	switch (term.kind()) {
+		case TermKind::Variable:
+			return make_unique<Variable>(term.name(), term.type()->clone());
+		case TermKind::Abstraction:
+			return make_unique<Abstraction>(term.type()->clone(), term.name(), from_shared(*term.left()));
+		case TermKind::Application:
+			return make_unique<Application>(from_shared(*term.left()), from_shared(*term.right()));
+		case TermKind::Literal: {
+			const auto literal = term.literal();
+			return make_unique<Literal>(literal.kind, literal.value);
+		}
+		case TermKind::Primitive:
+			return make_unique<Primitive>(term.op(), term.type() ? term.type()->clone() : nullptr);
+		case TermKind::Let:
+			return make_unique<Let>(term.name(), from_shared(*term.left()), from_shared(*term.right()));
+		case TermKind::Reference:
+			return make_unique<Reference>(term.definition());
+		case TermKind::Pair:
+			return make_unique<Pair>(from_shared(*term.left()), from_shared(*term.right()));
+		case TermKind::Projection:
+			return make_unique<Projection>(term.component(), from_shared(*term.left()));
+		case TermKind::Injection:
+			return make_unique<Injection>(term.side(), term.type()->clone(), from_shared(*term.left()));
+		case TermKind::Case:
+			return make_unique<Case>(from_shared(*term.left()), from_shared(*term.right()), from_shared(*term.last()));
+	}
+	return nullptr;
+}
@@ -0,0 +1,160 @@
+//
+// SharedTerm.h
+//
+// Immutable term nodes with intrusive reference counts. Copying a
+// SharedTermPtr is a counter increment, and rewrites hand back the original
+// node for every subtree they leave unchanged, so a reduction step only
+// allocates along the path to its redex. The operations below follow the
+// semantics of the corresponding Term methods exactly, binder renaming
+// included, so results print identically.
+//
+// Every node caches whether it is normal, and two 64-bit Bloom masks over
+// the names of its free variables and of its binders. Substitution returns
+// a subtree as it is whenever the masks prove that the target does not
+// occur free in it and that none of its binders would be renamed.
+//
+// Dropping the last reference never recurses, so arbitrarily deep terms can
+// be released without exhausting the stack.
+//
+
+#ifndef SHAREDTERM_H
+#define SHAREDTERM_H
+
+#include "Terms.h"
+#include "Type.h"
+#include "TaggedTerm.h"
+#include "Definitions.h"
+#include "terms/Literal.h"
+#include "terms/Primitive.h"
+#include "terms/Projection.h"
+#include "terms/Injection.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+class SharedTerm;
+
+class SharedTermPtr {
+public:
+	SharedTermPtr() = default;
+	SharedTermPtr(const SharedTermPtr& other) noexcept;
+	SharedTermPtr(SharedTermPtr&& other) noexcept: node(std::exchange(other.node, nullptr)) {}
+	SharedTermPtr& operator=(SharedTermPtr other) noexcept {
+		std::swap(this->node, other.node);
+		return *this;
+	}
+	~SharedTermPtr() { if (this->node != nullptr) release(this->node); }
+
+	[[nodiscard]] const SharedTerm& operator*() const { return *this->node; }
+	[[nodiscard]] const SharedTerm* operator->() const { return this->node; }
+	[[nodiscard]] const SharedTerm* get() const { return this->node; }
+	explicit operator bool() const { return this->node != nullptr; }
+	friend bool operator==(const SharedTermPtr& lhs, const SharedTermPtr& rhs) { return lhs.node == rhs.node; }
+
+	[[nodiscard]] std::size_t use_count() const;
+
+private:
+	friend class SharedTerm;
+
+	SharedTerm* node = nullptr;
+
+	// Adopts a node whose count already includes this reference.
+	explicit SharedTermPtr(SharedTerm* node) noexcept: node(node) {}
+	SharedTerm* detach() noexcept { return std::exchange(this->node, nullptr); }
+	static void release(SharedTerm* node) noexcept;
+};
+
+class SharedTerm {
+public:
+	[[nodiscard]] static SharedTermPtr variable(std::string name, std::shared_ptr<const Type> type);
+	[[nodiscard]] static SharedTermPtr abstraction(std::string var_name, std::shared_ptr<const Type> var_type, SharedTermPtr body);
+	[[nodiscard]] static SharedTermPtr application(SharedTermPtr function, SharedTermPtr value);
+	[[nodiscard]] static SharedTermPtr literal(LiteralKind kind, std::uint64_t value);
+	[[nodiscard]] static SharedTermPtr primitive(PrimitiveOp op, std::shared_ptr<const Type> branch_type = nullptr);
+	[[nodiscard]] static SharedTermPtr let(std::string var_name, SharedTermPtr bound, SharedTermPtr body);
+	[[nodiscard]] static SharedTermPtr reference(std::shared_ptr<const Definition> definition);
+	[[nodiscard]] static SharedTermPtr pair(SharedTermPtr first, SharedTermPtr second);
+	[[nodiscard]] static SharedTermPtr projection(Component component, SharedTermPtr operand);
+	[[nodiscard]] static SharedTermPtr injection(Side side, std::shared_ptr<const Type> sum_type, SharedTermPtr value);
+	[[nodiscard]] static SharedTermPtr case_of(SharedTermPtr scrutinee, SharedTermPtr on_left, SharedTermPtr on_right);
+
+	SharedTerm(const SharedTerm&) = delete;
+	SharedTerm& operator=(const SharedTerm&) = delete;
+
+	[[nodiscard]] TermKind kind() const { return this->term_kind; }
+	// Variable name, or the binder of an Abstraction or Let.
+	[[nodiscard]] const std::string& name() const { return this->text; }
+	// Variable annotation, binder type, the branch type of an If, or the sum
+	// type of an Injection.
+	[[nodiscard]] const std::shared_ptr<const Type>& type() const { return this->annotation; }
+	[[nodiscard]] LiteralValue literal() const { return {this->literal_kind, this->value}; }
+	[[nodiscard]] PrimitiveOp op() const { return this->primitive_op; }
+	[[nodiscard]] Component component() const { return static_cast<Component>(this->value); }
+	[[nodiscard]] Side side() const { return static_cast<Side>(this->value); }
+	// Abstraction body, Application function, Let bound term, first
+	// component of a Pair, Projection operand, Injection payload or Case
+	// scrutinee.
+	[[nodiscard]] const SharedTermPtr& left() const { return this->first; }
+	// Application value, Let body, second component of a Pair or the left
+	// branch of a Case.
+	[[nodiscard]] const SharedTermPtr& right() const { return this->second; }
+	// Right branch of a Case.
+	[[nodiscard]] const SharedTermPtr& last() const { return this->third; }
+	[[nodiscard]] const std::shared_ptr<const Definition>& definition() const { return this->target; }
+
+	[[nodiscard]] bool is_normal() const { return this->normal; }
+	// Supersets of the names free in the term and bound in it, one bit per
+	// name hash.
+	[[nodiscard]] std::uint64_t free_mask() const { return this->free_names; }
+	[[nodiscard]] std::uint64_t binder_mask() const { return this->binder_names; }
+
+private:
+	friend class SharedTermPtr;
+
+	mutable std::atomic<std::uint32_t> references{1};
+	TermKind term_kind;
+	bool normal = true;
+	LiteralKind literal_kind{};
+	PrimitiveOp primitive_op{};
+	std::uint64_t value = 0;
+	std::uint64_t free_names = 0;
+	std::uint64_t binder_names = 0;
+	std::string text;
+	std::shared_ptr<const Type> annotation;
+	SharedTermPtr first;
+	SharedTermPtr second;
+	SharedTermPtr third;
+	std::shared_ptr<const Definition> target;
+
+	explicit SharedTerm(TermKind kind): term_kind(kind) {}
+};
+
+inline SharedTermPtr::SharedTermPtr(const SharedTermPtr& other) noexcept:
+	node(other.node)
+{
+	if (this->node != nullptr) this->node->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline std::size_t SharedTermPtr::use_count() const {
+	return this->node != nullptr ? this->node->references.load(std::memory_order_relaxed) : 0;
+}
+
+[[nodiscard]] std::string to_string(const SharedTerm& term);
+[[nodiscard]] bool has_free(const SharedTerm& term, std::string_view target);
+[[nodiscard]] SharedTermPtr substitute(const SharedTermPtr& term, const std::string& target, const SharedTermPtr& newValue);
+// One normal-order step (β, δ, let, unfolding, projection or case); throws ReductionOnNormalForm like Term::beta_reduce.
+[[nodiscard]] SharedTermPtr beta_reduce(const SharedTermPtr& term);
+// Reduces to normal form without any limit, counting steps into `steps`.
+[[nodiscard]] SharedTermPtr normalize(SharedTermPtr term, std::size_t& steps);
+// Nodes reachable from `term`, each shared subtree counted once.
+[[nodiscard]] std::size_t distinct_nodes(const SharedTerm& term);
+
+[[nodiscard]] SharedTermPtr to_shared(const Term& term);
+[[nodiscard]] std::unique_ptr<Term> from_shared(const SharedTerm& term);
+
+#endif //SHAREDTERM_H
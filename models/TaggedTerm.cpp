@@ -0,0 +1,581 @@
+//
+// TaggedTerm.cpp
+//
+
+#include "TaggedTerm.h"
+
+#include "terms/Variable.h"
+#include "terms/Abstraction.h"
+#include "terms/Application.h"
+#include "terms/Literal.h"
+#include "terms/Primitive.h"
+#include "terms/Let.h"
+#include "terms/Reference.h"
+#include "terms/Pair.h"
+#include "terms/Case.h"
+#include "../exceptions/Exceptions.h"
+
+#include <array>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+using std::unique_ptr, std::make_unique;
+
+TaggedTermPtr make_variable(std::string name, TaggedTypePtr type) {
+	return make_unique<TaggedTerm>(TaggedTerm{VariableNode{std::move(name), std::move(type)}});
+}
+
+TaggedTermPtr make_abstraction(std::string var_name, TaggedTypePtr var_type, TaggedTermPtr body) {
+	return make_unique<TaggedTerm>(TaggedTerm{AbstractionNode{std::move(var_name), std::move(var_type), std::move(body)}});
+}
+
+TaggedTermPtr make_application(TaggedTermPtr function, TaggedTermPtr value) {
+	return make_unique<TaggedTerm>(TaggedTerm{ApplicationNode{std::move(function), std::move(value)}});
+}
+
+TaggedTermPtr make_literal(LiteralKind kind, std::uint64_t value) {
+	return make_unique<TaggedTerm>(TaggedTerm{LiteralNode{kind, value}});
+}
+
+TaggedTermPtr make_primitive(PrimitiveOp op, TaggedTypePtr branch_type) {
+	return make_unique<TaggedTerm>(TaggedTerm{PrimitiveNode{op, std::move(branch_type)}});
+}
+
+TaggedTermPtr make_let(std::string var_name, TaggedTermPtr bound, TaggedTermPtr body) {
+	return make_unique<TaggedTerm>(TaggedTerm{LetNode{std::move(var_name), std::move(bound), std::move(body)}});
+}
+
+TaggedTermPtr make_reference(std::shared_ptr<const Definition> definition) {
+	return make_unique<TaggedTerm>(TaggedTerm{ReferenceNode{std::move(definition)}});
+}
+
+TaggedTermPtr make_pair(TaggedTermPtr first, TaggedTermPtr second) {
+	return make_unique<TaggedTerm>(TaggedTerm{PairNode{std::move(first), std::move(second)}});
+}
+
+TaggedTermPtr make_projection(Component component, TaggedTermPtr operand) {
+	return make_unique<TaggedTerm>(TaggedTerm{ProjectionNode{component, std::move(operand)}});
+}
+
+TaggedTermPtr make_injection(Side side, TaggedTypePtr sum_type, TaggedTermPtr value) {
+	return make_unique<TaggedTerm>(TaggedTerm{InjectionNode{side, std::move(sum_type), std::move(value)}});
+}
+
+TaggedTermPtr make_case(TaggedTermPtr scrutinee, TaggedTermPtr on_left, TaggedTermPtr on_right) {
+	return make_unique<TaggedTerm>(TaggedTerm{CaseNode{std::move(scrutinee), std::move(on_left), std::move(on_right)}});
+}
+
+TaggedTermPtr clone(const TaggedTerm& term) {
+	switch (term.kind()) {
+		case TermKind::Variable: {
+			const auto& var = term.as<VariableNode>();
+			return make_variable(var.name, clone(*var.type));
+		}
+		case TermKind::Abstraction: {
+			const auto& abs = term.as<AbstractionNode>();
+			return make_abstraction(abs.var_name, clone(*abs.var_type), clone(*abs.body));
+		}
+		case TermKind::Application: {
+			const auto& app = term.as<ApplicationNode>();
+			return make_application(clone(*app.function), clone(*app.value));
+		}
+		case TermKind::Literal: {
+			const auto& literal = term.as<LiteralNode>();
+			return make_literal(literal.kind, literal.value);
+		}
+		case TermKind::Primitive: {
+			const auto& prim = term.as<PrimitiveNode>();
+			return make_primitive(prim.op, prim.branch_type ? clone(*prim.branch_type) : nullptr);
+		}
+		case TermKind::Let: {
+			const auto& let = term.as<LetNode>();
+			return make_let(let.var_name, clone(*let.bound), clone(*let.body));
+		}
+		case TermKind::Reference:
+			return make_reference(term.as<ReferenceNode>().definition);
+		case TermKind::Pair: {
+			const auto& pair = term.as<PairNode>();
+			return make_pair(clone(*pair.first), clone(*pair.second));
+		}
+		case TermKind::Projection: {
+			const auto& projection = term.as<ProjectionNode>();
+			return make_projection(projection.component, clone(*projection.operand));
+		}
+		case TermKind::Injection: {
+			const auto& injection = term.as<InjectionNode>();
+			return make_injection(injection.side, clone(*injection.sum_type), clone(*injection.value));
+		}
+		case TermKind::Case: {
+			const auto& node = term.as<CaseNode>();
+			return make_case(clone(*node.scrutinee), clone(*node.on_left), clone(*node.on_right));
+		}
+	}
+	return nullptr;
+}
+
+std::string to_string(const TaggedTerm& term) {
+	switch (term.kind()) {
+		case TermKind::Variable:
+			return term.as<VariableNode>().name;
+		case TermKind::Abstraction: {
+			const auto& abs = term.as<AbstractionNode>();
+			return "λ" + abs.var_name + ". " + to_string(*abs.body);
+		}
+		case TermKind::Application: {
+			const auto& app = term.as<ApplicationNode>();
+			return "(" + to_string(*app.function) + ") (" + to_string(*app.value) + ")";
+		}
+		case TermKind::Literal: {
+			const auto& literal = term.as<LiteralNode>();
+			if (literal.kind == LiteralKind::Bool) return literal.value ? "true" : "false";
+			return std::to_string(literal.value);
+		}
+		case TermKind::Primitive:
+			return primitive_name(term.as<PrimitiveNode>().op);
+		case TermKind::Let: {
+			const auto& let = term.as<LetNode>();
+			return "let " + let.var_name + " = " + to_string(*let.bound) + " in " + to_string(*let.body);
+		}
+		case TermKind::Reference:
+			return term.as<ReferenceNode>().definition->name;
+		case TermKind::Pair: {
+			const auto& pair = term.as<PairNode>();
+			return "(" + to_string(*pair.first) + ", " + to_string(*pair.second) + ")";
+		}
+		case TermKind::Projection: {
+			const auto& projection = term.as<ProjectionNode>();
+			return std::string(component_name(projection.component)) + " (" + to_string(*projection.operand) + ")";
+		}
+		case TermKind::Injection: {
+			const auto& injection = term.as<InjectionNode>();
+			return std::string(side_name(injection.side)) + "[" + to_string(*injection.sum_type) + "] (" + to_string(*injection.value) + ")";
+		}
+		case TermKind::Case: {
+			const auto& node = term.as<CaseNode>();
+			return "case (" + to_string(*node.scrutinee) + ") (" + to_string(*node.on_left) + ") (" + to_string(*node.on_right) + ")";
+		}
+	}
+	return "";
+}
+
+bool has_free(const TaggedTerm& term, const std::string& target) {
+	switch (term.kind()) {
+		case TermKind::Variable:
+			return term.as<VariableNode>().name == target;
+		case TermKind::Abstraction: {
+			const auto& abs = term.as<AbstractionNode>();
+			return abs.var_name != target && has_free(*abs.body, target);
+		}
+		case TermKind::Application: {
+			const auto& app = term.as<ApplicationNode>();
+			return has_free(*app.function, target) || has_free(*app.value, target);
+		}
+		case TermKind::Let: {
+			const auto& let = term.as<LetNode>();
+			return has_free(*let.bound, target) || (let.var_name != target && has_free(*let.body, target));
+		}
+		case TermKind::Pair: {
+			const auto& pair = term.as<PairNode>();
+			return has_free(*pair.first, target) || has_free(*pair.second, target);
+		}
+		case TermKind::Projection:
+			return has_free(*term.as<ProjectionNode>().operand, target);
+		case TermKind::Injection:
+			return has_free(*term.as<InjectionNode>().value, target);
+		case TermKind::Case: {
+			const auto& node = term.as<CaseNode>();
+			return has_free(*node.scrutinee, target) || has_free(*node.on_left, target) || has_free(*node.on_right, target);
+		}
+		case TermKind::Literal:
+		case TermKind::Primitive:
+		case TermKind::Reference:
+			return false;
+	}
+	return false;
+}
+
+bool is_delta_redex(const TaggedTerm& term) {
+	// Unwind at most three applications (the largest arity) to the head.
+	std::array<const TaggedTerm*, 3> args{};
+	const TaggedTerm* node = &term;
+	std::size_t count = 0;
+	while (node->kind() == TermKind::Application) {
+		if (count == args.size()) return false;
+		const auto& app = node->as<ApplicationNode>();
+		args[count++] = app.value.get();
+		node = app.function.get();
+	}
+	if (node->kind() != TermKind::Primitive || count == 0) return false;
+	const auto op = node->as<PrimitiveNode>().op;
+	if (primitive_arity(op) != count) return false;
+
+	for (std::size_t i = 0; i < count; ++i) {
+		LiteralKind expected;
+		if (!primitive_strict_in(op, i, expected)) continue;
+		// args were collected outermost first.
+		const TaggedTerm* arg = args[count - 1 - i];
+		if (arg->kind() != TermKind::Literal || arg->as<LiteralNode>().kind != expected) return false;
+	}
+	return true;
+}
+
+bool is_normal(const TaggedTerm& term) {
+	switch (term.kind()) {
+		case TermKind::Variable:
+		case TermKind::Literal:
+		case TermKind::Primitive:
+			return true;
+		case TermKind::Let:
+		case TermKind::Reference:
+			return false;
+		case TermKind::Abstraction:
+			return is_normal(*term.as<AbstractionNode>().body);
+		case TermKind::Application: {
+			const auto& app = term.as<ApplicationNode>();
+			return app.function->kind() != TermKind::Abstraction && !is_delta_redex(term)
+				&& is_normal(*app.function) && is_normal(*app.value);
+		}
+		case TermKind::Pair: {
+			const auto& pair = term.as<PairNode>();
+			return is_normal(*pair.first) && is_normal(*pair.second);
+		}
+		case TermKind::Projection: {
+			const auto& projection = term.as<ProjectionNode>();
+			return projection.operand->kind() != TermKind::Pair && is_normal(*projection.operand);
+		}
+		case TermKind::Injection:
+			return is_normal(*term.as<InjectionNode>().value);
+		case TermKind::Case: {
+			const auto& node = term.as<CaseNode>();
+			return node.scrutinee->kind() != TermKind::Injection && is_normal(*node.scrutinee)
+				&& is_normal(*node.on_left) && is_normal(*node.on_right);
+		}
+	}
+	return true;
+}
+
+TaggedTermPtr substitute(const TaggedTerm& term, const std::string& target, const TaggedTerm& newValue) {
+	switch (term.kind()) {
+		case TermKind::Variable:
+			return term.as<VariableNode>().name == target ? clone(newValue) : clone(term);
+		case TermKind::Abstraction: {
+			const auto& abs = term.as<AbstractionNode>();
+			if (abs.var_name == target) return clone(term);
+			if (has_free(newValue, abs.var_name)) {
+				auto fresh_name = abs.var_name + "'";
+				while (has_free(newValue, fresh_name) || has_free(*abs.body, fresh_name)) fresh_name += "'";
+				const auto fresh_var = make_variable(fresh_name, clone(*abs.var_type));
+				const auto renamed_body = substitute(*abs.body, abs.var_name, *fresh_var);
+				return make_abstraction(fresh_name, clone(*abs.var_type), substitute(*renamed_body, target, newValue));
+			}
+			return make_abstraction(abs.var_name, clone(*abs.var_type), substitute(*abs.body, target, newValue));
+		}
+		case TermKind::Application: {
+			const auto& app = term.as<ApplicationNode>();
+			return make_application(substitute(*app.function, target, newValue), substitute(*app.value, target, newValue));
+		}
+		case TermKind::Let: {
+			const auto& let = term.as<LetNode>();
+			auto new_bound = substitute(*let.bound, target, newValue);
+			if (let.var_name == target) return make_let(let.var_name, std::move(new_bound), clone(*let.body));
+			if (has_free(newValue, let.var_name)) {
+				auto fresh_name = let.var_name + "'";
+				while (has_free(newValue, fresh_name) || has_free(*let.body, fresh_name)) fresh_name += "'";
+				const auto fresh_var = make_variable(fresh_name, make_base_type("τ"));
+				const auto renamed_body = substitute(*let.body, let.var_name, *fresh_var);
+				return make_let(fresh_name, std::move(new_bound), substitute(*renamed_body, target, newValue));
+			}
+			return make_let(let.var_name, std::move(new_bound), substitute(*let.body, target, newValue));
+		}
+		case TermKind::Pair: {
+			const auto& pair = term.as<PairNode>();
+			return make_pair(substitute(*pair.first, target, newValue), substitute(*pair.second, target, newValue));
+		}
+		case TermKind::Projection: {
+			const auto& projection = term.as<ProjectionNode>();
+			return make_projection(projection.component, substitute(*projection.operand, target, newValue));
+		}
+		case TermKind::Injection: {
+			const auto& injection = term.as<InjectionNode>();
+			return make_injection(injection.side, clone(*injection.sum_type), substitute(*injection.value, target, newValue));
+		}
+		case TermKind::Case: {
+			const auto& node = term.as<CaseNode>();
+			return make_case(substitute(*node.scrutinee, target, newValue), substitute(*node.on_left, target, newValue),
+				substitute(*node.on_right, target, newValue));
+		}
+		case TermKind::Literal:
+		case TermKind::Primitive:
+		case TermKind::Reference:
+			return clone(term);
+	}
+	return nullptr;
+}
+
+namespace {
+	TaggedTermPtr delta_reduce(const TaggedTerm& term) {
+		const auto& outer = term.as<ApplicationNode>();
+		if (outer.function->as<ApplicationNode>().function->kind() == TermKind::Primitive) {
+			const auto& inner = outer.function->as<ApplicationNode>();
+			const auto [kind, value] = evaluate_primitive(inner.function->as<PrimitiveNode>().op,
+				inner.value->as<LiteralNode>().value, outer.value->as<LiteralNode>().value);
+			return make_literal(kind, value);
+		}
+		// ((if c) t) e
+		const auto& middle = outer.function->as<ApplicationNode>();
+		const auto& condition = middle.function->as<ApplicationNode>().value->as<LiteralNode>();
+		return clone(condition.value ? *middle.value : *outer.value);
+	}
+}
+
+TaggedTermPtr beta_reduce(const TaggedTerm& term) {
+	switch (term.kind()) {
+		case TermKind::Variable:
+		case TermKind::Literal:
+		case TermKind::Primitive:
+			break;
+		case TermKind::Abstraction: {
+			const auto& abs = term.as<AbstractionNode>();
+			if (is_normal(*abs.body)) break;
+			return make_abstraction(abs.var_name, clone(*abs.var_type), beta_reduce(*abs.body));
+		}
+		case TermKind::Application: {
+			const auto& app = term.as<ApplicationNode>();
+			if (app.function->kind() == TermKind::Abstraction) {
+				const auto& func = app.function->as<AbstractionNode>();
+				return substitute(*func.body, func.var_name, *app.value);
+			}
+			if (is_delta_redex(term)) return delta_reduce(term);
+			if (!is_normal(*app.function)) return make_application(beta_reduce(*app.function), clone(*app.value));
+			if (!is_normal(*app.value)) return make_application(clone(*app.function), beta_reduce(*app.value));
+			break;
+		}
+		case TermKind::Let: {
+			const auto& let = term.as<LetNode>();
+			return substitute(*let.body, let.var_name, *let.bound);
+		}
+		case TermKind::Reference:
+			return to_tagged(*term.as<ReferenceNode>().definition->body);
+		case TermKind::Pair: {
+			const auto& pair = term.as<PairNode>();
+			if (!is_normal(*pair.first)) return make_pair(beta_reduce(*pair.first), clone(*pair.second));
+			if (!is_normal(*pair.second)) return make_pair(clone(*pair.first), beta_reduce(*pair.second));
+			break;
+		}
+		case TermKind::Projection: {
+			const auto& projection = term.as<ProjectionNode>();
+			if (projection.operand->kind() == TermKind::Pair) {
+				const auto& pair = projection.operand->as<PairNode>();
+				return clone(projection.component == Component::First ? *pair.first : *pair.second);
+			}
+			if (!is_normal(*projection.operand)) return make_projection(projection.component, beta_reduce(*projection.operand));
+			break;
+		}
+		case TermKind::Injection: {
+			const auto& injection = term.as<InjectionNode>();
+			if (!is_normal(*injection.value)) return make_injection(injection.side, clone(*injection.sum_type), beta_reduce(*injection.value));
+			break;
+		}
+		case TermKind::Case: {
+			const auto& node = term.as<CaseNode>();
+			if (node.scrutinee->kind() == TermKind::Injection) {
+				const auto& injection = node.scrutinee->as<InjectionNode>();
+				return make_application(clone(injection.side == Side::Left ? *node.on_left : *node.on_right), clone(*injection.value));
+			}
+			if (!is_normal(*node.scrutinee)) return make_case(beta_reduce(*node.scrutinee), clone(*node.on_left), clone(*node.on_right));
+			if (!is_normal(*node.on_left)) return make_case(clone(*node.scrutinee), beta_reduce(*node.on_left), clone(*node.on_right));
+			if (!is_normal(*node.on_right)) return make_case(clone(*node.scrutinee), clone(*node.on_left), beta_reduce(*node.on_right));
+			break;
+		}
+	}
+	throw ReductionOnNormalForm(from_tagged(term));
+}
+
+namespace {
+	using Scope = std::vector<std::pair<std::string_view, const TaggedType*>>;
+
+	TaggedTypePtr type_check_in(const TaggedTerm& term, Scope& scope, const TypingContext& context);
+
+	// Mirrors the branch check of Case::type_check.
+	TaggedTypePtr branch_type(const TaggedTerm& branch, const TaggedType& domain, Scope& scope, const TypingContext& context) {
+		auto type = type_check_in(branch, scope, context);
+		if (type->kind() != TypeKind::Function) throw NotAFunctionError(to_string(*type));
+		auto& func = std::get<FunctionTypeNode>(type->node);
+		if (!equals(*func.domain, domain)) throw DomainTypeMismatchError(to_string(*func.domain), to_string(domain));
+		return std::move(func.codomain);
+	}
+
+	TaggedTypePtr type_check_in(const TaggedTerm& term, Scope& scope, const TypingContext& context) {
+		switch (term.kind()) {
+			case TermKind::Variable: {
+				const auto& name = term.as<VariableNode>().name;
+				for (auto it = scope.rbegin(); it != scope.rend(); ++it) {
+					if (it->first == name) return clone(*it->second);
+				}
+				const Type* type = context.lookup(name);
+				if (type == nullptr) throw UndeclaredVariableError(name);
+				return to_tagged(*type);
+			}
+			case TermKind::Abstraction: {
+				const auto& abs = term.as<AbstractionNode>();
+				scope.emplace_back(abs.var_name, abs.var_type.get());
+				auto body_type = type_check_in(*abs.body, scope, context);
+				scope.pop_back();
+				return make_function_type(clone(*abs.var_type), std::move(body_type));
+			}
+			case TermKind::Application: {
+				const auto& app = term.as<ApplicationNode>();
+				auto func_type = type_check_in(*app.function, scope, context);
+				if (func_type->kind() != TypeKind::Function) {
+					throw NotAFunctionError(to_string(*func_type));
+				}
+				auto& func = std::get<FunctionTypeNode>(func_type->node);
+				const auto value_type = type_check_in(*app.value, scope, context);
+				if (!equals(*value_type, *func.domain)) {
+					throw DomainTypeMismatchError(to_string(*value_type), to_string(*func.domain));
+				}
+				return std::move(func.codomain);
+			}
+			case TermKind::Literal:
+				return make_base_type(term.as<LiteralNode>().kind == LiteralKind::Nat ? NAT_TYPE_NAME : BOOL_TYPE_NAME);
+			case TermKind::Primitive: {
+				const auto& prim = term.as<PrimitiveNode>();
+				const auto branch_type = prim.branch_type ? from_tagged(*prim.branch_type) : nullptr;
+				return to_tagged(*primitive_type(prim.op, branch_type.get()));
+			}
+			case TermKind::Let: {
+				const auto& let = term.as<LetNode>();
+				const auto bound_type = type_check_in(*let.bound, scope, context);
+				scope.emplace_back(let.var_name, bound_type.get());
+				auto body_type = type_check_in(*let.body, scope, context);
+				scope.pop_back();
+				return body_type;
+			}
+			case TermKind::Reference:
+				return to_tagged(term.as<ReferenceNode>().definition->type());
+			case TermKind::Pair: {
+				const auto& pair = term.as<PairNode>();
+				auto first_type = type_check_in(*pair.first, scope, context);
+				return make_product_type(std::move(first_type), type_check_in(*pair.second, scope, context));
+			}
+			case TermKind::Projection: {
+				const auto& projection = term.as<ProjectionNode>();
+				auto operand_type = type_check_in(*projection.operand, scope, context);
+				if (operand_type->kind() != TypeKind::Product) throw NotAProductError(to_string(*operand_type));
+				auto& product = std::get<ProductTypeNode>(operand_type->node);
+				return std::move(projection.component == Component::First ? product.first : product.second);
+			}
+			case TermKind::Injection: {
+				const auto& injection = term.as<InjectionNode>();
+				if (injection.sum_type->kind() != TypeKind::Sum) throw NotASumError(to_string(*injection.sum_type));
+				const auto& sum = injection.sum_type->as<SumTypeNode>();
+				const auto value_type = type_check_in(*injection.value, scope, context);
+				const auto& expected = injection.side == Side::Left ? *sum.left : *sum.right;
+				if (!equals(*value_type, expected)) throw DomainTypeMismatchError(to_string(expected), to_string(*value_type));
+				return clone(*injection.sum_type);
+			}
+			case TermKind::Case: {
+				const auto& node = term.as<CaseNode>();
+				const auto scrutinee_type = type_check_in(*node.scrutinee, scope, context);
+				if (scrutinee_type->kind() != TypeKind::Sum) throw NotASumError(to_string(*scrutinee_type));
+				const auto& sum = scrutinee_type->as<SumTypeNode>();
+				auto left = branch_type(*node.on_left, *sum.left, scope, context);
+				const auto right = branch_type(*node.on_right, *sum.right, scope, context);
+				if (!equals(*left, *right)) throw BranchTypeMismatchError(to_string(*left), to_string(*right));
+				return left;
+			}
+		}
+		return nullptr;
+	}
+}
+
+TaggedTypePtr type_check(const TaggedTerm& term, const TypingContext& context) {
+	Scope scope;
+	return type_check_in(term, scope, context);
+}
+
+TaggedTermPtr to_tagged(const Term& term) {
+	if (const auto* var = dynamic_cast<const Variable*>(&term)) {
+		return make_variable(var->name, to_tagged(var->get_type()));
+	}
+	if (const auto* abs = dynamic_cast<const Abstraction*>(&term)) {
+		return make_abstraction(abs->var_name, to_tagged(*abs->var_type), to_tagged(*abs->body));
+	}
+	if (const auto* app = dynamic_cast<const Application*>(&term)) {
+		return make_application(to_tagged(*app->function), to_tagged(*app->value));
+	}
+	if (const auto* literal = dynamic_cast<const Literal*>(&term)) {
+		return make_literal(literal->kind, literal->value);
+	}
+	if (const auto* prim = dynamic_cast<const Primitive*>(&term)) {
+		return make_primitive(prim->op, prim->branch_type ? to_tagged(*prim->branch_type) : nullptr);
+	}
+	if (const auto* let = dynamic_cast<const Let*>(&term)) {
+		return make_let(let->var_name, to_tagged(*let->bound), to_tagged(*let->body));
+	}
+	if (const auto* ref = dynamic_cast<const Reference*>(&term)) {
+		return make_reference(ref->definition);
+	}
+	if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+		return make_pair(to_tagged(*pair->first), to_tagged(*pair->second));
+	}
+	if (const auto* projection = dynamic_cast<const Projection*>(&term)) {
+		return make_projection(projection->component, to_tagged(*projection->operand));
+	}
+	if (const auto* injection = dynamic_cast<const Injection*>(&term)) {
+		return make_injection(injection->side, to_tagged(*injection->sum_type), to_tagged(*injection->value));
+	}
+	if (const auto* node = dynamic_cast<const Case*>(&term)) {
+		return make_case(to_tagged(*node->scrutinee), to_tagged(*node->on_left), to_tagged(*node->on_right));
+	}
+	throw std::invalid_argument("Unsupported term '" + term.to_string() + "'");
+}
+
+unique_ptr<Term> from_tagged(const TaggedTerm& term) {
+	switch (term.kind()) {
+		case TermKind::Variable: {
+			const auto& var = term.as<VariableNode>();
+			return make_unique<Variable>(var.name, from_tagged(*var.type));
+		}
+		case TermKind::Abstraction: {
+			const auto& abs = term.as<AbstractionNode>();
+			return make_unique<Abstraction>(from_tagged(*abs.var_type), abs.var_name, from_tagged(*abs.body));
+		}
+		case TermKind::Application: {
+			const auto& app = term.as<ApplicationNode>();
+			return make_unique<Application>(from_tagged(*app.function), from_tagged(*app.value));
+		}
+		case TermKind::Literal: {
+			const auto& literal = term.as<LiteralNode>();
+			return make_unique<Literal>(literal.kind, literal.value);
+		}
+		case TermKind::Primitive: {
+			const auto& prim = term.as<PrimitiveNode>();
+			return make_unique<Primitive>(prim.op, prim.branch_type ? from_tagged(*prim.branch_type) : nullptr);
+		}
+		case TermKind::Let: {
+			const auto& let = term.as<LetNode>();
+			return make_unique<Let>(let.var_name, from_tagged(*let.bound), from_tagged(*let.body));
+		}
+		case TermKind::Reference:
+			return make_unique<Reference>(term.as<ReferenceNode>().definition);
+		case TermKind::Pair: {
+			const auto& pair = term.as<PairNode>();
+			return make_unique<Pair>(from_tagged(*pair.first), from_tagged(*pair.second));
+		}
+		case TermKind::Projection: {
+			const auto& projection = term.as<ProjectionNode>();
+			return make_unique<Projection>(projection.component, from_tagged(*projection.operand));
+		}
+		case TermKind::Injection: {
+			const auto& injection = term.as<InjectionNode>();
+			return make_unique<Injection>(injection.side, from_tagged(*injection.sum_type), from_tagged(*injection.value));
+		}
+		case TermKind::Case: {
+			const auto& node = term.as<CaseNode>();
+			return make_unique<Case>(from_tagged(*node.scrutinee), from_tagged(*node.on_left), from_tagged(*node.on_right));
+		}
+	}
+	return nullptr;
+}
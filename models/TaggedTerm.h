@@ -0,0 +1,134 @@
+//
+// TaggedTerm.h
+//
+// Closed sum-type mirror of the Term hierarchy, convertible both ways.
+// Engines dispatch with `switch (term.kind())`; the operations below follow
+// the semantics of the corresponding Term methods exactly.
+//
+
+#ifndef TAGGEDTERM_H
+#define TAGGEDTERM_H
+
+#include "Terms.h"
+#include "TaggedType.h"
+#include "TypingContext.h"
+#include "Definitions.h"
+#include "terms/Primitive.h"
+#include "terms/Projection.h"
+#include "terms/Injection.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+
+// Order must follow the alternatives of TaggedTerm::node.
+enum class TermKind : std::uint8_t {
+	Variable, Abstraction, Application, Literal, Primitive, Let, Reference, Pair, Projection, Injection, Case
+};
+
+struct TaggedTerm;
+using TaggedTermPtr = std::unique_ptr<TaggedTerm>;
+
+struct VariableNode {
+	std::string name;
+	TaggedTypePtr type;
+};
+
+struct AbstractionNode {
+	std::string var_name;
+	TaggedTypePtr var_type;
+	TaggedTermPtr body;
+};
+
+struct ApplicationNode {
+	TaggedTermPtr function;
+	TaggedTermPtr value;
+};
+
+struct LiteralNode {
+	LiteralKind kind;
+	std::uint64_t value;
+};
+
+struct PrimitiveNode {
+	PrimitiveOp op;
+	// Only set for If.
+	TaggedTypePtr branch_type;
+};
+
+struct LetNode {
+	std::string var_name;
+	TaggedTermPtr bound;
+	TaggedTermPtr body;
+};
+
+struct ReferenceNode {
+	std::shared_ptr<const Definition> definition;
+};
+
+struct PairNode {
+	TaggedTermPtr first;
+	TaggedTermPtr second;
+};
+
+struct ProjectionNode {
+	Component component;
+	TaggedTermPtr operand;
+};
+
+struct InjectionNode {
+	Side side;
+	TaggedTypePtr sum_type;
+	TaggedTermPtr value;
+};
+
+struct CaseNode {
+	TaggedTermPtr scrutinee;
+	TaggedTermPtr on_left;
+	TaggedTermPtr on_right;
+};
+
+struct TaggedTerm {
+	std::variant<VariableNode, AbstractionNode, ApplicationNode, LiteralNode, PrimitiveNode, LetNode, ReferenceNode,
+		PairNode, ProjectionNode, InjectionNode, CaseNode> node;
+
+	[[nodiscard]] TermKind kind() const { return static_cast<TermKind>(node.index()); }
+
+	// Unchecked access; the caller has already switched on kind().
+	template<typename Node>
+	[[nodiscard]] const Node& as() const { return *std::get_if<Node>(&node); }
+	template<typename Node>
+	[[nodiscard]] Node& as() { return *std::get_if<Node>(&node); }
+
+	template<typename Visitor>
+	decltype(auto) visit(Visitor&& visitor) const { return std::visit(std::forward<Visitor>(visitor), node); }
+};
+
+[[nodiscard]] TaggedTermPtr make_variable(std::string name, TaggedTypePtr type);
+[[nodiscard]] TaggedTermPtr make_abstraction(std::string var_name, TaggedTypePtr var_type, TaggedTermPtr body);
+[[nodiscard]] TaggedTermPtr make_application(TaggedTermPtr function, TaggedTermPtr value);
+[[nodiscard]] TaggedTermPtr make_literal(LiteralKind kind, std::uint64_t value);
+[[nodiscard]] TaggedTermPtr make_primitive(PrimitiveOp op, TaggedTypePtr branch_type = nullptr);
+[[nodiscard]] TaggedTermPtr make_let(std::string var_name, TaggedTermPtr bound, TaggedTermPtr body);
+[[nodiscard]] TaggedTermPtr make_reference(std::shared_ptr<const Definition> definition);
+[[nodiscard]] TaggedTermPtr make_pair(TaggedTermPtr first, TaggedTermPtr second);
+[[nodiscard]] TaggedTermPtr make_projection(Component component, TaggedTermPtr operand);
+[[nodiscard]] TaggedTermPtr make_injection(Side side, TaggedTypePtr sum_type, TaggedTermPtr value);
+[[nodiscard]] TaggedTermPtr make_case(TaggedTermPtr scrutinee, TaggedTermPtr on_left, TaggedTermPtr on_right);
+
+[[nodiscard]] TaggedTermPtr clone(const TaggedTerm& term);
+[[nodiscard]] std::string to_string(const TaggedTerm& term);
+[[nodiscard]] bool has_free(const TaggedTerm& term, const std::string& target);
+[[nodiscard]] bool is_normal(const TaggedTerm& term);
+[[nodiscard]] bool is_delta_redex(const TaggedTerm& term);
+[[nodiscard]] TaggedTermPtr substitute(const TaggedTerm& term, const std::string& target, const TaggedTerm& newValue);
+// One normal-order step (β, δ, let, unfolding, projection or case); throws ReductionOnNormalForm like Term::beta_reduce.
+[[nodiscard]] TaggedTermPtr beta_reduce(const TaggedTerm& term);
+[[nodiscard]] TaggedTypePtr type_check(const TaggedTerm& term, const TypingContext& context);
+
+[[nodiscard]] TaggedTermPtr to_tagged(const Term& term);
+[[nodiscard]] std::unique_ptr<Term> from_tagged(const TaggedTerm& term);
+
+#endif //TAGGEDTERM_H
@@ -0,0 +1,137 @@
+//
+// TaggedType.cpp
+//
+
+#include "TaggedType.h"
+
+#include <stdexcept>
+
+using std::unique_ptr, std::make_unique;
+
+TaggedTypePtr make_base_type(std::string name) {
+	return make_unique<TaggedType>(TaggedType{BaseTypeNode{std::move(name)}});
+}
+
+TaggedTypePtr make_function_type(TaggedTypePtr domain, TaggedTypePtr codomain) {
+	return make_unique<TaggedType>(TaggedType{FunctionTypeNode{std::move(domain), std::move(codomain)}});
+}
+
+TaggedTypePtr make_product_type(TaggedTypePtr first, TaggedTypePtr second) {
+	return make_unique<TaggedType>(TaggedType{ProductTypeNode{std::move(first), std::move(second)}});
+}
+
+TaggedTypePtr make_sum_type(TaggedTypePtr left, TaggedTypePtr right) {
+	return make_unique<TaggedType>(TaggedType{SumTypeNode{std::move(left), std::move(right)}});
+}
+
+TaggedTypePtr clone(const TaggedType& type) {
+	switch (type.kind()) {
+		case TypeKind::Base:
+			return make_base_type(type.as<BaseTypeNode>().name);
+		case TypeKind::Function: {
+			const auto& func = type.as<FunctionTypeNode>();
+			return make_function_type(clone(*func.domain), clone(*func.codomain));
+		}
+		case TypeKind::Product: {
+			const auto& product = type.as<ProductTypeNode>();
+			return make_product_type(clone(*product.first), clone(*product.second));
+		}
+		case TypeKind::Sum: {
+			const auto& sum = type.as<SumTypeNode>();
+			return make_sum_type(clone(*sum.left), clone(*sum.right));
+		}
+	}
+	return nullptr;
+}
+
+bool equals(const TaggedType& lhs, const TaggedType& rhs) {
+	if (lhs.kind() != rhs.kind()) return false;
+	switch (lhs.kind()) {
+		case TypeKind::Base:
+			return lhs.as<BaseTypeNode>().name == rhs.as<BaseTypeNode>().name;
+		case TypeKind::Function: {
+			const auto& l = lhs.as<FunctionTypeNode>();
+			const auto& r = rhs.as<FunctionTypeNode>();
+			return equals(*l.domain, *r.domain) && equals(*l.codomain, *r.codomain);
+		}
+		case TypeKind::Product: {
+			const auto& l = lhs.as<ProductTypeNode>();
+			const auto& r = rhs.as<ProductTypeNode>();
+			return equals(*l.first, *r.first) && equals(*l.second, *r.second);
+		}
+		case TypeKind::Sum: {
+			const auto& l = lhs.as<SumTypeNode>();
+			const auto& r = rhs.as<SumTypeNode>();
+			return equals(*l.left, *r.left) && equals(*l.right, *r.right);
+		}
+	}
+	return false;
+}
+
+namespace {
+	// Same bracketing as ProductType and SumType.
+	std::string operand_string(const TaggedType& type) {
+		return type.kind() == TypeKind::Base ? to_string(type) : "(" + to_string(type) + ")";
+	}
+}
+
+std::string to_string(const TaggedType& type) {
+	switch (type.kind()) {
+		case TypeKind::Base:
+			return type.as<BaseTypeNode>().name;
+		case TypeKind::Function: {
+			// Same bracketing as FunctionType::to_string.
+			const auto& func = type.as<FunctionTypeNode>();
+			std::string domain_str = to_string(*func.domain);
+			std::string codomain_str = to_string(*func.codomain);
+			if (func.domain->kind() == TypeKind::Function) domain_str = "(" + domain_str + ")";
+			if (func.codomain->kind() == TypeKind::Function) codomain_str = "(" + codomain_str + ")";
+			return domain_str + " -> " + codomain_str;
+		}
+		case TypeKind::Product: {
+			const auto& product = type.as<ProductTypeNode>();
+			return operand_string(*product.first) + " * " + operand_string(*product.second);
+		}
+		case TypeKind::Sum: {
+			const auto& sum = type.as<SumTypeNode>();
+			return operand_string(*sum.left) + " + " + operand_string(*sum.right);
+		}
+	}
+	return "";
+}
+
+TaggedTypePtr to_tagged(const Type& type) {
+	if (const auto* base = dynamic_cast<const BaseType*>(&type)) {
+		return make_base_type(base->name);
+	}
+	if (const auto* func = dynamic_cast<const FunctionType*>(&type)) {
+		return make_function_type(to_tagged(*func->domain), to_tagged(*func->codomain));
+	}
+	if (const auto* product = dynamic_cast<const ProductType*>(&type)) {
+		return make_product_type(to_tagged(*product->first), to_tagged(*product->second));
+	}
+	if (const auto* sum = dynamic_cast<const SumType*>(&type)) {
+		return make_sum_type(to_tagged(*sum->left), to_tagged(*sum->right));
+	}
+	throw std::invalid_argument("Unsupported type '" + type.to_string() + "'");
+}
+
+unique_ptr<Type> from_tagged(const TaggedType& type) {
+	switch (type.kind()) {
+		case TypeKind::Base:
+			return make_unique<BaseType>(type.as<BaseTypeNode>().name);
+		case TypeKind::Function: {
+			const auto& func = type.as<FunctionTypeNode>();
+			return make_unique<FunctionType>(from_tagged(*func.domain), from_tagged(*func.codomain));
+		}
+		case TypeKind::Product: {
+			const auto& product = type.as<ProductTypeNode>();
+			return make_unique<ProductType>(from_tagged(*product.first), from_tagged(*product.second));
+		}
+		case TypeKind::Sum: {
+			const auto& sum = type.as<SumTypeNode>();
+			return make_unique<SumType>(from_tagged(*sum.left), from_tagged(*sum.right));
+		}
+	}
+	return nullptr;
+}
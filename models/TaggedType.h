@@ -0,0 +1,70 @@
+//
+// TaggedType.h
+//
+// Closed sum-type mirror of the Type hierarchy. The node kind is the index
+// of a std::variant, so analyses branch with a switch instead of virtual
+// calls and dynamic_cast.
+//
+
+#ifndef TAGGEDTYPE_H
+#define TAGGEDTYPE_H
+
+#include "Type.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+
+// Order must follow the alternatives of TaggedType::node.
+enum class TypeKind : std::uint8_t { Base, Function, Product, Sum };
+
+struct TaggedType;
+using TaggedTypePtr = std::unique_ptr<TaggedType>;
+
+struct BaseTypeNode {
+	std::string name;
+};
+
+struct FunctionTypeNode {
+	TaggedTypePtr domain;
+	TaggedTypePtr codomain;
+};
+
+struct ProductTypeNode {
+	TaggedTypePtr first;
+	TaggedTypePtr second;
+};
+
+struct SumTypeNode {
+	TaggedTypePtr left;
+	TaggedTypePtr right;
+};
+
+struct TaggedType {
+	std::variant<BaseTypeNode, FunctionTypeNode, ProductTypeNode, SumTypeNode> node;
+
+	[[nodiscard]] TypeKind kind() const { return static_cast<TypeKind>(node.index()); }
+
+	// Unchecked access; the caller has already switched on kind().
+	template<typename Node>
+	[[nodiscard]] const Node& as() const { return *std::get_if<Node>(&node); }
+
+	template<typename Visitor>
+	decltype(auto) visit(Visitor&& visitor) const { return std::visit(std::forward<Visitor>(visitor), node); }
+};
+
+[[nodiscard]] TaggedTypePtr make_base_type(std::string name);
+[[nodiscard]] TaggedTypePtr make_function_type(TaggedTypePtr domain, TaggedTypePtr codomain);
+[[nodiscard]] TaggedTypePtr make_product_type(TaggedTypePtr first, TaggedTypePtr second);
+[[nodiscard]] TaggedTypePtr make_sum_type(TaggedTypePtr left, TaggedTypePtr right);
+
+[[nodiscard]] TaggedTypePtr clone(const TaggedType& type);
+[[nodiscard]] bool equals(const TaggedType& lhs, const TaggedType& rhs);
+[[nodiscard]] std::string to_string(const TaggedType& type);
+
+[[nodiscard]] TaggedTypePtr to_tagged(const Type& type);
+[[nodiscard]] std::unique_ptr<Type> from_tagged(const TaggedType& type);
+
+#endif //TAGGEDTYPE_H
@@ -0,0 +1,323 @@
+//
+// TermCodec.cpp
+//
+
+#include "TermCodec.h"
+
+#include "TaggedTerm.h"
+#include "terms/Variable.h"
+#include "terms/Abstraction.h"
+#include "terms/Application.h"
+#include "terms/Literal.h"
+#include "terms/Primitive.h"
+#include "terms/Let.h"
+#include "terms/Reference.h"
+#include "terms/Pair.h"
+#include "terms/Projection.h"
+#include "terms/Injection.h"
+#include "terms/Case.h"
+#include "../exceptions/Exceptions.h"
+
+#include <stdexcept>
+
+using std::unique_ptr, std::make_unique;
+
+namespace {
+
+enum TypeTag : std::uint8_t { NoType, BaseTypeTag, FunctionTypeTag, ProductTypeTag, SumTypeTag };
+
+[[noreturn]] void malformed(const std::string& message) {
+	throw TermFormatError("Malformed term encoding: " + message);
+}
+
+}
+
+void put_varint(std::string& out, std::uint64_t value) {
+	while (value >= 0x80) {
+		out.push_back(static_cast<char>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<char>(value));
+}
+
+void put_u64(std::string& out, std::uint64_t value) {
+	for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+void put_string(std::string& out, std::string_view text) {
+	put_varint(out, text.size());
+	out.append(text);
+}
+
+std::uint8_t ByteReader::byte() {
+	if (this->at_end()) malformed("unexpected end of input");
+	return static_cast<std::uint8_t>(this->data[this->position++]);
+}
+
+std::uint64_t ByteReader::varint() {
+	std::uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		const auto next = this->byte();
+		value |= static_cast<std::uint64_t>(next & 0x7f) << shift;
+		if ((next & 0x80) == 0) return value;
+	}
+	malformed("varint too long");
+}
+
+std::uint64_t ByteReader::u64() {
+	std::uint64_t value = 0;
+	for (int i = 0; i < 8; ++i) value |= static_cast<std::uint64_t>(this->byte()) << (8 * i);
+	return value;
+}
+
+std::string_view ByteReader::bytes(std::uint64_t count) {
+	if (count > this->data.size() - this->position) malformed("unexpected end of input");
+	const auto text = this->data.substr(this->position, count);
+	this->position += count;
+	return text;
+}
+
+void TermEncoder::name(const std::string& name) {
+	const auto [entry, inserted] = this->names.try_emplace(name, static_cast<std::uint32_t>(this->names.size()));
+	if (!inserted) {
+		put_varint(this->out, entry->second + 1);
+		return;
+	}
+	put_varint(this->out, 0);
+	put_string(this->out, name);
+}
+
+void TermEncoder::type(const Type* type) {
+	if (const auto* base = dynamic_cast<const BaseType*>(type)) {
+		this->out.push_back(BaseTypeTag);
+		this->name(base->name);
+	} else if (const auto* function = dynamic_cast<const FunctionType*>(type)) {
+		this->out.push_back(FunctionTypeTag);
+		this->type(function->domain.get());
+		this->type(function->codomain.get());
+	} else if (const auto* product = dynamic_cast<const ProductType*>(type)) {
+		this->out.push_back(ProductTypeTag);
+		this->type(product->first.get());
+		this->type(product->second.get());
+	} else if (const auto* sum = dynamic_cast<const SumType*>(type)) {
+		this->out.push_back(SumTypeTag);
+		this->type(sum->left.get());
+		this->type(sum->right.get());
+	} else {
+		this->out.push_back(NoType);
+	}
+}
+
+void TermEncoder::term(const Term& term) {
+	put_varint(this->out, term.measure().nodes);
+	this->nodes(term);
+}
+
+bool TermEncoder::define(const Definition& definition) {
+	return this->definitions.emplace(&definition, static_cast<std::uint32_t>(this->definitions.size())).second;
+}
+
+void TermEncoder::nodes(const Term& term) {
+	if (const auto* variable = dynamic_cast<const Variable*>(&term)) {
+		this->out.push_back(static_cast<char>(TermKind::Variable));
+		this->name(variable->name);
+		this->type(&variable->get_type());
+	} else if (const auto* abstraction = dynamic_cast<const Abstraction*>(&term)) {
+		this->nodes(*abstraction->body);
+		this->out.push_back(static_cast<char>(TermKind::Abstraction));
+		this->name(abstraction->var_name);
+		this->type(abstraction->var_type.get());
+	} else if (const auto* application = dynamic_cast<const Application*>(&term)) {
+		this->nodes(*application->function);
+		this->nodes(*application->value);
+		this->out.push_back(static_cast<char>(TermKind::Application));
+	} else if (const auto* literal = dynamic_cast<const Literal*>(&term)) {
+		this->out.push_back(static_cast<char>(TermKind::Literal));
+		this->out.push_back(static_cast<char>(literal->kind));
+		put_varint(this->out, literal->value);
+	} else if (const auto* primitive = dynamic_cast<const Primitive*>(&term)) {
+		this->out.push_back(static_cast<char>(TermKind::Primitive));
+		this->out.push_back(static_cast<char>(primitive->op));
+		this->type(primitive->branch_type.get());
+	} else if (const auto* let = dynamic_cast<const Let*>(&term)) {
+		this->nodes(*let->bound);
+		this->nodes(*let->body);
+		this->out.push_back(static_cast<char>(TermKind::Let));
+		this->name(let->var_name);
+	} else if (const auto* reference = dynamic_cast<const Reference*>(&term)) {
+		const auto it = this->definitions.find(reference->definition.get());
+		if (it == this->definitions.end()) throw std::invalid_argument("reference to unregistered definition " + reference->definition->name);
+		this->out.push_back(static_cast<char>(TermKind::Reference));
+		put_varint(this->out, it->second);
+	} else if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+		this->nodes(*pair->first);
+		this->nodes(*pair->second);
+		this->out.push_back(static_cast<char>(TermKind::Pair));
+	} else if (const auto* projection = dynamic_cast<const Projection*>(&term)) {
+		this->nodes(*projection->operand);
+		this->out.push_back(static_cast<char>(TermKind::Projection));
+		this->out.push_back(static_cast<char>(projection->component));
+	} else if (const auto* injection = dynamic_cast<const Injection*>(&term)) {
+		this->nodes(*injection->value);
+		this->out.push_back(static_cast<char>(TermKind::Injection));
+		this->out.push_back(static_cast<char>(injection->side));
+		this->type(injection->sum_type.get());
+	} else if (const auto* match = dynamic_cast<const Case*>(&term)) {
+		this->nodes(*match->scrutinee);
+		this->nodes(*match->on_left);
+		this->nodes(*match->on_right);
+		this->out.push_back(static_cast<char>(TermKind::Case));
+	}
+}
+
+std::string TermDecoder::name() {
+	const auto id = this->input.varint();
+	if (id == 0) {
+		this->names.emplace_back(this->input.bytes(this->input.varint()));
+		return this->names.back();
+	}
+	if (id > this->names.size()) malformed("unknown name id " + std::to_string(id - 1));
+	return this->names[id - 1];
+}
+
+unique_ptr<Type> TermDecoder::type() {
+	switch (this->input.byte()) {
+		case NoType: return nullptr;
+		case BaseTypeTag: return make_unique<BaseType>(this->name());
+		case FunctionTypeTag: {
+			auto domain = this->type();
+			auto codomain = this->type();
+			if (!domain || !codomain) malformed("function type without domain or codomain");
+			return make_unique<FunctionType>(std::move(domain), std::move(codomain));
+		}
+		case ProductTypeTag: {
+			auto first = this->type();
+			auto second = this->type();
+			if (!first || !second) malformed("product type without both components");
+			return make_unique<ProductType>(std::move(first), std::move(second));
+		}
+		case SumTypeTag: {
+			auto left = this->type();
+			auto right = this->type();
+			if (!left || !right) malformed("sum type without both alternatives");
+			return make_unique<SumType>(std::move(left), std::move(right));
+		}
+		default: malformed("unknown type tag");
+	}
+}
+
+unique_ptr<Term> TermDecoder::term() {
+	const auto count = this->input.varint();
+	std::vector<unique_ptr<Term>> built;
+	const auto children = [&built](std::size_t needed) {
+		if (built.size() < needed) malformed("node without its children");
+	};
+	for (std::uint64_t i = 0; i < count; ++i) {
+		switch (static_cast<TermKind>(this->input.byte())) {
+			case TermKind::Variable: {
+				auto name = this->name();
+				auto type = this->type();
+				built.push_back(type ? make_unique<Variable>(std::move(name), std::move(type)) : make_unique<Variable>(std::move(name)));
+				break;
+			}
+			case TermKind::Abstraction: {
+				children(1);
+				auto name = this->name();
+				auto type = this->type();
+				if (!type) type = make_unique<BaseType>("τ");
+				auto body = std::move(built.back());
+				built.back() = make_unique<Abstraction>(std::move(type), std::move(name), std::move(body));
+				break;
+			}
+			case TermKind::Application: {
+				children(2);
+				auto value = std::move(built.back());
+				built.pop_back();
+				auto function = std::move(built.back());
+				built.back() = make_unique<Application>(std::move(function), std::move(value));
+				break;
+			}
+			case TermKind::Literal: {
+				const auto kind = static_cast<LiteralKind>(this->input.byte());
+				built.push_back(make_unique<Literal>(kind, this->input.varint()));
+				break;
+			}
+			case TermKind::Primitive: {
+				const auto op = static_cast<PrimitiveOp>(this->input.byte());
+				built.push_back(make_unique<Primitive>(op, this->type()));
+				break;
+			}
+			case TermKind::Let: {
+				children(2);
+				auto name = this->name();
+				auto body = std::move(built.back());
+				built.pop_back();
+				auto bound = std::move(built.back());
+				built.back() = make_unique<Let>(std::move(name), std::move(bound), std::move(body));
+				break;
+			}
+			case TermKind::Reference: {
+				const auto id = this->input.varint();
+				if (id >= this->definitions.size()) malformed("unknown definition id " + std::to_string(id));
+				built.push_back(make_unique<Reference>(this->definitions[id]));
+				break;
+			}
+			case TermKind::Pair: {
+				children(2);
+				auto second = std::move(built.back());
+				built.pop_back();
+				auto first = std::move(built.back());
+				built.back() = make_unique<Pair>(std::move(first), std::move(second));
+				break;
+			}
+			case TermKind::Projection: {
+				children(1);
+				const auto component = this->input.byte();
+				if (component > static_cast<std::uint8_t>(Component::Second)) malformed("unknown projection component");
+				auto operand = std::move(built.back());
+				built.back() = make_unique<Projection>(static_cast<Component>(component), std::move(operand));
+				break;
+			}
+			case TermKind::Injection: {
+				children(1);
+				const auto side = this->input.byte();
+				if (side > static_cast<std::uint8_t>(Side::Right)) malformed("unknown injection side");
+				auto sum_type = this->type();
+				if (!sum_type) malformed("injection without its sum type");
+				auto value = std::move(built.back());
+				built.back() = make_unique<Injection>(static_cast<Side>(side), std::move(sum_type), std::move(value));
+				break;
+			}
+			case TermKind::Case: {
+				children(3);
+				auto on_right = std::move(built.back());
+				built.pop_back();
+				auto on_left = std::move(built.back());
+				built.pop_back();
+				auto scrutinee = std::move(built.back());
+				built.back() = make_unique<Case>(std::move(scrutinee), std::move(on_left), std::move(on_right));
+				break;
+			}
+			default: malformed("unknown node kind");
+		}
+	}
+	if (built.size() != 1) malformed("term is not a single tree");
+	return std::move(built.back());
+}
+
+void TermDecoder::define(std::shared_ptr<const Definition> definition) {
+	this->definitions.push_back(std::move(definition));
+}
+
+std::string encode_term(const Term& term) {
+	TermEncoder encoder;
+	encoder.term(term);
+	return std::move(encoder.bytes());
+}
+
+unique_ptr<Term> decode_term(std::string_view bytes) {
+	TermDecoder decoder(bytes);
+	auto term = decoder.term();
+	if (!decoder.reader().at_end()) malformed("trailing bytes after term");
+	return term;
+}
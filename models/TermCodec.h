@@ -0,0 +1,93 @@
+//
+// TermCodec.h
+//
+// Compact binary encoding of terms, shared by reduction traces and the
+// normal-form cache. Integers are LEB128 varints. A term is its node count
+// followed by its nodes in post-order, as on a TermTape. Names are interned
+// per encoder: the first use of a name writes its text, and later uses
+// write only its id.
+//
+
+#ifndef TERMCODEC_H
+#define TERMCODEC_H
+
+#include "Terms.h"
+#include "Type.h"
+#include "Definitions.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+void put_varint(std::string& out, std::uint64_t value);
+void put_u64(std::string& out, std::uint64_t value);
+void put_string(std::string& out, std::string_view text);
+
+// Bounds-checked cursor over encoded bytes; throws TermFormatError on
+// truncated or malformed input.
+class ByteReader {
+public:
+	explicit ByteReader(std::string_view data): data(data) {}
+
+	[[nodiscard]] bool at_end() const { return this->position == this->data.size(); }
+	[[nodiscard]] std::size_t offset() const { return this->position; }
+
+	std::uint8_t byte();
+	std::uint64_t varint();
+	std::uint64_t u64();
+	std::string_view bytes(std::uint64_t count);
+
+private:
+	std::string_view data;
+	std::size_t position = 0;
+};
+
+class TermEncoder {
+public:
+	[[nodiscard]] std::string& bytes() { return this->out; }
+	[[nodiscard]] const std::string& bytes() const { return this->out; }
+
+	void name(const std::string& name);
+	void type(const Type* type);
+	void term(const Term& term);
+
+	// Gives `definition` the next id, which Reference nodes are encoded as.
+	// Returns false if it already had one.
+	bool define(const Definition& definition);
+	[[nodiscard]] bool defined(const Definition& definition) const { return this->definitions.contains(&definition); }
+
+private:
+	std::string out;
+	std::map<std::string, std::uint32_t, std::less<>> names;
+	std::map<const Definition*, std::uint32_t> definitions;
+
+	void nodes(const Term& term);
+};
+
+class TermDecoder {
+public:
+	explicit TermDecoder(std::string_view data): input(data) {}
+
+	[[nodiscard]] ByteReader& reader() { return this->input; }
+
+	[[nodiscard]] std::string name();
+	[[nodiscard]] std::unique_ptr<Type> type();
+	[[nodiscard]] std::unique_ptr<Term> term();
+
+	// Counterpart of TermEncoder::define, in the same order.
+	void define(std::shared_ptr<const Definition> definition);
+
+private:
+	ByteReader input;
+	std::vector<std::string> names;
+	std::vector<std::shared_ptr<const Definition>> definitions;
+};
+
+// A single self-contained term. References cannot be encoded this way.
+[[nodiscard]] std::string encode_term(const Term& term);
+[[nodiscard]] std::unique_ptr<Term> decode_term(std::string_view bytes);
+
+#endif //TERMCODEC_H
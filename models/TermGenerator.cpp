@@ -0,0 +1,173 @@
+//
+// TermGenerator.cpp
+//
+
+#include "TermGenerator.h"
+
+#include "terms/Variable.h"
+#include "terms/Abstraction.h"
+#include "terms/Application.h"
+#include "terms/Literal.h"
+#include "terms/Primitive.h"
+#include "terms/Let.h"
+
+using std::unique_ptr, std::make_unique;
+
+TermGenerator::TermGenerator(GeneratorOptions options):
+	options(options),
+	random(options.seed),
+	nat(this->types.intern_base(NAT_TYPE_NAME)),
+	boolean(this->types.intern_base(BOOL_TYPE_NAME))
+{}
+
+bool TermGenerator::chance(double probability) {
+	return std::uniform_real_distribution<double>(0, 1)(this->random) < probability;
+}
+
+std::size_t TermGenerator::below(std::size_t bound) {
+	return std::uniform_int_distribution<std::size_t>(0, bound - 1)(this->random);
+}
+
+std::uint32_t TermGenerator::random_type(std::size_t depth) {
+	if (depth == 0 || this->chance(0.5)) return this->chance(0.5) ? this->nat : this->boolean;
+	const auto domain = this->random_type(depth - 1);
+	return this->types.intern_function(domain, this->random_type(depth - 1));
+}
+
+unique_ptr<Type> TermGenerator::random_type() {
+	return this->types.to_type(this->random_type(this->options.type_depth));
+}
+
+std::string TermGenerator::fresh_name() {
+	return "x" + std::to_string(this->next_name++);
+}
+
+// Splits `budget` into `parts` shares of random, roughly equal size.
+std::vector<std::size_t> TermGenerator::split(std::size_t budget, std::size_t parts) {
+	std::vector<std::size_t> shares(parts);
+	const auto share = budget / parts;
+	for (auto& part : shares) part = share / 2 + (share == 0 ? 0 : this->below(share + 1));
+	return shares;
+}
+
+unique_ptr<Term> TermGenerator::generate() {
+	return this->generate(*this->random_type());
+}
+
+unique_ptr<Term> TermGenerator::generate(const Type& type) {
+	this->scope.clear();
+	return this->term(this->types.intern(type), this->options.size, 0);
+}
+
+unique_ptr<Term> TermGenerator::term(std::uint32_t type, std::size_t budget, std::size_t depth) {
+	if (budget <= 1 || depth >= this->options.max_depth) return this->leaf(type, depth);
+	// By value: interning new types below may move the table.
+	const auto entry = this->types[type];
+
+	if (this->chance(this->options.redex_density)) {
+		const auto domain = this->random_type(this->options.type_depth);
+		const auto shares = this->split(budget - 2, 2);
+		auto function = this->abstraction(domain, type, shares[0] + 1, depth + 1);
+		return make_unique<Application>(std::move(function), this->term(domain, shares[1], depth + 1));
+	}
+	if (entry.kind == TypeKind::Function && this->chance(0.5)) {
+		return this->abstraction(entry.domain, entry.codomain, budget, depth);
+	}
+	if (this->options.lets && this->chance(0.05)) {
+		const auto bound_type = this->random_type(this->options.type_depth);
+		const auto shares = this->split(budget - 1, 2);
+		auto bound = this->term(bound_type, shares[0], depth + 1);
+		auto name = this->fresh_name();
+		this->scope.push_back({name, bound_type});
+		auto body = this->term(type, shares[1], depth + 1);
+		this->scope.pop_back();
+		return make_unique<Let>(std::move(name), std::move(bound), std::move(body));
+	}
+	if (this->options.primitives && this->chance(0.2)) {
+		if (auto result = this->primitive_application(type, budget, depth)) return result;
+	}
+	if (auto result = this->variable_application(type, budget, depth)) return result;
+	if (entry.kind == TypeKind::Function) return this->abstraction(entry.domain, entry.codomain, budget, depth);
+	if (this->options.primitives) {
+		if (auto result = this->primitive_application(type, budget, depth)) return result;
+	}
+	return this->leaf(type, depth);
+}
+
+unique_ptr<Term> TermGenerator::abstraction(std::uint32_t domain, std::uint32_t codomain, std::size_t budget, std::size_t depth) {
+	auto name = this->fresh_name();
+	this->scope.push_back({name, domain});
+	auto body = this->term(codomain, budget - 1, depth + 1);
+	this->scope.pop_back();
+	return make_unique<Abstraction>(this->types.to_type(domain), std::move(name), std::move(body));
+}
+
+// x a1 ... ak for an x in scope whose type returns `type` after k arguments.
+unique_ptr<Term> TermGenerator::variable_application(std::uint32_t type, std::size_t budget, std::size_t depth) {
+	struct Candidate {
+		std::size_t binding;
+		std::size_t arity;
+	};
+	std::vector<Candidate> candidates;
+	for (std::size_t i = 0; i < this->scope.size(); ++i) {
+		auto current = this->scope[i].type;
+		for (std::size_t arity = 1; arity <= this->options.max_arity; ++arity) {
+			if (this->types[current].kind != TypeKind::Function) break;
+			current = this->types[current].codomain;
+			if (current == type) candidates.push_back({i, arity});
+		}
+	}
+	if (candidates.empty()) return nullptr;
+
+	const auto [binding, arity] = candidates[this->below(candidates.size())];
+	const auto head = this->scope[binding];
+	unique_ptr<Term> result = make_unique<Variable>(head.name, this->types.to_type(head.type));
+	auto current = head.type;
+	const auto shares = this->split(budget > 2 * arity ? budget - 2 * arity : 0, arity);
+	for (std::size_t i = 0; i < arity; ++i) {
+		const auto entry = this->types[current];
+		result = make_unique<Application>(std::move(result), this->term(entry.domain, shares[i], depth + 1));
+		current = entry.codomain;
+	}
+	return result;
+}
+
+// Arithmetic at Nat, comparisons at Bool, and if at any type.
+unique_ptr<Term> TermGenerator::primitive_application(std::uint32_t type, std::size_t budget, std::size_t depth) {
+	static constexpr PrimitiveOp NAT_OPS[] = {PrimitiveOp::Add, PrimitiveOp::Sub, PrimitiveOp::Mul};
+	static constexpr PrimitiveOp BOOL_OPS[] = {PrimitiveOp::Eq, PrimitiveOp::Lt};
+
+	if ((type != this->nat && type != this->boolean) || this->chance(0.25)) {
+		const auto shares = this->split(budget > 4 ? budget - 4 : 0, 3);
+		auto condition = this->term(this->boolean, shares[0], depth + 1);
+		auto then_branch = this->term(type, shares[1], depth + 1);
+		auto else_branch = this->term(type, shares[2], depth + 1);
+		auto head = make_unique<Primitive>(PrimitiveOp::If, this->types.to_type(type));
+		return make_unique<Application>(
+			make_unique<Application>(make_unique<Application>(std::move(head), std::move(condition)), std::move(then_branch)),
+			std::move(else_branch));
+	}
+
+	const auto op = type == this->nat ? NAT_OPS[this->below(3)] : BOOL_OPS[this->below(2)];
+	const auto shares = this->split(budget > 3 ? budget - 3 : 0, 2);
+	auto lhs = this->term(this->nat, shares[0], depth + 1);
+	auto rhs = this->term(this->nat, shares[1], depth + 1);
+	return make_unique<Application>(make_unique<Application>(make_unique<Primitive>(op), std::move(lhs)), std::move(rhs));
+}
+
+// The smallest term of `type` available here: a variable of that type, a
+// literal, or λx. leaf.
+unique_ptr<Term> TermGenerator::leaf(std::uint32_t type, std::size_t depth) {
+	std::vector<std::size_t> matches;
+	for (std::size_t i = 0; i < this->scope.size(); ++i) {
+		if (this->scope[i].type == type) matches.push_back(i);
+	}
+	if (!matches.empty() && (!this->options.primitives || this->types[type].kind == TypeKind::Function || this->chance(0.7))) {
+		const auto& binding = this->scope[matches[this->below(matches.size())]];
+		return make_unique<Variable>(binding.name, this->types.to_type(type));
+	}
+	if (type == this->nat) return Literal::nat(this->below(100));
+	if (type == this->boolean) return Literal::boolean(this->chance(0.5));
+	const auto entry = this->types[type];
+	return this->abstraction(entry.domain, entry.codomain, 1, depth);
+}
@@ -0,0 +1,79 @@
+//
+// TermGenerator.h
+//
+// Seeded generator of random closed, well-typed terms for load generation,
+// scaling benchmarks and property tests. Generation is type-directed: every
+// subterm is built against the type it must have, so no rejection sampling
+// is needed. Base types are Nat and Bool, whose literals make every type
+// cheaply inhabited.
+//
+
+#ifndef TERMGENERATOR_H
+#define TERMGENERATOR_H
+
+#include "Terms.h"
+#include "Type.h"
+#include "TermTape.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+struct GeneratorOptions {
+	std::uint64_t seed = 0;
+	// Approximate node count of a generated term.
+	std::size_t size = 100;
+	// Nesting limit; deeper subterms are closed off with small leaves.
+	std::size_t max_depth = 48;
+	// Most arguments a variable head is applied to.
+	std::size_t max_arity = 3;
+	// Arrow nesting of the types of binders and of generate().
+	std::size_t type_depth = 2;
+	// Chance that a subterm is a β-redex (λx:A. t) u.
+	double redex_density = 0.1;
+	// Allow literals' operators (and their δ-redexes) and let.
+	bool primitives = true;
+	bool lets = true;
+};
+
+class TermGenerator {
+public:
+	explicit TermGenerator(GeneratorOptions options);
+
+	// A closed term of a random type.
+	[[nodiscard]] std::unique_ptr<Term> generate();
+	// A closed term of `type`, which must be built from Nat and Bool.
+	[[nodiscard]] std::unique_ptr<Term> generate(const Type& type);
+	[[nodiscard]] std::unique_ptr<Type> random_type();
+
+private:
+	struct Binding {
+		std::string name;
+		std::uint32_t type;
+	};
+
+	GeneratorOptions options;
+	std::mt19937_64 random;
+	TypeTable types;
+	std::uint32_t nat;
+	std::uint32_t boolean;
+	std::vector<Binding> scope;
+	std::size_t next_name = 0;
+
+	[[nodiscard]] bool chance(double probability);
+	[[nodiscard]] std::size_t below(std::size_t bound);
+	[[nodiscard]] std::uint32_t random_type(std::size_t depth);
+	[[nodiscard]] std::string fresh_name();
+	[[nodiscard]] std::vector<std::size_t> split(std::size_t budget, std::size_t parts);
+
+	[[nodiscard]] std::unique_ptr<Term> term(std::uint32_t type, std::size_t budget, std::size_t depth);
+	[[nodiscard]] std::unique_ptr<Term> leaf(std::uint32_t type, std::size_t depth);
+	[[nodiscard]] std::unique_ptr<Term> abstraction(std::uint32_t domain, std::uint32_t codomain, std::size_t budget, std::size_t depth);
+	[[nodiscard]] std::unique_ptr<Term> variable_application(std::uint32_t type, std::size_t budget, std::size_t depth);
+	[[nodiscard]] std::unique_ptr<Term> primitive_application(std::uint32_t type, std::size_t budget, std::size_t depth);
+};
+
+#endif //TERMGENERATOR_H
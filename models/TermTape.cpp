@@ -0,0 +1,541 @@
+//
+// TermTape.cpp
+//
+
+#include "TermTape.h"
+
+#include "terms/Variable.h"
+#include "terms/Abstraction.h"
+#include "terms/Application.h"
+#include "terms/Literal.h"
+#include "terms/Primitive.h"
+#include "terms/Let.h"
+#include "terms/Reference.h"
+#include "terms/Pair.h"
+#include "terms/Projection.h"
+#include "terms/Injection.h"
+#include "terms/Case.h"
+#include "../exceptions/Exceptions.h"
+
+#include <stdexcept>
+#include <variant>
+
+using std::unique_ptr, std::make_unique;
+
+std::uint32_t TypeTable::intern_base(const std::string& name) {
+	auto name_it = this->name_index.find(name);
+	if (name_it == this->name_index.end()) {
+		name_it = this->name_index.emplace(name, static_cast<std::uint32_t>(this->names.size())).first;
+		this->names.push_back(name);
+	}
+	const auto key = std::make_tuple(TypeKind::Base, name_it->second, npos, npos);
+	if (const auto it = this->index.find(key); it != this->index.end()) return it->second;
+	const auto id = static_cast<std::uint32_t>(this->entries.size());
+	this->entries.push_back({TypeKind::Base, name_it->second, npos, npos});
+	this->index.emplace(key, id);
+	return id;
+}
+
+std::uint32_t TypeTable::intern_compound(TypeKind kind, std::uint32_t first, std::uint32_t second) {
+	const auto key = std::make_tuple(kind, npos, first, second);
+	if (const auto it = this->index.find(key); it != this->index.end()) return it->second;
+	const auto id = static_cast<std::uint32_t>(this->entries.size());
+	this->entries.push_back({kind, npos, first, second});
+	this->index.emplace(key, id);
+	return id;
+}
+
+std::uint32_t TypeTable::intern_function(std::uint32_t domain, std::uint32_t codomain) {
+	return this->intern_compound(TypeKind::Function, domain, codomain);
+}
+
+std::uint32_t TypeTable::intern_product(std::uint32_t first, std::uint32_t second) {
+	return this->intern_compound(TypeKind::Product, first, second);
+}
+
+std::uint32_t TypeTable::intern_sum(std::uint32_t left, std::uint32_t right) {
+	return this->intern_compound(TypeKind::Sum, left, right);
+}
+
+std::uint32_t TypeTable::intern(const Type& type) {
+	if (const auto* base = dynamic_cast<const BaseType*>(&type)) {
+		return this->intern_base(base->name);
+	}
+	if (const auto* func = dynamic_cast<const FunctionType*>(&type)) {
+		const auto domain = this->intern(*func->domain);
+		return this->intern_function(domain, this->intern(*func->codomain));
+	}
+	if (const auto* product = dynamic_cast<const ProductType*>(&type)) {
+		const auto first = this->intern(*product->first);
+		return this->intern_product(first, this->intern(*product->second));
+	}
+	if (const auto* sum = dynamic_cast<const SumType*>(&type)) {
+		const auto left = this->intern(*sum->left);
+		return this->intern_sum(left, this->intern(*sum->right));
+	}
+	throw std::invalid_argument("Unsupported type '" + type.to_string() + "'");
+}
+
+std::string TypeTable::to_string(std::uint32_t id) const {
+	const auto& entry = this->entries[id];
+	switch (entry.kind) {
+		case TypeKind::Base:
+			return this->names[entry.name];
+		case TypeKind::Function: {
+			// Same bracketing as FunctionType::to_string.
+			std::string domain_str = this->to_string(entry.domain);
+			std::string codomain_str = this->to_string(entry.codomain);
+			if (this->entries[entry.domain].kind == TypeKind::Function) domain_str = "(" + domain_str + ")";
+			if (this->entries[entry.codomain].kind == TypeKind::Function) codomain_str = "(" + codomain_str + ")";
+			return domain_str + " -> " + codomain_str;
+		}
+		case TypeKind::Product:
+		case TypeKind::Sum: {
+			// Same bracketing as ProductType and SumType::to_string.
+			std::string first_str = this->to_string(entry.domain);
+			std::string second_str = this->to_string(entry.codomain);
+			if (this->entries[entry.domain].kind != TypeKind::Base) first_str = "(" + first_str + ")";
+			if (this->entries[entry.codomain].kind != TypeKind::Base) second_str = "(" + second_str + ")";
+			return first_str + (entry.kind == TypeKind::Product ? " * " : " + ") + second_str;
+		}
+	}
+	return "";
+}
+
+unique_ptr<Type> TypeTable::to_type(std::uint32_t id) const {
+	const auto& entry = this->entries[id];
+	switch (entry.kind) {
+		case TypeKind::Base:
+			return make_unique<BaseType>(this->names[entry.name]);
+		case TypeKind::Function:
+			return make_unique<FunctionType>(this->to_type(entry.domain), this->to_type(entry.codomain));
+		case TypeKind::Product:
+			return make_unique<ProductType>(this->to_type(entry.domain), this->to_type(entry.codomain));
+		case TypeKind::Sum:
+			return make_unique<SumType>(this->to_type(entry.domain), this->to_type(entry.codomain));
+	}
+	return nullptr;
+}
+
+TermTape::TermTape(const Term& term) {
+	std::vector<std::pair<std::uint32_t, std::vector<std::uint32_t>>> binders;
+	std::map<std::string, std::uint32_t, std::less<>> lookup;
+	this->append(term, binders, lookup);
+}
+
+std::uint32_t TermTape::intern_name(const std::string& name, std::map<std::string, std::uint32_t, std::less<>>& lookup) {
+	if (const auto it = lookup.find(name); it != lookup.end()) return it->second;
+	const auto id = static_cast<std::uint32_t>(this->name_table.size());
+	this->name_table.push_back(name);
+	lookup.emplace(name, id);
+	return id;
+}
+
+std::uint32_t TermTape::append(const Term& term, std::vector<std::pair<std::uint32_t, std::vector<std::uint32_t>>>& binders,
+	std::map<std::string, std::uint32_t, std::less<>>& lookup) {
+	const auto position = static_cast<std::uint32_t>(this->tape.size());
+
+	if (const auto* var = dynamic_cast<const Variable*>(&term)) {
+		const auto name = this->intern_name(var->name, lookup);
+		// Binder indices are patched in once the enclosing abstraction is emitted.
+		for (auto it = binders.rbegin(); it != binders.rend(); ++it) {
+			if (it->first == name) {
+				it->second.push_back(position);
+				break;
+			}
+		}
+		this->tape.push_back({TermKind::Variable, name, this->type_table.intern(var->get_type()), npos, npos});
+		return position;
+	}
+	if (const auto* abs = dynamic_cast<const Abstraction*>(&term)) {
+		const auto name = this->intern_name(abs->var_name, lookup);
+		binders.emplace_back(name, std::vector<std::uint32_t>{});
+		const auto body = this->append(*abs->body, binders, lookup);
+		const auto binder = static_cast<std::uint32_t>(this->tape.size());
+		for (const auto occurrence : binders.back().second) this->tape[occurrence].left = binder;
+		binders.pop_back();
+		this->tape.push_back({TermKind::Abstraction, name, this->type_table.intern(*abs->var_type), body, npos});
+		return binder;
+	}
+	if (const auto* app = dynamic_cast<const Application*>(&term)) {
+		const auto function = this->append(*app->function, binders, lookup);
+		const auto value = this->append(*app->value, binders, lookup);
+		const auto application = static_cast<std::uint32_t>(this->tape.size());
+		this->tape.push_back({TermKind::Application, npos, npos, function, value});
+		return application;
+	}
+	if (const auto* literal = dynamic_cast<const Literal*>(&term)) {
+		const auto type = this->type_table.intern_base(literal->kind == LiteralKind::Nat ? NAT_TYPE_NAME : BOOL_TYPE_NAME);
+		this->tape.push_back({TermKind::Literal, static_cast<std::uint32_t>(this->literal_table.size()), type, npos, npos});
+		this->literal_table.push_back({literal->kind, literal->value});
+		return position;
+	}
+	if (const auto* prim = dynamic_cast<const Primitive*>(&term)) {
+		const auto branch_type = prim->branch_type ? this->type_table.intern(*prim->branch_type) : npos;
+		this->tape.push_back({TermKind::Primitive, static_cast<std::uint32_t>(prim->op), branch_type, npos, npos});
+		return position;
+	}
+	if (const auto* let = dynamic_cast<const Let*>(&term)) {
+		const auto name = this->intern_name(let->var_name, lookup);
+		const auto bound = this->append(*let->bound, binders, lookup);
+		binders.emplace_back(name, std::vector<std::uint32_t>{});
+		const auto body = this->append(*let->body, binders, lookup);
+		const auto binder = static_cast<std::uint32_t>(this->tape.size());
+		for (const auto occurrence : binders.back().second) this->tape[occurrence].left = binder;
+		binders.pop_back();
+		this->tape.push_back({TermKind::Let, name, npos, bound, body});
+		return binder;
+	}
+	if (const auto* ref = dynamic_cast<const Reference*>(&term)) {
+		this->tape.push_back({TermKind::Reference, static_cast<std::uint32_t>(this->definition_table.size()), npos, npos, npos});
+		this->definition_table.push_back(ref->definition);
+		return position;
+	}
+	if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+		const auto first = this->append(*pair->first, binders, lookup);
+		const auto second = this->append(*pair->second, binders, lookup);
+		const auto node = static_cast<std::uint32_t>(this->tape.size());
+		this->tape.push_back({TermKind::Pair, npos, npos, first, second});
+		return node;
+	}
+	if (const auto* projection = dynamic_cast<const Projection*>(&term)) {
+		const auto operand = this->append(*projection->operand, binders, lookup);
+		const auto node = static_cast<std::uint32_t>(this->tape.size());
+		this->tape.push_back({TermKind::Projection, static_cast<std::uint32_t>(projection->component), npos, operand, npos});
+		return node;
+	}
+	if (const auto* injection = dynamic_cast<const Injection*>(&term)) {
+		const auto value = this->append(*injection->value, binders, lookup);
+		const auto node = static_cast<std::uint32_t>(this->tape.size());
+		this->tape.push_back({TermKind::Injection, static_cast<std::uint32_t>(injection->side),
+			this->type_table.intern(*injection->sum_type), value, npos});
+		return node;
+	}
+	if (const auto* match = dynamic_cast<const Case*>(&term)) {
+		const auto scrutinee = this->append(*match->scrutinee, binders, lookup);
+		const auto on_left = this->append(*match->on_left, binders, lookup);
+		const auto on_right = this->append(*match->on_right, binders, lookup);
+		const auto node = static_cast<std::uint32_t>(this->tape.size());
+		this->tape.push_back({TermKind::Case, on_right, npos, scrutinee, on_left});
+		return node;
+	}
+	throw std::invalid_argument("Unsupported term '" + term.to_string() + "'");
+}
+
+bool TermTape::is_normal() const {
+	// Per node: whether it is normal, and for primitive spines the number of
+	// arguments applied so far (npos when not headed by an unsaturated
+	// primitive) and whether every strict argument so far is a literal.
+	struct Scan {
+		std::uint8_t normal;
+		std::uint8_t strict_ok;
+		std::uint32_t applied;
+	};
+	std::vector<Scan> scan(this->tape.size());
+	std::vector<PrimitiveOp> head(this->tape.size());
+	for (std::size_t i = 0; i < this->tape.size(); ++i) {
+		const auto& node = this->tape[i];
+		switch (node.kind) {
+			case TermKind::Variable:
+			case TermKind::Literal:
+				scan[i] = {true, false, npos};
+				break;
+			case TermKind::Let:
+			case TermKind::Reference:
+				scan[i] = {false, false, npos};
+				break;
+			case TermKind::Primitive:
+				scan[i] = {true, true, 0};
+				head[i] = static_cast<PrimitiveOp>(node.name);
+				break;
+			case TermKind::Abstraction:
+				scan[i] = {scan[node.left].normal, false, npos};
+				break;
+			case TermKind::Application: {
+				const auto& function = scan[node.left];
+				bool delta_redex = false;
+				scan[i] = {false, false, npos};
+				if (function.applied != npos && function.applied < primitive_arity(head[node.left])) {
+					const auto op = head[node.left];
+					LiteralKind expected;
+					bool strict_ok = function.strict_ok;
+					if (primitive_strict_in(op, function.applied, expected)) {
+						const auto& value = this->tape[node.right];
+						strict_ok = strict_ok && value.kind == TermKind::Literal && this->literal_table[value.name].kind == expected;
+					}
+					head[i] = op;
+					scan[i].applied = function.applied + 1;
+					scan[i].strict_ok = strict_ok;
+					delta_redex = strict_ok && scan[i].applied == primitive_arity(op);
+				}
+				scan[i].normal = this->tape[node.left].kind != TermKind::Abstraction && !delta_redex
+					&& function.normal && scan[node.right].normal;
+				break;
+			}
+			case TermKind::Pair:
+				scan[i] = {scan[node.left].normal && scan[node.right].normal, false, npos};
+				break;
+			case TermKind::Projection:
+				scan[i] = {this->tape[node.left].kind != TermKind::Pair && scan[node.left].normal, false, npos};
+				break;
+			case TermKind::Injection:
+				scan[i] = {scan[node.left].normal, false, npos};
+				break;
+			case TermKind::Case:
+				scan[i] = {this->tape[node.left].kind != TermKind::Injection && scan[node.left].normal
+					&& scan[node.right].normal && scan[node.name].normal, false, npos};
+				break;
+		}
+	}
+	return scan.back().normal;
+}
+
+bool TermTape::has_free(const std::string& target) const {
+	std::uint32_t name = npos;
+	for (std::size_t i = 0; i < this->name_table.size(); ++i) {
+		if (this->name_table[i] == target) name = static_cast<std::uint32_t>(i);
+	}
+	if (name == npos) return false;
+
+	// Only a variable without a binder can be free, and its binder link
+	// already says so: no scope needs to be tracked.
+	for (const auto& node : this->tape) {
+		if (node.kind == TermKind::Variable && node.name == name && node.left == npos) return true;
+	}
+	return false;
+}
+
+namespace {
+	// Codomain of a case branch that must accept `domain`.
+	std::uint32_t branch_codomain(const TypeTable& table, std::uint32_t branch, std::uint32_t domain) {
+		if (table[branch].kind != TypeKind::Function) throw NotAFunctionError(table.to_string(branch));
+		if (table[branch].domain != domain) throw DomainTypeMismatchError(table.to_string(table[branch].domain), table.to_string(domain));
+		return table[branch].codomain;
+	}
+}
+
+unique_ptr<Type> TermTape::type_check(const TypingContext& context) const {
+	TypeTable table = this->type_table;
+	std::vector<std::uint32_t> types(this->tape.size());
+	for (std::size_t i = 0; i < this->tape.size(); ++i) {
+		const auto& node = this->tape[i];
+		switch (node.kind) {
+			case TermKind::Variable:
+				if (node.left != npos) {
+					const auto& binder = this->tape[node.left];
+					types[i] = binder.kind == TermKind::Let ? types[binder.left] : binder.type;
+				} else {
+					const Type* type = context.lookup(this->name_table[node.name]);
+					if (type == nullptr) throw UndeclaredVariableError(this->name_table[node.name]);
+					types[i] = table.intern(*type);
+				}
+				break;
+			case TermKind::Abstraction:
+				types[i] = table.intern_function(node.type, types[node.left]);
+				break;
+			case TermKind::Application: {
+				const auto func_type = types[node.left];
+				if (table[func_type].kind != TypeKind::Function) {
+					throw NotAFunctionError(table.to_string(func_type));
+				}
+				if (table[func_type].domain != types[node.right]) {
+					throw DomainTypeMismatchError(table.to_string(types[node.right]), table.to_string(table[func_type].domain));
+				}
+				types[i] = table[func_type].codomain;
+				break;
+			}
+			case TermKind::Literal:
+				types[i] = node.type;
+				break;
+			case TermKind::Primitive: {
+				const auto branch_type = node.type == npos ? nullptr : table.to_type(node.type);
+				types[i] = table.intern(*primitive_type(static_cast<PrimitiveOp>(node.name), branch_type.get()));
+				break;
+			}
+			case TermKind::Let:
+				types[i] = types[node.right];
+				break;
+			case TermKind::Reference:
+				types[i] = table.intern(this->definition_table[node.name]->type());
+				break;
+			case TermKind::Pair:
+				types[i] = table.intern_product(types[node.left], types[node.right]);
+				break;
+			case TermKind::Projection: {
+				const auto operand_type = types[node.left];
+				if (table[operand_type].kind != TypeKind::Product) throw NotAProductError(table.to_string(operand_type));
+				types[i] = static_cast<Component>(node.name) == Component::First ? table[operand_type].domain : table[operand_type].codomain;
+				break;
+			}
+			case TermKind::Injection: {
+				if (table[node.type].kind != TypeKind::Sum) throw NotASumError(table.to_string(node.type));
+				const auto expected = static_cast<Side>(node.name) == Side::Left ? table[node.type].domain : table[node.type].codomain;
+				if (types[node.left] != expected) throw DomainTypeMismatchError(table.to_string(expected), table.to_string(types[node.left]));
+				types[i] = node.type;
+				break;
+			}
+			case TermKind::Case: {
+				const auto sum = types[node.left];
+				if (table[sum].kind != TypeKind::Sum) throw NotASumError(table.to_string(sum));
+				const auto left = branch_codomain(table, types[node.right], table[sum].domain);
+				const auto right = branch_codomain(table, types[node.name], table[sum].codomain);
+				if (left != right) throw BranchTypeMismatchError(table.to_string(left), table.to_string(right));
+				types[i] = left;
+				break;
+			}
+		}
+	}
+	return table.to_type(types.back());
+}
+
+std::string TermTape::to_string() const {
+	std::string out;
+	std::vector<std::variant<std::uint32_t, const char*>> pending{this->root()};
+	while (!pending.empty()) {
+		const auto item = pending.back();
+		pending.pop_back();
+		if (const auto* literal = std::get_if<const char*>(&item)) {
+			out += *literal;
+			continue;
+		}
+		const auto& node = this->tape[std::get<std::uint32_t>(item)];
+		switch (node.kind) {
+			case TermKind::Variable:
+				out += this->name_table[node.name];
+				break;
+			case TermKind::Abstraction:
+				out += "λ";
+				out += this->name_table[node.name];
+				out += ". ";
+				pending.emplace_back(node.left);
+				break;
+			case TermKind::Application:
+				out += "(";
+				pending.emplace_back(")");
+				pending.emplace_back(node.right);
+				pending.emplace_back(") (");
+				pending.emplace_back(node.left);
+				break;
+			case TermKind::Literal: {
+				const auto& literal = this->literal_table[node.name];
+				if (literal.kind == LiteralKind::Bool) out += literal.value ? "true" : "false";
+				else out += std::to_string(literal.value);
+				break;
+			}
+			case TermKind::Primitive:
+				out += primitive_name(static_cast<PrimitiveOp>(node.name));
+				break;
+			case TermKind::Let:
+				out += "let ";
+				out += this->name_table[node.name];
+				out += " = ";
+				pending.emplace_back(node.right);
+				pending.emplace_back(" in ");
+				pending.emplace_back(node.left);
+				break;
+			case TermKind::Reference:
+				out += this->definition_table[node.name]->name;
+				break;
+			case TermKind::Pair:
+				out += "(";
+				pending.emplace_back(")");
+				pending.emplace_back(node.right);
+				pending.emplace_back(", ");
+				pending.emplace_back(node.left);
+				break;
+			case TermKind::Projection:
+				out += component_name(static_cast<Component>(node.name));
+				out += " (";
+				pending.emplace_back(")");
+				pending.emplace_back(node.left);
+				break;
+			case TermKind::Injection:
+				out += side_name(static_cast<Side>(node.name));
+				out += "[";
+				out += this->type_table.to_string(node.type);
+				out += "] (";
+				pending.emplace_back(")");
+				pending.emplace_back(node.left);
+				break;
+			case TermKind::Case:
+				out += "case (";
+				pending.emplace_back(")");
+				pending.emplace_back(node.name);
+				pending.emplace_back(") (");
+				pending.emplace_back(node.right);
+				pending.emplace_back(") (");
+				pending.emplace_back(node.left);
+				break;
+		}
+	}
+	return out;
+}
+
+unique_ptr<Term> TermTape::to_term() const {
+	std::vector<unique_ptr<Term>> built;
+	for (const auto& node : this->tape) {
+		switch (node.kind) {
+			case TermKind::Variable:
+				built.push_back(make_unique<Variable>(this->name_table[node.name], this->type_table.to_type(node.type)));
+				break;
+			case TermKind::Abstraction: {
+				auto body = std::move(built.back());
+				built.back() = make_unique<Abstraction>(this->type_table.to_type(node.type), this->name_table[node.name], std::move(body));
+				break;
+			}
+			case TermKind::Application: {
+				auto value = std::move(built.back());
+				built.pop_back();
+				auto function = std::move(built.back());
+				built.back() = make_unique<Application>(std::move(function), std::move(value));
+				break;
+			}
+			case TermKind::Literal: {
+				const auto& literal = this->literal_table[node.name];
+				built.push_back(make_unique<Literal>(literal.kind, literal.value));
+				break;
+			}
+			case TermKind::Primitive:
+				built.push_back(make_unique<Primitive>(static_cast<PrimitiveOp>(node.name),
+					node.type == npos ? nullptr : this->type_table.to_type(node.type)));
+				break;
+			case TermKind::Let: {
+				auto body = std::move(built.back());
+				built.pop_back();
+				auto bound = std::move(built.back());
+				built.back() = make_unique<Let>(this->name_table[node.name], std::move(bound), std::move(body));
+				break;
+			}
+			case TermKind::Reference:
+				built.push_back(make_unique<Reference>(this->definition_table[node.name]));
+				break;
+			case TermKind::Pair: {
+				auto second = std::move(built.back());
+				built.pop_back();
+				auto first = std::move(built.back());
+				built.back() = make_unique<Pair>(std::move(first), std::move(second));
+				break;
+			}
+			case TermKind::Projection: {
+				auto operand = std::move(built.back());
+				built.back() = make_unique<Projection>(static_cast<Component>(node.name), std::move(operand));
+				break;
+			}
+			case TermKind::Injection: {
+				auto value = std::move(built.back());
+				built.back() = make_unique<Injection>(static_cast<Side>(node.name), this->type_table.to_type(node.type), std::move(value));
+				break;
+			}
+			case TermKind::Case: {
+				auto on_right = std::move(built.back());
+				built.pop_back();
+				auto on_left = std::move(built.back());
+				built.pop_back();
+				auto scrutinee = std::move(built.back());
+				built.back() = make_unique<Case>(std::move(scrutinee), std::move(on_left), std::move(on_right));
+				break;
+			}
+		}
+	}
+	return std::move(built.back());
+}
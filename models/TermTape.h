@@ -0,0 +1,112 @@
+//
+// TermTape.h
+//
+// Immutable flat encoding of a term: every node lives in one contiguous
+// array in post-order, so children always precede their parent and the root
+// is the last entry. Read-only analyses are single linear scans over that
+// array instead of pointer chasing through unique_ptr children.
+//
+
+#ifndef TERMTAPE_H
+#define TERMTAPE_H
+
+#include "Terms.h"
+#include "Type.h"
+#include "TaggedTerm.h"
+#include "TypingContext.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Hash-consed type table: structurally equal types share one id, so type
+// equality during checking is an integer comparison.
+class TypeTable {
+public:
+	static constexpr std::uint32_t npos = UINT32_MAX;
+
+	struct Entry {
+		TypeKind kind;
+		std::uint32_t name;
+		// Also the components of a product or a sum.
+		std::uint32_t domain;
+		std::uint32_t codomain;
+	};
+
+	[[nodiscard]] std::uint32_t intern_base(const std::string& name);
+	[[nodiscard]] std::uint32_t intern_function(std::uint32_t domain, std::uint32_t codomain);
+	[[nodiscard]] std::uint32_t intern_product(std::uint32_t first, std::uint32_t second);
+	[[nodiscard]] std::uint32_t intern_sum(std::uint32_t left, std::uint32_t right);
+	[[nodiscard]] std::uint32_t intern(const Type& type);
+
+	[[nodiscard]] const Entry& operator[](std::uint32_t id) const { return entries[id]; }
+	[[nodiscard]] std::string to_string(std::uint32_t id) const;
+	[[nodiscard]] std::unique_ptr<Type> to_type(std::uint32_t id) const;
+
+private:
+	std::vector<Entry> entries;
+	std::vector<std::string> names;
+	std::map<std::tuple<TypeKind, std::uint32_t, std::uint32_t, std::uint32_t>, std::uint32_t> index;
+	std::map<std::string, std::uint32_t, std::less<>> name_index;
+
+	[[nodiscard]] std::uint32_t intern_compound(TypeKind kind, std::uint32_t first, std::uint32_t second);
+};
+
+class TermTape {
+public:
+	static constexpr std::uint32_t npos = UINT32_MAX;
+
+	struct Node {
+		TermKind kind;
+		// Variable name or binder name, an index into names(). For a Literal,
+		// an index into literals(); for a Primitive, its PrimitiveOp; for a
+		// Reference, an index into definitions(); for a Projection, its
+		// Component; for an Injection, its Side; for a Case, the index of
+		// the right branch.
+		std::uint32_t name;
+		// Variable annotation, binder type, If branch type or the sum type
+		// of an Injection, an id in types().
+		std::uint32_t type;
+		// Abstraction body / Application function / Let bound term / first
+		// component of a Pair / operand of a Projection / Injection payload /
+		// Case scrutinee. For a Variable, the index of its binding
+		// Abstraction or Let, or npos when free.
+		std::uint32_t left;
+		// Application value / Let body / second component of a Pair / left
+		// branch of a Case.
+		std::uint32_t right;
+	};
+
+	explicit TermTape(const Term& term);
+
+	[[nodiscard]] const std::vector<Node>& nodes() const { return tape; }
+	[[nodiscard]] const std::vector<std::string>& names() const { return name_table; }
+	[[nodiscard]] const std::vector<LiteralValue>& literals() const { return literal_table; }
+	[[nodiscard]] const std::vector<std::shared_ptr<const Definition>>& definitions() const { return definition_table; }
+	[[nodiscard]] const TypeTable& types() const { return type_table; }
+	[[nodiscard]] std::uint32_t root() const { return static_cast<std::uint32_t>(tape.size() - 1); }
+	[[nodiscard]] std::size_t size() const { return tape.size(); }
+
+	[[nodiscard]] bool is_normal() const;
+	[[nodiscard]] bool has_free(const std::string& target) const;
+	[[nodiscard]] std::unique_ptr<Type> type_check(const TypingContext& context) const;
+	[[nodiscard]] std::string to_string() const;
+
+	[[nodiscard]] std::unique_ptr<Term> to_term() const;
+
+private:
+	std::vector<Node> tape;
+	std::vector<std::string> name_table;
+	std::vector<LiteralValue> literal_table;
+	std::vector<std::shared_ptr<const Definition>> definition_table;
+	TypeTable type_table;
+
+	[[nodiscard]] std::uint32_t intern_name(const std::string& name, std::map<std::string, std::uint32_t, std::less<>>& lookup);
+	std::uint32_t append(const Term& term, std::vector<std::pair<std::uint32_t, std::vector<std::uint32_t>>>& binders,
+		std::map<std::string, std::uint32_t, std::less<>>& lookup);
+};
+
+#endif //TERMTAPE_H
@@ -3,10 +3,48 @@
 //
 
 #include "Terms.h"
+#include "MemoryProfile.h"
 
 Term::~Term() = default;
 
+void* Term::operator new(std::size_t size) {
+	record_term_allocation(size);
+	return ::operator new(size);
+}
+
+void Term::operator delete(void* pointer, std::size_t size) {
+	record_term_deallocation(size);
+	::operator delete(pointer, size);
+}
+
 std::ostream& operator<<(std::ostream& os, const Term& term) {
 	os << term.to_string();
 	return os;
+}
+
+std::unique_ptr<Term> substitute(std::unique_ptr<Term>&& term, const std::string& target, const Term& newValue) {
+	Term* node = term.get();
+	return node->substitute_in_place(std::move(term), target, newValue);
+}
+
+std::unique_ptr<Term> beta_reduce(std::unique_ptr<Term>&& term) {
+	Term* node = term.get();
+	return node->beta_reduce_in_place(std::move(term));
+}
+
+std::uint64_t alpha_hash(const Term& term) {
+	BinderScope scope;
+	return term.alpha_hash(scope);
+}
+
+std::uint64_t type_hash(const Type& type) {
+	if (const auto* base = dynamic_cast<const BaseType*>(&type)) return hash_mix(1, hash_name(base->name));
+	if (const auto* function = dynamic_cast<const FunctionType*>(&type)) {
+		return hash_mix(hash_mix(2, type_hash(*function->domain)), type_hash(*function->codomain));
+	}
+	if (const auto* product = dynamic_cast<const ProductType*>(&type)) {
+		return hash_mix(hash_mix(3, type_hash(*product->first)), type_hash(*product->second));
+	}
+	const auto& sum = dynamic_cast<const SumType&>(type);
+	return hash_mix(hash_mix(4, type_hash(*sum.left)), type_hash(*sum.right));
 }
\ No newline at end of file
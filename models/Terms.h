@@ -7,15 +7,60 @@
 
 #include "Type.h"
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <iostream>
+#include <vector>
 
 #include "TypingContext.h"
 
+// Node count and approximate heap footprint of a term, type annotations
+// excluded. Used to bound evaluation by term size.
+struct TermSize {
+    std::size_t nodes = 0;
+    std::size_t bytes = 0;
+
+    TermSize& operator+=(const TermSize& other) {
+        this->nodes += other.nodes;
+        this->bytes += other.bytes;
+        return *this;
+    }
+};
+
+// Bytes a string holds outside its small-string buffer.
+[[nodiscard]] inline std::size_t heap_bytes(const std::string& text) {
+    return text.capacity() > std::string().capacity() ? text.capacity() + 1 : 0;
+}
+
+// Names bound around a subterm, innermost last. Alpha-invariant hashing
+// looks bound variables up here and hashes their de Bruijn index.
+using BinderScope = std::vector<std::string_view>;
+
+// Hash building blocks. They do not depend on the standard library's
+// std::hash, so values are stable across builds and processes.
+[[nodiscard]] inline std::uint64_t hash_mix(std::uint64_t seed, std::uint64_t value) {
+    std::uint64_t x = seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+[[nodiscard]] inline std::uint64_t hash_name(std::string_view name) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const unsigned char c : name) hash = (hash ^ c) * 0x100000001b3ULL;
+    return hash;
+}
+
 class Term {
 public:
     virtual ~Term() = 0;
+
+    // Route every node allocation through the hooks of MemoryProfile.h.
+    static void* operator new(std::size_t size);
+    static void operator delete(void* pointer, std::size_t size);
+
     [[nodiscard]] virtual std::unique_ptr<Term> alpha_convert(std::string newValue) const = 0;
     [[nodiscard]] virtual std::unique_ptr<Term> substitute(std::string target, Term& newValue) const = 0;
     [[nodiscard]] virtual std::unique_ptr<Term> beta_reduce() const = 0;
@@ -24,8 +69,27 @@ public:
     [[nodiscard]] virtual bool is_normal() const = 0;
     [[nodiscard]] virtual bool has_free(std::string target) const = 0;
     [[nodiscard]] virtual std::string to_string() const = 0;
+    [[nodiscard]] virtual TermSize measure() const = 0;
+    // Equal for alpha-equivalent terms. Binder annotations are ignored; an
+    // injection's sum type is hashed, since it is part of the value.
+    [[nodiscard]] virtual std::uint64_t alpha_hash(BinderScope& scope) const = 0;
+
+    // Consuming rewrites. `self` must own `this`; nodes the rewrite does not
+    // touch are moved into the result instead of being cloned.
+    [[nodiscard]] virtual std::unique_ptr<Term> substitute_in_place(std::unique_ptr<Term> self, const std::string& target, const Term& newValue) = 0;
+    [[nodiscard]] virtual std::unique_ptr<Term> beta_reduce_in_place(std::unique_ptr<Term> self) = 0;
 };
 
+// Consuming forms of substitute() and beta_reduce(); `term` is always
+// moved from. beta_reduce on a normal form throws ReductionOnNormalForm,
+// which then owns the term, so check is_normal() first, or use
+// try_beta_reduce() from Diagnostics.h, which hands a normal form back.
+[[nodiscard]] std::unique_ptr<Term> substitute(std::unique_ptr<Term>&& term, const std::string& target, const Term& newValue);
+[[nodiscard]] std::unique_ptr<Term> beta_reduce(std::unique_ptr<Term>&& term);
+[[nodiscard]] std::uint64_t alpha_hash(const Term& term);
+// Structural hash of a type, stable like hash_mix.
+[[nodiscard]] std::uint64_t type_hash(const Type& type);
+
 std::ostream& operator<<(std::ostream& os, const Term& term);
 std::istream& operator>>(std::istream& is, std::unique_ptr<Term>& term);
 #endif //TERM_H
\ No newline at end of file
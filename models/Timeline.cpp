@@ -0,0 +1,176 @@
+//
+// Timeline.cpp
+//
+
+#include "Timeline.h"
+
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+std::atomic<bool> Timeline::active = false;
+
+namespace {
+
+struct Event {
+	const char* name;
+	std::int64_t begin;
+	std::int64_t end;
+};
+
+// One per thread that recorded a span. The registry owns it, so a worker's
+// events outlive the worker. Only its own thread appends; the lock is there
+// for start() and write_json() and is otherwise uncontended.
+struct Track {
+	std::mutex mutex;
+	std::size_t id = 0;
+	std::string name;
+	std::vector<Event> events;
+	bool finished = false;      // its thread has exited
+};
+
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<Track>> registry;
+std::size_t next_id = 1;
+std::atomic<std::int64_t> origin = 0;
+
+// The calling thread's name and track. The track is registered on the
+// first span it records, so naming threads outside a recording stays
+// local; start() drops the tracks of threads that have exited.
+struct ThreadTrack {
+	std::string name;
+	Track* track = nullptr;
+
+	~ThreadTrack() {
+		if (this->track == nullptr) return;
+		std::lock_guard lock(this->track->mutex);
+		this->track->finished = true;
+	}
+};
+
+thread_local ThreadTrack current;
+
+Track& own_track() {
+	if (current.track == nullptr) {
+		std::lock_guard lock(registry_mutex);
+		auto& track = registry.emplace_back(std::make_unique<Track>());
+		track->id = next_id++;
+		track->name = current.name;
+		current.track = track.get();
+	}
+	return *current.track;
+}
+
+void write_string(std::ostream& out, const std::string& text) {
+	out << '"';
+	for (const char c : text) {
+		if (c == '"' || c == '\\') {
+			out << '\\' << c;
+		} else if (static_cast<unsigned char>(c) < 0x20) {
+			out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+		} else {
+			out << c;
+		}
+	}
+	out << '"';
+}
+
+// Trace-event times are microseconds; keep the nanoseconds as decimals.
+void write_micros(std::ostream& out, std::int64_t nanoseconds) {
+	if (nanoseconds < 0) nanoseconds = 0;
+	out << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+}
+
+}
+
+void Timeline::start() {
+	{
+		std::lock_guard lock(registry_mutex);
+		std::erase_if(registry, [](const auto& track) {
+			std::lock_guard track_lock(track->mutex);
+			track->events.clear();
+			return track->finished;
+		});
+	}
+	origin.store(now(), std::memory_order_relaxed);
+	active.store(true, std::memory_order_release);
+}
+
+void Timeline::stop() {
+	active.store(false, std::memory_order_release);
+}
+
+void Timeline::name_thread(std::string name) {
+	if (current.track != nullptr) {
+		std::lock_guard lock(current.track->mutex);
+		current.track->name = name;
+	}
+	current.name = std::move(name);
+}
+
+std::int64_t Timeline::now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Timeline::record(const char* name, std::int64_t begin, std::int64_t end) {
+	auto& track = own_track();
+	std::lock_guard lock(track.mutex);
+	track.events.push_back(Event{name, begin, end});
+}
+
+std::size_t Timeline::events() {
+	std::lock_guard lock(registry_mutex);
+	std::size_t total = 0;
+	for (const auto& track : registry) {
+		std::lock_guard track_lock(track->mutex);
+		total += track->events.size();
+	}
+	return total;
+}
+
+std::size_t Timeline::tracks() {
+	std::lock_guard lock(registry_mutex);
+	return registry.size();
+}
+
+void Timeline::write_json(std::ostream& out) {
+	const auto base = origin.load(std::memory_order_relaxed);
+	std::lock_guard lock(registry_mutex);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	const auto separate = [&] {
+		if (!first) out << ',';
+		first = false;
+	};
+	for (const auto& track : registry) {
+		std::lock_guard track_lock(track->mutex);
+		// Idle threads would only add empty rows.
+		if (track->events.empty()) continue;
+		if (!track->name.empty()) {
+			separate();
+			out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track->id << ",\"args\":{\"name\":";
+			write_string(out, track->name);
+			out << "}}";
+		}
+		for (const auto& event : track->events) {
+			separate();
+			out << "{\"name\":";
+			write_string(out, event.name);
+			out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << track->id << ",\"ts\":";
+			write_micros(out, event.begin - base);
+			out << ",\"dur\":";
+			write_micros(out, event.end - event.begin);
+			out << '}';
+		}
+	}
+	out << "]}";
+}
+
+std::string Timeline::to_json() {
+	std::ostringstream out;
+	write_json(out);
+	return out.str();
+}
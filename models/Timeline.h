@@ -0,0 +1,81 @@
+//
+// Timeline.h
+//
+// A wall-clock timeline of one run, written as Chrome trace-event JSON for
+// Perfetto (ui.perfetto.dev) or chrome://tracing. TIMELINE_SPAN marks a
+// scope; while a recording is running, each span becomes one complete
+// ("X") event on the track of the thread that ran it, so pipeline stages
+// and work-stealing workers each get a row. Spans nest by time.
+//
+// A span outside a recording costs one relaxed load. Inside one it reads
+// the clock twice and appends to a buffer owned by its thread. Building
+// without LAMBDA_TIMELINE turns TIMELINE_SPAN and TIMELINE_THREAD into
+// nothing at all.
+//
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+class Timeline {
+public:
+	// Drops any earlier events and starts recording on every thread.
+	static void start();
+	static void stop();
+	[[nodiscard]] static bool recording() {
+		return active.load(std::memory_order_relaxed);
+	}
+
+	// Labels the calling thread's track, e.g. "check 2". The name stays in
+	// the thread until it records its first span.
+	static void name_thread(std::string name);
+
+	// Nanoseconds on the steady clock. `name` must outlive the recording;
+	// spans pass string literals.
+	[[nodiscard]] static std::int64_t now();
+	static void record(const char* name, std::int64_t begin, std::int64_t end);
+
+	// Events recorded so far, on threads alive or finished, and the
+	// threads holding a track. start() drops those of finished threads.
+	[[nodiscard]] static std::size_t events();
+	[[nodiscard]] static std::size_t tracks();
+	static void write_json(std::ostream& out);
+	[[nodiscard]] static std::string to_json();
+
+private:
+	static std::atomic<bool> active;
+};
+
+class TimelineSpan {
+public:
+	explicit TimelineSpan(const char* name):
+		name(Timeline::recording() ? name : nullptr),
+		begin(this->name != nullptr ? Timeline::now() : 0)
+	{}
+	~TimelineSpan() {
+		if (this->name != nullptr) Timeline::record(this->name, this->begin, Timeline::now());
+	}
+	TimelineSpan(const TimelineSpan&) = delete;
+	TimelineSpan& operator=(const TimelineSpan&) = delete;
+
+private:
+	const char* name;
+	std::int64_t begin;
+};
+
+#ifdef LAMBDA_TIMELINE
+#define TIMELINE_CONCAT_INNER(a, b) a##b
+#define TIMELINE_CONCAT(a, b) TIMELINE_CONCAT_INNER(a, b)
+#define TIMELINE_SPAN(name) const TimelineSpan TIMELINE_CONCAT(timeline_span_, __LINE__)(name)
+#define TIMELINE_THREAD(name) Timeline::name_thread(name)
+#else
+#define TIMELINE_SPAN(name) static_cast<void>(0)
+#define TIMELINE_THREAD(name) static_cast<void>(0)
+#endif
+
+#endif //TIMELINE_H
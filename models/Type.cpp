@@ -44,4 +44,43 @@ std::string FunctionType::to_string() const {
 
 std::unique_ptr<Type> FunctionType::clone() const {
 	return std::make_unique<FunctionType>(*this);
-}
\ No newline at end of file
+}
+
+namespace {
+	// Products and sums do not associate, so compound operands are always
+	// parenthesized.
+	std::string operand_string(const Type& type) {
+		if (dynamic_cast<const BaseType*>(&type) != nullptr) return type.to_string();
+		return "(" + type.to_string() + ")";
+	}
+}
+
+ProductType::~ProductType() = default;
+
+ProductType::ProductType(const ProductType& other)
+	: first(other.first->clone()),
+	  second(other.second->clone())
+{}
+
+std::string ProductType::to_string() const {
+	return operand_string(*this->first) + " * " + operand_string(*this->second);
+}
+
+std::unique_ptr<Type> ProductType::clone() const {
+	return std::make_unique<ProductType>(*this);
+}
+
+SumType::~SumType() = default;
+
+SumType::SumType(const SumType& other)
+	: left(other.left->clone()),
+	  right(other.right->clone())
+{}
+
+std::string SumType::to_string() const {
+	return operand_string(*this->left) + " + " + operand_string(*this->right);
+}
+
+std::unique_ptr<Type> SumType::clone() const {
+	return std::make_unique<SumType>(*this);
+}
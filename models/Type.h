@@ -8,6 +8,9 @@
 #include <memory>
 #include <string>
 
+// Base types inhabited by the built-in Literal constants.
+inline constexpr const char* NAT_TYPE_NAME = "Nat";
+inline constexpr const char* BOOL_TYPE_NAME = "Bool";
 
 class Type {
 public:
@@ -45,4 +48,38 @@ public:
 	[[nodiscard]] std::unique_ptr<Type> clone() const override;
 };
 
+// A * B, inhabited by pairs.
+class ProductType final : public Type {
+public:
+	std::unique_ptr<Type> first;
+	std::unique_ptr<Type> second;
+
+	~ProductType() override;
+	explicit ProductType(std::unique_ptr<Type> first, std::unique_ptr<Type> second):
+		first(std::move(first)),
+		second(std::move(second))
+	{}
+	ProductType(const ProductType& other);
+
+	[[nodiscard]] std::string to_string() const override;
+	[[nodiscard]] std::unique_ptr<Type> clone() const override;
+};
+
+// A + B, inhabited by left and right injections.
+class SumType final : public Type {
+public:
+	std::unique_ptr<Type> left;
+	std::unique_ptr<Type> right;
+
+	~SumType() override;
+	explicit SumType(std::unique_ptr<Type> left, std::unique_ptr<Type> right):
+		left(std::move(left)),
+		right(std::move(right))
+	{}
+	SumType(const SumType& other);
+
+	[[nodiscard]] std::string to_string() const override;
+	[[nodiscard]] std::unique_ptr<Type> clone() const override;
+};
+
 #endif //TYPE_H
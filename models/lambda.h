@@ -11,6 +11,15 @@
 #include "models/terms/Variable.h"
 #include "models/terms/Abstraction.h"
 #include "models/terms/Application.h"
+#include "models/terms/Literal.h"
+#include "models/terms/Primitive.h"
+#include "models/terms/Let.h"
+#include "models/terms/Reference.h"
+#include "models/terms/Pair.h"
+#include "models/terms/Projection.h"
+#include "models/terms/Injection.h"
+#include "models/terms/Case.h"
+#include "models/Definitions.h"
 #include "exceptions/Exceptions.h"
 
 #endif // LAMBDA_H
\ No newline at end of file
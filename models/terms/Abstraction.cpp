@@ -36,8 +36,9 @@ unique_ptr<Term> Abstraction::substitute(std::string target, Term& newValue) con
 
     // Free var capturing
     if (newValue.has_free(this->var_name)) {
-        auto new_var = make_unique<Variable>(this->var_name+"'", this->var_type->clone());
-        return new_var->substitute(target, newValue);
+        auto fresh_name = this->var_name + "'";
+        while (newValue.has_free(fresh_name) || this->body->has_free(fresh_name)) fresh_name += "'";
+        return this->alpha_convert(fresh_name)->substitute(target, newValue);
     }
 
     // Everything's nice
@@ -79,4 +80,38 @@ bool Abstraction::has_free(std::string target) const {
 
 std::string Abstraction::to_string() const {
     return "λ" + this->var_name + ". " + this->body->to_string();
-}
\ No newline at end of file
+}
+
+TermSize Abstraction::measure() const {
+    TermSize size{1, sizeof(Abstraction) + heap_bytes(this->var_name)};
+    size += this->body->measure();
+    return size;
+}
+
+std::uint64_t Abstraction::alpha_hash(BinderScope& scope) const {
+    scope.emplace_back(this->var_name);
+    const auto body_hash = this->body->alpha_hash(scope);
+    scope.pop_back();
+    return hash_mix(3, body_hash);
+}
+
+unique_ptr<Term> Abstraction::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+    if (this->var_name == target) return self;
+
+    if (newValue.has_free(this->var_name)) {
+        auto fresh_name = this->var_name + "'";
+        while (newValue.has_free(fresh_name) || this->body->has_free(fresh_name)) fresh_name += "'";
+        const Variable fresh_var(fresh_name, this->var_type->clone());
+        this->body = ::substitute(std::move(this->body), this->var_name, fresh_var);
+        this->var_name = fresh_name;
+    }
+
+    this->body = ::substitute(std::move(this->body), target, newValue);
+    return self;
+}
+
+unique_ptr<Term> Abstraction::beta_reduce_in_place(unique_ptr<Term> self) {
+    if (this->is_normal()) throw ReductionOnNormalForm(std::move(self));
+    this->body = ::beta_reduce(std::move(this->body));
+    return self;
+}
@@ -5,6 +5,7 @@
 #include "Abstraction.h"
 
 #include "Application.h"
+#include "Primitive.h"
 
 #include "../../exceptions/Exceptions.h"
 
@@ -40,13 +41,14 @@ unique_ptr<Term> Application::beta_reduce() const {
 			*this->value
 		);
 	};
+	if (is_delta_redex(*this)) return delta_reduce(*this);
 	if (!this->function->is_normal()) {
 		return make_unique<Application>(this->function->beta_reduce(), this->value->clone());
 	}
 	if (!this->value->is_normal()) {
 		return make_unique<Application>(this->function->clone(), this->value->beta_reduce());
 	}
-	throw ReductionOnNormalForm(this->value);
+	throw ReductionOnNormalForm(this->clone());
 }
 
 std::unique_ptr<Type> Application::type_check(const TypingContext &context) const {
@@ -75,6 +77,7 @@ std::unique_ptr<Type> Application::type_check(const TypingContext &context) cons
 
 bool Application::is_normal() const {
 	if (const auto* func_term = dynamic_cast<const Abstraction*>(this->function.get())) return false;
+	else if (is_delta_redex(*this)) return false;
 	else {
 		return this->function->is_normal() && this->value->is_normal();
 	};
@@ -86,4 +89,39 @@ bool Application::has_free(std::string target) const {
 
 std::string Application::to_string() const {
 	return "(" + this->function->to_string() + ") (" + this->value->to_string() + ")";
-}
\ No newline at end of file
+}
+
+TermSize Application::measure() const {
+	TermSize size{1, sizeof(Application)};
+	size += this->function->measure();
+	size += this->value->measure();
+	return size;
+}
+
+std::uint64_t Application::alpha_hash(BinderScope& scope) const {
+	const auto function_hash = this->function->alpha_hash(scope);
+	return hash_mix(hash_mix(4, function_hash), this->value->alpha_hash(scope));
+}
+
+unique_ptr<Term> Application::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+	this->function = ::substitute(std::move(this->function), target, newValue);
+	this->value = ::substitute(std::move(this->value), target, newValue);
+	return self;
+}
+
+unique_ptr<Term> Application::beta_reduce_in_place(unique_ptr<Term> self) {
+	if (auto* func_term = dynamic_cast<Abstraction*>(this->function.get())) {
+		// The redex body is reused; only occurrences of the bound variable allocate.
+		return ::substitute(std::move(func_term->body), func_term->var_name, *this->value);
+	}
+	if (is_delta_redex(*this)) return delta_reduce(std::move(self));
+	if (!this->function->is_normal()) {
+		this->function = ::beta_reduce(std::move(this->function));
+		return self;
+	}
+	if (!this->value->is_normal()) {
+		this->value = ::beta_reduce(std::move(this->value));
+		return self;
+	}
+	throw ReductionOnNormalForm(std::move(self));
+}
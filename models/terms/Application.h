@@ -28,6 +28,10 @@ public:
 	[[nodiscard]] bool is_normal() const override;
     [[nodiscard]] bool has_free(std::string target) const override;
 	[[nodiscard]] std::string to_string() const override;
+	[[nodiscard]] TermSize measure() const override;
+	[[nodiscard]] std::uint64_t alpha_hash(BinderScope& scope) const override;
+	[[nodiscard]] std::unique_ptr<Term> substitute_in_place(std::unique_ptr<Term> self, const std::string& target, const Term& newValue) override;
+	[[nodiscard]] std::unique_ptr<Term> beta_reduce_in_place(std::unique_ptr<Term> self) override;
 };
 
 
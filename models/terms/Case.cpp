@@ -0,0 +1,131 @@
+//
+// Case.cpp
+//
+
+#include "Case.h"
+
+#include "Application.h"
+#include "Injection.h"
+#include "../Type.h"
+#include "../../exceptions/Exceptions.h"
+
+using std::unique_ptr, std::make_unique;
+
+Case::~Case() = default;
+
+namespace {
+    // Type of a branch that must accept `domain`; returns its codomain.
+    unique_ptr<Type> branch_type(const Term& branch, const Type& domain, const TypingContext& context) {
+        const auto type = branch.type_check(context);
+        const auto* function = dynamic_cast<const FunctionType*>(type.get());
+        if (function == nullptr) throw NotAFunctionError(type->to_string());
+        if (function->domain->to_string() != domain.to_string()) {
+            throw DomainTypeMismatchError(function->domain->to_string(), domain.to_string());
+        }
+        return function->codomain->clone();
+    }
+}
+
+bool Case::is_redex() const {
+    return dynamic_cast<const Injection*>(this->scrutinee.get()) != nullptr;
+}
+
+unique_ptr<Term> Case::alpha_convert(std::string newValue) const {
+    return make_unique<Case>(
+        this->scrutinee->alpha_convert(newValue),
+        this->on_left->alpha_convert(newValue),
+        this->on_right->alpha_convert(newValue)
+    );
+}
+
+unique_ptr<Term> Case::substitute(std::string target, Term& newValue) const {
+    return make_unique<Case>(
+        this->scrutinee->substitute(target, newValue),
+        this->on_left->substitute(target, newValue),
+        this->on_right->substitute(target, newValue)
+    );
+}
+
+unique_ptr<Term> Case::clone() const {
+    return make_unique<Case>(this->scrutinee->clone(), this->on_left->clone(), this->on_right->clone());
+}
+
+unique_ptr<Term> Case::beta_reduce() const {
+    if (const auto* injection = dynamic_cast<const Injection*>(this->scrutinee.get())) {
+        const auto& branch = injection->side == Side::Left ? this->on_left : this->on_right;
+        return make_unique<Application>(branch->clone(), injection->value->clone());
+    }
+    if (!this->scrutinee->is_normal()) {
+        return make_unique<Case>(this->scrutinee->beta_reduce(), this->on_left->clone(), this->on_right->clone());
+    }
+    if (!this->on_left->is_normal()) {
+        return make_unique<Case>(this->scrutinee->clone(), this->on_left->beta_reduce(), this->on_right->clone());
+    }
+    if (!this->on_right->is_normal()) {
+        return make_unique<Case>(this->scrutinee->clone(), this->on_left->clone(), this->on_right->beta_reduce());
+    }
+    throw ReductionOnNormalForm(this->clone());
+}
+
+unique_ptr<Type> Case::type_check(const TypingContext& context) const {
+    const auto scrutinee_type = this->scrutinee->type_check(context);
+    const auto* sum = dynamic_cast<const SumType*>(scrutinee_type.get());
+    if (sum == nullptr) throw NotASumError(scrutinee_type->to_string());
+    auto left = branch_type(*this->on_left, *sum->left, context);
+    const auto right = branch_type(*this->on_right, *sum->right, context);
+    if (left->to_string() != right->to_string()) throw BranchTypeMismatchError(left->to_string(), right->to_string());
+    return left;
+}
+
+bool Case::is_normal() const {
+    return !this->is_redex() && this->scrutinee->is_normal() && this->on_left->is_normal() && this->on_right->is_normal();
+}
+
+bool Case::has_free(std::string target) const {
+    return this->scrutinee->has_free(target) || this->on_left->has_free(target) || this->on_right->has_free(target);
+}
+
+std::string Case::to_string() const {
+    return "case (" + this->scrutinee->to_string() + ") (" + this->on_left->to_string() + ") (" + this->on_right->to_string() + ")";
+}
+
+TermSize Case::measure() const {
+    TermSize size{1, sizeof(Case)};
+    size += this->scrutinee->measure();
+    size += this->on_left->measure();
+    size += this->on_right->measure();
+    return size;
+}
+
+std::uint64_t Case::alpha_hash(BinderScope& scope) const {
+    const auto scrutinee_hash = this->scrutinee->alpha_hash(scope);
+    const auto left_hash = this->on_left->alpha_hash(scope);
+    return hash_mix(hash_mix(hash_mix(12, scrutinee_hash), left_hash), this->on_right->alpha_hash(scope));
+}
+
+unique_ptr<Term> Case::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+    this->scrutinee = ::substitute(std::move(this->scrutinee), target, newValue);
+    this->on_left = ::substitute(std::move(this->on_left), target, newValue);
+    this->on_right = ::substitute(std::move(this->on_right), target, newValue);
+    return self;
+}
+
+unique_ptr<Term> Case::beta_reduce_in_place(unique_ptr<Term> self) {
+    if (auto* injection = dynamic_cast<Injection*>(this->scrutinee.get())) {
+        auto& branch = injection->side == Side::Left ? this->on_left : this->on_right;
+        return make_unique<Application>(std::move(branch), std::move(injection->value));
+    }
+    if (!this->scrutinee->is_normal()) {
+        this->scrutinee = ::beta_reduce(std::move(this->scrutinee));
+        return self;
+    }
+    if (!this->on_left->is_normal()) {
+        this->on_left = ::beta_reduce(std::move(this->on_left));
+        return self;
+    }
+    if (!this->on_right->is_normal()) {
+        this->on_right = ::beta_reduce(std::move(this->on_right));
+        return self;
+    }
+    throw ReductionOnNormalForm(std::move(self));
+}
@@ -0,0 +1,47 @@
+//
+// Case.h
+//
+// case t f g, the elimination form of A + B. The branches are functions
+// A -> C and B -> C rather than binders, so case introduces no names of
+// its own: case (inl v) f g steps to f v, and case (inr v) f g to g v.
+//
+
+#ifndef CASE_H
+#define CASE_H
+
+#include "../Terms.h"
+
+#include <memory>
+
+class Case final : public Term {
+public:
+    std::unique_ptr<Term> scrutinee;
+    std::unique_ptr<Term> on_left;
+    std::unique_ptr<Term> on_right;
+
+    explicit Case(std::unique_ptr<Term> scrutinee, std::unique_ptr<Term> on_left, std::unique_ptr<Term> on_right):
+        scrutinee(std::move(scrutinee)),
+        on_left(std::move(on_left)),
+        on_right(std::move(on_right))
+    {};
+    ~Case() override;
+
+    // True when the scrutinee is an injection, so the next step selects a
+    // branch.
+    [[nodiscard]] bool is_redex() const;
+
+    [[nodiscard]] std::unique_ptr<Term> alpha_convert(std::string newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute(std::string target, Term& newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> clone() const override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce() const override;
+    [[nodiscard]] std::unique_ptr<Type> type_check(const TypingContext& context) const override;
+    [[nodiscard]] bool is_normal() const override;
+    [[nodiscard]] bool has_free(std::string target) const override;
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] TermSize measure() const override;
+    [[nodiscard]] std::uint64_t alpha_hash(BinderScope& scope) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute_in_place(std::unique_ptr<Term> self, const std::string& target, const Term& newValue) override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce_in_place(std::unique_ptr<Term> self) override;
+};
+
+#endif //CASE_H
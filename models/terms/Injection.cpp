@@ -0,0 +1,80 @@
+//
+// Injection.cpp
+//
+
+#include "Injection.h"
+
+#include "../Type.h"
+#include "../../exceptions/Exceptions.h"
+
+using std::unique_ptr, std::make_unique;
+
+Injection::~Injection() = default;
+
+const char* side_name(Side side) {
+    return side == Side::Left ? "inl" : "inr";
+}
+
+unique_ptr<Term> Injection::alpha_convert(std::string newValue) const {
+    return make_unique<Injection>(this->side, this->sum_type->clone(), this->value->alpha_convert(newValue));
+}
+
+unique_ptr<Term> Injection::substitute(std::string target, Term& newValue) const {
+    return make_unique<Injection>(this->side, this->sum_type->clone(), this->value->substitute(target, newValue));
+}
+
+unique_ptr<Term> Injection::clone() const {
+    return make_unique<Injection>(this->side, this->sum_type->clone(), this->value->clone());
+}
+
+unique_ptr<Term> Injection::beta_reduce() const {
+    if (!this->value->is_normal()) return make_unique<Injection>(this->side, this->sum_type->clone(), this->value->beta_reduce());
+    throw ReductionOnNormalForm(this->clone());
+}
+
+unique_ptr<Type> Injection::type_check(const TypingContext& context) const {
+    const auto* sum = dynamic_cast<const SumType*>(this->sum_type.get());
+    if (sum == nullptr) throw NotASumError(this->sum_type->to_string());
+    const auto value_type = this->value->type_check(context);
+    const auto& expected = this->side == Side::Left ? *sum->left : *sum->right;
+    if (value_type->to_string() != expected.to_string()) {
+        throw DomainTypeMismatchError(expected.to_string(), value_type->to_string());
+    }
+    return sum->clone();
+}
+
+bool Injection::is_normal() const {
+    return this->value->is_normal();
+}
+
+bool Injection::has_free(std::string target) const {
+    return this->value->has_free(target);
+}
+
+std::string Injection::to_string() const {
+    return std::string(side_name(this->side)) + "[" + this->sum_type->to_string() + "] (" + this->value->to_string() + ")";
+}
+
+TermSize Injection::measure() const {
+    TermSize size{1, sizeof(Injection)};
+    size += this->value->measure();
+    return size;
+}
+
+std::uint64_t Injection::alpha_hash(BinderScope& scope) const {
+    const auto head = hash_mix(hash_mix(11, static_cast<std::uint64_t>(this->side)), type_hash(*this->sum_type));
+    return hash_mix(head, this->value->alpha_hash(scope));
+}
+
+unique_ptr<Term> Injection::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+    this->value = ::substitute(std::move(this->value), target, newValue);
+    return self;
+}
+
+unique_ptr<Term> Injection::beta_reduce_in_place(unique_ptr<Term> self) {
+    if (!this->value->is_normal()) {
+        this->value = ::beta_reduce(std::move(this->value));
+        return self;
+    }
+    throw ReductionOnNormalForm(std::move(self));
+}
@@ -0,0 +1,48 @@
+//
+// Injection.h
+//
+// inl[A + B] t and inr[A + B] t, the introduction forms of A + B. The
+// annotation names the whole sum, so the type of an injection never has to
+// be guessed. An injection is normal once its payload is.
+//
+
+#ifndef INJECTION_H
+#define INJECTION_H
+
+#include "../Terms.h"
+
+#include <cstdint>
+#include <memory>
+
+enum class Side : std::uint8_t { Left, Right };
+
+class Injection final : public Term {
+public:
+    Side side;
+    std::unique_ptr<Type> sum_type;
+    std::unique_ptr<Term> value;
+
+    explicit Injection(Side side, std::unique_ptr<Type> sum_type, std::unique_ptr<Term> value):
+        side(side),
+        sum_type(std::move(sum_type)),
+        value(std::move(value))
+    {};
+    ~Injection() override;
+
+    [[nodiscard]] std::unique_ptr<Term> alpha_convert(std::string newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute(std::string target, Term& newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> clone() const override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce() const override;
+    [[nodiscard]] std::unique_ptr<Type> type_check(const TypingContext& context) const override;
+    [[nodiscard]] bool is_normal() const override;
+    [[nodiscard]] bool has_free(std::string target) const override;
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] TermSize measure() const override;
+    [[nodiscard]] std::uint64_t alpha_hash(BinderScope& scope) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute_in_place(std::unique_ptr<Term> self, const std::string& target, const Term& newValue) override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce_in_place(std::unique_ptr<Term> self) override;
+};
+
+[[nodiscard]] const char* side_name(Side side);
+
+#endif //INJECTION_H
@@ -0,0 +1,101 @@
+//
+// Let.cpp
+//
+
+#include "Let.h"
+
+#include "Variable.h"
+#include "../Type.h"
+#include "../TypingContext.h"
+
+using std::unique_ptr, std::make_unique;
+
+Let::~Let() = default;
+
+unique_ptr<Term> Let::alpha_convert(std::string newValue) const {
+    Variable new_variable(newValue);
+    return make_unique<Let>(newValue, this->bound->clone(), this->body->substitute(this->var_name, new_variable));
+}
+
+unique_ptr<Term> Let::substitute(std::string target, Term& newValue) const {
+    auto new_bound = this->bound->substitute(target, newValue);
+
+    // Target var is shadowed in the body
+    if (this->var_name == target) {
+        return make_unique<Let>(this->var_name, std::move(new_bound), this->body->clone());
+    }
+
+    // Free var capturing
+    if (newValue.has_free(this->var_name)) {
+        auto fresh_name = this->var_name + "'";
+        while (newValue.has_free(fresh_name) || this->body->has_free(fresh_name)) fresh_name += "'";
+        Variable fresh_var(fresh_name);
+        auto renamed_body = this->body->substitute(this->var_name, fresh_var);
+        return make_unique<Let>(fresh_name, std::move(new_bound), renamed_body->substitute(target, newValue));
+    }
+
+    return make_unique<Let>(this->var_name, std::move(new_bound), this->body->substitute(target, newValue));
+}
+
+unique_ptr<Term> Let::clone() const {
+    return make_unique<Let>(this->var_name, this->bound->clone(), this->body->clone());
+}
+
+unique_ptr<Term> Let::beta_reduce() const {
+    return this->body->substitute(this->var_name, *this->bound);
+}
+
+unique_ptr<Type> Let::type_check(const TypingContext& context) const {
+    const auto bound_type = this->bound->type_check(context);
+    auto extended_ctx = context;
+    extended_ctx.add(this->var_name, bound_type.get());
+    return this->body->type_check(extended_ctx);
+}
+
+bool Let::is_normal() const {
+    return false;
+}
+
+bool Let::has_free(std::string target) const {
+    if (this->bound->has_free(target)) return true;
+    return this->var_name != target && this->body->has_free(target);
+}
+
+std::string Let::to_string() const {
+    return "let " + this->var_name + " = " + this->bound->to_string() + " in " + this->body->to_string();
+}
+
+TermSize Let::measure() const {
+    TermSize size{1, sizeof(Let) + heap_bytes(this->var_name)};
+    size += this->bound->measure();
+    size += this->body->measure();
+    return size;
+}
+
+std::uint64_t Let::alpha_hash(BinderScope& scope) const {
+    const auto bound_hash = this->bound->alpha_hash(scope);
+    scope.emplace_back(this->var_name);
+    const auto body_hash = this->body->alpha_hash(scope);
+    scope.pop_back();
+    return hash_mix(hash_mix(7, bound_hash), body_hash);
+}
+
+unique_ptr<Term> Let::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+    this->bound = ::substitute(std::move(this->bound), target, newValue);
+    if (this->var_name == target) return self;
+
+    if (newValue.has_free(this->var_name)) {
+        auto fresh_name = this->var_name + "'";
+        while (newValue.has_free(fresh_name) || this->body->has_free(fresh_name)) fresh_name += "'";
+        const Variable fresh_var(fresh_name);
+        this->body = ::substitute(std::move(this->body), this->var_name, fresh_var);
+        this->var_name = fresh_name;
+    }
+
+    this->body = ::substitute(std::move(this->body), target, newValue);
+    return self;
+}
+
+unique_ptr<Term> Let::beta_reduce_in_place(unique_ptr<Term> self) {
+    return ::substitute(std::move(this->body), this->var_name, *this->bound);
+}
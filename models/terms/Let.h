@@ -0,0 +1,43 @@
+//
+// Let.h
+//
+// let x = bound in body. Typed like (λx:T. body) bound with T inferred from
+// `bound`; one reduction step substitutes `bound` for x in `body`.
+//
+
+#ifndef LET_H
+#define LET_H
+
+#include "../Terms.h"
+
+#include <memory>
+#include <string>
+
+class Let final : public Term {
+public:
+    std::string var_name;
+    std::unique_ptr<Term> bound;
+    std::unique_ptr<Term> body;
+
+    explicit Let(std::string var_name, std::unique_ptr<Term> bound, std::unique_ptr<Term> body):
+        var_name(std::move(var_name)),
+        bound(std::move(bound)),
+        body(std::move(body))
+    {};
+    ~Let() override;
+
+    [[nodiscard]] std::unique_ptr<Term> alpha_convert(std::string newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute(std::string target, Term& newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> clone() const override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce() const override;
+    [[nodiscard]] std::unique_ptr<Type> type_check(const TypingContext& context) const override;
+    [[nodiscard]] bool is_normal() const override;
+    [[nodiscard]] bool has_free(std::string target) const override;
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] TermSize measure() const override;
+    [[nodiscard]] std::uint64_t alpha_hash(BinderScope& scope) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute_in_place(std::unique_ptr<Term> self, const std::string& target, const Term& newValue) override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce_in_place(std::unique_ptr<Term> self) override;
+};
+
+#endif //LET_H
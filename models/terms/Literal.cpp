@@ -0,0 +1,69 @@
+//
+// Literal.cpp
+//
+
+#include "Literal.h"
+
+#include "../Type.h"
+#include "../../exceptions/Exceptions.h"
+
+using std::unique_ptr, std::make_unique;
+
+Literal::~Literal() = default;
+
+unique_ptr<Literal> Literal::nat(std::uint64_t value) {
+    return make_unique<Literal>(LiteralKind::Nat, value);
+}
+
+unique_ptr<Literal> Literal::boolean(bool value) {
+    return make_unique<Literal>(LiteralKind::Bool, value ? 1 : 0);
+}
+
+unique_ptr<Term> Literal::alpha_convert(std::string newValue) const {
+    return this->clone();
+}
+
+unique_ptr<Term> Literal::substitute(std::string target, Term& newValue) const {
+    return this->clone();
+}
+
+unique_ptr<Term> Literal::clone() const {
+    return make_unique<Literal>(this->kind, this->value);
+}
+
+unique_ptr<Term> Literal::beta_reduce() const {
+    throw ReductionOnNormalForm(this->clone());
+}
+
+unique_ptr<Type> Literal::type_check(const TypingContext& context) const {
+    return make_unique<BaseType>(this->kind == LiteralKind::Nat ? NAT_TYPE_NAME : BOOL_TYPE_NAME);
+}
+
+bool Literal::is_normal() const {
+    return true;
+}
+
+bool Literal::has_free(std::string target) const {
+    return false;
+}
+
+std::string Literal::to_string() const {
+    if (this->kind == LiteralKind::Bool) return this->value ? "true" : "false";
+    return std::to_string(this->value);
+}
+
+TermSize Literal::measure() const {
+    return {1, sizeof(Literal)};
+}
+
+std::uint64_t Literal::alpha_hash(BinderScope&) const {
+    return hash_mix(hash_mix(5, static_cast<std::uint64_t>(this->kind)), this->value);
+}
+
+unique_ptr<Term> Literal::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+    return self;
+}
+
+unique_ptr<Term> Literal::beta_reduce_in_place(unique_ptr<Term> self) {
+    throw ReductionOnNormalForm(std::move(self));
+}
@@ -0,0 +1,45 @@
+//
+// Literal.h
+//
+// Native constants of the built-in Nat and Bool base types.
+//
+
+#ifndef LITERAL_H
+#define LITERAL_H
+
+#include "../Terms.h"
+
+#include <cstdint>
+#include <memory>
+
+enum class LiteralKind : std::uint8_t { Nat, Bool };
+
+class Literal final : public Term {
+public:
+    LiteralKind kind;
+    std::uint64_t value;
+
+    explicit Literal(LiteralKind kind, std::uint64_t value):
+        kind(kind),
+        value(value)
+    {};
+    ~Literal() override;
+
+    [[nodiscard]] static std::unique_ptr<Literal> nat(std::uint64_t value);
+    [[nodiscard]] static std::unique_ptr<Literal> boolean(bool value);
+
+    [[nodiscard]] std::unique_ptr<Term> alpha_convert(std::string newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute(std::string target, Term& newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> clone() const override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce() const override;
+    [[nodiscard]] std::unique_ptr<Type> type_check(const TypingContext& context) const override;
+    [[nodiscard]] bool is_normal() const override;
+    [[nodiscard]] bool has_free(std::string target) const override;
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] TermSize measure() const override;
+    [[nodiscard]] std::uint64_t alpha_hash(BinderScope& scope) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute_in_place(std::unique_ptr<Term> self, const std::string& target, const Term& newValue) override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce_in_place(std::unique_ptr<Term> self) override;
+};
+
+#endif //LITERAL_H
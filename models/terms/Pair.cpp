@@ -0,0 +1,77 @@
+//
+// Pair.cpp
+//
+
+#include "Pair.h"
+
+#include "../Type.h"
+#include "../../exceptions/Exceptions.h"
+
+using std::unique_ptr, std::make_unique;
+
+Pair::~Pair() = default;
+
+unique_ptr<Term> Pair::alpha_convert(std::string newValue) const {
+    return make_unique<Pair>(this->first->alpha_convert(newValue), this->second->alpha_convert(newValue));
+}
+
+unique_ptr<Term> Pair::substitute(std::string target, Term& newValue) const {
+    return make_unique<Pair>(this->first->substitute(target, newValue), this->second->substitute(target, newValue));
+}
+
+unique_ptr<Term> Pair::clone() const {
+    return make_unique<Pair>(this->first->clone(), this->second->clone());
+}
+
+unique_ptr<Term> Pair::beta_reduce() const {
+    if (!this->first->is_normal()) return make_unique<Pair>(this->first->beta_reduce(), this->second->clone());
+    if (!this->second->is_normal()) return make_unique<Pair>(this->first->clone(), this->second->beta_reduce());
+    throw ReductionOnNormalForm(this->clone());
+}
+
+unique_ptr<Type> Pair::type_check(const TypingContext& context) const {
+    auto first_type = this->first->type_check(context);
+    return make_unique<ProductType>(std::move(first_type), this->second->type_check(context));
+}
+
+bool Pair::is_normal() const {
+    return this->first->is_normal() && this->second->is_normal();
+}
+
+bool Pair::has_free(std::string target) const {
+    return this->first->has_free(target) || this->second->has_free(target);
+}
+
+std::string Pair::to_string() const {
+    return "(" + this->first->to_string() + ", " + this->second->to_string() + ")";
+}
+
+TermSize Pair::measure() const {
+    TermSize size{1, sizeof(Pair)};
+    size += this->first->measure();
+    size += this->second->measure();
+    return size;
+}
+
+std::uint64_t Pair::alpha_hash(BinderScope& scope) const {
+    const auto first_hash = this->first->alpha_hash(scope);
+    return hash_mix(hash_mix(9, first_hash), this->second->alpha_hash(scope));
+}
+
+unique_ptr<Term> Pair::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+    this->first = ::substitute(std::move(this->first), target, newValue);
+    this->second = ::substitute(std::move(this->second), target, newValue);
+    return self;
+}
+
+unique_ptr<Term> Pair::beta_reduce_in_place(unique_ptr<Term> self) {
+    if (!this->first->is_normal()) {
+        this->first = ::beta_reduce(std::move(this->first));
+        return self;
+    }
+    if (!this->second->is_normal()) {
+        this->second = ::beta_reduce(std::move(this->second));
+        return self;
+    }
+    throw ReductionOnNormalForm(std::move(self));
+}
@@ -0,0 +1,41 @@
+//
+// Pair.h
+//
+// (first, second), the introduction form of A * B. A pair is a value: it is
+// normal once both components are, and a projection takes it apart in one
+// step.
+//
+
+#ifndef PAIR_H
+#define PAIR_H
+
+#include "../Terms.h"
+
+#include <memory>
+
+class Pair final : public Term {
+public:
+    std::unique_ptr<Term> first;
+    std::unique_ptr<Term> second;
+
+    explicit Pair(std::unique_ptr<Term> first, std::unique_ptr<Term> second):
+        first(std::move(first)),
+        second(std::move(second))
+    {};
+    ~Pair() override;
+
+    [[nodiscard]] std::unique_ptr<Term> alpha_convert(std::string newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute(std::string target, Term& newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> clone() const override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce() const override;
+    [[nodiscard]] std::unique_ptr<Type> type_check(const TypingContext& context) const override;
+    [[nodiscard]] bool is_normal() const override;
+    [[nodiscard]] bool has_free(std::string target) const override;
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] TermSize measure() const override;
+    [[nodiscard]] std::uint64_t alpha_hash(BinderScope& scope) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute_in_place(std::unique_ptr<Term> self, const std::string& target, const Term& newValue) override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce_in_place(std::unique_ptr<Term> self) override;
+};
+
+#endif //PAIR_H
@@ -0,0 +1,190 @@
+//
+// Primitive.cpp
+//
+
+#include "Primitive.h"
+
+#include "Application.h"
+#include "../Type.h"
+#include "../../utils.h"
+#include "../../exceptions/Exceptions.h"
+
+#include <array>
+
+using std::unique_ptr, std::make_unique;
+
+Primitive::~Primitive() = default;
+
+std::size_t primitive_arity(PrimitiveOp op) {
+    return op == PrimitiveOp::If ? 3 : 2;
+}
+
+const char* primitive_name(PrimitiveOp op) {
+    switch (op) {
+        case PrimitiveOp::Add: return "add";
+        case PrimitiveOp::Sub: return "sub";
+        case PrimitiveOp::Mul: return "mul";
+        case PrimitiveOp::Eq: return "eq";
+        case PrimitiveOp::Lt: return "lt";
+        case PrimitiveOp::If: return "if";
+    }
+    return "";
+}
+
+bool primitive_strict_in(PrimitiveOp op, std::size_t position, LiteralKind& expected) {
+    if (op == PrimitiveOp::If) {
+        expected = LiteralKind::Bool;
+        return position == 0;
+    }
+    expected = LiteralKind::Nat;
+    return position < 2;
+}
+
+LiteralValue evaluate_primitive(PrimitiveOp op, std::uint64_t lhs, std::uint64_t rhs) {
+    switch (op) {
+        case PrimitiveOp::Add: return {LiteralKind::Nat, lhs + rhs};
+        case PrimitiveOp::Sub: return {LiteralKind::Nat, lhs > rhs ? lhs - rhs : 0};
+        case PrimitiveOp::Mul: return {LiteralKind::Nat, lhs * rhs};
+        case PrimitiveOp::Eq: return {LiteralKind::Bool, lhs == rhs};
+        case PrimitiveOp::Lt: return {LiteralKind::Bool, lhs < rhs};
+        case PrimitiveOp::If: break;
+    }
+    throw std::logic_error("evaluate_primitive: 'if' has no value rule");
+}
+
+unique_ptr<Type> primitive_type(PrimitiveOp op, const Type* branch_type) {
+    auto base = [](const char* name) { return make_unique<BaseType>(name); };
+    switch (op) {
+        case PrimitiveOp::Add:
+        case PrimitiveOp::Sub:
+        case PrimitiveOp::Mul:
+            return make_unique<FunctionType>(base(NAT_TYPE_NAME), make_unique<FunctionType>(base(NAT_TYPE_NAME), base(NAT_TYPE_NAME)));
+        case PrimitiveOp::Eq:
+        case PrimitiveOp::Lt:
+            return make_unique<FunctionType>(base(NAT_TYPE_NAME), make_unique<FunctionType>(base(NAT_TYPE_NAME), base(BOOL_TYPE_NAME)));
+        case PrimitiveOp::If:
+            if (branch_type == nullptr) throw TypeMismatchError("Type error: 'if' has no branch type");
+            return make_unique<FunctionType>(base(BOOL_TYPE_NAME), make_unique<FunctionType>(branch_type->clone(),
+                make_unique<FunctionType>(branch_type->clone(), branch_type->clone())));
+    }
+    return nullptr;
+}
+
+std::size_t Primitive::arity() const {
+    return primitive_arity(this->op);
+}
+
+unique_ptr<Term> Primitive::alpha_convert(std::string newValue) const {
+    return this->clone();
+}
+
+unique_ptr<Term> Primitive::substitute(std::string target, Term& newValue) const {
+    return this->clone();
+}
+
+unique_ptr<Term> Primitive::clone() const {
+    return make_unique<Primitive>(this->op, this->branch_type ? this->branch_type->clone() : nullptr);
+}
+
+unique_ptr<Term> Primitive::beta_reduce() const {
+    throw ReductionOnNormalForm(this->clone());
+}
+
+unique_ptr<Type> Primitive::type_check(const TypingContext& context) const {
+    return primitive_type(this->op, this->branch_type.get());
+}
+
+bool Primitive::is_normal() const {
+    return true;
+}
+
+bool Primitive::has_free(std::string target) const {
+    return false;
+}
+
+std::string Primitive::to_string() const {
+    return primitive_name(this->op);
+}
+
+TermSize Primitive::measure() const {
+    return {1, sizeof(Primitive)};
+}
+
+std::uint64_t Primitive::alpha_hash(BinderScope&) const {
+    return hash_mix(6, static_cast<std::uint64_t>(this->op));
+}
+
+unique_ptr<Term> Primitive::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+    return self;
+}
+
+unique_ptr<Term> Primitive::beta_reduce_in_place(unique_ptr<Term> self) {
+    throw ReductionOnNormalForm(std::move(self));
+}
+
+namespace {
+    // Unwinds at most three applications (the largest arity) from `app`.
+    // Returns the primitive head when the spine is exactly saturated.
+    const Primitive* saturated_head(const Application& app, std::array<const Term*, 3>& args) {
+        const Term* node = &app;
+        std::size_t count = 0;
+        while (const auto* spine = dynamic_cast<const Application*>(node)) {
+            if (count == args.size()) return nullptr;
+            ++count;
+            node = spine->function.get();
+        }
+        const auto* head = dynamic_cast<const Primitive*>(node);
+        if (head == nullptr || head->arity() != count) return nullptr;
+
+        node = &app;
+        for (std::size_t i = count; i-- > 0;) {
+            const auto* spine = static_cast<const Application*>(node);
+            args[i] = spine->value.get();
+            node = spine->function.get();
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            LiteralKind expected;
+            if (!primitive_strict_in(head->op, i, expected)) continue;
+            const auto* literal = dynamic_cast<const Literal*>(args[i]);
+            if (literal == nullptr || literal->kind != expected) return nullptr;
+        }
+        return head;
+    }
+}
+
+bool is_delta_redex(const Application& app) {
+    std::array<const Term*, 3> args{};
+    return saturated_head(app, args) != nullptr;
+}
+
+unique_ptr<Term> delta_reduce(const Application& app) {
+    std::array<const Term*, 3> args{};
+    const auto* head = saturated_head(app, args);
+    if (head == nullptr) throw ReductionOnNormalForm(app.clone());
+
+    if (head->op == PrimitiveOp::If) {
+        return static_cast<const Literal*>(args[0])->value ? args[1]->clone() : args[2]->clone();
+    }
+    const auto [kind, value] = evaluate_primitive(head->op,
+        static_cast<const Literal*>(args[0])->value,
+        static_cast<const Literal*>(args[1])->value);
+    return make_unique<Literal>(kind, value);
+}
+
+unique_ptr<Term> delta_reduce(unique_ptr<Term> app) {
+    const auto* outer = dynamic_cast<const Application*>(app.get());
+    std::array<const Term*, 3> args{};
+    const auto* head = outer == nullptr ? nullptr : saturated_head(*outer, args);
+    if (head == nullptr) throw ReductionOnNormalForm(std::move(app));
+
+    if (head->op == PrimitiveOp::If) {
+        // ((if c) t) e
+        auto outer_app = static_unique_ptr_cast<Application>(std::move(app));
+        if (!static_cast<const Literal*>(args[0])->value) return std::move(outer_app->value);
+        return std::move(static_cast<Application*>(outer_app->function.get())->value);
+    }
+    const auto [kind, value] = evaluate_primitive(head->op,
+        static_cast<const Literal*>(args[0])->value,
+        static_cast<const Literal*>(args[1])->value);
+    return make_unique<Literal>(kind, value);
+}
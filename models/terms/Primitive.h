@@ -0,0 +1,74 @@
+//
+// Primitive.h
+//
+// Built-in operators over Nat and Bool literals. A primitive is a curried
+// constant; once applied to all of its arguments, and the strict ones are
+// literals, the application contracts by a δ-rule in O(1).
+//
+
+#ifndef PRIMITIVE_H
+#define PRIMITIVE_H
+
+#include "Literal.h"
+#include "../Terms.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class Application;
+
+enum class PrimitiveOp : std::uint8_t { Add, Sub, Mul, Eq, Lt, If };
+
+class Primitive final : public Term {
+public:
+    PrimitiveOp op;
+    // Type of both branches and of the result, only used by If.
+    std::unique_ptr<Type> branch_type;
+
+    explicit Primitive(PrimitiveOp op, std::unique_ptr<Type> branch_type = nullptr):
+        op(op),
+        branch_type(std::move(branch_type))
+    {};
+    ~Primitive() override;
+
+    [[nodiscard]] std::size_t arity() const;
+
+    [[nodiscard]] std::unique_ptr<Term> alpha_convert(std::string newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute(std::string target, Term& newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> clone() const override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce() const override;
+    [[nodiscard]] std::unique_ptr<Type> type_check(const TypingContext& context) const override;
+    [[nodiscard]] bool is_normal() const override;
+    [[nodiscard]] bool has_free(std::string target) const override;
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] TermSize measure() const override;
+    [[nodiscard]] std::uint64_t alpha_hash(BinderScope& scope) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute_in_place(std::unique_ptr<Term> self, const std::string& target, const Term& newValue) override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce_in_place(std::unique_ptr<Term> self) override;
+};
+
+struct LiteralValue {
+    LiteralKind kind;
+    std::uint64_t value;
+};
+
+[[nodiscard]] std::size_t primitive_arity(PrimitiveOp op);
+[[nodiscard]] const char* primitive_name(PrimitiveOp op);
+// Kind of literal the δ-rule needs at argument `position`. Arguments that are
+// not listed (the branches of If) are passed through unevaluated.
+[[nodiscard]] bool primitive_strict_in(PrimitiveOp op, std::size_t position, LiteralKind& expected);
+// δ-rule for the binary Nat operators. Nat arithmetic wraps modulo 2^64 and
+// Sub is truncated at zero.
+[[nodiscard]] LiteralValue evaluate_primitive(PrimitiveOp op, std::uint64_t lhs, std::uint64_t rhs);
+// Type of the curried constant, e.g. Nat -> (Nat -> Nat).
+[[nodiscard]] std::unique_ptr<Type> primitive_type(PrimitiveOp op, const Type* branch_type);
+
+// True when `app` is `op a1 ... an` with n the arity of op and every strict
+// argument a literal of the expected kind.
+[[nodiscard]] bool is_delta_redex(const Application& app);
+[[nodiscard]] std::unique_ptr<Term> delta_reduce(const Application& app);
+// Consuming form: the selected branch of If is moved, not cloned.
+[[nodiscard]] std::unique_ptr<Term> delta_reduce(std::unique_ptr<Term> app);
+
+#endif //PRIMITIVE_H
@@ -0,0 +1,86 @@
+//
+// Projection.cpp
+//
+
+#include "Projection.h"
+
+#include "Pair.h"
+#include "../Type.h"
+#include "../../exceptions/Exceptions.h"
+
+using std::unique_ptr, std::make_unique;
+
+Projection::~Projection() = default;
+
+const char* component_name(Component component) {
+    return component == Component::First ? "fst" : "snd";
+}
+
+bool Projection::is_redex() const {
+    return dynamic_cast<const Pair*>(this->operand.get()) != nullptr;
+}
+
+unique_ptr<Term> Projection::alpha_convert(std::string newValue) const {
+    return make_unique<Projection>(this->component, this->operand->alpha_convert(newValue));
+}
+
+unique_ptr<Term> Projection::substitute(std::string target, Term& newValue) const {
+    return make_unique<Projection>(this->component, this->operand->substitute(target, newValue));
+}
+
+unique_ptr<Term> Projection::clone() const {
+    return make_unique<Projection>(this->component, this->operand->clone());
+}
+
+unique_ptr<Term> Projection::beta_reduce() const {
+    if (const auto* pair = dynamic_cast<const Pair*>(this->operand.get())) {
+        return this->component == Component::First ? pair->first->clone() : pair->second->clone();
+    }
+    if (!this->operand->is_normal()) return make_unique<Projection>(this->component, this->operand->beta_reduce());
+    throw ReductionOnNormalForm(this->clone());
+}
+
+unique_ptr<Type> Projection::type_check(const TypingContext& context) const {
+    const auto operand_type = this->operand->type_check(context);
+    const auto* product = dynamic_cast<const ProductType*>(operand_type.get());
+    if (product == nullptr) throw NotAProductError(operand_type->to_string());
+    return this->component == Component::First ? product->first->clone() : product->second->clone();
+}
+
+bool Projection::is_normal() const {
+    return !this->is_redex() && this->operand->is_normal();
+}
+
+bool Projection::has_free(std::string target) const {
+    return this->operand->has_free(target);
+}
+
+std::string Projection::to_string() const {
+    return std::string(component_name(this->component)) + " (" + this->operand->to_string() + ")";
+}
+
+TermSize Projection::measure() const {
+    TermSize size{1, sizeof(Projection)};
+    size += this->operand->measure();
+    return size;
+}
+
+std::uint64_t Projection::alpha_hash(BinderScope& scope) const {
+    return hash_mix(hash_mix(10, static_cast<std::uint64_t>(this->component)), this->operand->alpha_hash(scope));
+}
+
+unique_ptr<Term> Projection::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+    this->operand = ::substitute(std::move(this->operand), target, newValue);
+    return self;
+}
+
+unique_ptr<Term> Projection::beta_reduce_in_place(unique_ptr<Term> self) {
+    if (auto* pair = dynamic_cast<Pair*>(this->operand.get())) {
+        return this->component == Component::First ? std::move(pair->first) : std::move(pair->second);
+    }
+    if (!this->operand->is_normal()) {
+        this->operand = ::beta_reduce(std::move(this->operand));
+        return self;
+    }
+    throw ReductionOnNormalForm(std::move(self));
+}
@@ -0,0 +1,48 @@
+//
+// Projection.h
+//
+// fst t and snd t, the elimination forms of A * B. Applied to a pair, a
+// projection contracts to the selected component in one step.
+//
+
+#ifndef PROJECTION_H
+#define PROJECTION_H
+
+#include "../Terms.h"
+
+#include <cstdint>
+#include <memory>
+
+enum class Component : std::uint8_t { First, Second };
+
+class Projection final : public Term {
+public:
+    Component component;
+    std::unique_ptr<Term> operand;
+
+    explicit Projection(Component component, std::unique_ptr<Term> operand):
+        component(component),
+        operand(std::move(operand))
+    {};
+    ~Projection() override;
+
+    // True when the operand is a pair, so the next step is a projection.
+    [[nodiscard]] bool is_redex() const;
+
+    [[nodiscard]] std::unique_ptr<Term> alpha_convert(std::string newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute(std::string target, Term& newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> clone() const override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce() const override;
+    [[nodiscard]] std::unique_ptr<Type> type_check(const TypingContext& context) const override;
+    [[nodiscard]] bool is_normal() const override;
+    [[nodiscard]] bool has_free(std::string target) const override;
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] TermSize measure() const override;
+    [[nodiscard]] std::uint64_t alpha_hash(BinderScope& scope) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute_in_place(std::unique_ptr<Term> self, const std::string& target, const Term& newValue) override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce_in_place(std::unique_ptr<Term> self) override;
+};
+
+[[nodiscard]] const char* component_name(Component component);
+
+#endif //PROJECTION_H
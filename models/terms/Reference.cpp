@@ -0,0 +1,63 @@
+//
+// Reference.cpp
+//
+
+#include "Reference.h"
+
+using std::unique_ptr, std::make_unique;
+
+Reference::~Reference() = default;
+
+unique_ptr<Term> Reference::unfold() const {
+    return this->definition->body->clone();
+}
+
+// Definitions are closed, so renaming and substitution never reach inside.
+unique_ptr<Term> Reference::alpha_convert(std::string newValue) const {
+    return this->clone();
+}
+
+unique_ptr<Term> Reference::substitute(std::string target, Term& newValue) const {
+    return this->clone();
+}
+
+unique_ptr<Term> Reference::clone() const {
+    return make_unique<Reference>(this->definition);
+}
+
+unique_ptr<Term> Reference::beta_reduce() const {
+    return this->unfold();
+}
+
+unique_ptr<Type> Reference::type_check(const TypingContext& context) const {
+    return this->definition->type().clone();
+}
+
+bool Reference::is_normal() const {
+    return false;
+}
+
+bool Reference::has_free(std::string target) const {
+    return false;
+}
+
+std::string Reference::to_string() const {
+    return this->definition->name;
+}
+
+TermSize Reference::measure() const {
+    // The definition body is shared, not owned.
+    return {1, sizeof(Reference)};
+}
+
+std::uint64_t Reference::alpha_hash(BinderScope&) const {
+    return hash_mix(8, hash_name(this->definition->name));
+}
+
+unique_ptr<Term> Reference::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+    return self;
+}
+
+unique_ptr<Term> Reference::beta_reduce_in_place(unique_ptr<Term> self) {
+    return this->unfold();
+}
@@ -0,0 +1,42 @@
+//
+// Reference.h
+//
+// Use of a global Definition. A reference is never in normal form: one
+// reduction step unfolds it into a copy of the definition body, and normal
+// order only takes that step once the reference is the next redex.
+//
+
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include "../Terms.h"
+#include "../Definitions.h"
+
+#include <memory>
+
+class Reference final : public Term {
+public:
+    std::shared_ptr<const Definition> definition;
+
+    explicit Reference(std::shared_ptr<const Definition> definition):
+        definition(std::move(definition))
+    {};
+    ~Reference() override;
+
+    [[nodiscard]] std::unique_ptr<Term> unfold() const;
+
+    [[nodiscard]] std::unique_ptr<Term> alpha_convert(std::string newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute(std::string target, Term& newValue) const override;
+    [[nodiscard]] std::unique_ptr<Term> clone() const override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce() const override;
+    [[nodiscard]] std::unique_ptr<Type> type_check(const TypingContext& context) const override;
+    [[nodiscard]] bool is_normal() const override;
+    [[nodiscard]] bool has_free(std::string target) const override;
+    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] TermSize measure() const override;
+    [[nodiscard]] std::uint64_t alpha_hash(BinderScope& scope) const override;
+    [[nodiscard]] std::unique_ptr<Term> substitute_in_place(std::unique_ptr<Term> self, const std::string& target, const Term& newValue) override;
+    [[nodiscard]] std::unique_ptr<Term> beta_reduce_in_place(std::unique_ptr<Term> self) override;
+};
+
+#endif //REFERENCE_H
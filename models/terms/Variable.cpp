@@ -57,4 +57,24 @@ bool Variable::has_free(const std::string target) const {
 
 std::string Variable::to_string() const {
     return name;
-}
\ No newline at end of file
+}
+
+TermSize Variable::measure() const {
+    return {1, sizeof(Variable) + heap_bytes(this->name)};
+}
+
+std::uint64_t Variable::alpha_hash(BinderScope& scope) const {
+    for (std::size_t i = scope.size(); i-- > 0;) {
+        if (scope[i] == this->name) return hash_mix(1, scope.size() - 1 - i);
+    }
+    return hash_mix(2, hash_name(this->name));
+}
+
+unique_ptr<Term> Variable::substitute_in_place(unique_ptr<Term> self, const std::string& target, const Term& newValue) {
+    if (target == name) return newValue.clone();
+    return self;
+}
+
+unique_ptr<Term> Variable::beta_reduce_in_place(unique_ptr<Term> self) {
+    throw ReductionOnNormalForm(std::move(self));
+}
@@ -0,0 +1,313 @@
+//
+// BlockLexer.cpp
+//
+
+#include "BlockLexer.h"
+
+#include "../exceptions/Exceptions.h"
+#include "../models/Timeline.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LAMBDA_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr std::size_t block_bytes = 64;
+
+// Raw per-byte classes of one block, one bit per byte.
+struct BlockMasks {
+	std::uint64_t space = 0;
+	std::uint64_t ascii_word = 0;   // letters, digits, '_' and '\''
+	std::uint64_t high = 0;         // bytes >= 0x80
+	std::uint64_t lambda_lead = 0;  // 0xCE, first byte of λ
+	std::uint64_t lambda_tail = 0;  // 0xBB, second byte of λ
+	std::uint64_t punctuation = 0;  // . ( ) [ ] : = , * + and backslash
+	std::uint64_t dash = 0;
+	std::uint64_t greater = 0;
+};
+
+enum ByteClass : std::uint8_t {
+	Space = 1, AsciiWord = 2, High = 4, LambdaLead = 8, LambdaTail = 16, Punctuation = 32, Dash = 64, Greater = 128
+};
+
+constexpr std::array<std::uint8_t, 256> byte_classes = [] {
+	std::array<std::uint8_t, 256> table{};
+	for (int c = 0; c < 256; ++c) {
+		std::uint8_t bits = 0;
+		if (c == ' ' || c == '\t' || c == '\n' || c == '\r') bits |= Space;
+		if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '\'') bits |= AsciiWord;
+		if (c >= 0x80) bits |= High;
+		if (c == 0xCE) bits |= LambdaLead;
+		if (c == 0xBB) bits |= LambdaTail;
+		if (c == '.' || c == '(' || c == ')' || c == '[' || c == ']' || c == ':' || c == '=' || c == ','
+			|| c == '*' || c == '+' || c == '\\') bits |= Punctuation;
+		if (c == '-') bits |= Dash;
+		if (c == '>') bits |= Greater;
+		table[c] = bits;
+	}
+	return table;
+}();
+
+BlockMasks classify_scalar(const unsigned char* block) {
+	BlockMasks masks;
+	for (std::size_t i = 0; i < block_bytes; ++i) {
+		const auto bits = byte_classes[block[i]];
+		const auto bit = std::uint64_t{1} << i;
+		if (bits & Space) masks.space |= bit;
+		if (bits & AsciiWord) masks.ascii_word |= bit;
+		if (bits & High) masks.high |= bit;
+		if (bits & LambdaLead) masks.lambda_lead |= bit;
+		if (bits & LambdaTail) masks.lambda_tail |= bit;
+		if (bits & Punctuation) masks.punctuation |= bit;
+		if (bits & Dash) masks.dash |= bit;
+		if (bits & Greater) masks.greater |= bit;
+	}
+	return masks;
+}
+
+#ifdef LAMBDA_X86_KERNELS
+
+// Both kernels run the same comparisons; only the vector width differs.
+// Signed compares leave bytes >= 0x80 out of every ASCII range. Helpers
+// carry the target attribute too, or they could not inline into the kernel.
+#define LAMBDA_AVX2 __attribute__((target("avx2"), always_inline)) inline
+
+LAMBDA_AVX2 __m256i equal_avx2(__m256i chunk, char c) {
+	return _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c));
+}
+
+LAMBDA_AVX2 __m256i between_avx2(__m256i chunk, char low, char high) {
+	return _mm256_and_si256(_mm256_cmpgt_epi8(chunk, _mm256_set1_epi8(static_cast<char>(low - 1))),
+		_mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(high + 1)), chunk));
+}
+
+LAMBDA_AVX2 std::uint64_t bits_avx2(__m256i value) {
+	return static_cast<std::uint32_t>(_mm256_movemask_epi8(value));
+}
+
+__attribute__((target("avx2")))
+BlockMasks classify_avx2(const unsigned char* block) {
+	BlockMasks masks;
+	for (unsigned half = 0; half < 2; ++half) {
+		const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32 * half));
+		const __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+		const __m256i space = _mm256_or_si256(_mm256_or_si256(equal_avx2(chunk, ' '), equal_avx2(chunk, '\t')),
+			_mm256_or_si256(equal_avx2(chunk, '\n'), equal_avx2(chunk, '\r')));
+		const __m256i word = _mm256_or_si256(_mm256_or_si256(between_avx2(folded, 'a', 'z'), between_avx2(chunk, '0', '9')),
+			_mm256_or_si256(equal_avx2(chunk, '_'), equal_avx2(chunk, '\'')));
+		const __m256i punctuation = _mm256_or_si256(
+			_mm256_or_si256(_mm256_or_si256(equal_avx2(chunk, '.'), equal_avx2(chunk, '(')),
+				_mm256_or_si256(equal_avx2(chunk, ')'), equal_avx2(chunk, '['))),
+			_mm256_or_si256(_mm256_or_si256(equal_avx2(chunk, ']'), equal_avx2(chunk, ':')),
+				_mm256_or_si256(equal_avx2(chunk, '='), equal_avx2(chunk, '\\'))));
+		const __m256i operators = _mm256_or_si256(equal_avx2(chunk, ','), _mm256_or_si256(equal_avx2(chunk, '*'), equal_avx2(chunk, '+')));
+		const unsigned shift = 32 * half;
+		masks.space |= bits_avx2(space) << shift;
+		masks.ascii_word |= bits_avx2(word) << shift;
+		masks.high |= bits_avx2(chunk) << shift;
+		masks.lambda_lead |= bits_avx2(equal_avx2(chunk, static_cast<char>(0xCE))) << shift;
+		masks.lambda_tail |= bits_avx2(equal_avx2(chunk, static_cast<char>(0xBB))) << shift;
+		masks.punctuation |= bits_avx2(_mm256_or_si256(punctuation, operators)) << shift;
+		masks.dash |= bits_avx2(equal_avx2(chunk, '-')) << shift;
+		masks.greater |= bits_avx2(equal_avx2(chunk, '>')) << shift;
+	}
+	return masks;
+}
+
+#undef LAMBDA_AVX2
+
+inline __m128i equal_sse2(__m128i chunk, char c) {
+	return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c));
+}
+
+inline __m128i between_sse2(__m128i chunk, char low, char high) {
+	return _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8(static_cast<char>(low - 1))),
+		_mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(high + 1)), chunk));
+}
+
+inline std::uint64_t bits_sse2(__m128i value) {
+	return static_cast<std::uint16_t>(_mm_movemask_epi8(value));
+}
+
+BlockMasks classify_sse2(const unsigned char* block) {
+	BlockMasks masks;
+	for (unsigned quarter = 0; quarter < 4; ++quarter) {
+		const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * quarter));
+		const __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+		const __m128i space = _mm_or_si128(_mm_or_si128(equal_sse2(chunk, ' '), equal_sse2(chunk, '\t')),
+			_mm_or_si128(equal_sse2(chunk, '\n'), equal_sse2(chunk, '\r')));
+		const __m128i word = _mm_or_si128(_mm_or_si128(between_sse2(folded, 'a', 'z'), between_sse2(chunk, '0', '9')),
+			_mm_or_si128(equal_sse2(chunk, '_'), equal_sse2(chunk, '\'')));
+		const __m128i punctuation = _mm_or_si128(
+			_mm_or_si128(_mm_or_si128(equal_sse2(chunk, '.'), equal_sse2(chunk, '(')),
+				_mm_or_si128(equal_sse2(chunk, ')'), equal_sse2(chunk, '['))),
+			_mm_or_si128(_mm_or_si128(equal_sse2(chunk, ']'), equal_sse2(chunk, ':')),
+				_mm_or_si128(equal_sse2(chunk, '='), equal_sse2(chunk, '\\'))));
+		const __m128i operators = _mm_or_si128(equal_sse2(chunk, ','), _mm_or_si128(equal_sse2(chunk, '*'), equal_sse2(chunk, '+')));
+		const unsigned shift = 16 * quarter;
+		masks.space |= bits_sse2(space) << shift;
+		masks.ascii_word |= bits_sse2(word) << shift;
+		masks.high |= bits_sse2(chunk) << shift;
+		masks.lambda_lead |= bits_sse2(equal_sse2(chunk, static_cast<char>(0xCE))) << shift;
+		masks.lambda_tail |= bits_sse2(equal_sse2(chunk, static_cast<char>(0xBB))) << shift;
+		masks.punctuation |= bits_sse2(_mm_or_si128(punctuation, operators)) << shift;
+		masks.dash |= bits_sse2(equal_sse2(chunk, '-')) << shift;
+		masks.greater |= bits_sse2(equal_sse2(chunk, '>')) << shift;
+	}
+	return masks;
+}
+
+#endif
+
+using Classifier = BlockMasks (*)(const unsigned char*);
+
+Classifier classifier_for(ScanBackend backend) {
+	if (!scan_backend_supported(backend)) throw std::invalid_argument(std::string("scan backend not supported: ") + scan_backend_name(backend));
+	switch (backend) {
+#ifdef LAMBDA_X86_KERNELS
+		case ScanBackend::AVX2: return classify_avx2;
+		case ScanBackend::SSE2: return classify_sse2;
+#endif
+		default: return classify_scalar;
+	}
+}
+
+TokenKind punctuation_kind(char c) {
+	switch (c) {
+		case '.': return TokenKind::Dot;
+		case '(': return TokenKind::LParen;
+		case ')': return TokenKind::RParen;
+		case '[': return TokenKind::LBracket;
+		case ']': return TokenKind::RBracket;
+		case ':': return TokenKind::Colon;
+		case '=': return TokenKind::Equals;
+		case ',': return TokenKind::Comma;
+		case '*': return TokenKind::Star;
+		case '+': return TokenKind::Plus;
+		default: return TokenKind::Lambda;  // backslash
+	}
+}
+
+// A word is a Number only if every byte is a digit, as in tokenize().
+TokenKind word_kind(std::string_view word) {
+	for (const char c : word) {
+		if (c < '0' || c > '9') return TokenKind::Identifier;
+	}
+	return TokenKind::Number;
+}
+
+}
+
+const char* scan_backend_name(ScanBackend backend) {
+	switch (backend) {
+		case ScanBackend::Scalar: return "scalar";
+		case ScanBackend::SSE2: return "sse2";
+		case ScanBackend::AVX2: return "avx2";
+	}
+	return "?";
+}
+
+bool scan_backend_supported(ScanBackend backend) {
+	switch (backend) {
+		case ScanBackend::Scalar: return true;
+#ifdef LAMBDA_X86_KERNELS
+		case ScanBackend::SSE2: return true;
+		case ScanBackend::AVX2: return __builtin_cpu_supports("avx2");
+#else
+		default: return false;
+#endif
+	}
+	return false;
+}
+
+ScanBackend fastest_scan_backend() {
+	static const ScanBackend fastest = [] {
+		if (scan_backend_supported(ScanBackend::AVX2)) return ScanBackend::AVX2;
+		if (scan_backend_supported(ScanBackend::SSE2)) return ScanBackend::SSE2;
+		return ScanBackend::Scalar;
+	}();
+	return fastest;
+}
+
+std::vector<Token> tokenize_blocks(std::string_view source, ScanBackend backend) {
+	TIMELINE_SPAN("tokenize");
+	const auto classify = classifier_for(backend);
+	const auto* bytes = reinterpret_cast<const unsigned char*>(source.data());
+	std::vector<Token> tokens;
+	// Roughly one token per four bytes of to_string output.
+	tokens.reserve(source.size() / 4 + 1);
+	const auto emit = [&tokens](TokenKind kind, std::size_t offset, std::size_t length) {
+		tokens.push_back({kind, static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(length)});
+	};
+
+	// State carried across block boundaries.
+	bool word_open = false;          // inside a word that started at word_start
+	std::size_t word_start = 0;
+	bool pair_tail_carry = false;    // previous block ended on the first byte of λ or ->
+
+	for (std::size_t base = 0; base < source.size(); base += block_bytes) {
+		const std::size_t length = std::min(block_bytes, source.size() - base);
+		BlockMasks masks;
+		if (length == block_bytes) {
+			masks = classify(bytes + base);
+		} else {
+			// Pad the last block with spaces, which start no token.
+			unsigned char padded[block_bytes];
+			std::memset(padded, ' ', block_bytes);
+			std::memcpy(padded, bytes + base, length);
+			masks = classify(padded);
+		}
+		const std::uint64_t valid = length == block_bytes ? ~std::uint64_t{0} : (std::uint64_t{1} << length) - 1;
+
+		// The second byte of λ and -> may sit in the next block.
+		const bool next_tail_lambda = base + block_bytes < source.size() && bytes[base + block_bytes] == 0xBB;
+		const bool next_tail_arrow = base + block_bytes < source.size() && bytes[base + block_bytes] == '>';
+		const std::uint64_t lambda = masks.lambda_lead & ((masks.lambda_tail >> 1) | (std::uint64_t{next_tail_lambda} << 63));
+		const std::uint64_t arrow = masks.dash & ((masks.greater >> 1) | (std::uint64_t{next_tail_arrow} << 63));
+		const std::uint64_t pair_tails = ((lambda | arrow) << 1) | std::uint64_t{pair_tail_carry};
+		const std::uint64_t word = (masks.ascii_word | masks.high) & ~lambda & ~pair_tails & valid;
+
+		const std::uint64_t covered = masks.space | word | masks.punctuation | lambda | arrow | pair_tails;
+		if (const std::uint64_t invalid = ~covered & valid) {
+			const auto at = base + static_cast<std::size_t>(std::countr_zero(invalid));
+			// Tokens after the bad byte are never read, as in tokenize().
+			throw ParseError("unexpected character", at);
+		}
+
+		const std::uint64_t word_before = (word << 1) | std::uint64_t{word_open};
+		const std::uint64_t word_starts = word & ~word_before;
+		const std::uint64_t word_ends = ~word & word_before & valid;
+		const std::uint64_t others = (masks.punctuation | lambda | arrow) & valid;
+
+		for (std::uint64_t events = word_starts | word_ends | others; events != 0; events &= events - 1) {
+			const auto bit = static_cast<unsigned>(std::countr_zero(events));
+			const auto at = base + bit;
+			const auto mask = std::uint64_t{1} << bit;
+			if (word_ends & mask) {
+				emit(word_kind(source.substr(word_start, at - word_start)), word_start, at - word_start);
+				word_open = false;
+			}
+			if (word_starts & mask) {
+				word_start = at;
+				word_open = true;
+			} else if (lambda & mask) {
+				emit(TokenKind::Lambda, at, 2);
+			} else if (arrow & mask) {
+				emit(TokenKind::Arrow, at, 2);
+			} else if (masks.punctuation & mask) {
+				emit(punctuation_kind(source[at]), at, 1);
+			}
+		}
+		pair_tail_carry = ((lambda | arrow) >> 63) & 1;
+	}
+	if (word_open) emit(word_kind(source.substr(word_start)), word_start, source.size() - word_start);
+	tokens.push_back({TokenKind::End, static_cast<std::uint32_t>(source.size()), 0});
+	return tokens;
+}
@@ -0,0 +1,34 @@
+//
+// BlockLexer.h
+//
+// Bulk tokenizer producing exactly the tokens of tokenize(), for long
+// inputs. Each 64-byte block is classified at once into bitmasks: spaces,
+// identifier bytes, λ and -> halves, and one-byte punctuation. Tokens are
+// then read off the mask bits. Per-byte work happens only at token
+// boundaries, not for every byte.
+//
+// The x86-64 kernels are chosen at run time: AVX2 when the CPU has it,
+// otherwise SSE2. Every other target uses a table-driven scalar kernel.
+//
+
+#ifndef BLOCKLEXER_H
+#define BLOCKLEXER_H
+
+#include "Lexer.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+enum class ScanBackend : std::uint8_t { Scalar, SSE2, AVX2 };
+
+[[nodiscard]] const char* scan_backend_name(ScanBackend backend);
+[[nodiscard]] bool scan_backend_supported(ScanBackend backend);
+// The widest backend the running CPU supports.
+[[nodiscard]] ScanBackend fastest_scan_backend();
+
+// Same result as tokenize(source), including the ParseError offset. Throws
+// std::invalid_argument for a backend the CPU lacks.
+[[nodiscard]] std::vector<Token> tokenize_blocks(std::string_view source, ScanBackend backend = fastest_scan_backend());
+
+#endif //BLOCKLEXER_H
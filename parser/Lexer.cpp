@@ -0,0 +1,84 @@
+//
+// Lexer.cpp
+//
+
+#include "Lexer.h"
+
+#include "../exceptions/Exceptions.h"
+#include "../models/Timeline.h"
+
+namespace {
+	bool is_space(unsigned char c) {
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	bool is_digit(unsigned char c) {
+		return c >= '0' && c <= '9';
+	}
+
+	bool starts_lambda(std::string_view source, std::size_t at) {
+		return source.substr(at, 2) == "λ";
+	}
+
+	// ASCII letters, digits, '_' and primes, plus any non-ASCII byte that is
+	// not part of a λ, so names such as τ lex as identifiers.
+	bool is_identifier_byte(std::string_view source, std::size_t at) {
+		const auto c = static_cast<unsigned char>(source[at]);
+		if (c >= 0x80) return !starts_lambda(source, at);
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || is_digit(c) || c == '_' || c == '\'';
+	}
+}
+
+std::vector<Token> tokenize(std::string_view source) {
+	TIMELINE_SPAN("tokenize");
+	std::vector<Token> tokens;
+	std::size_t at = 0;
+	auto emit = [&](TokenKind kind, std::size_t length) {
+		tokens.push_back({kind, static_cast<std::uint32_t>(at), static_cast<std::uint32_t>(length)});
+		at += length;
+	};
+
+	while (at < source.size()) {
+		const auto c = static_cast<unsigned char>(source[at]);
+		if (is_space(c)) {
+			++at;
+			continue;
+		}
+		if (starts_lambda(source, at)) { emit(TokenKind::Lambda, 2); continue; }
+		switch (c) {
+			case '\\': emit(TokenKind::Lambda, 1); continue;
+			case '.': emit(TokenKind::Dot, 1); continue;
+			case '(': emit(TokenKind::LParen, 1); continue;
+			case ')': emit(TokenKind::RParen, 1); continue;
+			case '[': emit(TokenKind::LBracket, 1); continue;
+			case ']': emit(TokenKind::RBracket, 1); continue;
+			case ':': emit(TokenKind::Colon, 1); continue;
+			case '=': emit(TokenKind::Equals, 1); continue;
+			case ',': emit(TokenKind::Comma, 1); continue;
+			case '*': emit(TokenKind::Star, 1); continue;
+			case '+': emit(TokenKind::Plus, 1); continue;
+			case '-':
+				if (at + 1 < source.size() && source[at + 1] == '>') { emit(TokenKind::Arrow, 2); continue; }
+				break;
+			default:
+				break;
+		}
+		if (is_digit(c)) {
+			std::size_t end = at;
+			while (end < source.size() && is_digit(static_cast<unsigned char>(source[end]))) ++end;
+			if (end == source.size() || !is_identifier_byte(source, end)) {
+				emit(TokenKind::Number, end - at);
+				continue;
+			}
+		}
+		if (is_identifier_byte(source, at)) {
+			std::size_t end = at;
+			while (end < source.size() && is_identifier_byte(source, end)) ++end;
+			emit(TokenKind::Identifier, end - at);
+			continue;
+		}
+		throw ParseError("unexpected character", at);
+	}
+	tokens.push_back({TokenKind::End, static_cast<std::uint32_t>(source.size()), 0});
+	return tokens;
+}
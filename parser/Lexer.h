@@ -0,0 +1,48 @@
+//
+// Lexer.h
+//
+// Tokenizer for the concrete syntax printed by Term::to_string, extended
+// with binder annotations (λx:Nat -> Nat. body), let, literals, pairs and
+// product and sum types.
+//
+
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+enum class TokenKind : std::uint8_t {
+	Lambda,     // λ or backslash
+	Dot,
+	LParen,
+	RParen,
+	LBracket,
+	RBracket,
+	Colon,
+	Arrow,      // ->
+	Equals,
+	Comma,
+	Star,       // product types
+	Plus,       // sum types
+	Identifier,
+	Number,
+	End
+};
+
+struct Token {
+	TokenKind kind;
+	std::uint32_t offset;
+	std::uint32_t length;
+};
+
+// Splits `source` into tokens; the result always ends with an End token.
+// Throws ParseError on a character that starts no token.
+[[nodiscard]] std::vector<Token> tokenize(std::string_view source);
+
+[[nodiscard]] inline std::string_view token_text(std::string_view source, const Token& token) {
+	return source.substr(token.offset, token.length);
+}
+
+#endif //LEXER_H
@@ -0,0 +1,245 @@
+//
+// Parser.cpp
+//
+
+#include "Parser.h"
+#include "BlockLexer.h"
+
+#include "../models/terms/Variable.h"
+#include "../models/terms/Abstraction.h"
+#include "../models/terms/Application.h"
+#include "../models/terms/Literal.h"
+#include "../models/terms/Primitive.h"
+#include "../models/terms/Let.h"
+#include "../models/terms/Reference.h"
+#include "../models/terms/Pair.h"
+#include "../models/terms/Projection.h"
+#include "../models/terms/Case.h"
+#include "../models/Timeline.h"
+#include "../exceptions/Exceptions.h"
+
+#include <charconv>
+#include <istream>
+
+using std::unique_ptr, std::make_unique;
+
+Parser::Parser(std::string_view source, const Definitions* definitions):
+	source(source),
+	tokens(tokenize_blocks(source)),
+	definitions(definitions)
+{}
+
+const Token& Parser::peek() const {
+	return this->tokens[this->cursor];
+}
+
+std::string_view Parser::text(const Token& token) const {
+	return token_text(this->source, token);
+}
+
+bool Parser::at_keyword(std::string_view keyword) const {
+	return this->peek().kind == TokenKind::Identifier && this->text(this->peek()) == keyword;
+}
+
+const Token& Parser::expect(TokenKind kind, const char* what) {
+	const auto& token = this->peek();
+	if (token.kind != kind) throw ParseError(std::string("expected ") + what, token.offset);
+	++this->cursor;
+	return token;
+}
+
+void Parser::expect_end() {
+	if (this->peek().kind != TokenKind::End) throw ParseError("unexpected trailing input", this->peek().offset);
+}
+
+unique_ptr<Term> Parser::parse_term() {
+	auto result = this->term();
+	this->expect_end();
+	return result;
+}
+
+unique_ptr<Type> Parser::parse_type() {
+	auto result = this->type();
+	this->expect_end();
+	return result;
+}
+
+unique_ptr<Term> Parser::term() {
+	if (this->peek().kind == TokenKind::Lambda) return this->abstraction();
+	if (this->at_keyword("let")) return this->let();
+	return this->application();
+}
+
+unique_ptr<Term> Parser::abstraction() {
+	this->expect(TokenKind::Lambda, "'λ'");
+	const auto name = std::string(this->text(this->expect(TokenKind::Identifier, "binder name")));
+	unique_ptr<Type> var_type;
+	if (this->peek().kind == TokenKind::Colon) {
+		++this->cursor;
+		var_type = this->type();
+	} else {
+		var_type = make_unique<BaseType>("τ");
+	}
+	this->expect(TokenKind::Dot, "'.'");
+
+	this->scope.emplace_back(name, var_type.get());
+	auto body = this->term();
+	this->scope.pop_back();
+	return make_unique<Abstraction>(std::move(var_type), name, std::move(body));
+}
+
+unique_ptr<Term> Parser::let() {
+	++this->cursor;
+	const auto name = std::string(this->text(this->expect(TokenKind::Identifier, "let binder name")));
+	this->expect(TokenKind::Equals, "'='");
+	auto bound = this->term();
+	if (!this->at_keyword("in")) throw ParseError("expected 'in'", this->peek().offset);
+	++this->cursor;
+
+	this->scope.emplace_back(name, nullptr);
+	auto body = this->term();
+	this->scope.pop_back();
+	return make_unique<Let>(name, std::move(bound), std::move(body));
+}
+
+unique_ptr<Term> Parser::application() {
+	auto result = this->atom();
+	for (;;) {
+		const auto kind = this->peek().kind;
+		if (kind == TokenKind::Lambda || this->at_keyword("let")) {
+			// A binder as the last argument extends to the end.
+			return make_unique<Application>(std::move(result), this->term());
+		}
+		if (kind != TokenKind::LParen && kind != TokenKind::Identifier && kind != TokenKind::Number) return result;
+		if (this->at_keyword("in")) return result;
+		result = make_unique<Application>(std::move(result), this->atom());
+	}
+}
+
+unique_ptr<Term> Parser::atom() {
+	const auto& token = this->peek();
+	switch (token.kind) {
+		case TokenKind::LParen: {
+			++this->cursor;
+			auto inner = this->term();
+			if (this->peek().kind == TokenKind::Comma) {
+				++this->cursor;
+				auto second = this->term();
+				this->expect(TokenKind::RParen, "')'");
+				return make_unique<Pair>(std::move(inner), std::move(second));
+			}
+			this->expect(TokenKind::RParen, "')'");
+			return inner;
+		}
+		case TokenKind::Number: {
+			++this->cursor;
+			std::uint64_t value = 0;
+			const auto digits = this->text(token);
+			const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+			if (error != std::errc()) throw ParseError("numeric literal out of range", token.offset);
+			return Literal::nat(value);
+		}
+		case TokenKind::Identifier:
+			++this->cursor;
+			return this->identifier(token);
+		default:
+			throw ParseError("expected a term", token.offset);
+	}
+}
+
+unique_ptr<Term> Parser::identifier(const Token& token) {
+	const auto name = this->text(token);
+	for (auto it = this->scope.rbegin(); it != this->scope.rend(); ++it) {
+		if (it->first != name) continue;
+		if (it->second == nullptr) return make_unique<Variable>(std::string(name));
+		return make_unique<Variable>(std::string(name), it->second->clone());
+	}
+
+	if (name == "let" || name == "in") throw ParseError("unexpected keyword", token.offset);
+	if (name == "true") return Literal::boolean(true);
+	if (name == "false") return Literal::boolean(false);
+	if (name == "add") return make_unique<Primitive>(PrimitiveOp::Add);
+	if (name == "sub") return make_unique<Primitive>(PrimitiveOp::Sub);
+	if (name == "mul") return make_unique<Primitive>(PrimitiveOp::Mul);
+	if (name == "eq") return make_unique<Primitive>(PrimitiveOp::Eq);
+	if (name == "lt") return make_unique<Primitive>(PrimitiveOp::Lt);
+	if (name == "if") {
+		unique_ptr<Type> branch_type;
+		if (this->peek().kind == TokenKind::LBracket) {
+			++this->cursor;
+			branch_type = this->type();
+			this->expect(TokenKind::RBracket, "']'");
+		}
+		return make_unique<Primitive>(PrimitiveOp::If, std::move(branch_type));
+	}
+	if (name == "fst") return make_unique<Projection>(Component::First, this->atom());
+	if (name == "snd") return make_unique<Projection>(Component::Second, this->atom());
+	if (name == "inl") return this->injection(Side::Left);
+	if (name == "inr") return this->injection(Side::Right);
+	if (name == "case") {
+		auto scrutinee = this->atom();
+		auto on_left = this->atom();
+		return make_unique<Case>(std::move(scrutinee), std::move(on_left), this->atom());
+	}
+
+	if (this->definitions != nullptr) {
+		if (auto definition = this->definitions->lookup(std::string(name))) {
+			return make_unique<Reference>(std::move(definition));
+		}
+	}
+	return make_unique<Variable>(std::string(name));
+}
+
+// The sum type is required: without it the injection could not be typed.
+unique_ptr<Term> Parser::injection(Side side) {
+	this->expect(TokenKind::LBracket, "'[' and the sum type");
+	auto sum_type = this->type();
+	this->expect(TokenKind::RBracket, "']'");
+	return make_unique<Injection>(side, std::move(sum_type), this->atom());
+}
+
+unique_ptr<Type> Parser::type() {
+	auto domain = this->sum_type();
+	if (this->peek().kind != TokenKind::Arrow) return domain;
+	++this->cursor;
+	return make_unique<FunctionType>(std::move(domain), this->type());
+}
+
+unique_ptr<Type> Parser::sum_type() {
+	auto left = this->product_type();
+	if (this->peek().kind != TokenKind::Plus) return left;
+	++this->cursor;
+	return make_unique<SumType>(std::move(left), this->product_type());
+}
+
+unique_ptr<Type> Parser::product_type() {
+	auto first = this->type_atom();
+	if (this->peek().kind != TokenKind::Star) return first;
+	++this->cursor;
+	return make_unique<ProductType>(std::move(first), this->type_atom());
+}
+
+unique_ptr<Type> Parser::type_atom() {
+	if (this->peek().kind == TokenKind::LParen) {
+		++this->cursor;
+		auto inner = this->type();
+		this->expect(TokenKind::RParen, "')'");
+		return inner;
+	}
+	return make_unique<BaseType>(std::string(this->text(this->expect(TokenKind::Identifier, "a type"))));
+}
+
+unique_ptr<Term> parse_term(std::string_view source, const Definitions* definitions) {
+	TIMELINE_SPAN("parse");
+	return Parser(source, definitions).parse_term();
+}
+
+unique_ptr<Type> parse_type(std::string_view source) {
+	return Parser(source).parse_type();
+}
+
+std::istream& operator>>(std::istream& is, unique_ptr<Term>& term) {
+	std::string line;
+	if (std::getline(is, line)) term = parse_term(line);
+	return is;
+}
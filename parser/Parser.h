@@ -0,0 +1,74 @@
+//
+// Parser.h
+//
+// Recursive-descent parser for the syntax printed by Term::to_string:
+//
+//   term  ::= λ ident [: type] . term | let ident = term in term | app
+//   app   ::= atom { atom } [ λ-term | let-term ]
+//   atom  ::= ( term ) | ( term , term ) | number | true | false
+//           | add | sub | mul | eq | lt | if [ type ]
+//           | fst atom | snd atom | inl [ type ] atom | inr [ type ] atom
+//           | case atom atom atom | ident
+//   type  ::= sum [ -> type ]
+//   sum   ::= prod [ + prod ]
+//   prod  ::= tatom [ * tatom ]
+//   tatom ::= ident | ( type )
+//
+// Unannotated binders get the default type τ. A free identifier that names
+// an entry of the supplied Definitions becomes a Reference.
+//
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#include "Lexer.h"
+#include "../models/Terms.h"
+#include "../models/Type.h"
+#include "../models/Definitions.h"
+#include "../models/terms/Injection.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class Parser {
+public:
+	explicit Parser(std::string_view source, const Definitions* definitions = nullptr);
+
+	// Both consume the whole input and throw ParseError otherwise.
+	[[nodiscard]] std::unique_ptr<Term> parse_term();
+	[[nodiscard]] std::unique_ptr<Type> parse_type();
+
+private:
+	std::string_view source;
+	std::vector<Token> tokens;
+	std::size_t cursor = 0;
+	const Definitions* definitions;
+	// Enclosing binders, innermost last; the type is null for let.
+	std::vector<std::pair<std::string, const Type*>> scope;
+
+	[[nodiscard]] const Token& peek() const;
+	[[nodiscard]] std::string_view text(const Token& token) const;
+	[[nodiscard]] bool at_keyword(std::string_view keyword) const;
+	const Token& expect(TokenKind kind, const char* what);
+	void expect_end();
+
+	[[nodiscard]] std::unique_ptr<Term> term();
+	[[nodiscard]] std::unique_ptr<Term> abstraction();
+	[[nodiscard]] std::unique_ptr<Term> let();
+	[[nodiscard]] std::unique_ptr<Term> application();
+	[[nodiscard]] std::unique_ptr<Term> atom();
+	[[nodiscard]] std::unique_ptr<Term> identifier(const Token& token);
+	[[nodiscard]] std::unique_ptr<Term> injection(Side side);
+	[[nodiscard]] std::unique_ptr<Type> type();
+	[[nodiscard]] std::unique_ptr<Type> sum_type();
+	[[nodiscard]] std::unique_ptr<Type> product_type();
+	[[nodiscard]] std::unique_ptr<Type> type_atom();
+};
+
+[[nodiscard]] std::unique_ptr<Term> parse_term(std::string_view source, const Definitions* definitions = nullptr);
+[[nodiscard]] std::unique_ptr<Type> parse_type(std::string_view source);
+
+#endif //PARSER_H
@@ -0,0 +1,453 @@
+//
+// BatchPipeline.cpp
+//
+
+#include "BatchPipeline.h"
+#include "BoundedQueue.h"
+#include "WorkerPool.h"
+
+#include "../models/Terms.h"
+#include "../models/Type.h"
+#include "../models/TermCodec.h"
+#include "../models/lambda.h"
+#include "../models/Timeline.h"
+#include "../parser/Lexer.h"
+#include "../parser/Parser.h"
+#include "../engines/Diagnostics.h"
+#include "../exceptions/Exceptions.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::unique_ptr;
+
+namespace {
+
+struct BatchItem {
+	std::size_t sequence = 0;
+	std::size_t line = 0;
+	unique_ptr<Term> term;
+	unique_ptr<Type> type;
+	std::string error;
+	std::size_t steps = 0;
+	EtaStats eta;
+	std::string trace;          // encoded reduction trace, when tracing
+	bool cached = false;
+	bool well_typed = false;
+	bool exhausted = false;
+};
+
+using BatchQueue = BoundedQueue<BatchItem>;
+
+bool is_blank_or_comment(const std::string& line) {
+	const auto first = line.find_first_not_of(" \t\r");
+	return first == std::string::npos || line[first] == '#';
+}
+
+// Handles `def name = term`; returns false if the line is not a definition.
+// Only the full `def name =` prefix makes one, so a term that merely starts
+// with a variable called def parses as it does anywhere else.
+bool try_define(const std::string& line, Definitions& globals) {
+	const auto tokens = tokenize(line);
+	if (tokens.size() < 4 || tokens[0].kind != TokenKind::Identifier || token_text(line, tokens[0]) != "def"
+		|| tokens[1].kind != TokenKind::Identifier || tokens[2].kind != TokenKind::Equals) return false;
+
+	const std::string_view source(line);
+	auto body = parse_term(source.substr(tokens[3].offset), &globals);
+	globals.define(std::string(token_text(line, tokens[1])), std::move(body));
+	return true;
+}
+
+void check_item(BatchItem& item, const BatchOptions& options) {
+	if (!item.error.empty()) return;
+	if (auto type = try_type_check(*item.term)) {
+		item.well_typed = true;
+		if (options.show_types) item.type = std::move(*type);
+	} else if (options.strict) {
+		item.error = type.error().message();
+		item.term.reset();
+	}
+}
+
+ResourcePolicy resource_policy(const BatchOptions& options, const CancellationToken& cancellation) {
+	ResourcePolicy policy;
+	policy.max_steps = options.max_steps;
+	policy.max_nodes = options.max_nodes;
+	policy.max_bytes = options.max_bytes;
+	policy.cancellation = &cancellation;
+	policy.detect_cycles = options.detect_cycles;
+	return policy;
+}
+
+void normalize_item(BatchItem& item, const BatchOptions& options, ResourcePolicy& policy, NormalFormCache* cache) {
+	if (!item.error.empty()) return;
+	try {
+		// A traced term always takes the guarded path, which records its steps.
+		std::optional<TraceRecorder> recorder;
+		if (!options.trace_path.empty()) recorder.emplace("line " + std::to_string(item.line));
+		policy.trace = recorder ? &*recorder : nullptr;
+		// A traced term is always reduced, since its steps are the point.
+		unique_ptr<Term> cached = cache != nullptr && !recorder ? cache->lookup(*item.term) : nullptr;
+		unique_ptr<Term> original = cache != nullptr && !cached ? item.term->clone() : nullptr;
+		if (cached) {
+			item.term = std::move(cached);
+			item.cached = true;
+		} else if (options.trust_types && item.well_typed && !recorder) {
+			// Strongly normalizing, so the guards buy nothing.
+			item.term = normalize_unguarded(std::move(item.term), item.steps);
+		} else {
+			if (options.timeout.count() != 0) policy.deadline = std::chrono::steady_clock::now() + options.timeout;
+			auto result = evaluate(std::move(item.term), policy);
+			item.steps = result.steps;
+			if (result.exhausted()) {
+				item.exhausted = true;
+				item.error = describe_exhaustion(result, policy);
+			} else {
+				item.term = std::move(result.term);
+			}
+			if (recorder) item.trace = recorder->bytes();
+		}
+		if (original && item.error.empty()) cache->store(*original, *item.term);
+		if (options.eta && item.error.empty()) item.term = eta_reduce(std::move(item.term), item.eta);
+	} catch (const std::exception& error) {
+		item.error = error.what();
+	}
+}
+
+void check_stage(BatchQueue& input, BatchQueue& output, std::atomic<std::size_t>& live, const BatchOptions& options) {
+	TIMELINE_THREAD("check");
+	while (auto item = input.pop()) {
+		check_item(*item, options);
+		output.push(std::move(*item));
+	}
+	if (--live == 0) output.close();
+}
+
+void normalize_stage(BatchQueue& input, BatchQueue& output, std::atomic<std::size_t>& live, const BatchOptions& options, const CancellationToken& cancellation, TraceFile* trace, NormalFormCache* cache) {
+	TIMELINE_THREAD("normalize");
+	auto policy = resource_policy(options, cancellation);
+	while (auto item = input.pop()) {
+		normalize_item(*item, options, policy, cache);
+		if (!item->trace.empty()) trace->append(item->trace);
+		output.push(std::move(*item));
+	}
+	if (--live == 0) output.close();
+}
+
+// Writes items in sequence order, whatever order they finish in. Items
+// that finish early wait in `pending`, so the reader is only admitted up to
+// `capacity` sequence numbers past the next one to print; otherwise one slow
+// term would let every later result pile up here.
+class OrderedPrinter {
+public:
+	OrderedPrinter(std::ostream& output, BatchStats& stats, std::size_t capacity):
+		output(output),
+		stats(stats),
+		capacity(std::max<std::size_t>(capacity, 1))
+	{}
+
+	void add(BatchItem item) {
+		this->pending.emplace(item.sequence, std::move(item));
+		for (auto it = this->pending.find(this->next); it != this->pending.end(); it = this->pending.find(this->next)) {
+			this->print(it->second);
+			{
+				TIMELINE_SPAN("destroy");
+				this->pending.erase(it);
+			}
+			std::lock_guard lock(this->mutex);
+			++this->next;
+			this->advanced.notify_all();
+		}
+	}
+
+	[[nodiscard]] bool admits(std::size_t sequence) const {
+		std::lock_guard lock(this->mutex);
+		return sequence < this->next + this->capacity;
+	}
+
+	// Blocks the reader until `sequence` is within the window.
+	void admit(std::size_t sequence) {
+		std::unique_lock lock(this->mutex);
+		this->advanced.wait(lock, [&] { return sequence < this->next + this->capacity; });
+	}
+
+private:
+	std::ostream& output;
+	BatchStats& stats;
+	const std::size_t capacity;
+	std::map<std::size_t, BatchItem> pending;
+	// Guards `next` only; `pending` belongs to the printing thread.
+	mutable std::mutex mutex;
+	std::condition_variable advanced;
+	std::size_t next = 0;
+
+	void print(const BatchItem& done) {
+		TIMELINE_SPAN("print");
+		++this->stats.terms;
+		this->stats.steps += done.steps;
+		if (done.cached) ++this->stats.cache_hits;
+		this->stats.eta.reductions += done.eta.reductions;
+		this->stats.eta.nodes_before += done.eta.nodes_before;
+		this->stats.eta.nodes_after += done.eta.nodes_after;
+		if (!done.error.empty()) {
+			++this->stats.failures;
+			if (done.exhausted) ++this->stats.exhausted;
+			this->output << "error: line " << done.line << ": " << done.error << '\n';
+		} else if (done.type) {
+			this->output << done.term->to_string() << " : " << done.type->to_string() << '\n';
+		} else {
+			this->output << done.term->to_string() << '\n';
+		}
+	}
+};
+
+void print_stage(BatchQueue& input, std::ostream& output, OrderedPrinter& printer) {
+	TIMELINE_THREAD("print");
+	while (auto item = input.pop()) printer.add(std::move(*item));
+	output.flush();
+}
+
+// Worker processes have no definition table, so a term crosses with every
+// definition it refers to, dependencies first: a 1 byte, the name and the
+// body per definition, then a 0 byte and the term itself.
+void encode_definitions(TermEncoder& encoder, const Term& term) {
+	if (const auto* abstraction = dynamic_cast<const Abstraction*>(&term)) {
+		encode_definitions(encoder, *abstraction->body);
+	} else if (const auto* application = dynamic_cast<const Application*>(&term)) {
+		encode_definitions(encoder, *application->function);
+		encode_definitions(encoder, *application->value);
+	} else if (const auto* let = dynamic_cast<const Let*>(&term)) {
+		encode_definitions(encoder, *let->bound);
+		encode_definitions(encoder, *let->body);
+	} else if (const auto* pair = dynamic_cast<const Pair*>(&term)) {
+		encode_definitions(encoder, *pair->first);
+		encode_definitions(encoder, *pair->second);
+	} else if (const auto* projection = dynamic_cast<const Projection*>(&term)) {
+		encode_definitions(encoder, *projection->operand);
+	} else if (const auto* injection = dynamic_cast<const Injection*>(&term)) {
+		encode_definitions(encoder, *injection->value);
+	} else if (const auto* match = dynamic_cast<const Case*>(&term)) {
+		encode_definitions(encoder, *match->scrutinee);
+		encode_definitions(encoder, *match->on_left);
+		encode_definitions(encoder, *match->on_right);
+	} else if (const auto* reference = dynamic_cast<const Reference*>(&term)) {
+		const auto& definition = *reference->definition;
+		if (encoder.defined(definition)) return;
+		encode_definitions(encoder, *definition.body);
+		(void)encoder.define(definition);
+		encoder.bytes().push_back(1);
+		encoder.name(definition.name);
+		encoder.term(*definition.body);
+	}
+}
+
+void encode_closed(TermEncoder& encoder, const Term& term) {
+	encode_definitions(encoder, term);
+	encoder.bytes().push_back(0);
+	encoder.term(term);
+}
+
+unique_ptr<Term> decode_closed(TermDecoder& decoder) {
+	while (decoder.reader().byte() != 0) {
+		auto name = decoder.name();
+		decoder.define(std::make_shared<const Definition>(std::move(name), decoder.term()));
+	}
+	return decoder.term();
+}
+
+constexpr std::uint8_t CachedFlag = 1;
+constexpr std::uint8_t ExhaustedFlag = 2;
+constexpr std::uint8_t FailedFlag = 4;
+
+std::string encode_request(const BatchItem& item) {
+	TIMELINE_SPAN("encode");
+	TermEncoder encoder;
+	put_varint(encoder.bytes(), item.line);
+	encode_closed(encoder, *item.term);
+	return std::move(encoder.bytes());
+}
+
+// Runs in a worker process: type checks and normalizes one term.
+std::string serve_request(std::string_view request, const BatchOptions& options, ResourcePolicy& policy, NormalFormCache* cache) {
+	BatchItem item;
+	TermDecoder decoder(request);
+	item.line = decoder.reader().varint();
+	item.term = decode_closed(decoder);
+	check_item(item, options);
+	normalize_item(item, options, policy, cache);
+
+	TermEncoder encoder;
+	auto& out = encoder.bytes();
+	out.push_back(static_cast<char>((item.cached ? CachedFlag : 0) | (item.exhausted ? ExhaustedFlag : 0) | (item.error.empty() ? 0 : FailedFlag)));
+	put_varint(out, item.steps);
+	put_varint(out, item.eta.reductions);
+	put_varint(out, item.eta.nodes_before);
+	put_varint(out, item.eta.nodes_after);
+	put_string(out, item.trace);
+	if (!item.error.empty()) {
+		put_string(out, item.error);
+	} else {
+		encode_closed(encoder, *item.term);
+		encoder.type(item.type.get());
+	}
+	return std::move(out);
+}
+
+void read_response(BatchItem& item, const WorkerResult& result) {
+	TIMELINE_SPAN("decode");
+	if (!result.failure.empty()) {
+		item.error = result.failure;
+		return;
+	}
+	TermDecoder decoder(result.response);
+	auto& input = decoder.reader();
+	const auto flags = input.byte();
+	item.cached = flags & CachedFlag;
+	item.exhausted = flags & ExhaustedFlag;
+	item.steps = input.varint();
+	item.eta.reductions = input.varint();
+	item.eta.nodes_before = input.varint();
+	item.eta.nodes_after = input.varint();
+	item.trace = input.bytes(input.varint());
+	if (flags & FailedFlag) {
+		item.error = input.bytes(input.varint());
+	} else {
+		item.term = decode_closed(decoder);
+		item.type = decoder.type();
+	}
+}
+
+// Parses the input on the calling thread. Definitions are registered here,
+// in input order, so every later line sees them.
+void read_items(std::istream& input, Definitions& globals, const CancellationToken& cancellation, const std::function<void(BatchItem)>& emit) {
+	std::string line;
+	std::size_t line_number = 0;
+	std::size_t sequence = 0;
+	while (!cancellation.cancelled() && std::getline(input, line)) {
+		++line_number;
+		if (is_blank_or_comment(line)) continue;
+
+		BatchItem item;
+		item.line = line_number;
+		try {
+			if (try_define(line, globals)) continue;
+			item.term = parse_term(line, &globals);
+		} catch (const std::exception& error) {
+			item.error = error.what();
+		}
+		item.sequence = sequence++;
+		emit(std::move(item));
+	}
+}
+
+}
+
+BatchPipeline::BatchPipeline(BatchOptions options):
+	options(options)
+{
+	if (this->options.workers == 0) this->options.workers = 1;
+	if (!this->options.trace_path.empty()) this->trace = std::make_unique<TraceFile>(this->options.trace_path);
+	if (!this->options.cache_path.empty()) this->cache = std::make_unique<NormalFormCache>(this->options.cache_path, this->options.cache_max_bytes);
+}
+
+BatchStats BatchPipeline::run(std::istream& input, std::ostream& output) {
+	const auto start = std::chrono::steady_clock::now();
+	auto stats = this->options.processes != 0 ? this->run_processes(input, output) : this->run_threads(input, output);
+	stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return stats;
+}
+
+
+BatchStats BatchPipeline::run_threads(std::istream& input, std::ostream& output) {
+	const auto workers = this->options.workers;
+	BatchStats stats;
+
+	BatchQueue parsed(this->options.queue_capacity);
+	BatchQueue checked(this->options.queue_capacity);
+	BatchQueue normalized(this->options.queue_capacity);
+	std::atomic<std::size_t> live_checkers = workers;
+	std::atomic<std::size_t> live_normalizers = workers;
+	OrderedPrinter printer(output, stats, this->options.queue_capacity);
+
+	std::vector<std::jthread> threads;
+	threads.reserve(2 * workers + 1);
+	for (std::size_t i = 0; i < workers; ++i) {
+		threads.emplace_back(check_stage, std::ref(parsed), std::ref(checked), std::ref(live_checkers), std::cref(this->options));
+		threads.emplace_back(normalize_stage, std::ref(checked), std::ref(normalized), std::ref(live_normalizers), std::cref(this->options), std::cref(this->cancellation), this->trace.get(), this->cache.get());
+	}
+	threads.emplace_back(print_stage, std::ref(normalized), std::ref(output), std::ref(printer));
+
+	read_items(input, this->globals, this->cancellation, [&](BatchItem item) {
+		printer.admit(item.sequence);
+		parsed.push(std::move(item));
+	});
+	parsed.close();
+
+	threads.clear();
+	return stats;
+}
+
+// Each worker process type checks and normalizes whole terms. The parent
+// only parses, and prints results in input order as they come back.
+BatchStats BatchPipeline::run_processes(std::istream& input, std::ostream& output) {
+	BatchStats stats;
+	OrderedPrinter printer(output, stats, this->options.queue_capacity);
+	std::map<std::uint64_t, BatchItem> in_flight;
+
+	WorkerOptions worker_options;
+	worker_options.workers = this->options.processes;
+	worker_options.memory_limit = this->options.worker_memory;
+	// Each worker opens the cache itself, so that its locks are its own.
+	std::shared_ptr<NormalFormCache> worker_cache;
+	WorkerPool pool(worker_options, [this, worker_cache](std::string_view request) mutable {
+		if (!this->options.cache_path.empty() && !worker_cache) {
+			worker_cache = std::make_shared<NormalFormCache>(this->options.cache_path, this->options.cache_max_bytes);
+		}
+		auto policy = resource_policy(this->options, this->cancellation);
+		return serve_request(request, this->options, policy, worker_cache.get());
+	});
+
+	const auto finish = [&](WorkerResult result) {
+		auto node = in_flight.extract(result.id);
+		auto& item = node.mapped();
+		try {
+			read_response(item, result);
+		} catch (const std::exception& error) {
+			item.error = error.what();
+		}
+		if (!item.trace.empty()) this->trace->append(item.trace);
+		printer.add(std::move(item));
+	};
+
+	read_items(input, this->globals, this->cancellation, [&](BatchItem item) {
+		// Results arrive on this thread, so wait by collecting them.
+		while (!printer.admits(item.sequence)) pool.wait(finish);
+		if (item.error.empty()) {
+			auto request = encode_request(item);
+			if (request.size() <= pool.max_request()) {
+				const auto id = item.sequence;
+				item.term.reset();
+				in_flight.emplace(id, std::move(item));
+				return pool.submit(id, std::move(request), finish);
+			}
+			item.error = "term of " + std::to_string(request.size()) + " encoded bytes does not fit the worker ring";
+		}
+		printer.add(std::move(item));
+	});
+	pool.drain(finish);
+	output.flush();
+	stats.worker_restarts = pool.restarts();
+	return stats;
+}
@@ -0,0 +1,96 @@
+//
+// BatchPipeline.h
+//
+// Batch driver behind the `lambda` executable. Input is one term per line;
+// `def name = term` lines extend the global definitions seen by later lines,
+// and blank lines and lines starting with '#' are skipped.
+//
+// The stages run concurrently and are connected by bounded queues:
+//
+//   reader/parser (1) -> type checkers (N) -> normalizers (N) -> printer (1)
+//
+// The printer restores input order, so the output is the same for any
+// worker count.
+//
+// With `processes` set, checking and normalizing move into that many forked
+// worker processes instead (see WorkerPool.h). Terms travel in the binary
+// term format, and a worker that crashes or runs out of memory only fails
+// the term it was working on.
+//
+
+#ifndef BATCHPIPELINE_H
+#define BATCHPIPELINE_H
+
+#include "../models/Definitions.h"
+#include "../engines/BoundedEvaluation.h"
+#include "../engines/EtaConversion.h"
+#include "../engines/NormalFormCache.h"
+#include "../engines/ReductionTrace.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+struct BatchOptions {
+	std::size_t workers = 1;            // threads per parallel stage
+	std::size_t processes = 0;          // worker processes instead of threads, 0 for threads
+	std::size_t worker_memory = 0;      // address-space limit per worker process in bytes, 0 for none
+	std::size_t queue_capacity = 1024;  // items per queue, and finished items waiting on an earlier one
+	std::size_t max_steps = 0;          // per term, 0 for no limit
+	std::size_t max_nodes = 0;          // per term, 0 for no limit
+	std::size_t max_bytes = 0;          // per term, 0 for no limit
+	std::chrono::milliseconds timeout{0};  // per term, 0 for no limit
+	bool detect_cycles = false;         // report terms whose reduction repeats a state
+	bool show_types = false;            // print "nf : type" when well typed
+	bool strict = false;                // report ill-typed terms instead of normalizing them
+	bool trust_types = false;           // normalize well-typed terms without resource limits
+	bool eta = false;                   // print βη- rather than β-normal forms
+	std::string trace_path;             // append a reduction trace per term here, empty for none
+	std::string cache_path;             // persistent normal-form cache, empty for none
+	std::size_t cache_max_bytes = NormalFormCache::default_max_bytes;
+};
+
+struct BatchStats {
+	std::size_t terms = 0;
+	std::size_t failures = 0;
+	std::size_t exhausted = 0;          // failures that ran out of resources
+	std::size_t steps = 0;
+	std::size_t cache_hits = 0;         // terms answered from the normal-form cache
+	std::size_t worker_restarts = 0;    // worker processes replaced after dying
+	EtaStats eta;                       // summed over the terms, when eta is set
+	double seconds = 0;
+
+	[[nodiscard]] double terms_per_second() const { return this->seconds > 0 ? this->terms / this->seconds : 0; }
+	[[nodiscard]] double steps_per_second() const { return this->seconds > 0 ? this->steps / this->seconds : 0; }
+};
+
+class BatchPipeline {
+public:
+	explicit BatchPipeline(BatchOptions options);
+
+	// Processes every line of `input`. Definitions persist across calls, so
+	// several files can be run in sequence; the returned stats cover this
+	// call only.
+	BatchStats run(std::istream& input, std::ostream& output);
+
+	[[nodiscard]] const Definitions& definitions() const { return this->globals; }
+
+	// Stops reading input and interrupts terms still being normalized; they
+	// are reported as cancelled. Safe to call from any thread, including a
+	// signal-handling one.
+	void cancel() { this->cancellation.cancel(); }
+
+private:
+	BatchOptions options;
+	Definitions globals;
+	CancellationToken cancellation;
+	std::unique_ptr<TraceFile> trace;
+	std::unique_ptr<NormalFormCache> cache;
+
+	BatchStats run_threads(std::istream& input, std::ostream& output);
+	BatchStats run_processes(std::istream& input, std::ostream& output);
+};
+
+#endif //BATCHPIPELINE_H
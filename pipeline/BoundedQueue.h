@@ -0,0 +1,73 @@
+//
+// BoundedQueue.h
+//
+// Blocking multi-producer multi-consumer FIFO with a fixed capacity. Producers
+// block while it is full, which is what keeps a fast stage from running
+// arbitrarily far ahead of a slow one.
+//
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+template <typename T>
+class BoundedQueue {
+public:
+	explicit BoundedQueue(std::size_t capacity):
+		capacity(capacity == 0 ? 1 : capacity)
+	{}
+
+	BoundedQueue(const BoundedQueue&) = delete;
+	BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+	// Blocks while the queue is full. Returns false, dropping `item`, once
+	// the queue has been closed.
+	bool push(T item) {
+		std::unique_lock lock(this->mutex);
+		this->not_full.wait(lock, [this] { return this->closed || this->items.size() < this->capacity; });
+		if (this->closed) return false;
+		this->items.push_back(std::move(item));
+		lock.unlock();
+		this->not_empty.notify_one();
+		return true;
+	}
+
+	// Blocks while the queue is empty. Returns nullopt once it is closed and
+	// drained.
+	std::optional<T> pop() {
+		std::unique_lock lock(this->mutex);
+		this->not_empty.wait(lock, [this] { return this->closed || !this->items.empty(); });
+		if (this->items.empty()) return std::nullopt;
+		T item = std::move(this->items.front());
+		this->items.pop_front();
+		lock.unlock();
+		this->not_full.notify_one();
+		return item;
+	}
+
+	// Items already queued are still delivered by pop().
+	void close() {
+		{
+			std::lock_guard lock(this->mutex);
+			this->closed = true;
+		}
+		this->not_empty.notify_all();
+		this->not_full.notify_all();
+	}
+
+private:
+	const std::size_t capacity;
+	std::mutex mutex;
+	std::condition_variable not_empty;
+	std::condition_variable not_full;
+	std::deque<T> items;
+	bool closed = false;
+};
+
+#endif //BOUNDEDQUEUE_H
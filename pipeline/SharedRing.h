@@ -0,0 +1,142 @@
+//
+// SharedRing.h
+//
+// Single-producer single-consumer ring of tagged, length-prefixed frames,
+// placed in memory shared by two processes. Neither side ever blocks; a
+// full or empty ring is reported to the caller, which decides how to wait.
+// Positions only grow, so `head - tail` is always the number of bytes in
+// use, and a frame becomes visible to the consumer only once it is whole.
+//
+// A side about to sleep raises a flag and then looks at the ring once more;
+// the other side, after changing the ring, lowers the flag and sends a
+// wake-up only if it was raised. Both look after a full fence, so at least
+// one of them sees the other, and a busy peer costs no system calls.
+//
+
+#ifndef SHAREDRING_H
+#define SHAREDRING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+struct SharedFrame {
+	std::uint8_t tag = 0;
+	std::string bytes;
+};
+
+class SharedRing {
+public:
+	static constexpr std::size_t frame_overhead = 5;  // u32 length, u8 tag
+
+	// Bytes of shared memory a ring with `capacity` data bytes occupies.
+	[[nodiscard]] static constexpr std::size_t footprint(std::size_t capacity) { return sizeof(Header) + capacity; }
+
+	// `memory` must be zero-filled the first time a ring is placed on it.
+	// `capacity` must be a power of two.
+	SharedRing(void* memory, std::size_t capacity):
+		header(static_cast<Header*>(memory)),
+		data(static_cast<unsigned char*>(memory) + sizeof(Header)),
+		capacity(capacity)
+	{}
+
+	// Largest payload that can ever be pushed.
+	[[nodiscard]] std::size_t max_payload() const { return this->capacity - frame_overhead; }
+
+	// Frames pushed but not yet popped.
+	[[nodiscard]] std::uint64_t queued() const {
+		return this->header->frames_pushed.load(std::memory_order_acquire) - this->header->frames_popped.load(std::memory_order_acquire);
+	}
+
+	// Returns false if the ring has no room for the frame right now.
+	bool try_push(std::uint8_t tag, std::string_view payload) {
+		const auto head = this->header->head.load(std::memory_order_relaxed);
+		const auto tail = this->header->tail.load(std::memory_order_acquire);
+		if (this->capacity - (head - tail) < frame_overhead + payload.size()) return false;
+
+		unsigned char prefix[frame_overhead];
+		const auto length = static_cast<std::uint32_t>(payload.size());
+		for (int i = 0; i < 4; ++i) prefix[i] = static_cast<unsigned char>(length >> (8 * i));
+		prefix[4] = tag;
+		this->write(head, prefix, frame_overhead);
+		this->write(head + frame_overhead, payload.data(), payload.size());
+		this->header->head.store(head + frame_overhead + payload.size(), std::memory_order_release);
+		this->header->frames_pushed.fetch_add(1, std::memory_order_release);
+		return true;
+	}
+
+	// Returns nullopt if the ring is empty.
+	std::optional<SharedFrame> try_pop() {
+		const auto tail = this->header->tail.load(std::memory_order_relaxed);
+		const auto head = this->header->head.load(std::memory_order_acquire);
+		if (head == tail) return std::nullopt;
+
+		unsigned char prefix[frame_overhead];
+		this->read(tail, prefix, frame_overhead);
+		std::uint32_t length = 0;
+		for (int i = 0; i < 4; ++i) length |= static_cast<std::uint32_t>(prefix[i]) << (8 * i);
+		SharedFrame frame{prefix[4], std::string(length, '\0')};
+		this->read(tail + frame_overhead, frame.bytes.data(), length);
+		this->header->tail.store(tail + frame_overhead + length, std::memory_order_release);
+		this->header->frames_popped.fetch_add(1, std::memory_order_release);
+		return frame;
+	}
+
+	// Called by a consumer that found the ring empty, before it looks again
+	// and then sleeps.
+	void await_data() { raise(this->header->data_waiter); }
+	// Called by a producer that found the ring full, before it tries again
+	// and then sleeps.
+	void await_space() { raise(this->header->space_waiter); }
+	// Whether the consumer has to be woken after a push.
+	[[nodiscard]] bool take_data_waiter() { return take(this->header->data_waiter); }
+	// Whether the producer has to be woken after a pop.
+	[[nodiscard]] bool take_space_waiter() { return take(this->header->space_waiter); }
+
+private:
+	// Producer and consumer positions live on separate cache lines.
+	struct Header {
+		alignas(64) std::atomic<std::uint64_t> head;
+		std::atomic<std::uint64_t> frames_pushed;
+		alignas(64) std::atomic<std::uint64_t> tail;
+		std::atomic<std::uint64_t> frames_popped;
+		alignas(64) std::atomic<std::uint32_t> data_waiter;
+		std::atomic<std::uint32_t> space_waiter;
+	};
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "ring positions must be usable across processes");
+
+	Header* header;
+	unsigned char* data;
+	std::size_t capacity;
+
+	static void raise(std::atomic<std::uint32_t>& flag) {
+		flag.store(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+
+	static bool take(std::atomic<std::uint32_t>& flag) {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		return flag.load(std::memory_order_relaxed) != 0 && flag.exchange(0, std::memory_order_relaxed) != 0;
+	}
+
+	void write(std::uint64_t position, const void* source, std::size_t count) {
+		const auto offset = position & (this->capacity - 1);
+		const auto first = std::min(count, this->capacity - offset);
+		std::memcpy(this->data + offset, source, first);
+		std::memcpy(this->data, static_cast<const unsigned char*>(source) + first, count - first);
+	}
+
+	void read(std::uint64_t position, void* target, std::size_t count) const {
+		const auto offset = position & (this->capacity - 1);
+		const auto first = std::min(count, this->capacity - offset);
+		std::memcpy(target, this->data + offset, first);
+		std::memcpy(static_cast<unsigned char*>(target) + first, this->data, count - first);
+	}
+};
+
+#endif //SHAREDRING_H
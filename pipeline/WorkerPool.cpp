@@ -0,0 +1,283 @@
+//
+// WorkerPool.cpp
+//
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::uint8_t RequestFrame = 0;
+constexpr std::uint8_t AnswerFrame = 1;
+constexpr std::uint8_t FailureFrame = 2;
+
+std::runtime_error system_error(const std::string& what) {
+	return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Wake-ups carry no data, so a full socket buffer already holds one.
+void wake(int socket) {
+	const char byte = 0;
+	(void)::send(socket, &byte, 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+// Blocks for the next wake-up. Returns false once the other side is gone.
+bool await_wakeup(int socket) {
+	char buffer[64];
+	while (true) {
+		const auto received = ::recv(socket, buffer, sizeof buffer, 0);
+		if (received > 0) return true;
+		if (received == 0 || errno != EINTR) return false;
+	}
+}
+
+// Consumes pending wake-ups without blocking. Returns false once the other
+// side is gone.
+bool drain_wakeups(int socket) {
+	char buffer[256];
+	while (true) {
+		const auto received = ::recv(socket, buffer, sizeof buffer, MSG_DONTWAIT);
+		if (received > 0) continue;
+		if (received == 0) return false;
+		if (errno == EINTR) continue;
+		return errno == EAGAIN || errno == EWOULDBLOCK;
+	}
+}
+
+std::string describe_exit(int status) {
+	if (WIFSIGNALED(status)) {
+		const int signal = WTERMSIG(status);
+		return "worker killed by signal " + std::to_string(signal) + " (" + ::strsignal(signal) + ")";
+	}
+	if (WIFEXITED(status)) return "worker exited with status " + std::to_string(WEXITSTATUS(status));
+	return "worker stopped";
+}
+
+}
+
+WorkerPool::WorkerPool(WorkerOptions options, Handler handler):
+	options(options),
+	handler(std::move(handler)),
+	capacity(std::bit_ceil(std::max<std::size_t>(options.ring_bytes, 4096)))
+{
+	this->workers.resize(std::max<std::size_t>(options.workers, 1));
+	try {
+		for (auto& worker : this->workers) this->start(worker);
+	} catch (...) {
+		for (auto& worker : this->workers) this->stop(worker);
+		throw;
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	for (auto& worker : this->workers) this->stop(worker);
+}
+
+void WorkerPool::start(Worker& worker) {
+	const auto footprint = SharedRing::footprint(this->capacity);
+	void* memory = ::mmap(nullptr, 2 * footprint, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED) throw system_error("cannot map worker rings");
+	int sockets[2];
+	if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+		::munmap(memory, 2 * footprint);
+		throw system_error("cannot create worker socket");
+	}
+
+	worker.memory = memory;
+	worker.requests.emplace(memory, this->capacity);
+	worker.responses.emplace(static_cast<unsigned char*>(memory) + footprint, this->capacity);
+
+	const pid_t pid = ::fork();
+	if (pid < 0) {
+		::close(sockets[0]);
+		::close(sockets[1]);
+		this->stop(worker);
+		throw system_error("cannot fork worker");
+	}
+	if (pid == 0) {
+		// Drop everything that belongs to the other workers, so that each
+		// one sees the parent hang up as soon as the parent closes its end.
+		for (auto& other : this->workers) {
+			if (&other == &worker || other.socket < 0) continue;
+			::close(other.socket);
+			::munmap(other.memory, 2 * footprint);
+		}
+		::close(sockets[0]);
+		worker.socket = sockets[1];
+		if (this->options.memory_limit != 0) {
+			const rlimit limit{this->options.memory_limit, this->options.memory_limit};
+			::setrlimit(RLIMIT_AS, &limit);
+		}
+		this->serve(worker);
+	}
+	::close(sockets[1]);
+	worker.socket = sockets[0];
+	worker.pid = pid;
+}
+
+// Closes the parent's end, which makes an idle worker exit, and reaps it.
+// A worker that still has requests is killed rather than waited for.
+void WorkerPool::stop(Worker& worker) {
+	if (worker.pid > 0 && !worker.pending.empty()) ::kill(worker.pid, SIGKILL);
+	if (worker.socket >= 0) ::close(worker.socket);
+	if (worker.pid > 0) {
+		int status = 0;
+		while (::waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {}
+	}
+	worker.requests.reset();
+	worker.responses.reset();
+	if (worker.memory != nullptr) ::munmap(worker.memory, 2 * SharedRing::footprint(this->capacity));
+	worker.pid = -1;
+	worker.socket = -1;
+	worker.memory = nullptr;
+	worker.pending.clear();
+}
+
+void WorkerPool::serve(Worker& worker) {
+	auto& requests = *worker.requests;
+	auto& responses = *worker.responses;
+	while (true) {
+		auto request = requests.try_pop();
+		if (!request) {
+			requests.await_data();
+			request = requests.try_pop();
+		}
+		if (!request) {
+			if (!await_wakeup(worker.socket)) ::_exit(0);
+			continue;
+		}
+		if (requests.take_space_waiter()) wake(worker.socket);
+
+		std::uint8_t tag = AnswerFrame;
+		std::string response;
+		try {
+			response = this->handler(request->bytes);
+		} catch (const std::exception& error) {
+			tag = FailureFrame;
+			response = error.what();
+		}
+		if (response.size() > responses.max_payload()) {
+			tag = FailureFrame;
+			response = "response of " + std::to_string(response.size()) + " bytes does not fit the worker ring";
+		}
+		while (!responses.try_push(tag, response)) {
+			responses.await_space();
+			if (responses.try_push(tag, response)) break;
+			if (!await_wakeup(worker.socket)) ::_exit(0);
+		}
+		if (responses.take_data_waiter()) wake(worker.socket);
+	}
+}
+
+void WorkerPool::submit(std::uint64_t id, std::string request, const Sink& sink) {
+	if (request.size() > this->max_request()) {
+		throw std::length_error("request of " + std::to_string(request.size()) + " bytes does not fit the worker ring");
+	}
+
+	std::vector<Worker*> order;
+	order.reserve(this->workers.size());
+	for (auto& worker : this->workers) order.push_back(&worker);
+	const auto push = [&] {
+		std::ranges::stable_sort(order, {}, [](const Worker* worker) { return worker->pending.size(); });
+		for (auto* worker : order) {
+			if (!worker->requests->try_push(RequestFrame, request)) continue;
+			if (worker->requests->take_data_waiter()) wake(worker->socket);
+			worker->pending.push_back({id, std::move(request)});
+			return true;
+		}
+		return false;
+	};
+	while (!push()) {
+		for (auto* worker : order) worker->requests->await_space();
+		if (push()) return;
+		this->wait(sink);
+	}
+}
+
+void WorkerPool::drain(const Sink& sink) {
+	while (this->in_flight() != 0) this->wait(sink);
+}
+
+std::size_t WorkerPool::in_flight() const {
+	std::size_t count = 0;
+	for (const auto& worker : this->workers) count += worker.pending.size();
+	return count;
+}
+
+std::vector<pid_t> WorkerPool::pids() const {
+	std::vector<pid_t> pids;
+	for (const auto& worker : this->workers) pids.push_back(worker.pid);
+	return pids;
+}
+
+void WorkerPool::wait(const Sink& sink) {
+	bool answered = false;
+	for (auto& worker : this->workers) {
+		worker.responses->await_data();
+		answered = answered || worker.responses->queued() != 0;
+	}
+	std::vector<pollfd> sockets;
+	for (const auto& worker : this->workers) sockets.push_back({worker.socket, POLLIN, 0});
+	if (!answered && ::poll(sockets.data(), sockets.size(), -1) < 0) {
+		if (errno == EINTR) return;
+		throw system_error("cannot wait for workers");
+	}
+
+	for (std::size_t i = 0; i < sockets.size(); ++i) {
+		auto& worker = this->workers[i];
+		const bool alive = sockets[i].revents == 0 || drain_wakeups(worker.socket);
+		this->collect(worker, sink);
+		if (alive) continue;
+		int status = 0;
+		while (::waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {}
+		worker.pid = -1;
+		this->restart(worker, describe_exit(status), sink);
+	}
+}
+
+void WorkerPool::collect(Worker& worker, const Sink& sink) {
+	bool freed = false;
+	while (auto frame = worker.responses->try_pop()) {
+		freed = true;
+		WorkerResult result{worker.pending.front().id};
+		worker.pending.pop_front();
+		if (frame->tag == AnswerFrame) {
+			result.response = std::move(frame->bytes);
+		} else {
+			result.failure = std::move(frame->bytes);
+		}
+		sink(std::move(result));
+	}
+	if (freed && worker.responses->take_space_waiter()) wake(worker.socket);
+}
+
+// Answers have been collected, so what is still pending is the request the
+// worker died on, if it had taken one, and the ones queued behind it.
+void WorkerPool::restart(Worker& worker, const std::string& reason, const Sink& sink) {
+	auto pending = std::move(worker.pending);
+	worker.pending.clear();
+	if (pending.size() > worker.requests->queued()) {
+		sink({pending.front().id, {}, reason});
+		pending.pop_front();
+	}
+	this->stop(worker);
+	++this->restart_count;
+	this->start(worker);
+	for (auto& request : pending) {
+		(void)worker.requests->try_push(RequestFrame, request.request);
+		worker.pending.push_back(std::move(request));
+	}
+	if (worker.requests->take_data_waiter()) wake(worker.socket);
+}
@@ -0,0 +1,98 @@
+//
+// WorkerPool.h
+//
+// Pool of forked worker processes. Each worker owns a pair of SharedRings,
+// one for requests and one for responses, and a socket pair that only
+// carries wake-ups; the frames themselves never pass through the kernel.
+// Workers answer their requests in order. A worker that dies is reaped and
+// replaced, the request it was handling is reported as failed, and the
+// requests queued behind it are resent to its replacement.
+//
+// The pool must be created while the calling process has no other threads,
+// since only the forking thread survives in the children.
+//
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include "SharedRing.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <vector>
+
+struct WorkerOptions {
+	std::size_t workers = 1;
+	std::size_t ring_bytes = std::size_t(1) << 22;  // per direction, rounded up to a power of two
+	std::size_t memory_limit = 0;  // address-space limit per worker in bytes, 0 for none
+};
+
+struct WorkerResult {
+	std::uint64_t id = 0;
+	std::string response;
+	// Why no response came back: the handler threw, or the worker died while
+	// handling the request. Empty on success.
+	std::string failure;
+};
+
+class WorkerPool {
+public:
+	// Runs in the workers. Exceptions it throws are reported as failures.
+	using Handler = std::function<std::string(std::string_view request)>;
+	using Sink = std::function<void(WorkerResult)>;
+
+	WorkerPool(WorkerOptions options, Handler handler);
+	~WorkerPool();
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// Queues a request on the least busy worker. Blocks while every ring is
+	// full, passing results that arrive meanwhile to `sink`. Throws
+	// std::length_error if the request can never fit a ring.
+	void submit(std::uint64_t id, std::string request, const Sink& sink);
+	// Blocks until every submitted request has been answered.
+	void drain(const Sink& sink);
+	// Blocks until some results arrive, or a worker dies, and passes them to
+	// `sink`. Only call it with requests in flight.
+	void wait(const Sink& sink);
+
+	[[nodiscard]] std::size_t max_request() const { return this->capacity - SharedRing::frame_overhead; }
+	[[nodiscard]] std::size_t in_flight() const;
+	[[nodiscard]] std::size_t restarts() const { return this->restart_count; }
+	[[nodiscard]] std::vector<pid_t> pids() const;
+
+private:
+	struct Pending {
+		std::uint64_t id;
+		std::string request;
+	};
+
+	struct Worker {
+		pid_t pid = -1;
+		int socket = -1;        // parent end of the wake-up socket pair
+		void* memory = nullptr;
+		std::optional<SharedRing> requests;
+		std::optional<SharedRing> responses;
+		std::deque<Pending> pending;  // submitted and not answered, oldest first
+	};
+
+	WorkerOptions options;
+	Handler handler;
+	std::size_t capacity;
+	std::vector<Worker> workers;
+	std::size_t restart_count = 0;
+
+	void start(Worker& worker);
+	void stop(Worker& worker);
+	[[noreturn]] void serve(Worker& worker);
+	void collect(Worker& worker, const Sink& sink);
+	void restart(Worker& worker, const std::string& reason, const Sink& sink);
+};
+
+#endif //WORKERPOOL_H
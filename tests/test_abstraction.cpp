@@ -329,4 +329,53 @@ TEST_F(AbstractionTest, Clone_PreservesTypes) {
     Variable* cloned_body = dynamic_cast<Variable*>(cloned_abs->body.get());
     ASSERT_NE(cloned_body, nullptr);
     EXPECT_EQ(cloned_body->get_type().to_string(), "String");
-}
\ No newline at end of file
+}
+
+TEST_F(AbstractionTest, Substitute_AvoidsCapture) {
+    // (λx. y)[y := x]  ->  λx'. x
+    Abstraction abs(std::make_unique<Variable>("x"), std::make_unique<Variable>("y"));
+    Variable replacement("x");
+    auto result = abs.substitute("y", replacement);
+    EXPECT_EQ(result->to_string(), "λx'. x");
+}
+
+TEST_F(AbstractionTest, SubstituteInPlace_ReusesBinderNode) {
+    std::unique_ptr<Term> abs = std::make_unique<Abstraction>(
+        std::make_unique<Variable>("x"),
+        std::make_unique<Application>(std::make_unique<Variable>("x"), std::make_unique<Variable>("y"))
+    );
+    Term* original = abs.get();
+    Variable replacement("z");
+    auto result = substitute(std::move(abs), "y", replacement);
+    EXPECT_EQ(result.get(), original);
+    EXPECT_EQ(result->to_string(), "λx. (x) (z)");
+}
+
+TEST_F(AbstractionTest, SubstituteInPlace_AvoidsCapture) {
+    std::unique_ptr<Term> abs = std::make_unique<Abstraction>(
+        std::make_unique<Variable>("x"),
+        std::make_unique<Variable>("y")
+    );
+    Variable replacement("x");
+    auto result = substitute(std::move(abs), "y", replacement);
+    EXPECT_EQ(result->to_string(), "λx'. x");
+}
+
+TEST_F(AbstractionTest, BetaReduceInPlace_WithReducibleBody) {
+    std::unique_ptr<Term> abs = std::make_unique<Abstraction>(
+        std::make_unique<Variable>("x"),
+        std::make_unique<Application>(
+            std::make_unique<Abstraction>(std::make_unique<Variable>("y"), std::make_unique<Variable>("y")),
+            std::make_unique<Variable>("z")
+        )
+    );
+    Term* original = abs.get();
+    auto result = beta_reduce(std::move(abs));
+    EXPECT_EQ(result.get(), original);
+    EXPECT_EQ(result->to_string(), "λx. z");
+}
+
+TEST_F(AbstractionTest, BetaReduceInPlace_NormalForm) {
+    std::unique_ptr<Term> abs = std::move(identity_abs);
+    EXPECT_THROW((void)beta_reduce(std::move(abs)), ReductionOnNormalForm);
+}
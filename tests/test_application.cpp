@@ -266,4 +266,57 @@ TEST_F(ApplicationTest, Clone_PreservesTypes) {
     ASSERT_NE(val, nullptr);
     EXPECT_EQ(func->get_type().to_string(), "String");
     EXPECT_EQ(val->get_type().to_string(), "Int");
-}
\ No newline at end of file
+}
+
+TEST_F(ApplicationTest, BetaReduceInPlace_WithAbstraction) {
+    std::unique_ptr<Term> app = std::move(app_with_abstraction);
+    auto result = beta_reduce(std::move(app));
+    Variable* result_var = dynamic_cast<Variable*>(result.get());
+    ASSERT_NE(result_var, nullptr);
+    EXPECT_EQ(result_var->name, "y");
+}
+
+TEST_F(ApplicationTest, BetaReduceInPlace_KeepsUntouchedSibling) {
+    auto nested_app = std::make_unique<Application>(
+        std::make_unique<Application>(
+            std::make_unique<Abstraction>(std::make_unique<Variable>("x"), std::make_unique<Variable>("x")),
+            std::make_unique<Variable>("f")
+        ),
+        std::make_unique<Variable>("y")
+    );
+    Term* untouched = nested_app->value.get();
+    Term* original = nested_app.get();
+
+    auto result = beta_reduce(std::move(nested_app));
+    Application* result_app = dynamic_cast<Application*>(result.get());
+    ASSERT_NE(result_app, nullptr);
+    EXPECT_EQ(result_app, original);
+    EXPECT_EQ(result_app->value.get(), untouched);
+    EXPECT_EQ(result->to_string(), "(f) (y)");
+}
+
+TEST_F(ApplicationTest, BetaReduceInPlace_MatchesConstReduction) {
+    // (λf. λx. f (f x)) g  reduced step by step both ways
+    auto term = std::make_unique<Application>(
+        std::make_unique<Abstraction>(std::make_unique<Variable>("f"),
+            std::make_unique<Abstraction>(std::make_unique<Variable>("x"),
+                std::make_unique<Application>(
+                    std::make_unique<Variable>("f"),
+                    std::make_unique<Application>(std::make_unique<Variable>("f"), std::make_unique<Variable>("x"))
+                ))),
+        std::make_unique<Abstraction>(std::make_unique<Variable>("y"), std::make_unique<Variable>("y"))
+    );
+    std::unique_ptr<Term> by_copy = term->clone();
+    std::unique_ptr<Term> by_move = std::move(term);
+    while (!by_copy->is_normal()) {
+        by_copy = by_copy->beta_reduce();
+        by_move = beta_reduce(std::move(by_move));
+        EXPECT_EQ(by_move->to_string(), by_copy->to_string());
+    }
+    EXPECT_TRUE(by_move->is_normal());
+}
+
+TEST_F(ApplicationTest, BetaReduceInPlace_NormalForm) {
+    std::unique_ptr<Term> app = std::move(simple_app);
+    EXPECT_THROW((void)beta_reduce(std::move(app)), ReductionOnNormalForm);
+}
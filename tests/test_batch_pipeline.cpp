@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "../pipeline/BatchPipeline.h"
+#include "../pipeline/BoundedQueue.h"
+#include "../parser/Parser.h"
+
+#include <atomic>
+#include <chrono>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Hands out one line per underflow and counts the lines read so far.
+class LineSource : public std::streambuf {
+public:
+    explicit LineSource(std::vector<std::string> lines): lines(std::move(lines)) {}
+
+    std::atomic<std::size_t> served = 0;
+
+protected:
+    int_type underflow() override {
+        const auto next = served.load();
+        if (next == lines.size()) return traits_type::eof();
+        auto& line = lines[next];
+        setg(line.data(), line.data(), line.data() + line.size());
+        served = next + 1;
+        return traits_type::to_int_type(line[0]);
+    }
+
+private:
+    std::vector<std::string> lines;
+};
+
+std::string run_batch(const std::string& input, BatchOptions options, BatchStats* stats = nullptr) {
+    std::istringstream in(input);
+    std::ostringstream out;
+    BatchPipeline pipeline(options);
+    const auto result = pipeline.run(in, out);
+    if (stats != nullptr) *stats = result;
+    return out.str();
+}
+
+}
+
+TEST(BoundedQueueTest, DeliversInOrderAndDrainsAfterClose) {
+    BoundedQueue<int> queue(2);
+    std::jthread producer([&queue] {
+        for (int i = 0; i < 100; ++i) queue.push(i);
+        queue.close();
+    });
+    int expected = 0;
+    while (auto value = queue.pop()) EXPECT_EQ(*value, expected++);
+    EXPECT_EQ(expected, 100);
+    EXPECT_FALSE(queue.push(1));
+}
+
+TEST(BatchPipelineTest, NormalizesEachLine) {
+    BatchStats stats;
+    const auto output = run_batch(
+        "# comment\n"
+        "(λx. x) (y)\n"
+        "\n"
+        "add 2 3\n", BatchOptions{}, &stats);
+    EXPECT_EQ(output, "y\n5\n");
+    EXPECT_EQ(stats.terms, 2u);
+    EXPECT_EQ(stats.failures, 0u);
+    EXPECT_EQ(stats.steps, 2u);
+}
+
+TEST(BatchPipelineTest, OutputOrderIndependentOfWorkers) {
+    std::string input;
+    std::string expected;
+    for (int i = 0; i < 200; ++i) {
+        // Alternate cheap and expensive lines so workers finish out of order.
+        if (i % 2 == 0) {
+            input += "add " + std::to_string(i) + " 1\n";
+            expected += std::to_string(i + 1) + "\n";
+        } else {
+            input += "(λf. λx. f (f (f x))) (λf. λx. f (f (f x))) g z\n";
+            expected += "(g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) ((g) (z)))))))))))))))))))))))))))\n";
+        }
+    }
+    BatchOptions options;
+    options.workers = 4;
+    options.queue_capacity = 3;
+    EXPECT_EQ(run_batch(input, options), expected);
+}
+
+TEST(BatchPipelineTest, DefinitionsApplyToLaterLines) {
+    BatchOptions options;
+    options.show_types = true;
+    const auto output = run_batch(
+        "def double = λn:Nat. add n n\n"
+        "double 21\n", options);
+    EXPECT_EQ(output, "42 : Nat\n");
+}
+
+TEST(BatchPipelineTest, DefIsOnlyADefinitionWithNameAndEquals) {
+    // Anything else that starts with def is an ordinary term.
+    const auto output = run_batch(
+        "def x\n"
+        "def ((λy. y) 1)\n", BatchOptions());
+    EXPECT_EQ(output, parse_term("def x")->to_string() + "\n" + parse_term("def 1")->to_string() + "\n");
+}
+
+TEST(BatchPipelineTest, ReaderStallsBehindASlowItem) {
+    // Ω runs until its deadline; the trivial lines behind it must not all be
+    // read and held for printing meanwhile.
+    std::vector<std::string> lines{"(λx. x x) (λx. x x)\n"};
+    for (int i = 0; i < 200; ++i) lines.emplace_back(std::to_string(i) + "\n");
+    LineSource source(lines);
+    std::istream in(&source);
+    std::ostringstream out;
+    BatchOptions options;
+    options.workers = 2;
+    options.queue_capacity = 4;
+    options.timeout = std::chrono::milliseconds(300);
+    BatchPipeline pipeline(options);
+    std::thread run([&] { (void)pipeline.run(in, out); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    // The window, plus the line the reader is blocked on.
+    EXPECT_LE(source.served.load(), options.queue_capacity + 1);
+    run.join();
+
+    EXPECT_EQ(source.served.load(), lines.size());
+    const auto output = out.str();
+    EXPECT_TRUE(output.starts_with("error: line 1:")) << output;
+    EXPECT_TRUE(output.ends_with("198\n199\n"));
+}
+
+TEST(BatchPipelineTest, ReportsErrorsInPlace) {
+    BatchOptions options;
+    options.max_steps = 100;
+    BatchStats stats;
+    const auto output = run_batch(
+        "λx. (x\n"
+        "(λx. x x) (λx. x x)\n"
+        "1\n", options, &stats);
+    std::istringstream lines(output);
+    std::string line;
+    std::getline(lines, line);
+    EXPECT_TRUE(line.starts_with("error: line 1: Parse error"));
+    std::getline(lines, line);
+    EXPECT_EQ(line, "error: line 2: step limit of 100 exceeded");
+    std::getline(lines, line);
+    EXPECT_EQ(line, "1");
+    EXPECT_EQ(stats.failures, 2u);
+}
+
+TEST(BatchPipelineTest, StrictModeRejectsIllTypedTerms) {
+    BatchOptions options;
+    options.strict = true;
+    const auto output = run_batch("add true 1\n", options);
+    EXPECT_TRUE(output.starts_with("error: line 1: "));
+    options.strict = false;
+    EXPECT_EQ(run_batch("add true 1\n", options), "((add) (true)) (1)\n");
+}
+
+TEST(BatchPipelineTest, TrustTypesBypassesLimitsForTypedTerms) {
+    BatchOptions options;
+    options.max_steps = 1;
+    options.trust_types = true;
+    BatchStats stats;
+    const auto output = run_batch(
+        "(λx:Nat. add x x) (mul 3 7)\n"
+        "(λx. x x) (λx. x x)\n", options, &stats);
+    EXPECT_EQ(output, "42\nerror: line 2: step limit of 1 exceeded\n");
+    EXPECT_EQ(stats.exhausted, 1u);
+}
+
+TEST(BatchPipelineTest, WorkerProcessesMatchThreads) {
+    const std::string input =
+        "def double = λn:Nat. add n n\n"
+        "def quadruple = λn:Nat. double (double n)\n"
+        "quadruple 5\n"
+        "λx. (x\n"
+        "(λx. x x) (λx. x x)\n"
+        "(λf:Nat->Nat. f) (λy:Nat. y)\n"
+        "add true 1\n";
+    BatchOptions options;
+    options.max_steps = 100;
+    options.show_types = true;
+    // Small enough that the reader has to wait on results.
+    options.queue_capacity = 2;
+    BatchStats threads;
+    const auto expected = run_batch(input, options, &threads);
+    options.processes = 3;
+    BatchStats processes;
+    EXPECT_EQ(run_batch(input, options, &processes), expected);
+    EXPECT_EQ(processes.failures, threads.failures);
+    EXPECT_EQ(processes.steps, threads.steps);
+    EXPECT_EQ(processes.worker_restarts, 0u);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TermGenerator.h"
+#include "../parser/Lexer.h"
+#include "../parser/BlockLexer.h"
+
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    std::vector<ScanBackend> supported_backends() {
+        std::vector<ScanBackend> backends;
+        for (const auto backend : {ScanBackend::Scalar, ScanBackend::SSE2, ScanBackend::AVX2}) {
+            if (scan_backend_supported(backend)) backends.push_back(backend);
+        }
+        return backends;
+    }
+
+    // Tokens, or the ParseError position.
+    struct LexResult {
+        std::vector<Token> tokens;
+        std::optional<std::size_t> error;
+    };
+
+    template <typename Lex>
+    LexResult lex(Lex&& lexer) {
+        try {
+            return {lexer(), std::nullopt};
+        } catch (const ParseError& error) {
+            return {{}, error.position};
+        }
+    }
+
+    void expect_same_as_scalar(const std::string& source) {
+        const auto expected = lex([&] { return tokenize(source); });
+        for (const auto backend : supported_backends()) {
+            const auto actual = lex([&] { return tokenize_blocks(source, backend); });
+            ASSERT_EQ(actual.error, expected.error) << scan_backend_name(backend) << ": " << source;
+            ASSERT_EQ(actual.tokens.size(), expected.tokens.size()) << scan_backend_name(backend) << ": " << source;
+            for (std::size_t i = 0; i < expected.tokens.size(); ++i) {
+                EXPECT_EQ(actual.tokens[i].kind, expected.tokens[i].kind) << scan_backend_name(backend) << " token " << i;
+                EXPECT_EQ(actual.tokens[i].offset, expected.tokens[i].offset) << scan_backend_name(backend) << " token " << i;
+                EXPECT_EQ(actual.tokens[i].length, expected.tokens[i].length) << scan_backend_name(backend) << " token " << i;
+            }
+        }
+    }
+}
+
+TEST(BlockLexerTest, ScalarBackendIsAlwaysAvailable) {
+    EXPECT_TRUE(scan_backend_supported(ScanBackend::Scalar));
+    EXPECT_TRUE(scan_backend_supported(fastest_scan_backend()));
+}
+
+TEST(BlockLexerTest, MatchesTokenizeOnSmallInputs) {
+    for (const std::string source : {
+        "", " ", "x", "λ", "\\x. x", "λx:Nat -> Bool. (f) (x')", "12 3x x3 007 τ λτ. τ",
+        "let id = λx. x in (id) (y)", "if[Nat -> Nat] true", "a.b(c)[d]:e=f", "λλx", "ττ λ"}) {
+        expect_same_as_scalar(source);
+    }
+}
+
+TEST(BlockLexerTest, MatchesTokenizeAcrossBlockBoundaries) {
+    // Slide two-byte tokens and words over the 64-byte boundary.
+    for (std::size_t pad = 56; pad < 72; ++pad) {
+        const std::string spaces(pad, ' ');
+        for (const std::string tail : {"λx. x", "A -> B", "abcdefgh ijk", "123456 7", "ab.cd", "\xCE\xCE\xBB"}) {
+            expect_same_as_scalar(spaces + tail);
+            expect_same_as_scalar(std::string(pad, 'w') + tail);
+        }
+    }
+}
+
+TEST(BlockLexerTest, MatchesTokenizeOnGeneratedTerms) {
+    for (std::uint64_t seed = 0; seed < 10; ++seed) {
+        const auto term = TermGenerator(GeneratorOptions{.seed = seed, .size = 2'000}).generate();
+        expect_same_as_scalar(term->to_string());
+    }
+}
+
+TEST(BlockLexerTest, ReportsTheSameErrorOffset) {
+    for (const std::string& source : std::vector<std::string>{"x ; y", "a - b", std::string(100, 'x') + ">", std::string(63, ' ') + "-", "\xCE"}) {
+        expect_same_as_scalar(source);
+    }
+}
+
+TEST(BlockLexerTest, MatchesTokenizeOnRandomBytes) {
+    const std::string alphabet = " \t\n.()[]:=\\->_'azAZ09\xCE\xBB\xCF\x84;#";
+    std::mt19937_64 random(7);
+    for (int round = 0; round < 300; ++round) {
+        std::string source(random() % 200, ' ');
+        for (auto& c : source) c = alphabet[random() % alphabet.size()];
+        // Keep most inputs lexable so the token paths are exercised too.
+        if (round % 2 == 0) std::erase_if(source, [](char c) { return c == ';' || c == '#'; });
+        expect_same_as_scalar(source);
+    }
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../parser/Parser.h"
+#include "../engines/BoundedEvaluation.h"
+
+#include <thread>
+
+class BoundedEvaluationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        omega = parse_term("(λx. x x) (λx. x x)");
+        // Each step adds another copy of the argument.
+        growing = parse_term("(λx. x x x) (λx. x x x)");
+    }
+
+    std::unique_ptr<Term> omega;
+    std::unique_ptr<Term> growing;
+};
+
+TEST_F(BoundedEvaluationTest, MeasureCountsNodes) {
+    const auto size = omega->measure();
+    EXPECT_EQ(size.nodes, 9u);
+    // Single-letter names fit the small-string buffer.
+    EXPECT_EQ(size.bytes, 3 * sizeof(Application) + 2 * sizeof(Abstraction) + 4 * sizeof(Variable));
+}
+
+TEST_F(BoundedEvaluationTest, ReachesNormalForm) {
+    const auto result = evaluate(parse_term("(λx. x) (add 1 2)"), ResourcePolicy{.max_steps = 10});
+    EXPECT_EQ(result.status, EvaluationStatus::Normal);
+    EXPECT_FALSE(result.exhausted());
+    EXPECT_EQ(result.term->to_string(), "3");
+    EXPECT_EQ(result.steps, 2u);
+}
+
+TEST_F(BoundedEvaluationTest, StepLimitStopsOmega) {
+    const ResourcePolicy policy{.max_steps = 50};
+    const auto result = evaluate(std::move(omega), policy);
+    EXPECT_EQ(result.status, EvaluationStatus::Steps);
+    EXPECT_EQ(result.steps, 50u);
+    EXPECT_EQ(result.term->to_string(), "(λx. (x) (x)) (λx. (x) (x))");
+    EXPECT_EQ(describe_exhaustion(result, policy), "step limit of 50 exceeded");
+}
+
+TEST_F(BoundedEvaluationTest, NodeLimitStopsGrowth) {
+    const auto result = evaluate(std::move(growing), ResourcePolicy{.max_nodes = 100});
+    EXPECT_EQ(result.status, EvaluationStatus::Nodes);
+    EXPECT_GT(result.peak.nodes, 100u);
+    EXPECT_GT(result.steps, 0u);
+}
+
+TEST_F(BoundedEvaluationTest, ByteLimitStopsGrowth) {
+    const auto result = evaluate(std::move(growing), ResourcePolicy{.max_bytes = 4096});
+    EXPECT_EQ(result.status, EvaluationStatus::Bytes);
+    EXPECT_GT(result.peak.bytes, 4096u);
+}
+
+TEST_F(BoundedEvaluationTest, DeadlineStopsOmega) {
+    const ResourcePolicy policy{.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20)};
+    const auto result = evaluate(std::move(omega), policy);
+    EXPECT_EQ(result.status, EvaluationStatus::Deadline);
+    EXPECT_GT(result.steps, 0u);
+}
+
+TEST_F(BoundedEvaluationTest, CancellationFromAnotherThread) {
+    CancellationToken token;
+    std::jthread canceller([&token] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        token.cancel();
+    });
+    const auto result = evaluate(std::move(omega), ResourcePolicy{.cancellation = &token});
+    EXPECT_EQ(result.status, EvaluationStatus::Cancelled);
+    EXPECT_TRUE(token.cancelled());
+}
+
+TEST_F(BoundedEvaluationTest, TypeDirectedSkipsGuardsForTypedTerms) {
+    // The step limit would stop the guarded evaluator; typed terms ignore it.
+    const ResourcePolicy policy{.max_steps = 1};
+    const auto result = evaluate_type_directed(parse_term("(λx:Nat. add x x) (mul 3 7)"), policy);
+    EXPECT_EQ(result.status, EvaluationStatus::Normal);
+    EXPECT_TRUE(result.unguarded);
+    EXPECT_EQ(result.term->to_string(), "42");
+    // Call by name: β, then both copies of the argument, then the add.
+    EXPECT_EQ(result.steps, 4u);
+}
+
+TEST_F(BoundedEvaluationTest, TypeDirectedGuardsUntypedTerms) {
+    const auto result = evaluate_type_directed(std::move(omega), ResourcePolicy{.max_steps = 10});
+    EXPECT_EQ(result.status, EvaluationStatus::Steps);
+    EXPECT_FALSE(result.unguarded);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../parser/Parser.h"
+#include "../engines/Combinators.h"
+
+namespace {
+
+std::string compiled(const std::string& source) {
+    return CombinatorGraph(*parse_term(source)).to_string();
+}
+
+std::string normalized(const std::string& source, const Definitions* definitions = nullptr) {
+    CombinatorGraph graph(*parse_term(source, definitions));
+    graph.normalize();
+    return graph.to_string();
+}
+
+}
+
+TEST(CombinatorCompileTest, BasicAbstractions) {
+    EXPECT_EQ(compiled("λx. x"), "I");
+    EXPECT_EQ(compiled("λx. y"), "K y");
+    EXPECT_EQ(compiled("λx. f x"), "f");
+    EXPECT_EQ(compiled("λx. λy. x"), "K");
+}
+
+TEST(CombinatorCompileTest, TurnerOptimizations) {
+    EXPECT_EQ(compiled("λx. f (g x)"), "B f g");
+    EXPECT_EQ(compiled("λx. f x y"), "C f y");
+    EXPECT_EQ(compiled("λx. x x"), "S I I");
+    EXPECT_EQ(compiled("λx. c (f x) (g x)"), "S' c f g");
+    EXPECT_EQ(compiled("λx. c (f (g x))"), "B* c f g");
+    EXPECT_EQ(compiled("λx. c (f x) y"), "C' c f y");
+}
+
+TEST(CombinatorReduceTest, ChurchArithmetic) {
+    const std::string two = "(λf. λx. f (f x))";
+    const std::string three = "(λf. λx. f (f (f x)))";
+    EXPECT_EQ(normalized("(λm. λn. λf. m (n f)) " + two + " " + three + " g z"), "g (g (g (g (g (g z)))))");
+    EXPECT_EQ(normalized("(λm. λn. λf. λx. m f (n f x)) " + two + " " + three + " g z"), "g (g (g (g (g z))))");
+}
+
+TEST(CombinatorReduceTest, AgreesWithBetaReduction) {
+    for (const std::string source : {
+        "(λx. λy. y x) a b",
+        "(λf. λx. f (f x)) (λy. h y y) z",
+        "let k = λa. λb. a in k u v",
+        "(λx. λx. x) a b",
+    }) {
+        auto term = parse_term(source);
+        while (!term->is_normal()) term = beta_reduce(std::move(term));
+        CombinatorGraph graph(*parse_term(source));
+        graph.normalize();
+        EXPECT_EQ(graph.read_back()->to_string(), term->to_string()) << source;
+    }
+}
+
+TEST(CombinatorReduceTest, SharesArguments) {
+    // The argument is reduced once although S duplicates it.
+    CombinatorGraph graph(*parse_term("(λx. add x x) (mul 6 7)"));
+    graph.normalize();
+    EXPECT_EQ(graph.to_string(), "84");
+    EXPECT_EQ(graph.stats().delta_steps, 2u);
+}
+
+TEST(CombinatorReduceTest, PrimitivesAndDefinitions) {
+    Definitions definitions;
+    definitions.define("double", parse_term("λn:Nat. add n n"));
+    EXPECT_EQ(normalized("if (lt 2 3) (double 20) 0", &definitions), "40");
+    EXPECT_EQ(normalized("add y 1"), "add y 1");
+}
+
+TEST(CombinatorReduceTest, WeakHeadOnly) {
+    CombinatorGraph graph(*parse_term("(λx. x) (f ((λy. y) z))"));
+    graph.weak_head_normalize();
+    EXPECT_EQ(graph.to_string(), "f (I z)");
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TermGenerator.h"
+#include "../parser/Parser.h"
+#include "../engines/Conversion.h"
+#include "../engines/ExplicitSubstitution.h"
+#include "../engines/EtaConversion.h"
+
+namespace {
+    bool convertible(const char* lhs, const char* rhs, ConversionStats& stats, const Definitions* definitions = nullptr) {
+        return ::convertible(*parse_term(lhs, definitions), *parse_term(rhs, definitions), stats);
+    }
+
+    bool convertible(const char* lhs, const char* rhs) {
+        ConversionStats stats;
+        return convertible(lhs, rhs, stats);
+    }
+
+    constexpr auto omega = "(λx. x x) (λx. x x)";
+}
+
+TEST(ConversionTest, AlphaEquivalentTermsNeedNoReduction) {
+    ConversionStats stats;
+    EXPECT_TRUE(convertible("λx. λy. x (y z)", "λa. λb. a (b z)", stats));
+    EXPECT_TRUE(stats.syntactic);
+    EXPECT_EQ(stats.comparisons, 0u);
+    // Even when the shared part has no normal form.
+    EXPECT_TRUE(convertible(omega, omega));
+}
+
+TEST(ConversionTest, BetaDeltaAndEta) {
+    EXPECT_TRUE(convertible("(λx. x) y", "y"));
+    EXPECT_TRUE(convertible("add 1 2", "3"));
+    EXPECT_TRUE(convertible("λx. f x", "f"));
+    EXPECT_TRUE(convertible("g", "λy. (λz. g z) y"));
+    EXPECT_TRUE(convertible("λx. add 1 x", "add ((λn. n) 1)"));
+    EXPECT_TRUE(convertible("fst (a, b)", "a"));
+    EXPECT_TRUE(convertible("case (inr[Nat + Bool] true) (λn: Nat. n) (λb: Bool. 7)", "7"));
+    EXPECT_TRUE(convertible("let id = λx. x in id id", "λy. y"));
+}
+
+TEST(ConversionTest, DistinguishesDifferentTerms) {
+    EXPECT_FALSE(convertible("λx. λy. x", "λx. λy. y"));
+    EXPECT_FALSE(convertible("λx. f x x", "f"));
+    EXPECT_FALSE(convertible("add 1 2", "4"));
+    EXPECT_FALSE(convertible("f a b", "f a"));
+    EXPECT_FALSE(convertible("(a, b)", "(b, a)"));
+    EXPECT_FALSE(convertible("inl[Nat + Nat] 1", "inr[Nat + Nat] 1"));
+    EXPECT_FALSE(convertible("1", "true"));
+}
+
+TEST(ConversionTest, ChurchArithmetic) {
+    Definitions definitions;
+    definitions.define("plus", parse_term("λm. λn. λf. λx. m f (n f x)"));
+    definitions.define("times", parse_term("λm. λn. λf. m (n f)"));
+    definitions.define("two", parse_term("λf. λx. f (f x)"));
+    ConversionStats stats;
+    EXPECT_TRUE(convertible("times two (plus two two)", "plus (times two two) (times two two)", stats, &definitions));
+    EXPECT_GT(stats.reduction.beta_steps, 0u);
+    EXPECT_FALSE(convertible("times two two", "plus two (λf. λx. f x)", stats, &definitions));
+}
+
+TEST(ConversionTest, StopsAtTheFirstMismatch) {
+    // Neither argument has a normal form, but the heads already differ.
+    ConversionStats stats;
+    EXPECT_FALSE(convertible((std::string("f (") + omega + ")").c_str(), (std::string("g (") + omega + ")").c_str(), stats));
+    EXPECT_EQ(stats.reduction.beta_steps, 0u);
+    // A diverging argument that is the very same definition is not entered.
+    Definitions definitions;
+    definitions.define("loop", parse_term(omega));
+    EXPECT_TRUE(convertible("(λx. f x) loop", "f loop", stats, &definitions));
+    EXPECT_GT(stats.shared, 0u);
+}
+
+TEST(ConversionTest, AgreesWithNormalization) {
+    // βη-normal forms, compared up to α.
+    const auto normal_form = [](const Term& term) {
+        EtaStats stats;
+        return alpha_hash(*eta_reduce(ExplicitSubstitutionEngine(term).normalize(), stats));
+    };
+    for (std::uint64_t seed = 1; seed <= 30; ++seed) {
+        const auto term = TermGenerator(GeneratorOptions{.seed = seed, .size = 60, .max_depth = 8}).generate();
+        EXPECT_TRUE(convertible(*term, *ExplicitSubstitutionEngine(*term).normalize())) << term->to_string();
+
+        const auto other = TermGenerator(GeneratorOptions{.seed = seed + 1000, .size = 60, .max_depth = 8}).generate();
+        EXPECT_EQ(convertible(*term, *other), normal_form(*term) == normal_form(*other))
+            << term->to_string() << " vs " << other->to_string();
+    }
+}
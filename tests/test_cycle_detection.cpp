@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../parser/Parser.h"
+#include "../engines/BoundedEvaluation.h"
+#include "../engines/CycleDetector.h"
+
+TEST(AlphaHashTest, InvariantUnderRenaming) {
+    EXPECT_EQ(alpha_hash(*parse_term("λx. λy. x y")), alpha_hash(*parse_term("λa. λb. a b")));
+    EXPECT_EQ(alpha_hash(*parse_term("let v = 1 in add v z")), alpha_hash(*parse_term("let w = 1 in add w z")));
+    // Annotations do not take part.
+    EXPECT_EQ(alpha_hash(*parse_term("λx:Nat. x")), alpha_hash(*parse_term("λx. x")));
+}
+
+TEST(AlphaHashTest, DistinguishesStructure) {
+    EXPECT_NE(alpha_hash(*parse_term("λx. λy. x")), alpha_hash(*parse_term("λx. λy. y")));
+    EXPECT_NE(alpha_hash(*parse_term("λx. x z")), alpha_hash(*parse_term("λx. z x")));
+    // Free variables keep their names.
+    EXPECT_NE(alpha_hash(*parse_term("λx. y")), alpha_hash(*parse_term("λx. z")));
+    EXPECT_NE(alpha_hash(*parse_term("1")), alpha_hash(*parse_term("true")));
+}
+
+TEST(CycleDetectorTest, FindsPeriod) {
+    // Tail of 5 states, then a cycle of 3.
+    CycleDetector detector;
+    std::size_t steps = 0;
+    for (std::uint64_t i = 0; !detector.observe(i < 5 ? 100 + i : i % 3); ++i) {
+        ASSERT_LT(++steps, 100u);
+    }
+    EXPECT_EQ(detector.period(), 3u);
+}
+
+TEST(CycleDetectorTest, EvaluationReportsOmega) {
+    const ResourcePolicy policy{.detect_cycles = true};
+    const auto result = evaluate(parse_term("(λx. x x) (λx. x x)"), policy);
+    EXPECT_EQ(result.status, EvaluationStatus::Cycle);
+    EXPECT_EQ(result.period, 1u);
+    EXPECT_EQ(result.steps, 1u);
+    EXPECT_EQ(describe_exhaustion(result, policy), "reduction cycles with period 1 after 1 steps");
+}
+
+TEST(CycleDetectorTest, EvaluationReportsLongerCycle) {
+    // (λx. x x) W -> W W -> (λx. x x) W with W = λy. (λx. x x) y, behind a
+    // one-step tail.
+    const auto result = evaluate(parse_term("(λd. (λx. x x) (λy. (λx. x x) y)) z"),
+                                 ResourcePolicy{.max_steps = 1000, .detect_cycles = true});
+    EXPECT_EQ(result.status, EvaluationStatus::Cycle);
+    EXPECT_EQ(result.period, 2u);
+    EXPECT_LE(result.steps, 5u);
+}
+
+TEST(CycleDetectorTest, TerminatingTermUnaffected) {
+    const auto result = evaluate(parse_term("(λf. λx. f (f x)) (λf. λx. f (f x)) g z"),
+                                 ResourcePolicy{.detect_cycles = true});
+    EXPECT_EQ(result.status, EvaluationStatus::Normal);
+    EXPECT_EQ(result.term->to_string(), "(g) ((g) ((g) ((g) (z))))");
+}
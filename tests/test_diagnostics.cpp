@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TermGenerator.h"
+#include "../parser/Parser.h"
+#include "../engines/Diagnostics.h"
+#include "../engines/BoundedEvaluation.h"
+#include "../models/MemoryProfile.h"
+
+#include <vector>
+
+TEST(DiagnosticsTest, AgreesWithTypeCheckOnWellTypedTerms) {
+    for (std::uint64_t seed = 0; seed < 20; ++seed) {
+        const auto term = TermGenerator(GeneratorOptions{.seed = seed, .size = 300}).generate();
+        const auto checked = try_type_check(*term);
+        ASSERT_TRUE(checked.has_value()) << "seed " << seed << ": " << checked.error().message();
+        EXPECT_EQ((*checked)->to_string(), term->type_check(TypingContext())->to_string());
+    }
+}
+
+TEST(DiagnosticsTest, ReportsErrorCodesWithoutThrowing) {
+    const auto undeclared = try_type_check(*parse_term("λx: Nat. y"));
+    ASSERT_FALSE(undeclared);
+    EXPECT_EQ(undeclared.error().code, ErrorCode::UndeclaredVariable);
+    EXPECT_EQ(undeclared.error().name, "y");
+    EXPECT_EQ(undeclared.error().message(), UndeclaredVariableError("y").what());
+
+    const auto not_function = try_type_check(*parse_term("3 4"));
+    ASSERT_FALSE(not_function);
+    EXPECT_EQ(not_function.error().code, ErrorCode::NotAFunction);
+    EXPECT_EQ(not_function.error().message(), NotAFunctionError("Nat").what());
+
+    const auto mismatch = try_type_check(*parse_term("(λx: Nat. x) true"));
+    ASSERT_FALSE(mismatch);
+    EXPECT_EQ(mismatch.error().code, ErrorCode::DomainMismatch);
+    EXPECT_EQ(mismatch.error().expected->to_string(), "Nat");
+    EXPECT_EQ(mismatch.error().actual->to_string(), "Bool");
+    EXPECT_EQ(mismatch.error().message(), "Type mismatch: expecting domain 'Nat', got 'Bool'");
+}
+
+TEST(DiagnosticsTest, UsesTheGivenContext) {
+    const BaseType nat("Nat");
+    TypingContext context;
+    context.add("n", &nat);
+    const auto checked = try_type_check(*parse_term("add n 1"), context);
+    ASSERT_TRUE(checked);
+    EXPECT_EQ((*checked)->to_string(), "Nat");
+}
+
+TEST(DiagnosticsTest, CollectsEveryErrorInOnePass) {
+    const auto term = parse_term("λf: Nat -> Nat. add (f true) (add (3 4) y)");
+    const auto errors = collect_type_errors(*term);
+    std::vector<ErrorCode> codes;
+    for (const auto& error : errors) codes.push_back(error.code);
+    EXPECT_EQ(codes, (std::vector{ErrorCode::DomainMismatch, ErrorCode::NotAFunction, ErrorCode::UndeclaredVariable}));
+
+    // try_type_check stops at the first of them.
+    EXPECT_EQ(try_type_check(*term).error().code, ErrorCode::DomainMismatch);
+
+    // A mismatch leaves the application typed, so its parent must not
+    // replace the error with one of its own.
+    EXPECT_EQ(try_type_check(*parse_term("add 1 add 2")).error().code, ErrorCode::DomainMismatch);
+}
+
+TEST(DiagnosticsTest, FailedSubtermsDoNotCascade) {
+    const auto errors = collect_type_errors(*parse_term("let g = nope 3 in add (g 4) (g 5)"));
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_EQ(errors[0].code, ErrorCode::UndeclaredVariable);
+    EXPECT_TRUE(collect_type_errors(*parse_term("(λx: Nat. add x 1) 41")).empty());
+}
+
+TEST(DiagnosticsTest, DefinitionErrorsAreReportedOnce) {
+    Definitions globals;
+    globals.define("bad", parse_term("λx: Nat. x x"));
+    const auto errors = collect_type_errors(*parse_term("λy: Nat. bad (bad y)", &globals));
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_EQ(errors[0].code, ErrorCode::NotAFunction);
+}
+
+TEST(DiagnosticsTest, ReductionEndsWithoutThrowing) {
+    const auto source = "(λf. λx. f (f x)) (λy. add y 1) 3";
+    auto term = parse_term(source);
+    std::size_t steps = 0;
+    for (;;) {
+        auto next = try_beta_reduce(std::move(term));
+        if (!next) {
+            EXPECT_EQ(next.error().code, ErrorCode::NormalForm);
+            term = std::move(next.error().term);
+            break;
+        }
+        term = std::move(*next);
+        ++steps;
+    }
+    std::size_t expected_steps = 0;
+    const auto expected = normalize_unguarded(parse_term(source), expected_steps);
+    EXPECT_EQ(steps, expected_steps);
+    EXPECT_EQ(term->to_string(), expected->to_string());
+}
+
+TEST(DiagnosticsTest, NormalFormMessageIsStillAvailable) {
+    try {
+        (void)::beta_reduce(parse_term("λx. x"));
+        FAIL() << "expected ReductionOnNormalForm";
+    } catch (const ReductionOnNormalForm& error) {
+        EXPECT_STREQ(error.what(), "Reduction on normal form: λx. x");
+        // The consumed term can still be recovered.
+        EXPECT_EQ(error.term().to_string(), "λx. x");
+    }
+}
+
+TEST(DiagnosticsTest, NormalFormErrorsDoNotCopyTheTerm) {
+    // The consuming step hands its term to the exception; the const step
+    // copies it once.
+    auto consumed = parse_term("λx. λy. x (y y)");
+    const auto kept = parse_term("λx. λy. x (y y)");
+    AllocationTracker tracker;
+    EXPECT_THROW((void)::beta_reduce(std::move(consumed)), ReductionOnNormalForm);
+    EXPECT_EQ(tracker.stats().allocations, 0u);
+    EXPECT_THROW((void)kept->beta_reduce(), ReductionOnNormalForm);
+    EXPECT_EQ(tracker.stats().allocations, kept->measure().nodes);
+}
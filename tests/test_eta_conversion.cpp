@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../parser/Parser.h"
+#include "../engines/EtaConversion.h"
+
+class EtaConversionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        nat_to_nat = parse_type("Nat -> Nat");
+        context.add("f", nat_to_nat.get());
+    }
+
+    std::unique_ptr<Type> nat_to_nat;
+    TypingContext context;
+    EtaStats stats;
+};
+
+TEST_F(EtaConversionTest, RecognizesRedex) {
+    EXPECT_TRUE(is_eta_redex(*parse_term("λx. f x")));
+    EXPECT_FALSE(is_eta_redex(*parse_term("λx. x x")));
+    EXPECT_FALSE(is_eta_redex(*parse_term("λx. f x y")));
+    EXPECT_FALSE(is_eta_redex(*parse_term("λx. f y")));
+}
+
+TEST_F(EtaConversionTest, ReducesNestedRedexes) {
+    auto term = eta_reduce(parse_term("λg. λx. λy. g x y"), stats);
+    EXPECT_EQ(term->to_string(), "λg. g");
+    EXPECT_EQ(stats.reductions, 2u);
+    EXPECT_EQ(stats.nodes_before, 8u);
+    EXPECT_EQ(stats.nodes_after, 2u);
+    EXPECT_EQ(stats.nodes_saved(), 6);
+}
+
+TEST_F(EtaConversionTest, LeavesNonRedexesAlone) {
+    auto term = eta_reduce(parse_term("λx. add x x"), stats);
+    EXPECT_EQ(term->to_string(), "λx. ((add) (x)) (x)");
+    EXPECT_EQ(stats.reductions, 0u);
+}
+
+TEST_F(EtaConversionTest, ExpandsToLongForm) {
+    const auto type = parse_type("Nat -> Nat");
+    auto term = eta_expand(parse_term("f"), *type, context, stats);
+    EXPECT_EQ(term->to_string(), "λx. (f) (x)");
+    EXPECT_EQ(stats.expansions, 1u);
+    EXPECT_EQ(term->type_check(context)->to_string(), "Nat -> Nat");
+}
+
+TEST_F(EtaConversionTest, ExpandsArgumentsAtHigherType) {
+    // A variable of function type is expanded both in head position and as
+    // an argument.
+    const auto type = parse_type("(Nat -> Nat) -> Nat -> Nat");
+    auto term = eta_expand(parse_term("λg:Nat -> Nat. g"), *type, context, stats);
+    EXPECT_EQ(term->to_string(), "λg. λx. (g) (x)");
+    const auto twice_type = parse_type("((Nat -> Nat) -> Nat -> Nat) -> Nat -> Nat");
+    auto applied = eta_expand(parse_term("λh:(Nat -> Nat) -> Nat -> Nat. h f"), *twice_type, context, stats);
+    EXPECT_EQ(applied->to_string(), "λh. λx. ((h) (λx. (f) (x))) (x)");
+}
+
+TEST_F(EtaConversionTest, ExpansionThenReductionRoundTrips) {
+    const auto type = parse_type("(Nat -> Nat) -> Nat -> Nat");
+    auto term = eta_reduce(eta_expand(parse_term("λg:Nat -> Nat. g"), *type, context, stats), stats);
+    EXPECT_EQ(term->to_string(), "λg. g");
+}
+
+TEST_F(EtaConversionTest, BetaEtaNormalize) {
+    const auto result = beta_eta_normalize(parse_term("(λk. λx. k x) (λy. f y)"), ResourcePolicy{}, stats);
+    EXPECT_EQ(result.status, EvaluationStatus::Normal);
+    EXPECT_EQ(result.term->to_string(), "f");
+    // β leaves λx. (f) (x), which η then contracts.
+    EXPECT_EQ(result.steps, 2u);
+    EXPECT_EQ(stats.reductions, 1u);
+}
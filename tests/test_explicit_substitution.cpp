@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../engines/ExplicitSubstitution.h"
+
+using std::make_unique;
+
+namespace {
+    std::unique_ptr<Term> numeral(int n) {
+        std::unique_ptr<Term> body = make_unique<Variable>("x");
+        for (int i = 0; i < n; ++i) {
+            body = make_unique<Application>(make_unique<Variable>("f"), std::move(body));
+        }
+        return make_unique<Abstraction>(
+            make_unique<Variable>("f"),
+            make_unique<Abstraction>(make_unique<Variable>("x"), std::move(body))
+        );
+    }
+
+    std::unique_ptr<Term> mult() {
+        return make_unique<Abstraction>(make_unique<Variable>("m"),
+            make_unique<Abstraction>(make_unique<Variable>("n"),
+                make_unique<Abstraction>(make_unique<Variable>("f"),
+                    make_unique<Application>(
+                        make_unique<Variable>("m"),
+                        make_unique<Application>(make_unique<Variable>("n"), make_unique<Variable>("f"))
+                    ))));
+    }
+
+    std::unique_ptr<Term> omega() {
+        auto half = make_unique<Abstraction>(
+            make_unique<Variable>("x"),
+            make_unique<Application>(make_unique<Variable>("x"), make_unique<Variable>("x"))
+        );
+        return make_unique<Application>(half->clone(), std::move(half));
+    }
+}
+
+TEST(ExplicitSubstitutionTest, NormalizesIdentityApplication) {
+    Application app(
+        make_unique<Abstraction>(make_unique<Variable>("x"), make_unique<Variable>("x")),
+        make_unique<Variable>("y")
+    );
+    ExplicitSubstitutionEngine engine(app);
+    EXPECT_EQ(engine.normalize()->to_string(), "y");
+    EXPECT_EQ(engine.stats().beta_steps, 1u);
+}
+
+TEST(ExplicitSubstitutionTest, ChurchMultiplication) {
+    auto term = make_unique<Application>(
+        make_unique<Application>(mult(), numeral(2)),
+        numeral(3)
+    );
+    ExplicitSubstitutionEngine engine(*term);
+    EXPECT_EQ(engine.normalize()->to_string(), numeral(6)->to_string());
+}
+
+TEST(ExplicitSubstitutionTest, AgreesWithEagerReduction) {
+    auto term = make_unique<Application>(
+        make_unique<Application>(mult(), numeral(3)),
+        numeral(2)
+    );
+    std::unique_ptr<Term> eager = term->clone();
+    while (!eager->is_normal()) eager = eager->beta_reduce();
+
+    ExplicitSubstitutionEngine engine(*term);
+    EXPECT_EQ(engine.normalize()->to_string(), eager->to_string());
+}
+
+TEST(ExplicitSubstitutionTest, DiscardedArgumentIsNeverReduced) {
+    // (λx. λy. y) Ω has a normal form only if Ω is left alone.
+    Application app(
+        make_unique<Abstraction>(
+            make_unique<Variable>("x"),
+            make_unique<Abstraction>(make_unique<Variable>("y"), make_unique<Variable>("y"))
+        ),
+        omega()
+    );
+    ExplicitSubstitutionEngine engine(app);
+    EXPECT_EQ(engine.normalize()->to_string(), "λy. y");
+}
+
+TEST(ExplicitSubstitutionTest, WeakHeadLeavesBodyUnreduced) {
+    // (λz. λw. (λa. a) z) v  ->  λw. (λa. a) v
+    Application app(
+        make_unique<Abstraction>(
+            make_unique<Variable>("z"),
+            make_unique<Abstraction>(
+                make_unique<Variable>("w"),
+                make_unique<Application>(
+                    make_unique<Abstraction>(make_unique<Variable>("a"), make_unique<Variable>("a")),
+                    make_unique<Variable>("z")
+                )
+            )
+        ),
+        make_unique<Variable>("v")
+    );
+    ExplicitSubstitutionEngine engine(app);
+    EXPECT_EQ(engine.weak_head_normalize()->to_string(), "λw. (λa. a) (v)");
+    EXPECT_EQ(engine.stats().beta_steps, 1u);
+}
+
+TEST(ExplicitSubstitutionTest, AvoidsCapture) {
+    // (λx. λy. x) y  ->  λy'. y
+    Application app(
+        make_unique<Abstraction>(
+            make_unique<Variable>("x"),
+            make_unique<Abstraction>(make_unique<Variable>("y"), make_unique<Variable>("x"))
+        ),
+        make_unique<Variable>("y")
+    );
+    ExplicitSubstitutionEngine engine(app);
+    EXPECT_EQ(engine.normalize()->to_string(), "λy'. y");
+}
+
+TEST(ExplicitSubstitutionTest, PreservesBinderTypes) {
+    Abstraction abs(
+        make_unique<Variable>("x", make_unique<BaseType>("Int")),
+        make_unique<Variable>("x", make_unique<BaseType>("Int"))
+    );
+    ExplicitSubstitutionEngine engine(abs);
+    auto result = engine.normalize();
+    auto* result_abs = dynamic_cast<Abstraction*>(result.get());
+    ASSERT_NE(result_abs, nullptr);
+    EXPECT_EQ(result_abs->var_type->to_string(), "Int");
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TaggedTerm.h"
+#include "../models/TermTape.h"
+#include "../engines/ExplicitSubstitution.h"
+
+using std::make_unique;
+
+class LetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // let id = λx. x in (id) (y)
+        let_term = make_unique<Let>(
+            "id",
+            make_unique<Abstraction>(make_unique<Variable>("x"), make_unique<Variable>("x")),
+            make_unique<Application>(make_unique<Variable>("id"), make_unique<Variable>("y"))
+        );
+        tau = make_unique<BaseType>("τ");
+        context.add("y", tau.get());
+    }
+
+    std::unique_ptr<Let> let_term;
+    std::unique_ptr<BaseType> tau;
+    TypingContext context;
+};
+
+TEST_F(LetTest, ToString) {
+    EXPECT_EQ(let_term->to_string(), "let id = λx. x in (id) (y)");
+}
+
+TEST_F(LetTest, HasFree) {
+    EXPECT_TRUE(let_term->has_free("y"));
+    EXPECT_FALSE(let_term->has_free("id"));
+    EXPECT_FALSE(let_term->has_free("x"));
+}
+
+TEST_F(LetTest, IsNeverNormal) {
+    EXPECT_FALSE(let_term->is_normal());
+}
+
+TEST_F(LetTest, BetaReduceSubstitutesBoundTerm) {
+    auto result = let_term->beta_reduce();
+    EXPECT_EQ(result->to_string(), "(λx. x) (y)");
+    EXPECT_EQ(result->beta_reduce()->to_string(), "y");
+}
+
+TEST_F(LetTest, BetaReduceInPlace) {
+    std::unique_ptr<Term> term = std::move(let_term);
+    EXPECT_EQ(beta_reduce(std::move(term))->to_string(), "(λx. x) (y)");
+}
+
+TEST_F(LetTest, TypeCheckInfersBoundType) {
+    EXPECT_EQ(let_term->type_check(context)->to_string(), "τ");
+}
+
+TEST_F(LetTest, Substitute_ShadowedInBody) {
+    // let y = y in y, [y := z] only touches the bound term
+    Let shadow("y", make_unique<Variable>("y"), make_unique<Variable>("y"));
+    Variable z("z");
+    EXPECT_EQ(shadow.substitute("y", z)->to_string(), "let y = z in y");
+}
+
+TEST_F(LetTest, Substitute_AvoidsCapture) {
+    Let let("x", make_unique<Variable>("a"), make_unique<Variable>("b"));
+    Variable x("x");
+    EXPECT_EQ(let.substitute("b", x)->to_string(), "let x' = a in x");
+    std::unique_ptr<Term> owned = let.clone();
+    EXPECT_EQ(substitute(std::move(owned), "b", x)->to_string(), "let x' = a in x");
+}
+
+TEST_F(LetTest, AlternateRepresentations) {
+    auto tagged = to_tagged(*let_term);
+    EXPECT_EQ(tagged->kind(), TermKind::Let);
+    EXPECT_EQ(to_string(*tagged), let_term->to_string());
+    EXPECT_EQ(to_string(*type_check(*tagged, context)), "τ");
+    EXPECT_EQ(to_string(*beta_reduce(*tagged)), "(λx. x) (y)");
+    EXPECT_EQ(from_tagged(*tagged)->to_string(), let_term->to_string());
+
+    TermTape tape(*let_term);
+    EXPECT_EQ(tape.to_string(), let_term->to_string());
+    EXPECT_FALSE(tape.is_normal());
+    EXPECT_FALSE(tape.has_free("id"));
+    EXPECT_EQ(tape.type_check(context)->to_string(), "τ");
+    EXPECT_EQ(tape.to_term()->to_string(), let_term->to_string());
+
+    ExplicitSubstitutionEngine engine(*let_term);
+    EXPECT_EQ(engine.normalize()->to_string(), "y");
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/MemoryProfile.h"
+#include "../parser/Parser.h"
+
+TEST(MemoryProfileTest, CountsNodesByKind) {
+    const auto profile = profile_memory(*parse_term("λx:Nat -> Nat. add (x 1) 2"));
+    const auto& terms = profile.terms;
+    EXPECT_EQ(terms[static_cast<std::size_t>(TermKind::Abstraction)].count, 1u);
+    EXPECT_EQ(terms[static_cast<std::size_t>(TermKind::Application)].count, 3u);
+    EXPECT_EQ(terms[static_cast<std::size_t>(TermKind::Variable)].count, 1u);
+    EXPECT_EQ(terms[static_cast<std::size_t>(TermKind::Literal)].count, 2u);
+    EXPECT_EQ(terms[static_cast<std::size_t>(TermKind::Primitive)].count, 1u);
+    EXPECT_EQ(terms[static_cast<std::size_t>(TermKind::Application)].bytes, 3 * sizeof(Application));
+    EXPECT_EQ(profile.term_nodes(), 8u);
+    EXPECT_EQ(profile.term_nodes(), parse_term("λx:Nat -> Nat. add (x 1) 2")->measure().nodes);
+}
+
+TEST(MemoryProfileTest, CountsTypesAndNames) {
+    // Binder and bound occurrence each own a copy of Nat -> Nat.
+    const auto profile = profile_memory(*parse_term("λx:Nat -> Nat. x"));
+    EXPECT_EQ(profile.function_types.count, 2u);
+    EXPECT_EQ(profile.base_types.count, 4u);
+    EXPECT_EQ(profile.names, 6u);
+    EXPECT_EQ(profile.name_chars, 2u + 4 * 3);
+    EXPECT_EQ(profile.name_heap_bytes, 0u);
+
+    const auto long_name = profile_memory(*parse_term("a_variable_name_past_the_small_buffer"));
+    EXPECT_GT(long_name.name_heap_bytes, 0u);
+}
+
+TEST(MemoryProfileTest, FindsDuplicatedSubtrees) {
+    // The two copies of (f (g y)) count once, at the largest repeat.
+    const auto profile = profile_memory(*parse_term("h (f (g y)) (f (g y))"));
+    EXPECT_EQ(profile.duplicate_subtrees, 1u);
+    EXPECT_EQ(profile.duplicate_nodes, 5u);
+    EXPECT_EQ(profile_memory(*parse_term("f x y")).duplicate_subtrees, 0u);
+}
+
+TEST(MemoryProfileTest, JsonReport) {
+    const auto json = profile_memory(*parse_term("λx. x")).to_json();
+    EXPECT_NE(json.find("\"Abstraction\":{\"count\":1,"), std::string::npos);
+    EXPECT_NE(json.find("\"duplicates\":{\"subtrees\":0,\"nodes\":0}"), std::string::npos);
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+}
+
+TEST(AllocationTrackerTest, TracksHighWaterMark) {
+    auto term = parse_term("(λf. λx. f (f x)) (λf. λx. f (f x)) g z");
+    AllocationTracker tracker;
+    while (!term->is_normal()) term = beta_reduce(std::move(term));
+    const auto stats = tracker.stats();
+    EXPECT_GT(stats.allocations, 0u);
+    EXPECT_GT(stats.peak_nodes, 0);
+    EXPECT_GE(stats.peak_nodes, stats.live_nodes);
+    EXPECT_GE(stats.peak_bytes, stats.peak_nodes * static_cast<std::int64_t>(sizeof(Application)));
+    EXPECT_EQ(static_cast<std::int64_t>(stats.allocations) - static_cast<std::int64_t>(stats.deallocations), stats.live_nodes);
+
+    const auto before = tracker.stats().live_nodes;
+    term.reset();
+    EXPECT_LT(tracker.stats().live_nodes, before);
+}
+
+TEST(AllocationTrackerTest, IdleWithoutTracker) {
+    std::size_t allocations;
+    {
+        AllocationTracker tracker;
+        allocations = tracker.stats().allocations;
+    }
+    auto term = parse_term("λx. x");
+    AllocationTracker tracker;
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_EQ(tracker.stats().allocations, 0u);
+}
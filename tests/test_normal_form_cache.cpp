@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../parser/Parser.h"
+#include "../engines/NormalFormCache.h"
+#include "../pipeline/BatchPipeline.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+    class NormalFormCacheTest : public ::testing::Test {
+    protected:
+        std::filesystem::path path;
+
+        void SetUp() override {
+            path = std::filesystem::temp_directory_path() /
+                ("lambda_nf_cache_" + std::to_string(::getpid()) + "_" +
+                 ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin");
+            std::filesystem::remove(path);
+        }
+
+        void TearDown() override {
+            std::filesystem::remove(path);
+        }
+    };
+
+    void store_normal_form(NormalFormCache& cache, const std::string& source) {
+        const auto term = parse_term(source);
+        std::size_t steps = 0;
+        const auto normal_form = normalize_unguarded(term->clone(), steps);
+        cache.store(*term, *normal_form);
+    }
+}
+
+TEST_F(NormalFormCacheTest, HitsAlphaEquivalentTerms) {
+    NormalFormCache cache(path);
+    EXPECT_EQ(cache.lookup(*parse_term("(λx. λy. x) a b")), nullptr);
+    store_normal_form(cache, "(λx. λy. x) a b");
+    const auto hit = cache.lookup(*parse_term("(λp. λq. p) a b"));
+    ASSERT_NE(hit, nullptr);
+    EXPECT_EQ(hit->to_string(), "a");
+    EXPECT_EQ(cache.lookup(*parse_term("(λx. λy. y) a b")), nullptr);
+
+    const auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.stores, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+}
+
+TEST_F(NormalFormCacheTest, SurvivesReopening) {
+    {
+        NormalFormCache cache(path);
+        store_normal_form(cache, "add 2 3");
+        store_normal_form(cache, "(λf: Nat -> Nat. f 1) (λn: Nat. mul n 9)");
+    }
+    NormalFormCache cache(path);
+    EXPECT_EQ(cache.stats().entries, 2u);
+    ASSERT_NE(cache.lookup(*parse_term("add 2 3")), nullptr);
+    EXPECT_EQ(cache.lookup(*parse_term("add 2 3"))->to_string(), "5");
+    EXPECT_EQ(cache.lookup(*parse_term("(λg: Nat -> Nat. g 1) (λm: Nat. mul m 9)"))->to_string(), "9");
+}
+
+TEST_F(NormalFormCacheTest, RefreshSeesOtherWriters) {
+    NormalFormCache reader(path);
+    NormalFormCache writer(path);
+    store_normal_form(writer, "(λx. x) z");
+    EXPECT_EQ(reader.lookup(*parse_term("(λx. x) z")), nullptr);
+    reader.refresh();
+    ASSERT_NE(reader.lookup(*parse_term("(λx. x) z")), nullptr);
+}
+
+TEST_F(NormalFormCacheTest, KeyCoversDefinitionBodies) {
+    Definitions first;
+    first.define("f", parse_term("λx. x"));
+    Definitions second;
+    second.define("f", parse_term("λx. λy. x"));
+    EXPECT_NE(cache_key(*parse_term("f a", &first)), cache_key(*parse_term("f a", &second)));
+    EXPECT_EQ(cache_key(*parse_term("f a", &first)), cache_key(*parse_term("f a", &first)));
+}
+
+TEST_F(NormalFormCacheTest, KeyCoversTypeAnnotations) {
+    NormalFormCache cache(path);
+    store_normal_form(cache, "(λf: Nat -> Nat. f) (λx: Nat. x)");
+    store_normal_form(cache, "(λv: Nat + Bool. v) (inl[Nat + Bool] 3)");
+    EXPECT_EQ(cache.lookup(*parse_term("(λf: Bool -> Bool. f) (λx: Bool. x)")), nullptr);
+    EXPECT_EQ(cache.lookup(*parse_term("(λv: Nat + Nat. v) (inl[Nat + Nat] 3)")), nullptr);
+    const auto hit = cache.lookup(*parse_term("(λg: Nat -> Nat. g) (λy: Nat. y)"));
+    ASSERT_NE(hit, nullptr);
+    EXPECT_EQ(hit->to_string(), "λx. x");
+}
+
+TEST_F(NormalFormCacheTest, StopsGrowingAtTheBound) {
+    NormalFormCache cache(path, 256);
+    for (int i = 0; i < 50; ++i) store_normal_form(cache, "add " + std::to_string(i) + " 1");
+    const auto stats = cache.stats();
+    EXPECT_LE(stats.file_bytes, 256u);
+    EXPECT_GT(stats.stores, 0u);
+    EXPECT_EQ(stats.stores + stats.rejected, 50u);
+}
+
+TEST_F(NormalFormCacheTest, TornTailIsIgnoredAndCut) {
+    {
+        NormalFormCache cache(path);
+        store_normal_form(cache, "add 1 1");
+    }
+    const auto intact = std::filesystem::file_size(path);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << std::string(30, '\x7f');
+    }
+    NormalFormCache cache(path);
+    EXPECT_EQ(cache.stats().entries, 1u);
+    store_normal_form(cache, "add 2 2");
+    EXPECT_GT(std::filesystem::file_size(path), intact);
+
+    NormalFormCache reopened(path);
+    EXPECT_EQ(reopened.stats().entries, 2u);
+    EXPECT_EQ(reopened.lookup(*parse_term("add 2 2"))->to_string(), "4");
+}
+
+TEST_F(NormalFormCacheTest, RescansATailReplacedAtTheSameSize) {
+    // The entry another writer will append, torn by one flipped byte.
+    const auto scratch = path.string() + ".scratch";
+    std::filesystem::remove(scratch);
+    {
+        NormalFormCache cache(scratch);
+        store_normal_form(cache, "add 3 3");
+    }
+    std::string entry;
+    {
+        std::ifstream in(scratch, std::ios::binary);
+        entry.assign(std::istreambuf_iterator<char>(in), {});
+        entry.erase(0, 8);
+    }
+    std::filesystem::remove(scratch);
+    {
+        NormalFormCache cache(path);
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << entry.substr(0, entry.size() - 1) << static_cast<char>(entry.back() ^ 1);
+    }
+
+    NormalFormCache stale(path);
+    EXPECT_EQ(stale.stats().entries, 0u);
+    NormalFormCache writer(path);
+    store_normal_form(writer, "add 3 3");
+    // Same file size as the torn tail; the stale reader must not cut it.
+    store_normal_form(stale, "add 4 4");
+    ASSERT_NE(stale.lookup(*parse_term("add 3 3")), nullptr);
+
+    NormalFormCache reopened(path);
+    EXPECT_EQ(reopened.stats().entries, 2u);
+    EXPECT_EQ(reopened.lookup(*parse_term("add 3 3"))->to_string(), "6");
+}
+
+TEST_F(NormalFormCacheTest, RejectsForeignFiles) {
+    {
+        std::ofstream out(path);
+        out << "not a cache at all";
+    }
+    EXPECT_THROW(NormalFormCache cache(path), std::runtime_error);
+}
+
+TEST_F(NormalFormCacheTest, ConcurrentProcessesAppendSafely) {
+    constexpr int processes = 4;
+    constexpr int terms = 40;
+    for (int p = 0; p < processes; ++p) {
+        if (::fork() == 0) {
+            NormalFormCache cache(path);
+            for (int i = 0; i < terms; ++i) {
+                store_normal_form(cache, "mul " + std::to_string(p) + " " + std::to_string(i));
+                // Everyone also races on one shared key.
+                store_normal_form(cache, "add 40 2");
+            }
+            ::_exit(0);
+        }
+    }
+    for (int p = 0; p < processes; ++p) {
+        int status = 0;
+        ::wait(&status);
+        EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    NormalFormCache cache(path);
+    EXPECT_EQ(cache.stats().entries, static_cast<std::size_t>(processes * terms + 1));
+    EXPECT_EQ(cache.lookup(*parse_term("mul 3 39"))->to_string(), "117");
+    EXPECT_EQ(cache.lookup(*parse_term("add 40 2"))->to_string(), "42");
+}
+
+TEST_F(NormalFormCacheTest, PipelineStartsWarm) {
+    const std::string input = "(λf. λx. f (f x)) (λy. add y 1) 3\nadd 4 5\n";
+    std::string first_output;
+    for (int run = 0; run < 2; ++run) {
+        BatchPipeline pipeline(BatchOptions{.workers = 2, .cache_path = path.string()});
+        std::istringstream in(input);
+        std::ostringstream out;
+        const auto stats = pipeline.run(in, out);
+        if (run == 0) {
+            EXPECT_EQ(stats.cache_hits, 0u);
+            first_output = out.str();
+        } else {
+            EXPECT_EQ(stats.cache_hits, 2u);
+            EXPECT_EQ(stats.steps, 0u);
+            EXPECT_EQ(out.str(), first_output);
+        }
+    }
+}
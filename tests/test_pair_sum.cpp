@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TaggedTerm.h"
+#include "../models/TermTape.h"
+#include "../models/TermCodec.h"
+#include "../models/SharedTerm.h"
+#include "../parser/Parser.h"
+#include "../engines/BoundedEvaluation.h"
+#include "../engines/Diagnostics.h"
+#include "../engines/ExplicitSubstitution.h"
+#include "../engines/ReductionTrace.h"
+#include "../exceptions/Exceptions.h"
+
+#include <sstream>
+
+namespace {
+    // A pair swap and a case on an injection, each with a β or δ redex
+    // left inside the components.
+    constexpr auto swap_source =
+        "(λp: Nat * Bool. (snd p, fst p)) (add 1 2, true)";
+    constexpr auto case_source =
+        "case (inl[Nat + Bool] (add 40 2)) (λn: Nat. lt n 50) (λb: Bool. b)";
+}
+
+TEST(PairSumTest, PrintsAndParsesTypes) {
+    EXPECT_EQ(parse_type("Nat * Bool")->to_string(), "Nat * Bool");
+    EXPECT_EQ(parse_type("Nat * Bool + Nat")->to_string(), "(Nat * Bool) + Nat");
+    EXPECT_EQ(parse_type("Nat -> Nat + Bool")->to_string(), "Nat -> Nat + Bool");
+    EXPECT_EQ(parse_type("(Nat -> Nat) * Bool")->to_string(), "(Nat -> Nat) * Bool");
+}
+
+TEST(PairSumTest, RoundTripsPrintedTerms) {
+    for (const auto* source : {
+        "(1, true)",
+        "fst ((1, true))",
+        "snd (p)",
+        "inl[Nat + Bool] (3)",
+        "inr[Nat + (Nat * Nat)] ((1, 2))",
+        "case (s) (λn. n) (λb. b)",
+    }) {
+        EXPECT_EQ(parse_term(source)->to_string(), source);
+    }
+}
+
+TEST(PairSumTest, InjectionHashIncludesItsSumType) {
+    EXPECT_NE(alpha_hash(*parse_term("inl[Nat + Bool] 3")), alpha_hash(*parse_term("inl[Nat + Nat] 3")));
+    EXPECT_NE(alpha_hash(*parse_term("inl[Nat + Bool] 3")), alpha_hash(*parse_term("inr[Bool + Nat] 3")));
+    EXPECT_EQ(alpha_hash(*parse_term("λx. inl[Nat + Bool] x")), alpha_hash(*parse_term("λy. inl[Nat + Bool] y")));
+}
+
+TEST(PairSumTest, TypeCheck) {
+    EXPECT_EQ(parse_term("(1, true)")->type_check(TypingContext())->to_string(), "Nat * Bool");
+    EXPECT_EQ(parse_term("snd (1, true)")->type_check(TypingContext())->to_string(), "Bool");
+    EXPECT_EQ(parse_term("inr[Nat + Bool] true")->type_check(TypingContext())->to_string(), "Nat + Bool");
+    EXPECT_EQ(parse_term(swap_source)->type_check(TypingContext())->to_string(), "Bool * Nat");
+    EXPECT_EQ(parse_term(case_source)->type_check(TypingContext())->to_string(), "Bool");
+}
+
+TEST(PairSumTest, TypeErrors) {
+    EXPECT_THROW((void)parse_term("fst 3")->type_check(TypingContext()), NotAProductError);
+    EXPECT_THROW((void)parse_term("inl[Nat] 3")->type_check(TypingContext()), NotASumError);
+    EXPECT_THROW((void)parse_term("inr[Nat + Bool] 3")->type_check(TypingContext()), DomainTypeMismatchError);
+    EXPECT_THROW((void)parse_term("case 3 (λn: Nat. n) (λn: Nat. n)")->type_check(TypingContext()), NotASumError);
+    EXPECT_THROW((void)parse_term("case (inl[Nat + Bool] 3) (λn: Nat. n) (λb: Bool. b)")->type_check(TypingContext()),
+        BranchTypeMismatchError);
+    EXPECT_THROW((void)parse_term("case (inl[Nat + Bool] 3) (λb: Bool. b) (λb: Bool. b)")->type_check(TypingContext()),
+        DomainTypeMismatchError);
+}
+
+TEST(PairSumTest, DiagnosticsMatchTheExceptions) {
+    for (const auto& [source, code] : std::initializer_list<std::pair<const char*, ErrorCode>>{
+        {"fst 3", ErrorCode::NotAProduct},
+        {"inl[Nat] 3", ErrorCode::NotASum},
+        {"inr[Nat + Bool] 3", ErrorCode::DomainMismatch},
+        {"case 3 (λn: Nat. n) (λn: Nat. n)", ErrorCode::NotASum},
+        {"case (inl[Nat + Bool] 3) (λn: Nat. n) (λb: Bool. b)", ErrorCode::BranchMismatch},
+        {"case (inl[Nat + Bool] 3) 4 (λb: Bool. b)", ErrorCode::NotAFunction},
+    }) {
+        const auto term = parse_term(source);
+        const auto checked = try_type_check(*term);
+        ASSERT_FALSE(checked) << source;
+        EXPECT_EQ(checked.error().code, code) << source;
+        try {
+            (void)term->type_check(TypingContext());
+            ADD_FAILURE() << source;
+        } catch (const TypeMismatchError& error) {
+            EXPECT_EQ(checked.error().message(), error.what()) << source;
+        }
+    }
+    EXPECT_EQ(collect_type_errors(*parse_term("(fst 1, inl[Nat] 2)")).size(), 2u);
+}
+
+TEST(PairSumTest, ProjectionAndCaseContractInOneStep) {
+    auto projection = parse_term("fst (1, true)");
+    EXPECT_FALSE(projection->is_normal());
+    EXPECT_EQ(projection->beta_reduce()->to_string(), "1");
+
+    auto match = parse_term("case (inr[Nat + Bool] true) (λn: Nat. n) (λb: Bool. 0)");
+    EXPECT_EQ(match->beta_reduce()->to_string(), "(λb. 0) (true)");
+    EXPECT_EQ(::beta_reduce(std::move(match))->to_string(), "(λb. 0) (true)");
+
+    EXPECT_TRUE(parse_term("fst p")->is_normal());
+    EXPECT_THROW((void)parse_term("(1, inl[Nat + Nat] 2)")->beta_reduce(), ReductionOnNormalForm);
+}
+
+TEST(PairSumTest, NormalizesThroughEveryRepresentation) {
+    for (const auto* source : {swap_source, case_source}) {
+        std::size_t steps = 0;
+        const auto expected = normalize_unguarded(parse_term(source), steps)->to_string();
+
+        const auto term = parse_term(source);
+        auto tagged = to_tagged(*term);
+        while (!is_normal(*tagged)) tagged = beta_reduce(*tagged);
+        EXPECT_EQ(to_string(*tagged), expected);
+        EXPECT_EQ(to_string(*type_check(*to_tagged(*term), TypingContext())), term->type_check(TypingContext())->to_string());
+
+        TermTape tape(*term);
+        EXPECT_EQ(tape.to_string(), term->to_string());
+        EXPECT_FALSE(tape.is_normal());
+        EXPECT_EQ(tape.type_check(TypingContext())->to_string(), term->type_check(TypingContext())->to_string());
+        EXPECT_EQ(tape.to_term()->to_string(), term->to_string());
+
+        std::size_t shared_steps = 0;
+        EXPECT_EQ(to_string(*normalize(to_shared(*term), shared_steps)), expected);
+        EXPECT_EQ(shared_steps, steps);
+
+        ExplicitSubstitutionEngine engine(*term);
+        EXPECT_EQ(engine.normalize()->to_string(), expected);
+
+        EXPECT_EQ(decode_term(encode_term(*term))->to_string(), term->to_string());
+    }
+}
+
+TEST(PairSumTest, TracesReplay) {
+    TraceRecorder recorder;
+    auto term = parse_term(case_source);
+    recorder.begin(*term);
+    while (!term->is_normal()) term = recorder.step(std::move(term));
+
+    std::stringstream file;
+    write_trace_header(file);
+    write_trace(file, recorder);
+    const auto traces = read_traces(file);
+    ASSERT_EQ(traces.size(), 1u);
+    EXPECT_EQ(traces[0].steps.front().rule, RedexRule::Case);
+    EXPECT_EQ(traces[0].term_at(traces[0].steps.size())->to_string(), term->to_string());
+}
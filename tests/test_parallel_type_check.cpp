@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TermGenerator.h"
+#include "../parser/Parser.h"
+#include "../engines/ParallelTypeCheck.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    // add (add ... ...) (add ... ...), 2^depth leaves, with `leaf` in the
+    // given position and 1 elsewhere.
+    std::unique_ptr<Term> balanced_sum(int depth, std::size_t& counter, std::size_t bad, const std::string& leaf) {
+        if (depth == 0) return parse_term(counter++ == bad ? leaf : "1");
+        auto left = balanced_sum(depth - 1, counter, bad, leaf);
+        auto right = balanced_sum(depth - 1, counter, bad, leaf);
+        return std::make_unique<Application>(
+            std::make_unique<Application>(std::make_unique<Primitive>(PrimitiveOp::Add), std::move(left)),
+            std::move(right)
+        );
+    }
+
+    std::unique_ptr<Term> balanced_sum(int depth, std::size_t bad = SIZE_MAX, const std::string& leaf = "1") {
+        std::size_t counter = 0;
+        return balanced_sum(depth, counter, bad, leaf);
+    }
+}
+
+TEST(WorkStealingPoolTest, RunsNestedForkJoin) {
+    WorkStealingPool pool(4);
+    std::atomic<int> leaves = 0;
+    std::function<void(int)> split = [&](int depth) {
+        if (depth == 0) {
+            ++leaves;
+            return;
+        }
+        WorkStealingPool::Task task([&] { split(depth - 1); });
+        pool.fork(task);
+        split(depth - 1);
+        pool.join(task);
+    };
+    split(10);
+    EXPECT_EQ(leaves, 1024);
+}
+
+TEST(WorkStealingPoolTest, JoinRethrowsWhatTheTaskThrew) {
+    WorkStealingPool pool(2);
+    WorkStealingPool::Task task([] { throw std::runtime_error("boom"); });
+    pool.fork(task);
+    EXPECT_THROW(pool.join(task), std::runtime_error);
+}
+
+TEST(ParallelTypeCheckTest, AgreesWithSequentialCheckOnGeneratedTerms) {
+    WorkStealingPool pool(4);
+    for (std::uint64_t seed = 0; seed < 10; ++seed) {
+        const auto term = TermGenerator(GeneratorOptions{.seed = seed, .size = 2000}).generate();
+        const auto checked = parallel_type_check(*term, pool, TypingContext(), 16);
+        ASSERT_TRUE(checked.has_value()) << "seed " << seed << ": " << checked.error().message();
+        EXPECT_EQ((*checked)->to_string(), (*try_type_check(*term))->to_string());
+    }
+}
+
+TEST(ParallelTypeCheckTest, ForksOnLargeBalancedTerms) {
+    WorkStealingPool pool(4);
+    const auto term = parse_term("λn: Nat. let k = add n 1 in " + balanced_sum(12)->to_string());
+    const auto checked = parallel_type_check(*term, pool, TypingContext(), 8);
+    ASSERT_TRUE(checked);
+    EXPECT_EQ((*checked)->to_string(), "Nat -> Nat");
+}
+
+TEST(ParallelTypeCheckTest, ReportsTheSameErrorAsTheSequentialCheck) {
+    WorkStealingPool pool(4);
+    const std::string leaves[] = {"true", "y", "(3 4)", "k"};
+    for (const auto& leaf : leaves) {
+        for (std::size_t bad : {0u, 700u, 2047u}) {
+            const auto term = parse_term("λf: Nat -> Nat. let k = f in " + balanced_sum(11, bad, leaf)->to_string());
+            const auto sequential = try_type_check(*term);
+            const auto parallel = parallel_type_check(*term, pool, TypingContext(), 4);
+            ASSERT_FALSE(sequential) << leaf;
+            ASSERT_FALSE(parallel) << leaf;
+            EXPECT_EQ(parallel.error().code, sequential.error().code) << leaf;
+            EXPECT_EQ(parallel.error().term, sequential.error().term) << leaf << " at " << bad;
+            EXPECT_EQ(parallel.error().message(), sequential.error().message()) << leaf;
+        }
+    }
+}
+
+TEST(ParallelTypeCheckTest, ReadsTheContextAndDefinitions) {
+    WorkStealingPool pool(3);
+    const BaseType nat("Nat");
+    TypingContext context;
+    context.add("n", &nat);
+    Definitions globals;
+    globals.define("inc", parse_term("λx: Nat. add x 1"));
+    const auto term = parse_term("inc (add n (" + balanced_sum(8)->to_string() + "))", &globals);
+    const auto checked = parallel_type_check(*term, pool, context, 4);
+    ASSERT_TRUE(checked);
+    EXPECT_EQ((*checked)->to_string(), "Nat");
+    EXPECT_FALSE(parallel_type_check(*parse_term("inc true", &globals), pool));
+}
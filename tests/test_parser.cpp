@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "../models/lambda.h"
+#include "../parser/Lexer.h"
+#include "../parser/Parser.h"
+
+using std::make_unique;
+
+TEST(LexerTest, TokenizesBinderSyntax) {
+    const std::string source = "λx:Nat -> Bool. (f) (x')";
+    const auto tokens = tokenize(source);
+    std::vector<TokenKind> kinds;
+    for (const auto& token : tokens) kinds.push_back(token.kind);
+    EXPECT_EQ(kinds, (std::vector<TokenKind>{
+        TokenKind::Lambda, TokenKind::Identifier, TokenKind::Colon, TokenKind::Identifier, TokenKind::Arrow,
+        TokenKind::Identifier, TokenKind::Dot, TokenKind::LParen, TokenKind::Identifier, TokenKind::RParen,
+        TokenKind::LParen, TokenKind::Identifier, TokenKind::RParen, TokenKind::End}));
+    EXPECT_EQ(token_text(source, tokens[11]), "x'");
+}
+
+TEST(LexerTest, RejectsStrayCharacter) {
+    EXPECT_THROW((void)tokenize("x ; y"), ParseError);
+}
+
+TEST(ParserTest, RoundTripsPrintedTerms) {
+    for (const std::string source : {
+        "λx. x",
+        "(λx. (x) (x)) (λx. (x) (x))",
+        "let id = λx. x in (id) (y)",
+        "(((if) (true)) (1)) (2)",
+    }) {
+        EXPECT_EQ(parse_term(source)->to_string(), source);
+    }
+}
+
+TEST(ParserTest, ApplicationIsLeftAssociative) {
+    EXPECT_EQ(parse_term("f x y")->to_string(), "((f) (x)) (y)");
+    EXPECT_EQ(parse_term("f λx. x y")->to_string(), "(f) (λx. (x) (y))");
+}
+
+TEST(ParserTest, AnnotationsReachBoundOccurrences) {
+    const auto term = parse_term("λf:Nat -> Nat. λx:Nat. f (f x)");
+    EXPECT_EQ(term->type_check(TypingContext())->to_string(), "(Nat -> Nat) -> (Nat -> Nat)");
+}
+
+TEST(ParserTest, ParsesLiteralsAndPrimitives) {
+    auto term = parse_term("if[Nat] (lt 2 3) (add 40 2) 0");
+    EXPECT_EQ(term->type_check(TypingContext())->to_string(), "Nat");
+    while (!term->is_normal()) term = beta_reduce(std::move(term));
+    EXPECT_EQ(term->to_string(), "42");
+}
+
+TEST(ParserTest, DefinedNamesBecomeReferences) {
+    Definitions definitions;
+    definitions.define("id", parse_term("λx:Nat. x"));
+    auto term = parse_term("id 7", &definitions);
+    EXPECT_EQ(term->to_string(), "(id) (7)");
+    EXPECT_EQ(term->type_check(TypingContext())->to_string(), "Nat");
+    // A binder shadows the definition.
+    EXPECT_TRUE(parse_term("λid. id", &definitions)->is_normal());
+}
+
+TEST(ParserTest, ParsesTypes) {
+    EXPECT_EQ(parse_type("(Nat -> Bool) -> Nat")->to_string(), "(Nat -> Bool) -> Nat");
+    EXPECT_EQ(parse_type("Nat -> Bool -> Nat")->to_string(), "Nat -> (Bool -> Nat)");
+}
+
+TEST(ParserTest, ReportsErrorPosition) {
+    try {
+        (void)parse_term("λx. (x");
+        FAIL();
+    } catch (const ParseError& error) {
+        EXPECT_EQ(error.position, 7u);
+    }
+    EXPECT_THROW((void)parse_term("x )"), ParseError);
+    EXPECT_THROW((void)parse_term(""), ParseError);
+}
+
+TEST(ParserTest, StreamExtraction) {
+    std::istringstream input("λx. x\n");
+    std::unique_ptr<Term> term;
+    input >> term;
+    ASSERT_NE(term, nullptr);
+    EXPECT_EQ(term->to_string(), "λx. x");
+}
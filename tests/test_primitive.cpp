@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TaggedTerm.h"
+#include "../models/TermTape.h"
+#include "../engines/ExplicitSubstitution.h"
+
+using std::make_unique;
+
+namespace {
+    std::unique_ptr<Term> app(std::unique_ptr<Term> function, std::unique_ptr<Term> value) {
+        return make_unique<Application>(std::move(function), std::move(value));
+    }
+
+    std::unique_ptr<Term> binary(PrimitiveOp op, std::unique_ptr<Term> lhs, std::unique_ptr<Term> rhs) {
+        return app(app(make_unique<Primitive>(op), std::move(lhs)), std::move(rhs));
+    }
+
+    std::unique_ptr<Term> normalize(std::unique_ptr<Term> term) {
+        while (!term->is_normal()) term = term->beta_reduce();
+        return term;
+    }
+}
+
+TEST(LiteralTest, ToStringAndType) {
+    TypingContext ctx;
+    EXPECT_EQ(Literal::nat(42)->to_string(), "42");
+    EXPECT_EQ(Literal::boolean(true)->to_string(), "true");
+    EXPECT_EQ(Literal::boolean(false)->to_string(), "false");
+    EXPECT_EQ(Literal::nat(0)->type_check(ctx)->to_string(), NAT_TYPE_NAME);
+    EXPECT_EQ(Literal::boolean(true)->type_check(ctx)->to_string(), BOOL_TYPE_NAME);
+}
+
+TEST(LiteralTest, IsNormalAndClosed) {
+    auto literal = Literal::nat(7);
+    EXPECT_TRUE(literal->is_normal());
+    EXPECT_FALSE(literal->has_free("x"));
+    EXPECT_THROW((void)literal->beta_reduce(), ReductionOnNormalForm);
+}
+
+TEST(PrimitiveTest, Types) {
+    TypingContext ctx;
+    EXPECT_EQ(Primitive(PrimitiveOp::Add).type_check(ctx)->to_string(), "Nat -> (Nat -> Nat)");
+    EXPECT_EQ(Primitive(PrimitiveOp::Lt).type_check(ctx)->to_string(), "Nat -> (Nat -> Bool)");
+    EXPECT_EQ(Primitive(PrimitiveOp::If, make_unique<BaseType>("Nat")).type_check(ctx)->to_string(),
+        "Bool -> (Nat -> (Nat -> Nat))");
+    EXPECT_THROW((void)Primitive(PrimitiveOp::If).type_check(ctx), TypeMismatchError);
+}
+
+TEST(PrimitiveTest, ArithmeticDeltaRules) {
+    EXPECT_EQ(normalize(binary(PrimitiveOp::Add, Literal::nat(2), Literal::nat(3)))->to_string(), "5");
+    EXPECT_EQ(normalize(binary(PrimitiveOp::Mul, Literal::nat(1000), Literal::nat(1000)))->to_string(), "1000000");
+    EXPECT_EQ(normalize(binary(PrimitiveOp::Sub, Literal::nat(2), Literal::nat(3)))->to_string(), "0");
+    EXPECT_EQ(normalize(binary(PrimitiveOp::Eq, Literal::nat(4), Literal::nat(4)))->to_string(), "true");
+    EXPECT_EQ(normalize(binary(PrimitiveOp::Lt, Literal::nat(4), Literal::nat(4)))->to_string(), "false");
+}
+
+TEST(PrimitiveTest, SingleDeltaStep) {
+    auto sum = binary(PrimitiveOp::Add, Literal::nat(2), Literal::nat(3));
+    EXPECT_FALSE(sum->is_normal());
+    EXPECT_EQ(sum->beta_reduce()->to_string(), "5");
+}
+
+TEST(PrimitiveTest, PartialApplicationIsNormal) {
+    auto partial = app(make_unique<Primitive>(PrimitiveOp::Add), Literal::nat(2));
+    EXPECT_TRUE(partial->is_normal());
+    auto stuck = binary(PrimitiveOp::Add, make_unique<Variable>("x"), Literal::nat(2));
+    EXPECT_TRUE(stuck->is_normal());
+}
+
+TEST(PrimitiveTest, ArgumentsReducedBeforeDelta) {
+    // add ((λx. x) 2) (mul 3 4)
+    auto term = binary(PrimitiveOp::Add,
+        app(make_unique<Abstraction>(make_unique<Variable>("x"), make_unique<Variable>("x")), Literal::nat(2)),
+        binary(PrimitiveOp::Mul, Literal::nat(3), Literal::nat(4)));
+    EXPECT_EQ(normalize(std::move(term))->to_string(), "14");
+}
+
+TEST(PrimitiveTest, IfSelectsBranchLazily) {
+    // if true 1 ((λx. x x) (λx. x x)) never touches the diverging branch
+    auto half = make_unique<Abstraction>(make_unique<Variable>("x"),
+        app(make_unique<Variable>("x"), make_unique<Variable>("x")));
+    auto half_copy = half->clone();
+    auto omega = app(std::move(half_copy), std::move(half));
+    auto term = app(app(app(make_unique<Primitive>(PrimitiveOp::If, make_unique<BaseType>("Nat")),
+        binary(PrimitiveOp::Lt, Literal::nat(1), Literal::nat(2))), Literal::nat(1)), std::move(omega));
+    EXPECT_EQ(normalize(std::move(term))->to_string(), "1");
+}
+
+TEST(PrimitiveTest, ConsumingReduction) {
+    std::unique_ptr<Term> term = app(app(app(make_unique<Primitive>(PrimitiveOp::If, make_unique<BaseType>("Nat")),
+        Literal::boolean(false)), Literal::nat(1)), Literal::nat(2));
+    EXPECT_EQ(beta_reduce(std::move(term))->to_string(), "2");
+
+    std::unique_ptr<Term> product = binary(PrimitiveOp::Mul, Literal::nat(6), Literal::nat(7));
+    EXPECT_EQ(beta_reduce(std::move(product))->to_string(), "42");
+}
+
+TEST(PrimitiveTest, TypeCheckApplications) {
+    TypingContext ctx;
+    EXPECT_EQ(binary(PrimitiveOp::Eq, Literal::nat(1), Literal::nat(2))->type_check(ctx)->to_string(), "Bool");
+    EXPECT_THROW((void)binary(PrimitiveOp::Add, Literal::boolean(true), Literal::nat(2))->type_check(ctx),
+        DomainTypeMismatchError);
+}
+
+TEST(PrimitiveTest, AlternateRepresentationsAgree) {
+    // λx. if (lt x 10) (add x 1) x, applied to 4
+    auto body = app(app(app(make_unique<Primitive>(PrimitiveOp::If, make_unique<BaseType>("Nat")),
+        binary(PrimitiveOp::Lt, make_unique<Variable>("x"), Literal::nat(10))),
+        binary(PrimitiveOp::Add, make_unique<Variable>("x"), Literal::nat(1))), make_unique<Variable>("x"));
+    auto term = app(make_unique<Abstraction>(make_unique<Variable>("x", make_unique<BaseType>("Nat")), std::move(body)),
+        Literal::nat(4));
+    TypingContext ctx;
+
+    auto tagged = to_tagged(*term);
+    EXPECT_EQ(to_string(*tagged), term->to_string());
+    EXPECT_EQ(to_string(*type_check(*tagged, ctx)), "Nat");
+    while (!is_normal(*tagged)) tagged = beta_reduce(*tagged);
+    EXPECT_EQ(to_string(*tagged), "5");
+
+    TermTape tape(*term);
+    EXPECT_EQ(tape.to_string(), term->to_string());
+    EXPECT_FALSE(tape.is_normal());
+    EXPECT_TRUE(TermTape(*binary(PrimitiveOp::Add, make_unique<Variable>("y"), Literal::nat(1))).is_normal());
+    EXPECT_FALSE(TermTape(*binary(PrimitiveOp::Add, Literal::nat(2), Literal::nat(1))).is_normal());
+    EXPECT_EQ(tape.type_check(ctx)->to_string(), "Nat");
+    EXPECT_EQ(tape.to_term()->to_string(), term->to_string());
+
+    ExplicitSubstitutionEngine engine(*term);
+    EXPECT_EQ(engine.normalize()->to_string(), "5");
+    EXPECT_EQ(engine.stats().delta_steps, 3u);
+
+    EXPECT_EQ(normalize(std::move(term))->to_string(), "5");
+}
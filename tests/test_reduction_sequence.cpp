@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../parser/Parser.h"
+#include "../engines/ReductionSequence.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+    std::vector<std::string> reduce_eagerly(std::unique_ptr<Term> term) {
+        std::vector<std::string> steps{term->to_string()};
+        while (!term->is_normal()) {
+            term = ::beta_reduce(std::move(term));
+            steps.push_back(term->to_string());
+        }
+        return steps;
+    }
+}
+
+TEST(ReductionSequenceTest, YieldsEveryIntermediateTerm) {
+    const std::string source = "(λf. λx. f (f x)) (λy. y) z";
+    std::vector<std::string> seen;
+    std::size_t expected_index = 0;
+    for (const auto& step : reduction_sequence(parse_term(source))) {
+        EXPECT_EQ(step.index, expected_index++);
+        seen.push_back(step.term.to_string());
+    }
+    EXPECT_EQ(seen, reduce_eagerly(parse_term(source)));
+    EXPECT_EQ(seen.back(), "z");
+}
+
+TEST(ReductionSequenceTest, LastStepIsMarkedNormal) {
+    auto steps = reduction_sequence(parse_term("(λx. x) y"));
+    const auto* first = steps.next();
+    ASSERT_NE(first, nullptr);
+    EXPECT_FALSE(first->normal);
+    const auto* second = steps.next();
+    ASSERT_NE(second, nullptr);
+    EXPECT_TRUE(second->normal);
+    EXPECT_EQ(second->term.to_string(), "y");
+    EXPECT_EQ(steps.next(), nullptr);
+    EXPECT_TRUE(steps.done());
+}
+
+TEST(ReductionSequenceTest, NormalFormYieldsOnce) {
+    std::size_t count = 0;
+    for (const auto& step : reduction_sequence(parse_term("λx. x"))) {
+        EXPECT_TRUE(step.normal);
+        ++count;
+    }
+    EXPECT_EQ(count, 1u);
+}
+
+TEST(ReductionSequenceTest, StopsEarlyOnDivergentTerm) {
+    // Ω never terminates; only the requested prefix is ever computed.
+    std::size_t count = 0;
+    for (const auto& step : reduction_sequence(parse_term("(λx. x x) (λx. x x)"))) {
+        EXPECT_FALSE(step.normal);
+        if (++count == 100) break;
+    }
+    EXPECT_EQ(count, 100u);
+}
+
+TEST(ReductionSequenceTest, ResumesWhereItStopped) {
+    const std::string source = "(λa. λb. λc. a b c) (λx. x) (λx. x) w";
+    const auto expected = reduce_eagerly(parse_term(source));
+    ASSERT_GE(expected.size(), 4u);
+
+    auto steps = reduction_sequence(parse_term(source));
+    std::vector<std::string> seen;
+    for (const auto& step : steps) {
+        seen.push_back(step.term.to_string());
+        if (step.index == 1) break;
+    }
+    // A second loop picks up at the step the first one stopped on.
+    bool first = true;
+    for (const auto& step : steps) {
+        if (first) {
+            EXPECT_EQ(step.index, 1u);
+            first = false;
+            continue;
+        }
+        seen.push_back(step.term.to_string());
+    }
+    EXPECT_EQ(seen, expected);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../parser/Parser.h"
+#include "../engines/BoundedEvaluation.h"
+#include "../engines/ReductionTrace.h"
+#include "../pipeline/BatchPipeline.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::vector<ReductionTrace> round_trip(const std::vector<const TraceRecorder*>& recorders) {
+        std::stringstream file;
+        write_trace_header(file);
+        for (const auto* recorder : recorders) write_trace(file, *recorder);
+        return read_traces(file);
+    }
+
+    std::vector<std::string> eager_steps(std::unique_ptr<Term> term) {
+        std::vector<std::string> steps{term->to_string()};
+        while (!term->is_normal()) {
+            term = ::beta_reduce(std::move(term));
+            steps.push_back(term->to_string());
+        }
+        return steps;
+    }
+}
+
+TEST(ReductionTraceTest, ReplayRebuildsEveryIntermediateTerm) {
+    const std::string source = "(λf. λx. f (f x)) (λy. add y 1) 3";
+    TraceRecorder recorder("example");
+    const auto result = evaluate(parse_term(source), ResourcePolicy{.trace = &recorder});
+    ASSERT_EQ(result.status, EvaluationStatus::Normal);
+    EXPECT_EQ(recorder.steps(), result.steps);
+
+    const auto traces = round_trip({&recorder});
+    ASSERT_EQ(traces.size(), 1u);
+    const auto& trace = traces[0];
+    EXPECT_EQ(trace.label, "example");
+    ASSERT_EQ(trace.steps.size(), result.steps);
+
+    const auto expected = eager_steps(parse_term(source));
+    for (std::size_t i = 0; i <= trace.steps.size(); ++i) {
+        EXPECT_EQ(trace.term_at(i)->to_string(), expected[i]) << "step " << i;
+    }
+    EXPECT_EQ(trace.term_at(trace.steps.size())->to_string(), "5");
+}
+
+TEST(ReductionTraceTest, StepsRecordRuleBinderAndPath) {
+    TraceRecorder recorder;
+    (void)evaluate(parse_term("λz. z ((λx. x) y)"), ResourcePolicy{.trace = &recorder});
+    const auto traces = round_trip({&recorder});
+    ASSERT_EQ(traces[0].steps.size(), 1u);
+    const auto& step = traces[0].steps[0];
+    EXPECT_EQ(step.rule, RedexRule::Beta);
+    EXPECT_EQ(step.binder, "x");
+    EXPECT_EQ(path_to_string(step.path), "a");
+    EXPECT_EQ(step.argument, alpha_hash(*parse_term("y")));
+}
+
+TEST(ReductionTraceTest, DeltaLetAndUnfoldSteps) {
+    Definitions globals;
+    globals.define("inc", parse_term("λn. add n 1"));
+    TraceRecorder recorder;
+    (void)evaluate(parse_term("let x = 4 in inc x", &globals), ResourcePolicy{.trace = &recorder});
+    const auto traces = round_trip({&recorder});
+    const auto& trace = traces[0];
+    std::vector<RedexRule> rules;
+    for (const auto& step : trace.steps) rules.push_back(step.rule);
+    EXPECT_EQ(rules, (std::vector{RedexRule::Let, RedexRule::Unfold, RedexRule::Beta, RedexRule::Delta}));
+    EXPECT_EQ(trace.steps[1].binder, "inc");
+    EXPECT_EQ(trace.term_at(trace.steps.size())->to_string(), "5");
+}
+
+TEST(ReductionTraceTest, StepsAreSmallerThanPrintedTerms) {
+    const std::string source = "(λm. λn. λf. m (n f)) (λf. λx. f (f (f x))) (λf. λx. f (f (f x)))";
+    TraceRecorder recorder;
+    const auto result = evaluate(parse_term(source), ResourcePolicy{.trace = &recorder});
+    std::size_t printed = 0;
+    for (const auto& term : eager_steps(parse_term(source))) printed += term.size();
+    EXPECT_LT(recorder.bytes().size() * 4, printed);
+    EXPECT_GT(result.steps, 5u);
+}
+
+TEST(ReductionTraceTest, StoppedReductionKeepsItsPrefix) {
+    TraceRecorder recorder;
+    const auto result = evaluate(parse_term("(λx. x x) (λx. x x)"), ResourcePolicy{.max_steps = 10, .trace = &recorder});
+    EXPECT_EQ(result.status, EvaluationStatus::Steps);
+    const auto traces = round_trip({&recorder});
+    EXPECT_EQ(traces[0].steps.size(), 10u);
+    EXPECT_EQ(traces[0].term_at(10)->to_string(), result.term->to_string());
+}
+
+TEST(ReductionTraceTest, TamperedStepIsRejected) {
+    TraceRecorder recorder;
+    (void)evaluate(parse_term("(λx. x) ((λy. y) z)"), ResourcePolicy{.trace = &recorder});
+    auto traces = round_trip({&recorder});
+    traces[0].steps[0].binder = "y";
+    EXPECT_THROW((void)traces[0].term_at(1), TraceFormatError);
+
+    std::stringstream garbage("LTRX\x01");
+    EXPECT_THROW((void)read_traces(garbage), TraceFormatError);
+    std::stringstream truncated;
+    write_trace_header(truncated);
+    write_trace(truncated, recorder);
+    const auto bytes = truncated.str();
+    std::stringstream cut(bytes.substr(0, bytes.size() - 3));
+    EXPECT_THROW((void)read_traces(cut), TermFormatError);
+}
+
+TEST(ReductionTraceTest, PipelineAppendsOneTracePerTerm) {
+    const auto path = std::filesystem::temp_directory_path() / "lambda_trace_test.bin";
+    std::filesystem::remove(path);
+    for (int run = 0; run < 2; ++run) {
+        BatchPipeline pipeline(BatchOptions{.workers = 2, .trace_path = path.string()});
+        std::istringstream input("(λx. x) a\n\nadd 2 3\n");
+        std::ostringstream output;
+        (void)pipeline.run(input, output);
+    }
+    std::ifstream file(path, std::ios::binary);
+    const auto traces = read_traces(file);
+    ASSERT_EQ(traces.size(), 4u);
+    std::vector<std::string> labels;
+    for (const auto& trace : traces) {
+        labels.push_back(trace.label);
+        EXPECT_TRUE(trace.term_at(trace.steps.size())->is_normal());
+    }
+    std::sort(labels.begin(), labels.end());
+    EXPECT_EQ(labels, (std::vector<std::string>{"line 1", "line 1", "line 3", "line 3"}));
+    std::filesystem::remove(path);
+}
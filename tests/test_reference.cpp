@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TaggedTerm.h"
+#include "../models/TermTape.h"
+#include "../engines/ExplicitSubstitution.h"
+
+using std::make_unique;
+
+class ReferenceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        definitions.define("id", make_unique<Abstraction>(
+            make_unique<Variable>("x", make_unique<BaseType>("Nat")),
+            make_unique<Variable>("x", make_unique<BaseType>("Nat"))
+        ));
+        // twice = λf. λx. f (f x), using no other definitions
+        auto nat_to_nat = make_unique<FunctionType>(make_unique<BaseType>("Nat"), make_unique<BaseType>("Nat"));
+        definitions.define("twice", make_unique<Abstraction>(
+            nat_to_nat->clone(), "f",
+            make_unique<Abstraction>(make_unique<BaseType>("Nat"), "x",
+                make_unique<Application>(
+                    make_unique<Variable>("f"),
+                    make_unique<Application>(make_unique<Variable>("f"), make_unique<Variable>("x"))
+                ))));
+    }
+
+    Definitions definitions;
+};
+
+TEST_F(ReferenceTest, DefineAndLookup) {
+    EXPECT_EQ(definitions.size(), 2u);
+    ASSERT_NE(definitions.lookup("id"), nullptr);
+    EXPECT_EQ(definitions.lookup("missing"), nullptr);
+    EXPECT_THROW((void)definitions.reference("missing"), UndeclaredVariableError);
+}
+
+TEST_F(ReferenceTest, RejectsDuplicatesAndOpenBodies) {
+    EXPECT_THROW(definitions.define("id", make_unique<Variable>("z")), DuplicateDefinitionError);
+    EXPECT_THROW(definitions.define("open", make_unique<Variable>("z")), UndeclaredVariableError);
+}
+
+TEST_F(ReferenceTest, ReferenceIsFoldedUntilReduced) {
+    auto ref = definitions.reference("id");
+    EXPECT_EQ(ref->to_string(), "id");
+    EXPECT_FALSE(ref->is_normal());
+    EXPECT_FALSE(ref->has_free("x"));
+    EXPECT_EQ(ref->beta_reduce()->to_string(), "λx. x");
+}
+
+TEST_F(ReferenceTest, HeadIsUnfoldedOnDemand) {
+    // (twice id) 3
+    std::unique_ptr<Term> term = make_unique<Application>(
+        make_unique<Application>(definitions.reference("twice"), definitions.reference("id")),
+        Literal::nat(3)
+    );
+    term = term->beta_reduce();
+    EXPECT_EQ(term->to_string(), "((λf. λx. (f) ((f) (x))) (id)) (3)");
+    while (!term->is_normal()) term = beta_reduce(std::move(term));
+    EXPECT_EQ(term->to_string(), "3");
+}
+
+TEST_F(ReferenceTest, TypeIsCheckedOnceAndCached) {
+    const auto definition = definitions.lookup("twice");
+    const Type& first = definition->type();
+    const Type& second = definition->type();
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(first.to_string(), "(Nat -> Nat) -> (Nat -> Nat)");
+
+    TypingContext ctx;
+    Application app(definitions.reference("twice"), definitions.reference("id"));
+    EXPECT_EQ(app.type_check(ctx)->to_string(), "Nat -> Nat");
+}
+
+TEST_F(ReferenceTest, AlternateRepresentations) {
+    Application app(
+        make_unique<Application>(definitions.reference("twice"), definitions.reference("id")),
+        Literal::nat(3)
+    );
+    TypingContext ctx;
+
+    auto tagged = to_tagged(app);
+    EXPECT_EQ(to_string(*tagged), app.to_string());
+    EXPECT_EQ(to_string(*type_check(*tagged, ctx)), "Nat");
+    while (!is_normal(*tagged)) tagged = beta_reduce(*tagged);
+    EXPECT_EQ(to_string(*tagged), "3");
+
+    TermTape tape(app);
+    EXPECT_EQ(tape.definitions().size(), 2u);
+    EXPECT_EQ(tape.to_string(), app.to_string());
+    EXPECT_FALSE(tape.is_normal());
+    EXPECT_EQ(tape.type_check(ctx)->to_string(), "Nat");
+    EXPECT_EQ(tape.to_term()->to_string(), app.to_string());
+
+    ExplicitSubstitutionEngine engine(app);
+    EXPECT_EQ(engine.normalize()->to_string(), "3");
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/SharedTerm.h"
+#include "../models/TermGenerator.h"
+#include "../parser/Parser.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::string shared_normal_form(const std::string& source, const Definitions* definitions = nullptr) {
+    std::size_t steps = 0;
+    return to_string(*normalize(to_shared(*parse_term(source, definitions)), steps));
+}
+
+// The Term baseline, one ::beta_reduce at a time.
+std::unique_ptr<Term> term_normalize(std::unique_ptr<Term> term, std::size_t& steps) {
+    while (!term->is_normal()) {
+        term = ::beta_reduce(std::move(term));
+        ++steps;
+    }
+    return term;
+}
+
+std::string term_normal_form(const std::string& source, const Definitions* definitions = nullptr) {
+    std::size_t steps = 0;
+    return term_normalize(parse_term(source, definitions), steps)->to_string();
+}
+
+}
+
+TEST(SharedTermTest, RoundTripPreservesTermAndTypes) {
+    const auto term = parse_term("λf:Nat->Bool. λx:Nat. let y = add x 1 in if [Bool] (f y) true (eq y 0)");
+    const auto shared = to_shared(*term);
+    EXPECT_EQ(to_string(*shared), term->to_string());
+    EXPECT_EQ(from_shared(*shared)->to_string(), term->to_string());
+    EXPECT_EQ(alpha_hash(*from_shared(*shared)), alpha_hash(*term));
+    EXPECT_EQ(from_shared(*shared)->type_check({})->to_string(), term->type_check({})->to_string());
+}
+
+TEST(SharedTermTest, CopiesShareTheNode) {
+    const auto shared = to_shared(*parse_term("λx. λy. x y"));
+    EXPECT_EQ(shared.use_count(), 1u);
+    {
+        const auto copy = shared;
+        EXPECT_EQ(copy, shared);
+        EXPECT_EQ(shared.use_count(), 2u);
+    }
+    EXPECT_EQ(shared.use_count(), 1u);
+}
+
+TEST(SharedTermTest, SubstitutionSharesUntouchedSubtrees) {
+    const auto term = to_shared(*parse_term("(λa. λb. a b) (x (λc. c))"));
+    const auto value = SharedTerm::literal(LiteralKind::Nat, 7);
+    EXPECT_EQ(substitute(term, "z", value), term);
+
+    const auto replaced = substitute(term, "x", value);
+    EXPECT_EQ(to_string(*replaced), "(λa. λb. (a) (b)) ((7) (λc. c))");
+    EXPECT_EQ(replaced->left(), term->left());
+    EXPECT_EQ(replaced->right()->left(), value);
+    EXPECT_EQ(replaced->right()->right(), term->right()->right());
+}
+
+TEST(SharedTermTest, StepsShareTheUnreducedSibling) {
+    const auto term = to_shared(*parse_term("((λx. x) y) (λz. (λw. w) z)"));
+    const auto reduced = beta_reduce(term);
+    EXPECT_EQ(to_string(*reduced), "(y) (λz. (λw. w) (z))");
+    EXPECT_EQ(reduced->right(), term->right());
+    EXPECT_FALSE(reduced->is_normal());
+
+    // The argument is spliced in without being copied.
+    const auto duplicate = to_shared(*parse_term("(λx. x x) (λy. y)"));
+    const auto doubled = beta_reduce(duplicate);
+    EXPECT_EQ(doubled->left(), duplicate->right());
+    EXPECT_EQ(doubled->right(), duplicate->right());
+    EXPECT_EQ(distinct_nodes(*doubled), 3u);
+}
+
+TEST(SharedTermTest, RenamesBindersLikeTerm) {
+    for (const auto* source : {
+        "(λx. λy. x) y",
+        "(λx. λy. λy'. x y y') (y y')",
+        "(λx. let y = x in y x) (y 1)",
+        "(λf. λx. f (f x)) (λx. λy. x)",
+    }) {
+        EXPECT_EQ(shared_normal_form(source), term_normal_form(source)) << source;
+    }
+}
+
+TEST(SharedTermTest, NormalFormsMatchTerm) {
+    Definitions definitions;
+    definitions.define("double", parse_term("λn:Nat. add n n"));
+    definitions.define("twice", parse_term("λf:Nat->Nat. λx:Nat. f (f x)", &definitions));
+    for (const auto* source : {
+        "twice double 5",
+        "(λm. λn. λf. m (n f)) (λf. λx. f (f (f x))) (λf. λx. f (f x))",
+        "if [Nat] (lt 2 3) (mul 6 7) (sub 1 2)",
+        "let k = λx. λy. x in k 1 (k true 2)",
+    }) {
+        EXPECT_EQ(shared_normal_form(source, &definitions), term_normal_form(source, &definitions)) << source;
+    }
+}
+
+TEST(SharedTermTest, GeneratedTermsNormalizeLikeTerm) {
+    for (std::uint64_t seed = 0; seed < 200; ++seed) {
+        GeneratorOptions options;
+        options.seed = seed;
+        options.size = 60;
+        options.redex_density = 0.3;
+        const auto term = TermGenerator(options).generate();
+        std::size_t term_steps = 0;
+        std::size_t shared_steps = 0;
+        const auto expected = term_normalize(term->clone(), term_steps);
+        const auto shared = normalize(to_shared(*term), shared_steps);
+        ASSERT_EQ(to_string(*shared), expected->to_string()) << term->to_string();
+        EXPECT_EQ(shared_steps, term_steps);
+        EXPECT_TRUE(shared->is_normal());
+    }
+}
+
+TEST(SharedTermTest, NormalFormsThrowOnStep) {
+    EXPECT_THROW((void)beta_reduce(to_shared(*parse_term("λx. x 1"))), ReductionOnNormalForm);
+}
+
+TEST(SharedTermTest, ReleasesDeepTermsWithoutRecursion) {
+    const auto nat = std::make_shared<const BaseType>("Nat");
+    auto term = SharedTerm::variable("x", nat);
+    for (int i = 0; i < 1'000'000; ++i) term = SharedTerm::abstraction("x", nat, std::move(term));
+    const auto kept = term->left()->left();
+    term = SharedTermPtr();
+    EXPECT_EQ(kept.use_count(), 1u);
+}
+
+TEST(SharedTermTest, CopiesAcrossThreads) {
+    const auto term = to_shared(*parse_term("λf. λx. f (f (f x))"));
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([term] {
+            for (int i = 0; i < 10000; ++i) {
+                const auto copy = term->left();
+                EXPECT_TRUE(copy->is_normal());
+            }
+        });
+    }
+    threads.clear();
+    EXPECT_EQ(term.use_count(), 1u);
+}
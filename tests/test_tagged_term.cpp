@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TaggedTerm.h"
+#include "../engines/ExplicitSubstitution.h"
+
+using std::make_unique;
+
+class TaggedTermTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // (λx. (f) (x)) (y) with f : Int -> Bool, x, y : Int
+        redex = make_unique<Application>(
+            make_unique<Abstraction>(
+                make_unique<Variable>("x", make_unique<BaseType>("Int")),
+                make_unique<Application>(
+                    make_unique<Variable>("f"),
+                    make_unique<Variable>("x", make_unique<BaseType>("Int"))
+                )
+            ),
+            make_unique<Variable>("y", make_unique<BaseType>("Int"))
+        );
+        f_type = make_unique<FunctionType>(make_unique<BaseType>("Int"), make_unique<BaseType>("Bool"));
+        int_type = make_unique<BaseType>("Int");
+        context.add("f", f_type.get());
+        context.add("y", int_type.get());
+    }
+
+    std::unique_ptr<Application> redex;
+    std::unique_ptr<FunctionType> f_type;
+    std::unique_ptr<BaseType> int_type;
+    TypingContext context;
+};
+
+TEST_F(TaggedTermTest, KindsFollowVariantOrder) {
+    auto tagged = to_tagged(*redex);
+    EXPECT_EQ(tagged->kind(), TermKind::Application);
+    EXPECT_EQ(tagged->as<ApplicationNode>().function->kind(), TermKind::Abstraction);
+    EXPECT_EQ(tagged->as<ApplicationNode>().value->kind(), TermKind::Variable);
+}
+
+TEST_F(TaggedTermTest, RoundTripPreservesTermAndTypes) {
+    auto back = from_tagged(*to_tagged(*redex));
+    EXPECT_EQ(back->to_string(), redex->to_string());
+    auto* app = dynamic_cast<Application*>(back.get());
+    ASSERT_NE(app, nullptr);
+    auto* abs = dynamic_cast<Abstraction*>(app->function.get());
+    ASSERT_NE(abs, nullptr);
+    EXPECT_EQ(abs->var_type->to_string(), "Int");
+}
+
+TEST_F(TaggedTermTest, TypeRoundTrip) {
+    FunctionType nested(
+        make_unique<FunctionType>(make_unique<BaseType>("Int"), make_unique<BaseType>("Bool")),
+        make_unique<BaseType>("Int")
+    );
+    auto tagged = to_tagged(nested);
+    EXPECT_EQ(tagged->kind(), TypeKind::Function);
+    EXPECT_EQ(to_string(*tagged), nested.to_string());
+    EXPECT_EQ(from_tagged(*tagged)->to_string(), nested.to_string());
+}
+
+TEST_F(TaggedTermTest, AnalysesMatchHierarchy) {
+    auto tagged = to_tagged(*redex);
+    EXPECT_EQ(to_string(*tagged), redex->to_string());
+    EXPECT_EQ(is_normal(*tagged), redex->is_normal());
+    EXPECT_EQ(has_free(*tagged, "f"), redex->has_free("f"));
+    EXPECT_EQ(has_free(*tagged, "x"), redex->has_free("x"));
+}
+
+TEST_F(TaggedTermTest, BetaReduceMatchesHierarchy) {
+    auto tagged = to_tagged(*redex);
+    std::unique_ptr<Term> reference = redex->clone();
+    while (!reference->is_normal()) {
+        reference = reference->beta_reduce();
+        tagged = beta_reduce(*tagged);
+        EXPECT_EQ(to_string(*tagged), reference->to_string());
+    }
+    EXPECT_THROW((void)beta_reduce(*tagged), ReductionOnNormalForm);
+}
+
+TEST_F(TaggedTermTest, TypeCheck) {
+    auto type = type_check(*to_tagged(*redex), context);
+    EXPECT_EQ(to_string(*type), "Bool");
+}
+
+TEST_F(TaggedTermTest, TypeCheck_Errors) {
+    auto not_a_function = to_tagged(Application(make_unique<Variable>("y"), make_unique<Variable>("y")));
+    EXPECT_THROW((void)type_check(*not_a_function, context), NotAFunctionError);
+
+    auto mismatch = to_tagged(Application(make_unique<Variable>("f"), make_unique<Variable>("f")));
+    EXPECT_THROW((void)type_check(*mismatch, context), DomainTypeMismatchError);
+
+    auto undeclared = to_tagged(Variable("nope"));
+    EXPECT_THROW((void)type_check(*undeclared, context), UndeclaredVariableError);
+}
+
+TEST_F(TaggedTermTest, EnginesAcceptTaggedInput) {
+    ExplicitSubstitutionEngine engine(*to_tagged(*redex));
+    EXPECT_EQ(engine.normalize()->to_string(), "(f) (y)");
+}
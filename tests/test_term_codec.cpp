@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TermCodec.h"
+#include "../models/TermGenerator.h"
+#include "../parser/Parser.h"
+
+TEST(TermCodecTest, RoundTripsEveryKind) {
+    const auto term = parse_term("let k = λx: Nat. λy: Bool. x in (λf: Nat -> Nat. f 3) (λn: Nat. if[Nat] (lt n 2) (k n true) (mul n 7))");
+    const auto decoded = decode_term(encode_term(*term));
+    EXPECT_EQ(decoded->to_string(), term->to_string());
+    EXPECT_EQ(decoded->type_check(TypingContext())->to_string(), term->type_check(TypingContext())->to_string());
+    EXPECT_EQ(alpha_hash(*decoded), alpha_hash(*term));
+}
+
+TEST(TermCodecTest, RoundTripsGeneratedTerms) {
+    for (std::uint64_t seed = 0; seed < 20; ++seed) {
+        const auto term = TermGenerator(GeneratorOptions{.seed = seed, .size = 300}).generate();
+        EXPECT_EQ(decode_term(encode_term(*term))->to_string(), term->to_string()) << "seed " << seed;
+    }
+}
+
+TEST(TermCodecTest, RepeatedNamesAreWrittenOnce) {
+    const auto term = parse_term("λlongname. longname longname longname longname");
+    EXPECT_LT(encode_term(*term).size(), 2 * std::string("longname").size() + 24);
+}
+
+TEST(TermCodecTest, ReferencesNeedRegisteredDefinitions) {
+    Definitions globals;
+    globals.define("id", parse_term("λx. x"));
+    const auto term = parse_term("id y", &globals);
+    EXPECT_THROW((void)encode_term(*term), std::invalid_argument);
+}
+
+TEST(TermCodecTest, MalformedInputThrows) {
+    const auto bytes = encode_term(*parse_term("(λx. x) y"));
+    EXPECT_THROW((void)decode_term(bytes.substr(0, bytes.size() - 1)), TermFormatError);
+    EXPECT_THROW((void)decode_term(bytes + "x"), TermFormatError);
+    EXPECT_THROW((void)decode_term(std::string("\x01\x09", 2)), TermFormatError);
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TermGenerator.h"
+#include "../engines/BoundedEvaluation.h"
+
+TEST(TermGeneratorTest, TermsAreWellTypedAtRequestedType) {
+    for (std::uint64_t seed = 0; seed < 50; ++seed) {
+        TermGenerator generator(GeneratorOptions{.seed = seed, .size = 200});
+        const auto type = generator.random_type();
+        const auto term = generator.generate(*type);
+        EXPECT_EQ(term->type_check(TypingContext())->to_string(), type->to_string()) << "seed " << seed;
+    }
+}
+
+TEST(TermGeneratorTest, SameSeedSameTerm) {
+    const GeneratorOptions options{.seed = 42, .size = 500};
+    EXPECT_EQ(TermGenerator(options).generate()->to_string(), TermGenerator(options).generate()->to_string());
+    EXPECT_NE(TermGenerator(options).generate()->to_string(),
+              TermGenerator(GeneratorOptions{.seed = 43, .size = 500}).generate()->to_string());
+}
+
+TEST(TermGeneratorTest, SizeTracksTarget) {
+    for (const std::size_t size : {1'000u, 20'000u}) {
+        TermGenerator generator(GeneratorOptions{.seed = 7, .size = size});
+        const auto nodes = generator.generate()->measure().nodes;
+        EXPECT_GT(nodes, size / 4) << size;
+        EXPECT_LT(nodes, size * 4) << size;
+    }
+}
+
+TEST(TermGeneratorTest, DepthLimitCapsSize) {
+    // At most four children per node and depth 6, so a huge budget cannot
+    // be spent.
+    TermGenerator generator(GeneratorOptions{.seed = 3, .size = 1'000'000, .max_depth = 6, .type_depth = 1});
+    const auto term = generator.generate();
+    EXPECT_LT(term->measure().nodes, 50'000u);
+    EXPECT_NO_THROW((void)term->type_check(TypingContext()));
+}
+
+TEST(TermGeneratorTest, ZeroRedexDensityGivesNormalForms) {
+    for (std::uint64_t seed = 0; seed < 20; ++seed) {
+        TermGenerator generator(GeneratorOptions{
+            .seed = seed, .size = 300, .redex_density = 0, .primitives = false, .lets = false});
+        EXPECT_TRUE(generator.generate()->is_normal()) << "seed " << seed;
+    }
+}
+
+TEST(TermGeneratorTest, RedexesNormalizeOnFastPath) {
+    TermGenerator generator(GeneratorOptions{.seed = 11, .size = 300, .redex_density = 0.3});
+    const auto result = evaluate_type_directed(generator.generate(), ResourcePolicy{});
+    EXPECT_TRUE(result.unguarded);
+    EXPECT_EQ(result.status, EvaluationStatus::Normal);
+    EXPECT_GT(result.steps, 0u);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "../models/lambda.h"
+#include "../models/TermTape.h"
+
+using std::make_unique;
+
+class TermTapeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // λx. (λy. (f) (y)) (x), binder types Int
+        term = make_unique<Abstraction>(
+            make_unique<Variable>("x", make_unique<BaseType>("Int")),
+            make_unique<Application>(
+                make_unique<Abstraction>(
+                    make_unique<Variable>("y", make_unique<BaseType>("Int")),
+                    make_unique<Application>(make_unique<Variable>("f"), make_unique<Variable>("y"))
+                ),
+                make_unique<Variable>("x")
+            )
+        );
+        f_type = make_unique<FunctionType>(make_unique<BaseType>("Int"), make_unique<BaseType>("Bool"));
+        context.add("f", f_type.get());
+    }
+
+    std::unique_ptr<Term> term;
+    std::unique_ptr<FunctionType> f_type;
+    TypingContext context;
+};
+
+TEST_F(TermTapeTest, PostOrderLayout) {
+    TermTape tape(*term);
+    const auto& nodes = tape.nodes();
+    ASSERT_EQ(tape.size(), 7u);
+    EXPECT_EQ(nodes[tape.root()].kind, TermKind::Abstraction);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].kind == TermKind::Application) {
+            EXPECT_LT(nodes[i].left, i);
+            EXPECT_LT(nodes[i].right, i);
+        } else if (nodes[i].kind == TermKind::Abstraction) {
+            EXPECT_LT(nodes[i].left, i);
+        }
+    }
+}
+
+TEST_F(TermTapeTest, VariablesLinkToBinders) {
+    TermTape tape(*term);
+    for (const auto& node : tape.nodes()) {
+        if (node.kind != TermKind::Variable) continue;
+        const auto& name = tape.names()[node.name];
+        if (name == "f") {
+            EXPECT_EQ(node.left, TermTape::npos);
+        } else {
+            ASSERT_NE(node.left, TermTape::npos);
+            EXPECT_EQ(tape.names()[tape.nodes()[node.left].name], name);
+        }
+    }
+}
+
+TEST_F(TermTapeTest, AnalysesMatchHierarchy) {
+    TermTape tape(*term);
+    EXPECT_EQ(tape.to_string(), term->to_string());
+    EXPECT_EQ(tape.is_normal(), term->is_normal());
+    EXPECT_EQ(tape.has_free("f"), term->has_free("f"));
+    EXPECT_EQ(tape.has_free("x"), term->has_free("x"));
+    EXPECT_FALSE(tape.has_free("unused"));
+}
+
+TEST_F(TermTapeTest, ShadowedBinderIsNotFree) {
+    // (λx. x) (x): x is free through the argument only
+    Application app(
+        make_unique<Abstraction>(make_unique<Variable>("x"), make_unique<Variable>("x")),
+        make_unique<Variable>("x")
+    );
+    TermTape tape(app);
+    EXPECT_TRUE(tape.has_free("x"));
+    EXPECT_FALSE(TermTape(*app.function).has_free("x"));
+}
+
+TEST_F(TermTapeTest, TypeCheck) {
+    TermTape tape(*term);
+    EXPECT_EQ(tape.type_check(context)->to_string(), term->type_check(context)->to_string());
+    EXPECT_EQ(tape.type_check(context)->to_string(), "Int -> Bool");
+}
+
+TEST_F(TermTapeTest, TypeCheck_Errors) {
+    Application not_a_function(make_unique<Variable>("x"), make_unique<Variable>("x"));
+    auto int_type = make_unique<BaseType>("Int");
+    context.add("x", int_type.get());
+    EXPECT_THROW((void)TermTape(not_a_function).type_check(context), NotAFunctionError);
+
+    Application mismatch(make_unique<Variable>("f"), make_unique<Variable>("f"));
+    EXPECT_THROW((void)TermTape(mismatch).type_check(context), DomainTypeMismatchError);
+
+    EXPECT_THROW((void)TermTape(Variable("nope")).type_check(context), UndeclaredVariableError);
+}
+
+TEST_F(TermTapeTest, RoundTrip) {
+    TermTape tape(*term);
+    auto back = tape.to_term();
+    EXPECT_EQ(back->to_string(), term->to_string());
+    auto* abs = dynamic_cast<Abstraction*>(back.get());
+    ASSERT_NE(abs, nullptr);
+    EXPECT_EQ(abs->var_type->to_string(), "Int");
+}
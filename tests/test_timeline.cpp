@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "../models/Timeline.h"
+#include "../models/lambda.h"
+#include "../parser/Parser.h"
+#include "../engines/Diagnostics.h"
+#include "../engines/ParallelTypeCheck.h"
+#include "../engines/WorkStealingPool.h"
+#include "../pipeline/BatchPipeline.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+    std::size_t count(const std::string& text, const std::string& needle) {
+        std::size_t total = 0;
+        for (auto at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) ++total;
+        return total;
+    }
+}
+
+TEST(TimelineTest, RecordsSpansOnlyWhileRecording) {
+    {
+        TimelineSpan idle("idle");
+    }
+    Timeline::start();
+    EXPECT_EQ(Timeline::events(), 0u);
+    {
+        TimelineSpan outer("outer");
+        TimelineSpan inner("inner");
+    }
+    Timeline::stop();
+    {
+        TimelineSpan late("late");
+    }
+    EXPECT_EQ(Timeline::events(), 2u);
+
+    const auto json = Timeline::to_json();
+    EXPECT_TRUE(json.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_TRUE(json.ends_with("]}"));
+    EXPECT_NE(json.find("{\"name\":\"outer\",\"ph\":\"X\",\"pid\":1,\"tid\":"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"inner\""), std::string::npos);
+    EXPECT_EQ(json.find("idle"), std::string::npos);
+    EXPECT_EQ(json.find("late"), std::string::npos);
+
+    // A new recording starts empty.
+    Timeline::start();
+    Timeline::stop();
+    EXPECT_EQ(Timeline::events(), 0u);
+}
+
+TEST(TimelineTest, EachThreadGetsANamedTrack) {
+    Timeline::start();
+    std::thread first([] {
+        Timeline::name_thread("first \"worker\"");
+        TimelineSpan span("work");
+    });
+    std::thread second([] {
+        Timeline::name_thread("second");
+        TimelineSpan span("work");
+    });
+    first.join();
+    second.join();
+    // Events outlive the threads that recorded them.
+    Timeline::stop();
+
+    const auto json = Timeline::to_json();
+    EXPECT_EQ(count(json, "\"name\":\"work\""), 2u);
+    EXPECT_EQ(count(json, "\"name\":\"thread_name\",\"ph\":\"M\""), 2u);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"first \\\"worker\\\"\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"second\"}"), std::string::npos);
+
+    const auto tid = [&json](const std::string& name) {
+        const auto args = json.find("\"args\":{\"name\":\"" + name);
+        const auto at = json.rfind("\"tid\":", args);
+        return json.substr(at, json.find(',', at) - at);
+    };
+    EXPECT_NE(tid("first"), tid("second"));
+}
+
+TEST(TimelineTest, ThreadsOnlyKeepTracksWhileTheyMatter) {
+    Timeline::start();
+    const auto before = Timeline::tracks();
+    // Naming threads outside a recording registers nothing.
+    Timeline::stop();
+    std::thread([] { Timeline::name_thread("idle"); }).join();
+    EXPECT_EQ(Timeline::tracks(), before);
+
+    Timeline::start();
+    std::thread([] {
+        Timeline::name_thread("busy");
+        TimelineSpan span("work");
+    }).join();
+    Timeline::stop();
+    EXPECT_EQ(Timeline::tracks(), before + 1);
+    EXPECT_NE(Timeline::to_json().find("\"args\":{\"name\":\"busy\"}"), std::string::npos);
+    // The thread is gone, so the next recording drops its track.
+    Timeline::start();
+    Timeline::stop();
+    EXPECT_EQ(Timeline::tracks(), before);
+}
+
+#ifdef LAMBDA_TIMELINE
+TEST(TimelineTest, LibraryPhasesAppear) {
+    Timeline::start();
+    auto term = parse_term("(λx: Nat. add x 1) 2");
+    EXPECT_TRUE(try_type_check(*term));
+    WorkStealingPool pool(2);
+    EXPECT_TRUE(parallel_type_check(*term, pool, TypingContext(), 1));
+    std::istringstream input("(λx. x) y\nadd 1 2\n");
+    std::ostringstream output;
+    BatchOptions options;
+    options.workers = 2;
+    (void)BatchPipeline(options).run(input, output);
+    Timeline::stop();
+
+    const auto json = Timeline::to_json();
+    for (const auto* phase : {"tokenize", "parse", "type_check", "parallel_type_check", "task", "evaluate", "step", "print", "destroy"}) {
+        EXPECT_NE(json.find(std::string("\"name\":\"") + phase + "\""), std::string::npos) << phase;
+    }
+    for (const auto* track : {"check", "normalize", "print"}) {
+        EXPECT_NE(json.find(std::string("\"args\":{\"name\":\"") + track + "\"}"), std::string::npos) << track;
+    }
+}
+#endif
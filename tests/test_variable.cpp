@@ -139,4 +139,23 @@ TEST_F(VariableTest, Substitute_PreservesCustomType) {
     ASSERT_NE(result_var, nullptr);
     EXPECT_EQ(result_var->name, "y");
     EXPECT_EQ(result_var->get_type().to_string(), "String");
-}
\ No newline at end of file
+}
+
+TEST_F(VariableTest, SubstituteInPlace_MatchingName) {
+    Variable replacement("replacement");
+    auto result = substitute(std::move(var_x), "x", replacement);
+    Variable* result_var = dynamic_cast<Variable*>(result.get());
+    ASSERT_NE(result_var, nullptr);
+    EXPECT_EQ(result_var->name, "replacement");
+}
+
+TEST_F(VariableTest, SubstituteInPlace_ReusesNodeWhenUnchanged) {
+    Variable replacement("replacement");
+    Term* original = var_x.get();
+    auto result = substitute(std::move(var_x), "y", replacement);
+    EXPECT_EQ(result.get(), original);
+}
+
+TEST_F(VariableTest, BetaReduceInPlace_Throws) {
+    EXPECT_THROW((void)beta_reduce(std::move(var_x)), ReductionOnNormalForm);
+}
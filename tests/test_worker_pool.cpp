@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "../pipeline/SharedRing.h"
+#include "../pipeline/WorkerPool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <csignal>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string shout(std::string_view request) {
+    std::string response(request);
+    std::ranges::transform(response, response.begin(), [](unsigned char c) { return std::toupper(c); });
+    return response;
+}
+
+}
+
+TEST(SharedRingTest, FramesWrapAroundTheEnd) {
+    std::vector<unsigned char> memory(SharedRing::footprint(64));
+    SharedRing ring(memory.data(), 64);
+    for (int round = 0; round < 50; ++round) {
+        const std::string payload(round % 23, static_cast<char>('a' + round % 26));
+        ASSERT_TRUE(ring.try_push(round % 3, payload));
+        EXPECT_EQ(ring.queued(), 1u);
+        const auto frame = ring.try_pop();
+        ASSERT_TRUE(frame);
+        EXPECT_EQ(frame->tag, round % 3);
+        EXPECT_EQ(frame->bytes, payload);
+    }
+    EXPECT_FALSE(ring.try_pop());
+}
+
+TEST(SharedRingTest, RefusesFramesThatDoNotFit) {
+    std::vector<unsigned char> memory(SharedRing::footprint(64));
+    SharedRing ring(memory.data(), 64);
+    EXPECT_TRUE(ring.try_push(0, std::string(40, 'x')));
+    EXPECT_FALSE(ring.try_push(0, std::string(20, 'y')));
+    (void)ring.try_pop();
+    EXPECT_TRUE(ring.try_push(0, std::string(20, 'y')));
+    EXPECT_FALSE(ring.try_push(0, std::string(ring.max_payload() + 1, 'z')));
+}
+
+TEST(WorkerPoolTest, AnswersEveryRequest) {
+    WorkerOptions options;
+    options.workers = 3;
+    options.ring_bytes = 4096;
+    WorkerPool pool(options, shout);
+    std::map<std::uint64_t, std::string> answers;
+    const auto sink = [&answers](WorkerResult result) {
+        EXPECT_TRUE(result.failure.empty());
+        answers[result.id] = result.response;
+    };
+    for (std::uint64_t id = 0; id < 2000; ++id) pool.submit(id, "term " + std::to_string(id), sink);
+    pool.drain(sink);
+    ASSERT_EQ(answers.size(), 2000u);
+    EXPECT_EQ(answers[1234], "TERM 1234");
+    EXPECT_EQ(pool.restarts(), 0u);
+}
+
+TEST(WorkerPoolTest, ReportsHandlerExceptions) {
+    WorkerPool pool({}, [](std::string_view request) -> std::string {
+        if (request == "bad") throw std::runtime_error("malformed request");
+        return std::string(request);
+    });
+    std::vector<WorkerResult> results;
+    const auto sink = [&results](WorkerResult result) { results.push_back(std::move(result)); };
+    pool.submit(0, "bad", sink);
+    pool.submit(1, "good", sink);
+    pool.drain(sink);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].failure, "malformed request");
+    EXPECT_EQ(results[1].response, "good");
+}
+
+TEST(WorkerPoolTest, RestartsCrashedWorkers) {
+    WorkerOptions options;
+    options.workers = 2;
+    WorkerPool pool(options, [](std::string_view request) {
+        if (request == "crash") std::abort();
+        return shout(request);
+    });
+    std::map<std::uint64_t, WorkerResult> results;
+    const auto sink = [&results](WorkerResult result) { results[result.id] = std::move(result); };
+    for (std::uint64_t id = 0; id < 40; ++id) pool.submit(id, id % 10 == 3 ? "crash" : "ok", sink);
+    pool.drain(sink);
+
+    ASSERT_EQ(results.size(), 40u);
+    for (const auto& [id, result] : results) {
+        if (id % 10 == 3) {
+            EXPECT_NE(result.failure.find("signal " + std::to_string(SIGABRT)), std::string::npos) << result.failure;
+        } else {
+            EXPECT_EQ(result.response, "OK") << id << ": " << result.failure;
+        }
+    }
+    EXPECT_EQ(pool.restarts(), 4u);
+}
+
+TEST(WorkerPoolTest, ReplacesWorkersKilledWhileIdle) {
+    WorkerPool pool({}, shout);
+    ASSERT_EQ(::kill(pool.pids().front(), SIGKILL), 0);
+    std::vector<WorkerResult> results;
+    const auto sink = [&results](WorkerResult result) { results.push_back(std::move(result)); };
+    pool.submit(0, "still served", sink);
+    pool.drain(sink);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].response, "STILL SERVED") << results[0].failure;
+    EXPECT_EQ(pool.restarts(), 1u);
+}
+
+TEST(WorkerPoolTest, EnforcesTheMemoryLimit) {
+    WorkerOptions options;
+    options.memory_limit = std::size_t(1) << 30;
+    WorkerPool pool(options, [](std::string_view request) {
+        std::vector<char> hog(std::size_t(4) << 30, 1);
+        return std::string(request) + std::to_string(hog.back());
+    });
+    std::vector<WorkerResult> results;
+    const auto sink = [&results](WorkerResult result) { results.push_back(std::move(result)); };
+    pool.submit(0, "hog", sink);
+    pool.drain(sink);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_TRUE(results[0].response.empty());
+    EXPECT_FALSE(results[0].failure.empty());
+}
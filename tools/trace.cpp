@@ -0,0 +1,88 @@
+//
+// trace.cpp
+//
+// Offline viewer for files written by `lambda --trace`:
+//
+//   lambda_trace file                 one line per trace
+//   lambda_trace file T               the steps of trace T
+//   lambda_trace file T --terms       the steps of trace T with every term
+//   lambda_trace file T N             the term after N steps of trace T
+//
+
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#include "../engines/ReductionTrace.h"
+
+namespace {
+
+void usage() {
+    std::cerr << "usage: lambda_trace file [trace [step | --terms]]\n";
+}
+
+bool parse_count(const char* text, std::size_t& value) {
+    const std::string_view digits(text);
+    const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+    return error == std::errc() && end == digits.data() + digits.size();
+}
+
+void print_step(const TraceStep& step, std::size_t index) {
+    std::printf("%6zu  %-6s %-12s at %s", index + 1, redex_rule_name(step.rule), step.binder.c_str(), path_to_string(step.path).c_str());
+    if (step.argument != 0) std::printf("  arg %016llx", static_cast<unsigned long long>(step.argument));
+    std::printf("\n");
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 4) return usage(), 2;
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input) {
+        std::cerr << "lambda_trace: cannot open " << argv[1] << '\n';
+        return 1;
+    }
+
+    try {
+        const auto traces = read_traces(input);
+        if (argc == 2) {
+            for (std::size_t i = 0; i < traces.size(); ++i) {
+                const auto& trace = traces[i];
+                std::printf("%zu\t%s\t%zu steps\t%s\n", i, trace.label.c_str(), trace.steps.size(), trace.initial->to_string().c_str());
+            }
+            return 0;
+        }
+
+        std::size_t index = 0;
+        if (!parse_count(argv[2], index)) return usage(), 2;
+        if (index >= traces.size()) {
+            std::cerr << "lambda_trace: the file has " << traces.size() << " traces\n";
+            return 1;
+        }
+        const auto& trace = traces[index];
+
+        const bool terms = argc == 4 && std::string_view(argv[3]) == "--terms";
+        if (argc == 4 && !terms) {
+            std::size_t step = 0;
+            if (!parse_count(argv[3], step)) return usage(), 2;
+            std::cout << trace.term_at(step)->to_string() << '\n';
+            return 0;
+        }
+
+        // Replays incrementally, so rendering every term is one pass.
+        auto term = trace.initial->clone();
+        std::printf("%6d  %s\n", 0, terms ? term->to_string().c_str() : trace.label.c_str());
+        for (std::size_t i = 0; i < trace.steps.size(); ++i) {
+            print_step(trace.steps[i], i);
+            if (!terms) continue;
+            term = trace.apply(std::move(term), i);
+            std::printf("        %s\n", term->to_string().c_str());
+        }
+    } catch (const std::exception& error) {
+        std::cerr << "lambda_trace: " << error.what() << '\n';
+        return 1;
+    }
+    return 0;
+}